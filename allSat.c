@@ -0,0 +1,293 @@
+/**
+ * @file allSat.c
+ * @brief Lazy All-SAT: satisfying assignments as disjoint cubes.
+ *
+ * printTruthTable evaluates all 2^n rows to show the few that are true,
+ * which stops working long before 60 variables. This searches for the
+ * models instead and hands them out one cube at a time, with don't-cares
+ * for the variables that no longer matter, so a formula with a handful
+ * of large model regions costs a handful of cubes.
+ * @section algo Algorithm: DPLL over the formula's own variables
+ *   - Propagation: the counter-based engine of unitProp.c on the clause
+ *     set, or on the Tseitin clauses of a formula (root asserted)
+ *   - Cube found: every clause satisfied (clause sets), or the formula
+ *     true in three-valued evaluation of the compiled tree (formulas),
+ *     so the auxiliary Tseitin variables never have to be decided
+ *   - Branching: shortest open clause, or the tree walked from the root
+ *     along undecided operands towards a leaf, with the polarity that
+ *     makes the walked path true
+ *   - Backtracking is chronological from an explicit decision stack, so
+ *     the search can stop after any cube and resume on the next call;
+ *     cubes of different branches differ in a decision, hence disjoint
+ * @section time Time Complexity: O(2^n) worst case; per node O(propagation)
+ *   plus O(|formula|) for the three-valued check
+ * @section space Space Complexity: O(clauses + n), independent of the
+ *   number of models
+ */
+
+#include "allSat.h"
+#include "unitProp.h"
+#include "tseitin.h"
+#include "compiledFormula.h"
+#include "simplify.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define UNKNOWN 2   /* third truth value of the compiled-tree check */
+
+/**
+ * @brief One branching decision.
+ */
+typedef struct {
+    int lit;        /**< Literal decided (its negation once flipped) */
+    int mark;       /**< Trail size before the decision */
+    int flipped;    /**< Second branch under way */
+} Decision;
+
+struct AllSat {
+    UnitProp *up;
+    CnfFormula *owned;      /**< Tseitin clauses built for a formula */
+    CompiledFormula *cf;    /**< Formula for the cube check (NULL: clause set) */
+    signed char *slots;     /**< Three-valued value of each instruction */
+    int numVars;            /**< Variables of the cubes: 1..numVars */
+    Decision *stack;
+    int depth;
+    signed char *cube;
+    int backtrack;          /**< The current branch is exhausted */
+    int done;
+    AllSatStats stats;
+};
+
+/**
+ * @brief Allocates an enumerator over f; the cube check uses cf if set.
+ */
+static AllSat *newEnumerator(const CnfFormula *f, int numVars, CompiledFormula *cf) {
+    AllSat *e = calloc(1, sizeof(AllSat));
+    if (!e) { perror("calloc"); return NULL; }
+    e->numVars = numVars;
+    e->cf = cf;
+    e->up = unitPropNew(f);
+    e->stack = malloc((size_t)(numVars + 1) * sizeof(Decision));
+    e->cube = malloc((size_t)(numVars + 1));
+    e->slots = cf ? malloc((size_t)cf->numInstrs) : NULL;
+    if (!e->up || !e->stack || !e->cube || (cf && !e->slots)) {
+        perror("malloc");
+        allSatFree(e);
+        return NULL;
+    }
+    return e;
+}
+
+/**
+ * @copydoc allSatNew
+ */
+AllSat *allSatNew(const CnfFormula *f) {
+    return newEnumerator(f, f->numVars, NULL);
+}
+
+/**
+ * @brief Clause set of a constant: no clauses (true) or one empty clause.
+ */
+static CnfFormula *constantCnf(int numVars, int value) {
+    CnfFormula *f = calloc(1, sizeof(CnfFormula));
+    if (f) f->clauseStart = calloc(2, sizeof(int));
+    if (!f || !f->clauseStart) {
+        perror("calloc");
+        freeCnfFormula(f);
+        return NULL;
+    }
+    f->numVars = numVars;
+    f->numClauses = value ? 0 : 1;
+    return f;
+}
+
+/**
+ * @copydoc allSatFromFormula
+ */
+AllSat *allSatFromFormula(const Node *root, VarMap *vm) {
+    if (!root || !root->tok) return NULL;
+    int constant = constantValue(root->tok);
+    if (constant < 0 && !varMapCollect(vm, root)) return NULL;
+
+    CnfFormula *f = constant >= 0 ? constantCnf(vm->count, constant) : tseitinToCnf(vm, root);
+    CompiledFormula *cf = constant >= 0 || !f ? NULL : compileFormula(root, vm);
+    AllSat *e = f && (constant >= 0 || cf) ? newEnumerator(f, vm->count, cf) : NULL;
+    if (!e) {
+        freeCnfFormula(f);
+        freeCompiledFormula(cf);
+        return NULL;
+    }
+    e->owned = f;
+    return e;
+}
+
+/**
+ * @copydoc allSatFree
+ */
+void allSatFree(AllSat *e) {
+    if (!e) return;
+    if (e->up) unitPropFree(e->up);
+    freeCnfFormula(e->owned);
+    freeCompiledFormula(e->cf);
+    free(e->slots);
+    free(e->stack);
+    free(e->cube);
+    free(e);
+}
+
+/**
+ * @copydoc allSatNumVars
+ */
+int allSatNumVars(const AllSat *e) {
+    return e->numVars;
+}
+
+/**
+ * @brief Three-valued (Kleene) evaluation of the compiled formula under
+ *        the engine's current assignment.
+ * @return 1, 0 or UNKNOWN.
+ */
+static int evalThreeValued(AllSat *e) {
+    const CompiledFormula *cf = e->cf;
+    signed char *v = e->slots;
+    for (int i = 0; i < cf->numInstrs; i++) {
+        const FormulaInstr *in = &cf->code[i];
+        int a = in->op == FOP_VAR ? e->up->value[in->a + 1] : v[in->a];
+        int b = in->op == FOP_VAR || in->op == FOP_NOT ? 0 : v[in->b];
+        if (in->op == FOP_IMPLIES) a = a == UNKNOWN ? UNKNOWN : !a;
+        switch (in->op) {
+        case FOP_VAR: v[i] = a < 0 ? UNKNOWN : a; break;
+        case FOP_NOT: v[i] = a == UNKNOWN ? UNKNOWN : !a; break;
+        case FOP_AND: v[i] = a == 0 || b == 0 ? 0 : a == 1 && b == 1 ? 1 : UNKNOWN; break;
+        default:      v[i] = a == 1 || b == 1 ? 1 : a == 0 && b == 0 ? 0 : UNKNOWN; break;
+        }
+    }
+    return v[cf->numInstrs - 1];
+}
+
+/**
+ * @brief Walks from the root along undecided operands to an unassigned
+ *        variable (slots must hold a fresh evaluation with root UNKNOWN).
+ * @return Literal making the walked path true.
+ */
+static int treeBranchLiteral(const AllSat *e) {
+    const FormulaInstr *code = e->cf->code;
+    int i = e->cf->numInstrs - 1, want = 1;
+    for (;;) {
+        const FormulaInstr *in = &code[i];
+        if (in->op == FOP_VAR) return want ? in->a + 1 : -(in->a + 1);
+        if (in->op == FOP_NOT || (in->op == FOP_IMPLIES && e->slots[in->a] == UNKNOWN)) {
+            i = in->a;
+            want = !want;
+        } else {
+            i = e->slots[in->a] == UNKNOWN && in->op != FOP_IMPLIES ? in->a : in->b;
+        }
+    }
+}
+
+/**
+ * @brief Picks a free literal of the shortest unsatisfied clause.
+ * @return DIMACS literal, or 0 if every clause is satisfied.
+ */
+static int clauseBranchLiteral(const UnitProp *up) {
+    const CnfFormula *f = up->f;
+    int best = -1, bestFree = 0x7fffffff;
+    for (int c = 0; c < f->numClauses; c++) {
+        if (up->satCount[c] == 0 && up->freeCount[c] < bestFree) {
+            best = c;
+            bestFree = up->freeCount[c];
+            if (bestFree <= 2) break;
+        }
+    }
+    if (best < 0) return 0;
+    const int *lits = cnfClause(f, best);
+    for (int k = 0; k < cnfClauseSize(f, best); k++)
+        if (unitPropLitValue(up, lits[k]) < 0) return lits[k];
+    return 0;
+}
+
+/**
+ * @brief Moves to the next unexplored branch.
+ * @return 0 if the search space is exhausted.
+ */
+static int backtrackOne(AllSat *e) {
+    while (e->depth > 0) {
+        Decision *d = &e->stack[e->depth - 1];
+        unitPropBacktrack(e->up, d->mark);
+        if (!d->flipped) {
+            d->flipped = 1;
+            d->lit = -d->lit;
+            unitPropAssign(e->up, d->lit);
+            return 1;
+        }
+        e->depth--;
+    }
+    return 0;
+}
+
+/**
+ * @copydoc allSatNext
+ */
+const signed char *allSatNext(AllSat *e) {
+    while (!e->done) {
+        if (e->backtrack && !backtrackOne(e)) {
+            e->done = 1;
+            break;
+        }
+        e->backtrack = 1;
+        if (!unitPropPropagate(e->up)) {
+            e->stats.conflicts++;
+            continue;
+        }
+        int lit;
+        if (e->cf) {
+            int value = evalThreeValued(e);
+            if (value == 0) {
+                e->stats.conflicts++;
+                continue;
+            }
+            lit = value == 1 ? 0 : treeBranchLiteral(e);
+        } else {
+            lit = clauseBranchLiteral(e->up);
+        }
+        if (lit == 0) {
+            int dontCare = 0;
+            for (int v = 1; v <= e->numVars; v++) {
+                e->cube[v - 1] = e->up->value[v];
+                dontCare += e->cube[v - 1] < 0;
+            }
+            e->stats.cubes++;
+            e->stats.models += ldexp(1.0, dontCare);
+            return e->cube;
+        }
+        e->stack[e->depth].lit = lit;
+        e->stack[e->depth].mark = e->up->trailSize;
+        e->stack[e->depth].flipped = 0;
+        e->depth++;
+        e->stats.decisions++;
+        unitPropAssign(e->up, lit);
+        e->backtrack = 0;
+    }
+    return NULL;
+}
+
+/**
+ * @copydoc allSatForEach
+ */
+long long allSatForEach(AllSat *e, AllSatFn fn, void *arg) {
+    long long n = 0;
+    const signed char *cube;
+    while ((cube = allSatNext(e)) != NULL) {
+        n++;
+        if (fn(cube, e->numVars, arg)) break;
+    }
+    return n;
+}
+
+/**
+ * @copydoc allSatGetStats
+ */
+AllSatStats allSatGetStats(const AllSat *e) {
+    return e->stats;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file allSat.h
+ * @brief Header for streaming enumeration of satisfying assignments.
+ */
+
+#ifndef ALL_SAT_H
+#define ALL_SAT_H
+
+#include "common.h"
+#include "varMap.h"
+#include "cnfFormula.h"
+
+/**
+ * @brief Counters of one enumeration.
+ */
+typedef struct {
+    long long cubes;       /**< Cubes returned so far */
+    double models;         /**< Total assignments they cover */
+    long long decisions;   /**< Branching decisions */
+    long long conflicts;   /**< Dead ends */
+} AllSatStats;
+
+/**
+ * @brief Opaque enumerator.
+ *
+ * Models come out as cubes: partial assignments whose every extension is
+ * a model. The cubes are pairwise disjoint and together cover all models,
+ * so each model is reported exactly once. Memory stays at O(formula +
+ * variables) however many models there are.
+ */
+typedef struct AllSat AllSat;
+
+/**
+ * @brief Called for each cube by allSatForEach.
+ * @param cube cube[v-1] is 1, 0, or -1 (don't care) for variable v.
+ * @return Nonzero to stop the enumeration.
+ */
+typedef int (*AllSatFn)(const signed char *cube, int numVars, void *arg);
+
+/**
+ * @brief Enumerates the models of a clause set over f->numVars variables.
+ * @param f Clause set; must outlive the enumerator.
+ * @return New enumerator, or NULL on malloc failure.
+ */
+AllSat *allSatNew(const CnfFormula *f);
+
+/**
+ * @brief Enumerates the models of a formula over the variables of vm.
+ *
+ * The leaves of root are interned into vm first, so vm->names gives the
+ * columns of the cubes; names already in vm that the formula does not
+ * use are don't-cares in every cube.
+ *
+ * @param root Formula (may be a "1" / "0" constant).
+ * @param vm Variable map (updated).
+ * @return New enumerator, or NULL if the tree is malformed or malloc fails.
+ */
+AllSat *allSatFromFormula(const Node *root, VarMap *vm);
+
+/**
+ * @brief Frees an enumerator.
+ */
+void allSatFree(AllSat *e);
+
+/**
+ * @brief Variables of the cubes.
+ */
+int allSatNumVars(const AllSat *e);
+
+/**
+ * @brief Finds the next cube.
+ * @return The cube (numVars values, valid until the next call), or NULL
+ *         once every model has been returned.
+ */
+const signed char *allSatNext(AllSat *e);
+
+/**
+ * @brief Runs allSatNext until the end or until fn returns nonzero.
+ * @return Number of cubes passed to fn.
+ */
+long long allSatForEach(AllSat *e, AllSatFn fn, void *arg);
+
+/**
+ * @brief Counters so far.
+ */
+AllSatStats allSatGetStats(const AllSat *e);
+
+#endif
@@ -0,0 +1,376 @@
+/**
+ * @file batchDriver.c
+ * @brief Runs analyses over a whole corpus without a person at the keyboard.
+ *
+ * The interactive menu starts one process per formula and stops for
+ * prompts. Here one process walks the corpus, and a loader thread keeps
+ * the next instances read and parsed while the current one is being
+ * solved, so the analyses rarely wait for the disk.
+ * @section algo Algorithm: Two-stage pipeline (loader -> analyzer)
+ *   - Loader: readCnfFormula into a bounded ring of parsed instances
+ *   - Analyzer: pops in order, runs the selected analyses, prints a JSON line
+ * @section time Time Complexity: max(total parse, total analysis) + fill
+ * @section space Space Complexity: O(prefetch + 1) parsed instances
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batchDriver.h"
+#include "cnfFormula.h"
+#include "compressedInput.h"
+#include "satSolver.h"
+#include "modelCount.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define PATH_LEN 4096
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @copydoc defaultBatchOptions
+ */
+BatchOptions defaultBatchOptions(void) {
+    BatchOptions o;
+    o.analyses = BATCH_PARSE | BATCH_SAT;
+    o.conflictBudget = 0;
+    o.prefetch = 2;
+    o.cache = NULL;
+    return o;
+}
+
+/**
+ * @copydoc parseBatchAnalyses
+ */
+int parseBatchAnalyses(const char *list, int *mask) {
+    static const struct { const char *name; int flag; } table[] = {
+        { "parse", BATCH_PARSE }, { "tautology", BATCH_TAUTOLOGY },
+        { "sat", BATCH_SAT }, { "count", BATCH_COUNT }
+    };
+    char *copy = strdup_s(list);
+    char *save = NULL;
+    int ok = copy != NULL;
+    *mask = 0;
+    for (char *tok = ok ? strtok_r(copy, ",", &save) : NULL; tok; tok = strtok_r(NULL, ",", &save)) {
+        int found = 0;
+        for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++) {
+            if (strcmp(tok, table[i].name) == 0) { *mask |= table[i].flag; found = 1; }
+        }
+        if (!found) {
+            printf("Error: Unknown analysis '%s'.\n", tok);
+            ok = 0;
+        }
+    }
+    free(copy);
+    return ok;
+}
+
+/* ----- input collection ----- */
+
+typedef struct {
+    char **items;
+    int count, cap;
+} PathList;
+
+static int pushPath(PathList *l, const char *path) {
+    if (l->count == l->cap) {
+        int ncap = l->cap ? l->cap * 2 : 256;
+        char **ni = realloc(l->items, (size_t)ncap * sizeof(char*));
+        if (!ni) { perror("realloc"); return 0; }
+        l->items = ni;
+        l->cap = ncap;
+    }
+    l->items[l->count] = strdup_s(path);
+    return l->items[l->count++] != NULL;
+}
+
+static int comparePaths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Appends every *.cnf below dir.
+ * @return 1 on success, 0 on error.
+ */
+static int walkDirectory(PathList *l, const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) { perror(dir); return 0; }
+    int ok = 1;
+    char path[PATH_LEN];
+    struct dirent *e;
+    while (ok && (e = readdir(d)) != NULL) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) ok = walkDirectory(l, path);
+        else if (S_ISREG(st.st_mode) && isCnfPath(e->d_name)) ok = pushPath(l, path);
+    }
+    closedir(d);
+    return ok;
+}
+
+/**
+ * @brief Appends the paths listed in a list file.
+ * @return 1 on success, 0 on error.
+ */
+static int readListFile(PathList *l, const char *listPath) {
+    FILE *fp = fopen(listPath, "r");
+    if (!fp) { perror(listPath); return 0; }
+    int ok = 1;
+    char line[PATH_LEN];
+    while (ok && fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+        ok = pushPath(l, line);
+    }
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @copydoc collectBatchInputs
+ */
+int collectBatchInputs(const char *path, char ***files) {
+    PathList l = { NULL, 0, 0 };
+    struct stat st;
+    int ok;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        ok = 0;
+    } else if (S_ISDIR(st.st_mode)) {
+        ok = walkDirectory(&l, path);
+        if (ok) qsort(l.items, (size_t)l.count, sizeof(char*), comparePaths);
+    } else if (isCnfPath(path)) {
+        ok = pushPath(&l, path);
+    } else {
+        ok = readListFile(&l, path);
+    }
+    if (!ok) {
+        for (int i = 0; i < l.count; i++) free(l.items[i]);
+        free(l.items);
+        *files = NULL;
+        return -1;
+    }
+    *files = l.items;
+    return l.count;
+}
+
+/* ----- loader thread ----- */
+
+/**
+ * @brief One parsed instance in flight between the two stages.
+ */
+typedef struct {
+    int index;               /**< Position in the file list */
+    CnfFormula *formula;     /**< NULL if reading failed */
+    double parseSeconds;
+} LoadedInstance;
+
+/**
+ * @brief Bounded ring shared by the loader and the analyzer.
+ */
+typedef struct {
+    char **files;
+    int n;
+    LoadedInstance *ring;
+    int cap, head, count;
+    int stop;                     /**< Analyzer gave up; loader should exit */
+    double loadSeconds;
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty, notFull;
+} Pipeline;
+
+static void *loaderMain(void *arg) {
+    Pipeline *p = arg;
+    for (int i = 0; i < p->n; i++) {
+        double t0 = nowSeconds();
+        LoadedInstance li = { i, readCnfFormula(p->files[i]), 0 };
+        li.parseSeconds = nowSeconds() - t0;
+
+        pthread_mutex_lock(&p->lock);
+        p->loadSeconds += li.parseSeconds;
+        while (p->count == p->cap && !p->stop) pthread_cond_wait(&p->notFull, &p->lock);
+        if (p->stop) {
+            pthread_mutex_unlock(&p->lock);
+            freeCnfFormula(li.formula);
+            break;
+        }
+        p->ring[(p->head + p->count) % p->cap] = li;
+        p->count++;
+        pthread_cond_signal(&p->notEmpty);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return NULL;
+}
+
+/* ----- analyses ----- */
+
+/**
+ * @copydoc printJsonString
+ */
+void printJsonString(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * @copydoc printCnfAnalyses
+ */
+void printCnfAnalyses(FILE *out, const CnfFormula *f, const BatchOptions *o) {
+    CachedResult rec = emptyCachedResult();
+    CacheKey key = { 0, 0 };
+    int hit = 0, fromCache = 0, learned = 0;
+    if (o->cache && (o->analyses & (BATCH_SAT | BATCH_COUNT))) {
+        key = hashClauseSet(f);
+        hit = resultCacheLookup(o->cache, key, &rec);
+        if (rec.sat < 0 && rec.models >= 0) rec.sat = rec.models > 0;
+    }
+
+    if (o->analyses & BATCH_PARSE)
+        fprintf(out, ",\"vars\":%d,\"clauses\":%d,\"literals\":%d",
+                f->numVars, f->numClauses, f->clauseStart[f->numClauses]);
+    if (o->analyses & BATCH_TAUTOLOGY) {
+        /* Tautological clauses were dropped while reading */
+        fprintf(out, ",\"tautology\":%s", f->numClauses == 0 ? "true" : "false");
+    }
+    if ((o->analyses & BATCH_SAT) && rec.sat >= 0) {
+        fprintf(out, ",\"sat\":\"%s\"", rec.sat ? "SAT" : "UNSAT");
+        fromCache = 1;
+    } else if (o->analyses & BATCH_SAT) {
+        double t0 = nowSeconds();
+        Solver *s = solverFromFormula(f);
+        if (!s) {
+            fprintf(out, ",\"sat\":\"ERROR\"");
+        } else {
+            if (o->conflictBudget > 0) solverSetConflictBudget(s, o->conflictBudget);
+            int res = solverSolve(s, NULL, 0);
+            SolverStats st = solverGetStats(s);
+            fprintf(out, ",\"sat\":\"%s\",\"sat_s\":%.6f,\"conflicts\":%lld",
+                    res == SOLVER_SAT ? "SAT" : res == SOLVER_UNSAT ? "UNSAT" : "UNKNOWN",
+                    nowSeconds() - t0, st.conflicts);
+            solverFree(s);
+            // A budget-limited UNKNOWN is not a property of the formula
+            if (res != SOLVER_UNKNOWN) {
+                rec.sat = res == SOLVER_SAT;
+                learned = 1;
+            }
+        }
+    }
+    if ((o->analyses & BATCH_COUNT) && rec.models >= 0) {
+        fprintf(out, ",\"models\":%.0f", rec.models);
+        fromCache = 1;
+    } else if (o->analyses & BATCH_COUNT) {
+        double t0 = nowSeconds();
+        double models = countModels(f);
+        if (models < 0) fprintf(out, ",\"models\":null");
+        else fprintf(out, ",\"models\":%.0f", models);
+        fprintf(out, ",\"count_s\":%.6f", nowSeconds() - t0);
+        if (models >= 0) {
+            rec.models = models;
+            rec.sat = models > 0;
+            learned = 1;
+        }
+    }
+
+    if (fromCache) fprintf(out, ",\"cached\":\"%s\"", hit == 2 ? "disk" : "memory");
+    if (learned && o->cache) {
+        rec.numVars = f->numVars;
+        rec.valid = f->numClauses == 0;
+        resultCacheStore(o->cache, key, &rec);
+    }
+    freeCachedResult(&rec);
+}
+
+/**
+ * @brief Runs the selected analyses on one instance and prints its line.
+ */
+static void analyzeInstance(const char *path, const LoadedInstance *li, const BatchOptions *o, FILE *out) {
+    const CnfFormula *f = li->formula;
+    fprintf(out, "{\"file\":");
+    printJsonString(out, path);
+    if (!f) {
+        fprintf(out, ",\"error\":\"read failed\"}\n");
+        return;
+    }
+    fprintf(out, ",\"parse_s\":%.6f", li->parseSeconds);
+    printCnfAnalyses(out, f, o);
+    fprintf(out, "}\n");
+}
+
+/**
+ * @copydoc runBatch
+ */
+int runBatch(char **files, int n, const BatchOptions *opts, FILE *out, BatchSummary *summary) {
+    BatchSummary local;
+    if (!summary) summary = &local;
+    memset(summary, 0, sizeof(*summary));
+
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.files = files;
+    p.n = n;
+    p.cap = opts->prefetch > 0 ? opts->prefetch : 1;
+    p.ring = malloc((size_t)p.cap * sizeof(LoadedInstance));
+    if (!p.ring) { perror("malloc"); return 0; }
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.notEmpty, NULL);
+    pthread_cond_init(&p.notFull, NULL);
+
+    double start = nowSeconds();
+    pthread_t loader;
+    if (pthread_create(&loader, NULL, loaderMain, &p) != 0) {
+        perror("pthread_create");
+        free(p.ring);
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        double t0 = nowSeconds();
+        pthread_mutex_lock(&p.lock);
+        while (p.count == 0) pthread_cond_wait(&p.notEmpty, &p.lock);
+        LoadedInstance li = p.ring[p.head];
+        p.head = (p.head + 1) % p.cap;
+        p.count--;
+        pthread_cond_signal(&p.notFull);
+        pthread_mutex_unlock(&p.lock);
+        double t1 = nowSeconds();
+        summary->stallSeconds += t1 - t0;
+
+        analyzeInstance(files[li.index], &li, opts, out);
+        fflush(out);
+        if (!li.formula) summary->failed++;
+        summary->instances++;
+        freeCnfFormula(li.formula);
+        summary->analyzeSeconds += nowSeconds() - t1;
+    }
+
+    pthread_mutex_lock(&p.lock);
+    p.stop = 1;
+    pthread_cond_signal(&p.notFull);
+    pthread_mutex_unlock(&p.lock);
+    pthread_join(loader, NULL);
+
+    summary->loadSeconds = p.loadSeconds;
+    summary->wallSeconds = nowSeconds() - start;
+    pthread_mutex_destroy(&p.lock);
+    pthread_cond_destroy(&p.notEmpty);
+    pthread_cond_destroy(&p.notFull);
+    free(p.ring);
+    return 1;
+}
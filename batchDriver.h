@@ -0,0 +1,106 @@
+/**
+ * @file batchDriver.h
+ * @brief Header for the non-interactive corpus driver.
+ */
+
+#ifndef BATCH_DRIVER_H
+#define BATCH_DRIVER_H
+
+#include <stdio.h>
+#include "cnfFormula.h"
+#include "resultCache.h"
+
+/**
+ * @brief Analyses the driver can run on each instance (bit mask).
+ */
+enum {
+    BATCH_PARSE     = 1,   /**< Variable, clause and literal counts */
+    BATCH_TAUTOLOGY = 2,   /**< Validity of the CNF (every clause tautological) */
+    BATCH_SAT       = 4,   /**< CDCL satisfiability */
+    BATCH_COUNT     = 8    /**< Exact model count (exponential in the worst case) */
+};
+
+/**
+ * @brief Settings of a batch run.
+ */
+typedef struct {
+    int analyses;             /**< Mask of BATCH_* flags */
+    long long conflictBudget; /**< Per-instance SAT conflict limit (<= 0: none) */
+    int prefetch;             /**< Parsed instances the loader may run ahead */
+    ResultCache *cache;       /**< Answers sat and count by clause-set hash (may be NULL) */
+} BatchOptions;
+
+/**
+ * @brief Totals of a batch run.
+ */
+typedef struct {
+    int instances;            /**< Instances processed */
+    int failed;               /**< Instances that could not be read */
+    double wallSeconds;       /**< Whole run */
+    double loadSeconds;       /**< Reading and parsing (loader thread) */
+    double analyzeSeconds;    /**< Running the analyses (main thread) */
+    double stallSeconds;      /**< Main thread waiting for the loader */
+} BatchSummary;
+
+/**
+ * @brief Returns the default options: parse and sat, no budget, prefetch 2,
+ *        no cache.
+ */
+BatchOptions defaultBatchOptions(void);
+
+/**
+ * @brief Parses a comma-separated analysis list ("parse,tautology,sat,count").
+ * @param list Names to enable.
+ * @param mask Output mask of BATCH_* flags.
+ * @return 1 on success, 0 on an unknown name.
+ */
+int parseBatchAnalyses(const char *list, int *mask);
+
+/**
+ * @brief Collects the instances to process.
+ *
+ * A directory is walked recursively for *.cnf files; a path ending in
+ * .cnf is a single instance; anything else is read as a list file with
+ * one path per line ('#' lines and blank lines are skipped). Directory
+ * results are sorted so runs are reproducible.
+ *
+ * @param path Directory, instance or list file.
+ * @param files Output array of paths (free each entry and the array).
+ * @return Number of paths, or -1 on error.
+ */
+int collectBatchInputs(const char *path, char ***files);
+
+/**
+ * @brief Runs the analyses on every instance and writes one JSON line each.
+ *
+ * A loader thread reads and parses the next instances while the current
+ * one is analyzed, so I/O and parsing overlap the solving.
+ *
+ * @param files Instance paths.
+ * @param n Number of paths.
+ * @param opts Analyses and limits.
+ * @param out Destination for the JSON lines.
+ * @param summary Output totals (may be NULL).
+ * @return 1 on success, 0 if the loader could not be started.
+ */
+int runBatch(char **files, int n, const BatchOptions *opts, FILE *out, BatchSummary *summary);
+
+/**
+ * @brief Runs the selected analyses on one formula and writes their JSON
+ *        fields, each preceded by a comma, so callers can embed them in
+ *        their own object.
+ * @param out Destination.
+ * @param f Formula.
+ * With opts->cache set, sat and count answers already known for the same
+ * clause set are reused (marked by a "cached" field) and new ones stored.
+ *
+ * @param opts Analyses and limits.
+ */
+void printCnfAnalyses(FILE *out, const CnfFormula *f, const BatchOptions *opts);
+
+/**
+ * @brief Writes s as a JSON string literal (quoted and escaped).
+ */
+void printJsonString(FILE *out, const char *s);
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file batchEval.c
+ * @brief Streams packed assignment rows through a compiled formula.
+ *
+ * Rows arrive one assignment per row, but evalCompiledBlock wants one
+ * word per variable holding 64 assignments. Each group of 64 rows is
+ * therefore turned around with a 64×64 bit-matrix transpose per 64
+ * columns, so the formula itself runs on 4096 rows per instruction pass
+ * and its result words are already the packed output bitmap.
+ * @section algo Algorithm:
+ *   Step 1: Read a chunk of rows with one fread
+ *   Step 2: For every 64-row group and 64-column slice, load 64 row words
+ *           and transpose them into 64 variable words
+ *   Step 3: Evaluate 64 groups at once (one block), write the result words
+ * @section time Time Complexity: O(R × (C/64 × log 64 + |F|/64))
+ *   - R = rows, C = columns, |F| = formula size
+ * @section space Space Complexity: O(C × 64 + |F| × 64) words + one I/O chunk
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batchEval.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BATCH_WIDTH 64                      /* words per block: 4096 rows */
+#define BLOCK_ROWS (BATCH_WIDTH * 64)
+#define CHUNK_BLOCKS 16                     /* rows per fread: 65536 */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Loads 8 bytes little-endian and keeps the low len of them. The
+ *        chunk buffer is padded, so reading past a short row is safe.
+ */
+static inline uint64_t loadWord(const unsigned char *p, uint64_t keep) {
+    uint64_t w;
+    memcpy(&w, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w & keep;
+}
+
+#if defined(__GNUC__)
+typedef uint64_t WordVec __attribute__((vector_size(32), aligned(8), may_alias));
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__) && !defined(__clang__) \
+    && !defined(__SANITIZE_THREAD__)
+#define SLICE_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define SLICE_TARGETS
+#endif
+
+/**
+ * @brief Transposes a 64×64 bit matrix in place: bit c of a[r] moves to
+ *        bit r of a[c]. Stages with j >= 4 swap runs of whole words and
+ *        run four words per vector operation.
+ */
+static inline void transpose64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    int j = 32;
+#if defined(__GNUC__)
+    for (; j >= 4; j >>= 1, m ^= m << j) {
+        for (int k = 0; k < 64; k += 2 * j) {
+            for (int i = k; i < k + j; i += 4) {
+                WordVec *lo = (WordVec*)&a[i], *hi = (WordVec*)&a[i + j];
+                WordVec t = ((*lo >> j) ^ *hi) & m;
+                *lo ^= t << j;
+                *hi ^= t;
+            }
+        }
+    }
+#endif
+    for (; j; j >>= 1, m ^= m << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+/**
+ * @brief Bit-slices the rows of one block into vars (numVars × BATCH_WIDTH).
+ *        Rows past nRows read as zero.
+ */
+SLICE_TARGETS
+static void sliceBlock(const unsigned char *rows, int stride, int nRows, int numVars, uint64_t *vars) {
+    uint64_t m[64];
+    for (int c = 0; c * 64 < numVars; c++) {
+        int len = stride - c * 8;
+        uint64_t keep = len >= 8 ? ~0ULL : (1ULL << (8 * len)) - 1;
+        int lim = numVars - c * 64 < 64 ? numVars - c * 64 : 64;
+        const unsigned char *p = rows + c * 8;
+        for (int w = 0; w < BATCH_WIDTH; w++) {
+            int base = w * 64;
+            if (base + 64 <= nRows) {
+                for (int r = 0; r < 64; r++) m[r] = loadWord(p + (size_t)(base + r) * stride, keep);
+            } else {
+                for (int r = 0; r < 64; r++)
+                    m[r] = base + r < nRows ? loadWord(p + (size_t)(base + r) * stride, keep) : 0;
+            }
+            transpose64(m);
+            for (int j = 0; j < lim; j++) vars[(size_t)(c * 64 + j) * BATCH_WIDTH + w] = m[j];
+        }
+    }
+}
+
+/**
+ * @brief Writes the first nBits result bits as little-endian bytes.
+ * @return 1 on success, 0 on a write error.
+ */
+static int writeBits(FILE *out, const uint64_t *res, int nBits, unsigned char *buf) {
+    int nBytes = (nBits + 7) / 8;
+    for (int w = 0; w * 64 < nBits; w++) {
+        uint64_t x = res[w];
+        if (nBits - w * 64 < 64) x &= (1ULL << (nBits - w * 64)) - 1;
+        for (int b = 0; b < 8; b++) buf[w * 8 + b] = (unsigned char)(x >> (8 * b));
+    }
+    return fwrite(buf, 1, (size_t)nBytes, out) == (size_t)nBytes;
+}
+
+/**
+ * @copydoc batchEvaluate
+ */
+int batchEvaluate(const CompiledFormula *cf, int columns, FILE *in, FILE *out, BatchEvalReport *rep) {
+    BatchEvalReport local;
+    if (!rep) rep = &local;
+    memset(rep, 0, sizeof(*rep));
+    if (columns < cf->numVars) {
+        printf("Error: Rows have %d columns but the formula uses %d variables.\n", columns, cf->numVars);
+        return 0;
+    }
+    int stride = (columns + 7) / 8;
+    if (stride == 0) stride = 1;
+    size_t chunkBytes = (size_t)CHUNK_BLOCKS * BLOCK_ROWS * stride;
+
+    unsigned char *chunk = malloc(chunkBytes + 8);  /* padding for loadWord */
+    uint64_t *vars = malloc((size_t)(cf->numVars ? cf->numVars : 1) * BATCH_WIDTH * sizeof(uint64_t));
+    uint64_t *slots = malloc((size_t)cf->numInstrs * BATCH_WIDTH * sizeof(uint64_t));
+    unsigned char *outBuf = malloc(BATCH_WIDTH * 8);
+    int ok = 0;
+    if (!chunk || !vars || !slots || !outBuf) { perror("malloc"); goto out; }
+
+    double t0 = nowSeconds();
+    size_t have = 0;
+    ok = 1;
+    for (;;) {
+        size_t got = fread(chunk + have, 1, chunkBytes - have, in);
+        have += got;
+        int eof = got == 0 || have < chunkBytes;
+        if (eof && ferror(in)) { perror("fread"); ok = 0; break; }
+
+        long long nRows = (long long)(have / stride);
+        for (long long r0 = 0; r0 < nRows && ok; r0 += BLOCK_ROWS) {
+            int blockRows = nRows - r0 < BLOCK_ROWS ? (int)(nRows - r0) : BLOCK_ROWS;
+            sliceBlock(chunk + (size_t)r0 * stride, stride, blockRows, cf->numVars, vars);
+            const uint64_t *res = evalCompiledBlock(cf, vars, BATCH_WIDTH, slots);
+            int words = (blockRows + 63) / 64;
+            for (int w = 0; w < words; w++) {
+                uint64_t x = res[w];
+                if (blockRows - w * 64 < 64) x &= (1ULL << (blockRows - w * 64)) - 1;
+                rep->trueRows += __builtin_popcountll(x);
+            }
+            /* Chunks are full until EOF, so only the last block can end mid-byte */
+            if (!writeBits(out, res, blockRows, outBuf)) { perror("fwrite"); ok = 0; }
+        }
+        rep->rows += nRows;
+        size_t used = (size_t)nRows * stride;
+        memmove(chunk, chunk + used, have - used);
+        have -= used;
+        if (eof || !ok) break;
+    }
+    rep->trailingBytes = (long long)have;
+    if (ok && fflush(out) != 0) { perror("fflush"); ok = 0; }
+    rep->seconds = nowSeconds() - t0;
+
+out:
+    free(chunk);
+    free(vars);
+    free(slots);
+    free(outBuf);
+    return ok;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file batchEval.h
+ * @brief Header for evaluating one formula on a stream of packed assignments.
+ */
+
+#ifndef BATCH_EVAL_H
+#define BATCH_EVAL_H
+
+#include <stdio.h>
+#include "compiledFormula.h"
+
+/**
+ * @brief Totals of one batch run.
+ */
+typedef struct {
+    long long rows;         /**< Assignments evaluated */
+    long long trueRows;     /**< Assignments satisfying the formula */
+    long long trailingBytes;/**< Bytes of an incomplete last row (ignored) */
+    double seconds;         /**< Wall time including I/O */
+} BatchEvalReport;
+
+/**
+ * @brief Evaluates a compiled formula on every row of a packed bit file.
+ *
+ * Each input row is ceil(columns/8) bytes; bit j of the row (byte j/8,
+ * least significant bit first) is the value of variable index j of the
+ * formula. The output is one bit per row, packed the same way: bit k of
+ * the stream (byte k/8, LSB first) is the value on row k, and the last
+ * byte is padded with zeros.
+ *
+ * @param cf Compiled formula.
+ * @param columns Bits per row; must be at least cf->numVars.
+ * @param in Input stream of rows.
+ * @param out Output stream for the result bitmap.
+ * @param rep Output totals (may be NULL).
+ * @return 1 on success, 0 on malloc or I/O failure.
+ */
+int batchEvaluate(const CompiledFormula *cf, int columns, FILE *in, FILE *out, BatchEvalReport *rep);
+
+#endif
@@ -0,0 +1,74 @@
+#!/bin/sh
+# @file checkCli.sh
+# @brief Regression checks of the command-line modes, run by 'make check'.
+#
+# Cached answers must match a cold recomputation line for line once the
+# timing and cache bookkeeping are removed.
+# Usage: sh checkCli.sh [./logic]
+
+LOGIC=${1:-./logic}
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+failures=0
+
+fail() {
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# Drops timings, cache statistics and the source of an answer
+normalize() {
+    grep -v -e '^Computed in' -e '^Answered from' -e '^Cache:' -e '^Hits:' -e '^Wall:' |
+        sed -e 's/"[a-z]*_s":[0-9.e+-]*,\{0,1\}//g' -e 's/"conflicts":[0-9]*,\{0,1\}//g' \
+            -e 's/,\{0,1\}"cached":"[a-z]*"//g' -e 's/,}/}/'
+}
+
+# --analyze with a cache (miss, disk hit, memory hit) against no cache
+checkAnalyze() {
+    "$LOGIC" --analyze "$@" 2>/dev/null | normalize > "$TMP/cold"
+    "$LOGIC" --analyze "$@" --cache-dir "$TMP/cache" 2>/dev/null | normalize > "$TMP/warm"
+    cmp -s "$TMP/cold" "$TMP/warm" || fail "--analyze $* differs when cached"
+    "$LOGIC" --analyze "$@" --cache-dir "$TMP/cache" --repeat 2 2>/dev/null | normalize > "$TMP/warm"
+    cmp -s "$TMP/cold" "$TMP/warm" || fail "--analyze $* differs on a repeated hit"
+}
+
+# Operand order changes the Task 6 CNF text and the clause counts, so each
+# spelling is checked against the same cache directory
+for f in '((B*C)+A)' '(A+(B*C))' '((A+B)*C)' '(C*(B+A))' '(A>B)' '(B>A)' \
+         '(~A+A)' '(A+~A)' '((A*~B)+(~A*B))' '((~A*B)+(A*~B))' '(~(A*B)>(C+A))'; do
+    checkAnalyze "$f"
+done
+
+printf 'p cnf 3 3\n1 2 0\n-1 3 0\n-2 -3 0\n' > "$TMP/sat.cnf"
+printf 'p cnf 1 2\n1 0\n-1 0\n' > "$TMP/unsat.cnf"
+printf 'p cnf 2 1\n1 -1 0\n' > "$TMP/valid.cnf"
+# The same clause set in another order shares a key
+printf 'c reordered\np cnf 3 3\n-3 -2 0\n2 1 0\n3 -1 0\n' > "$TMP/sat2.cnf"
+for f in sat unsat valid sat2; do
+    checkAnalyze "$TMP/$f.cnf" --count
+done
+
+# --batch without a cache against a cold and a warm cache
+mkdir "$TMP/batch"
+cp "$TMP"/*.cnf "$TMP/batch"
+ANALYSES="--analyses parse,tautology,sat,count"
+"$LOGIC" --batch "$TMP/batch" $ANALYSES 2>/dev/null | normalize > "$TMP/cold" ||
+    fail "--batch without a cache"
+grep -q '"sat":"UNSAT"' "$TMP/cold" || fail "--batch without a cache: no UNSAT instance"
+for pass in miss hit; do
+    "$LOGIC" --batch "$TMP/batch" $ANALYSES --cache-dir "$TMP/bcache" 2>/dev/null |
+        normalize > "$TMP/warm"
+    cmp -s "$TMP/cold" "$TMP/warm" || fail "--batch differs with a cache ($pass)"
+done
+
+# --query: contradictory assumptions fail together
+printf 's 1 -1 0\n' > "$TMP/queries.txt"
+"$LOGIC" --query "$TMP/sat.cnf" "$TMP/queries.txt" 2>/dev/null | head -n 1 > "$TMP/answer"
+grep -q -e '^UNSAT failed: 1 -1$' -e '^UNSAT failed: -1 1$' "$TMP/answer" ||
+    fail "--query with assumptions 1 -1: $(cat "$TMP/answer")"
+
+if [ "$failures" -ne 0 ]; then
+    echo "checkCli: $failures failure(s)"
+    exit 1
+fi
+echo "checkCli: all passed"
@@ -0,0 +1,298 @@
+/**
+ * @file checkCompressed.c
+ * @brief Regression checks of the compressed DIMACS reader, run by
+ *        'make check'.
+ *
+ * A generated CNF text is written plain and compressed with zlib, liblzma
+ * and libbz2, then read back through compressedInput.c and
+ * readCnfFormula. Truncated copies must be reported as errors rather than
+ * parsed as shorter formulas.
+ * @section algo Algorithm:
+ *   - Round trip: decoded bytes, lines and parsed clause sets must equal
+ *     the plain file's, across several ring buffers of output
+ *   - Truncation: half the file, and everything but the trailer
+ * @section time Time Complexity: O(formats × text)
+ * @section space Space Complexity: O(text)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "compressedInput.h"
+#include "cnfFormula.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <lzma.h>
+#include <bzlib.h>
+
+#define NUM_VARS 2000
+#define NUM_CLAUSES 150000
+#define PATH_LEN 512
+
+static int failures = 0;
+static char dir[] = "/tmp/checkCompressedXXXXXX";
+
+static void check(int cond, const char *what) {
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Sends stdout to /dev/null around calls expected to report errors.
+ */
+static void quiet(int on) {
+    static int saved = -1;
+    fflush(stdout);
+    if (on) {
+        saved = dup(1);
+        if (!freopen("/dev/null", "w", stdout)) return;
+    } else if (saved >= 0) {
+        dup2(saved, 1);
+        close(saved);
+        saved = -1;
+    }
+}
+
+/**
+ * @brief Random 3-CNF text with comments, long enough to span several
+ *        ring buffers once decoded.
+ */
+static char *generateCnf(size_t *len) {
+    size_t cap = (size_t)NUM_CLAUSES * 24 + 256;
+    char *text = malloc(cap);
+    if (!text) return NULL;
+    size_t n = (size_t)snprintf(text, cap, "c generated by checkCompressed\np cnf %d %d\n",
+                                NUM_VARS, NUM_CLAUSES);
+    srand(2024);
+    for (int i = 0; i < NUM_CLAUSES; i++) {
+        for (int j = 0; j < 3; j++) {
+            int v = 1 + rand() % NUM_VARS;
+            n += (size_t)snprintf(text + n, cap - n, "%d ", rand() % 2 ? v : -v);
+        }
+        n += (size_t)snprintf(text + n, cap - n, "0\n");
+    }
+    *len = n;
+    return text;
+}
+
+static unsigned char *gzipBytes(const char *in, size_t n, size_t *outLen) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return NULL;
+    size_t cap = deflateBound(&zs, n);
+    unsigned char *out = malloc(cap);
+    if (out) {
+        zs.next_in = (unsigned char*)in;
+        zs.avail_in = (unsigned)n;
+        zs.next_out = out;
+        zs.avail_out = (unsigned)cap;
+        if (deflate(&zs, Z_FINISH) == Z_STREAM_END) {
+            *outLen = zs.total_out;
+        } else {
+            free(out);
+            out = NULL;
+        }
+    }
+    deflateEnd(&zs);
+    return out;
+}
+
+static unsigned char *xzBytes(const char *in, size_t n, size_t *outLen) {
+    size_t cap = lzma_stream_buffer_bound(n);
+    unsigned char *out = malloc(cap);
+    *outLen = 0;
+    if (out && lzma_easy_buffer_encode(6, LZMA_CHECK_CRC64, NULL, (const uint8_t*)in, n,
+                                       out, outLen, cap) != LZMA_OK) {
+        free(out);
+        out = NULL;
+    }
+    return out;
+}
+
+static unsigned char *bzip2Bytes(const char *in, size_t n, size_t *outLen) {
+    unsigned cap = (unsigned)(n + n / 100 + 600);
+    unsigned char *out = malloc(cap);
+    if (out && BZ2_bzBuffToBuffCompress((char*)out, &cap, (char*)in, (unsigned)n, 9, 0, 0) != BZ_OK) {
+        free(out);
+        return NULL;
+    }
+    *outLen = cap;
+    return out;
+}
+
+static int writeFile(const char *path, const void *data, size_t n) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) { perror(path); return 0; }
+    int ok = fwrite(data, 1, n, fp) == n;
+    ok = fclose(fp) == 0 && ok;
+    return ok;
+}
+
+static int sameFormula(const CnfFormula *a, const CnfFormula *b) {
+    if (!a || !b || a->numVars != b->numVars || a->numClauses != b->numClauses) return 0;
+    size_t lits = (size_t)a->clauseStart[a->numClauses];
+    return memcmp(a->clauseStart, b->clauseStart, (a->numClauses + 1) * sizeof(int)) == 0 &&
+           memcmp(a->lits, b->lits, lits * sizeof(int)) == 0;
+}
+
+/**
+ * @brief Reads a file buffer by buffer and line by line and parses it.
+ */
+static void checkRoundTrip(const char *path, CompressFormat format, const char *text, size_t len,
+                           const CnfFormula *expected) {
+    char what[PATH_LEN + 64];
+    CompressedInput *in = compressedOpenFile(path);
+    snprintf(what, sizeof(what), "%s: open", path);
+    check(in != NULL, what);
+    if (!in) return;
+    snprintf(what, sizeof(what), "%s: detected as %s", path, compressFormatName(format));
+    check(compressedFormat(in) == format, what);
+    size_t pos = 0, got;
+    int same = 1;
+    const char *data;
+    while ((got = compressedRead(in, &data)) > 0) {
+        same = same && pos + got <= len && memcmp(text + pos, data, got) == 0;
+        pos += got;
+    }
+    snprintf(what, sizeof(what), "%s: decoded bytes", path);
+    check(same && pos == len, what);
+    snprintf(what, sizeof(what), "%s: clean close", path);
+    check(compressedClose(in), what);
+
+    in = compressedOpenFile(path);
+    if (!in) return;
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t n;
+    pos = 0;
+    same = 1;
+    while ((n = compressedGetline(in, &line, &cap)) > 0) {
+        same = same && pos + (size_t)n <= len && memcmp(text + pos, line, (size_t)n) == 0 &&
+               line[n - 1] == '\n';
+        pos += (size_t)n;
+    }
+    free(line);
+    snprintf(what, sizeof(what), "%s: lines", path);
+    check(same && pos == len && compressedClose(in), what);
+
+    CnfFormula *f = readCnfFormula(path);
+    snprintf(what, sizeof(what), "%s: parsed clause set", path);
+    check(sameFormula(f, expected), what);
+    freeCnfFormula(f);
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return;
+    f = readCnfFormulaStream(fp);
+    fclose(fp);
+    snprintf(what, sizeof(what), "%s: parsed from a stream", path);
+    check(sameFormula(f, expected), what);
+    freeCnfFormula(f);
+}
+
+/**
+ * @brief Cuts a compressed file short and expects both the reader and
+ *        the parser to fail.
+ */
+static void checkTruncated(const char *name, const unsigned char *bytes, size_t n) {
+    char path[PATH_LEN], what[PATH_LEN + 64];
+    size_t cuts[] = { n / 2, n - 4 };
+    for (int i = 0; i < 2; i++) {
+        snprintf(path, sizeof(path), "%s/trunc%d.%s", dir, i, name);
+        if (!writeFile(path, bytes, cuts[i])) { failures++; continue; }
+        quiet(1);
+        CompressedInput *in = compressedOpenFile(path);
+        int closed = -1;
+        if (in) {
+            const char *data;
+            while (compressedRead(in, &data) > 0) {}
+            closed = compressedClose(in);
+        }
+        CnfFormula *f = readCnfFormula(path);
+        quiet(0);
+        snprintf(what, sizeof(what), "%s cut to %zu of %zu bytes: reader error", name, cuts[i], n);
+        check(in && closed == 0, what);
+        snprintf(what, sizeof(what), "%s cut to %zu of %zu bytes: parse error", name, cuts[i], n);
+        check(f == NULL, what);
+        freeCnfFormula(f);
+        unlink(path);
+    }
+}
+
+static void checkDetection(void) {
+    const unsigned char gz[] = {0x1f, 0x8b, 8}, xz[] = {0xfd, '7', 'z', 'X', 'Z', 0};
+    const unsigned char zst[] = {0x28, 0xb5, 0x2f, 0xfd}, plain[] = "p cnf";
+    check(detectCompression(gz, sizeof(gz)) == COMPRESS_GZIP, "gzip magic");
+    check(detectCompression(xz, sizeof(xz)) == COMPRESS_XZ, "xz magic");
+    check(detectCompression((const unsigned char*)"BZh9", 4) == COMPRESS_BZIP2, "bzip2 magic");
+    check(detectCompression(zst, sizeof(zst)) == COMPRESS_ZSTD, "zstd magic");
+    check(detectCompression(plain, 5) == COMPRESS_NONE, "plain text");
+    check(detectCompression(gz, 1) == COMPRESS_NONE, "short input");
+    check(isCnfPath("a.cnf") && isCnfPath("a.cnf.gz") && isCnfPath("a.cnf.xz") && isCnfPath("a.cnf.bz2"),
+          "CNF paths");
+    check(!isCnfPath("a.txt") && !isCnfPath("a.gz") && !isCnfPath("a.cnf.zst"), "non-CNF paths");
+
+    // zstd is recognized but not decoded: an error, not garbage clauses
+    char path[PATH_LEN];
+    snprintf(path, sizeof(path), "%s/z.cnf", dir);
+    if (!writeFile(path, zst, sizeof(zst))) { failures++; return; }
+    quiet(1);
+    CompressedInput *in = compressedOpenFile(path);
+    quiet(0);
+    check(in == NULL, "zstd input is refused");
+    if (in) compressedClose(in);
+    unlink(path);
+}
+
+int main(void) {
+    if (!mkdtemp(dir)) { perror(dir); return 1; }
+    size_t len;
+    char *text = generateCnf(&len);
+    if (!text) { perror("malloc"); return 1; }
+
+    char plainPath[PATH_LEN];
+    snprintf(plainPath, sizeof(plainPath), "%s/f.cnf", dir);
+    CnfFormula *expected = writeFile(plainPath, text, len) ? readCnfFormula(plainPath) : NULL;
+    check(expected && expected->numVars == NUM_VARS, "plain file parses");
+    if (expected) {
+        checkRoundTrip(plainPath, COMPRESS_NONE, text, len, expected);
+
+        struct {
+            const char *suffix;
+            CompressFormat format;
+            unsigned char *(*compress)(const char*, size_t, size_t*);
+        } formats[] = {
+            { "gz", COMPRESS_GZIP, gzipBytes },
+            { "xz", COMPRESS_XZ, xzBytes },
+            { "bz2", COMPRESS_BZIP2, bzip2Bytes },
+        };
+        for (int i = 0; i < 3; i++) {
+            char path[PATH_LEN];
+            size_t n = 0;
+            unsigned char *bytes = formats[i].compress(text, len, &n);
+            snprintf(path, sizeof(path), "%s/f.cnf.%s", dir, formats[i].suffix);
+            check(bytes && writeFile(path, bytes, n), formats[i].suffix);
+            if (bytes) {
+                checkRoundTrip(path, formats[i].format, text, len, expected);
+                checkTruncated(formats[i].suffix, bytes, n);
+            }
+            unlink(path);
+            free(bytes);
+        }
+    }
+    checkDetection();
+
+    unlink(plainPath);
+    rmdir(dir);
+    freeCnfFormula(expected);
+    free(text);
+    if (failures) {
+        printf("checkCompressed: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("checkCompressed: all passed\n");
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file checkSolver.c
+ * @brief Regression checks of the CDCL solver, run by 'make check'.
+ *
+ * Small hand-written cases pin down the assumption interface (failed sets
+ * for contradictory assumptions and for assumptions already false at level
+ * 0); random 3-CNF instances are compared against exhaustive enumeration.
+ * @section algo Algorithm:
+ *   - SAT answers: the model must satisfy every clause and assumption
+ *   - UNSAT answers: enumeration must agree, the failed set must be a
+ *     subset of the assumptions and be UNSAT on its own
+ * @section time Time Complexity: O(instances × 2^v × m)
+ * @section space Space Complexity: O(m) per instance
+ */
+
+#include "satSolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_VARS 12
+#define MAX_CLAUSES 64
+
+static int failures = 0;
+
+static void check(int cond, const char *what) {
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Whether the last failed set is exactly the given literals, in any
+ *        order.
+ */
+static int failedSetIs(const Solver *s, const int *lits, int n) {
+    const int *failed;
+    if (solverFailedAssumptions(s, &failed) != n) return 0;
+    for (int i = 0; i < n; i++)
+        if (!solverIsFailed(s, lits[i])) return 0;
+    return 1;
+}
+
+static Solver *solverOf(int numVars, const int clauses[][4], int m) {
+    Solver *s = solverNew(numVars);
+    for (int i = 0; i < m; i++) {
+        int n = 0;
+        while (n < 4 && clauses[i][n] != 0) n++;
+        solverAddClause(s, clauses[i], n);
+    }
+    return s;
+}
+
+static void checkFixedCases(void) {
+    const int chain[][4] = { {1, 2, 0}, {-1, 3, 0}, {-2, -3, 0} };
+    Solver *s = solverOf(3, chain, 3);
+    check(solverSolve(s, NULL, 0) == SOLVER_SAT, "satisfiable clause set");
+    int model[4];
+    for (int v = 1; v <= 3; v++) model[v] = solverModelValue(s, v);
+    check((model[1] || model[2]) && (!model[1] || model[3]) && (!model[2] || !model[3]),
+          "model satisfies the clauses");
+
+    int contradictory[] = {1, -1};
+    check(solverSolve(s, contradictory, 2) == SOLVER_UNSAT, "assumptions 1 -1 are UNSAT");
+    check(failedSetIs(s, contradictory, 2), "assumptions 1 -1 both fail");
+
+    // Variable 4 is in no clause, so it cannot take part in the conflict
+    int withFree[] = {4, -1, 1};
+    check(solverSolve(s, withFree, 3) == SOLVER_UNSAT, "assumptions 4 -1 1 are UNSAT");
+    check(failedSetIs(s, withFree + 1, 2), "assumptions -1 1 fail, 4 does not");
+
+    int implied[] = {1, 2};
+    check(solverSolve(s, implied, 2) == SOLVER_UNSAT, "assumptions 1 2 are UNSAT");
+    check(failedSetIs(s, implied, 2), "assumptions 1 2 both fail");
+
+    check(solverSolve(s, NULL, 0) == SOLVER_SAT, "assumptions do not persist");
+    solverFree(s);
+
+    // -1 is a unit clause, so assumption 1 is false before any decision
+    const int unit[][4] = { {-1, 0}, {1, 2, 0} };
+    s = solverOf(2, unit, 2);
+    int falsified[] = {2, 1};
+    check(solverSolve(s, falsified, 2) == SOLVER_UNSAT, "assumption false at level 0 is UNSAT");
+    check(failedSetIs(s, falsified + 1, 1), "only the level-0 false assumption fails");
+    int first[] = {1, 2};
+    check(solverSolve(s, first, 2) == SOLVER_UNSAT && failedSetIs(s, first, 1),
+          "level-0 false assumption given first");
+    check(solverSolve(s, NULL, 0) == SOLVER_SAT && solverModelValue(s, 2),
+          "clause set stays satisfiable after a failed assumption");
+    solverFree(s);
+
+    const int conflict[][4] = { {1, 0}, {-1, 0} };
+    s = solverOf(1, conflict, 2);
+    const int *failed;
+    check(solverSolve(s, NULL, 0) == SOLVER_UNSAT, "unsatisfiable clause set");
+    check(solverFailedAssumptions(s, &failed) == 0, "no failed assumptions without assumptions");
+    int one[] = {-1};
+    check(solverSolve(s, one, 1) == SOLVER_UNSAT && solverFailedAssumptions(s, &failed) == 0,
+          "empty failed set when the clauses alone are UNSAT");
+    solverFree(s);
+}
+
+/**
+ * @brief Decides satisfiability under assumptions by enumeration.
+ */
+static int bruteForce(int numVars, int clauses[][3], int m, const int *assume, int n) {
+    for (unsigned a = 0; a < (1u << numVars); a++) {
+        int ok = 1;
+        for (int i = 0; ok && i < n; i++) {
+            int v = abs(assume[i]);
+            ok = ((a >> (v - 1)) & 1) == (assume[i] > 0);
+        }
+        for (int i = 0; ok && i < m; i++) {
+            int sat = 0;
+            for (int j = 0; j < 3 && !sat; j++) {
+                int v = abs(clauses[i][j]);
+                sat = ((a >> (v - 1)) & 1) == (clauses[i][j] > 0);
+            }
+            ok = sat;
+        }
+        if (ok) return 1;
+    }
+    return 0;
+}
+
+static void checkRandomCases(int rounds) {
+    int clauses[MAX_CLAUSES][3];
+    char what[96];
+    srand(12345);
+    for (int r = 0; r < rounds; r++) {
+        int numVars = 3 + rand() % (MAX_VARS - 2);
+        int m = 1 + rand() % (numVars * 5 < MAX_CLAUSES ? numVars * 5 : MAX_CLAUSES);
+        Solver *s = solverNew(numVars);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < 3; j++) {
+                int v = 1 + rand() % numVars;
+                clauses[i][j] = rand() % 2 ? v : -v;
+            }
+            solverAddClause(s, clauses[i], 3);
+        }
+        // Several queries on one solver, as the incremental modes use it
+        for (int q = 0; q < 4; q++) {
+            int assume[MAX_VARS];
+            int n = rand() % 5;
+            for (int i = 0; i < n; i++) {
+                int v = 1 + rand() % numVars;
+                assume[i] = rand() % 2 ? v : -v;
+            }
+            int status = solverSolve(s, assume, n);
+            int expected = bruteForce(numVars, clauses, m, assume, n);
+            snprintf(what, sizeof(what), "random instance %d query %d", r, q);
+            check(status == (expected ? SOLVER_SAT : SOLVER_UNSAT), what);
+            if (status == SOLVER_SAT) {
+                int ok = 1;
+                for (int i = 0; i < n; i++)
+                    ok &= solverModelValue(s, abs(assume[i])) == (assume[i] > 0);
+                for (int i = 0; ok && i < m; i++) {
+                    int sat = 0;
+                    for (int j = 0; j < 3; j++)
+                        sat |= solverModelValue(s, abs(clauses[i][j])) == (clauses[i][j] > 0);
+                    ok = sat;
+                }
+                snprintf(what, sizeof(what), "random instance %d query %d: model", r, q);
+                check(ok, what);
+            } else if (status == SOLVER_UNSAT) {
+                const int *failed;
+                int k = solverFailedAssumptions(s, &failed);
+                int copy[MAX_VARS + 1], subset = k <= n;
+                for (int i = 0; subset && i < k; i++) {
+                    int found = 0;
+                    for (int j = 0; j < n; j++) found |= assume[j] == failed[i];
+                    subset = found;
+                    copy[i] = failed[i];
+                }
+                snprintf(what, sizeof(what), "random instance %d query %d: failed set", r, q);
+                check(subset && !bruteForce(numVars, clauses, m, copy, k), what);
+            }
+        }
+        solverFree(s);
+    }
+}
+
+int main(void) {
+    checkFixedCases();
+    checkRandomCases(2000);
+    if (failures) {
+        printf("checkSolver: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("checkSolver: all passed\n");
+    return 0;
+}
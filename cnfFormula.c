@@ -0,0 +1,226 @@
+/**
+ * @file cnfFormula.c
+ * @brief Parses DIMACS CNF files into flat clause arrays.
+ *
+ * Unlike cnfToInfix, which produces a bounded infix string for the
+ * parse-tree tasks, this reader keeps clauses as integer arrays so that
+ * search-based analyses (SAT solving, cube splitting, model counting)
+ * can run on instances of any size.
+ * @section algo Algorithm: Single-pass buffered tokenizer
+ *   Literals are appended until a terminating 0, then the clause is
+ *   sorted, de-duplicated and dropped if it contains x and -x. Buffers
+ *   come from compressedInput.c, so gzip, xz and bzip2 files are parsed
+ *   as they are decoded.
+ * @section time Time Complexity: O(L log c)
+ *   - L = total literals, c = longest clause (per-clause sort)
+ * @section space Space Complexity: O(L)
+ */
+
+#include "cnfFormula.h"
+#include "compressedInput.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Growable int array used while reading.
+ */
+typedef struct {
+    int *data;
+    int size;
+    int cap;
+} IntVec;
+
+/**
+ * @brief Appends a value, doubling capacity when full.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int intVecPush(IntVec *v, int x) {
+    if (v->size == v->cap) {
+        int ncap = v->cap ? v->cap * 2 : 1024;
+        int *nd = realloc(v->data, (size_t)ncap * sizeof(int));
+        if (!nd) { perror("realloc"); return 0; }
+        v->data = nd;
+        v->cap = ncap;
+    }
+    v->data[v->size++] = x;
+    return 1;
+}
+
+/**
+ * @brief qsort comparator ordering literals by variable, then sign.
+ */
+static int cmpLit(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    int ax = abs(x), ay = abs(y);
+    if (ax != ay) return ax < ay ? -1 : 1;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Normalizes the clause stored at lits->data[start..] in place.
+ *
+ * @param lits Literal buffer; trailing clause is rewritten or removed.
+ * @param start Offset of the clause in the buffer.
+ * @return 1 if the clause was kept, 0 if it was a tautology and removed.
+ */
+static int normalizeClause(IntVec *lits, int start) {
+    int n = lits->size - start;
+    int *c = lits->data + start;
+    qsort(c, (size_t)n, sizeof(int), cmpLit);
+
+    int w = 0;
+    for (int r = 0; r < n; r++) {
+        if (w > 0 && c[w - 1] == c[r]) continue;
+        if (w > 0 && c[w - 1] == -c[r]) { lits->size = start; return 0; }
+        c[w++] = c[r];
+    }
+    lits->size = start + w;
+    return 1;
+}
+
+/**
+ * @copydoc readCnfFormula
+ */
+CnfFormula *readCnfFormula(const char *filename) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        perror("fopen");
+        return NULL;
+    }
+    CnfFormula *f = readCnfFormulaStream(fp);
+    fclose(fp);
+    return f;
+}
+
+/**
+ * @copydoc readCnfFormulaStream
+ */
+CnfFormula *readCnfFormulaStream(FILE *fp) {
+    IntVec lits = {0}, starts = {0};
+    int maxVar = 0, headerVars = 0, ok = 1;
+    int clauseOpen = 0, stop = 0;
+
+    CompressedInput *in = compressedOpen(fp);
+    if (!in) return NULL;
+    const char *buf;
+
+    // Tokenizer state carried across chunk boundaries
+    int inNumber = 0, neg = 0, val = 0;
+    int lineStart = 1, skipLine = 0, headerLine = 0;
+    char header[128];
+    int headerLen = 0;
+
+    size_t got;
+    while (ok && !stop && (got = compressedRead(in, &buf)) > 0) {
+        for (size_t i = 0; i < got && ok; i++) {
+            char ch = buf[i];
+
+            if (skipLine) {
+                if (headerLine && headerLen < (int)sizeof(header) - 1 && ch != '\n')
+                    header[headerLen++] = ch;
+                if (ch == '\n') {
+                    if (headerLine) {
+                        header[headerLen] = '\0';
+                        int hv = 0, hc = 0;
+                        if (sscanf(header, " cnf %d %d", &hv, &hc) >= 1) headerVars = hv;
+                        headerLine = 0;
+                    }
+                    skipLine = 0;
+                    lineStart = 1;
+                }
+                continue;
+            }
+
+            // SATLIB files end with a "%" line followed by a stray 0
+            if (lineStart && ch == '%') { stop = 1; break; }
+
+            if (lineStart && (ch == 'c' || ch == 'p')) {
+                skipLine = 1;
+                headerLine = (ch == 'p');
+                headerLen = 0;
+                continue;
+            }
+
+            if (ch == '-' && !inNumber) {
+                neg = 1;
+                lineStart = 0;
+            } else if (ch >= '0' && ch <= '9') {
+                inNumber = 1;
+                val = val * 10 + (ch - '0');
+                lineStart = 0;
+            } else {
+                if (inNumber) {
+                    if (val == 0) {
+                        if (clauseOpen) {
+                            int start = starts.data[starts.size - 1];
+                            if (!normalizeClause(&lits, start)) starts.size--;
+                            clauseOpen = 0;
+                        } else {
+                            // Empty clause "0" on its own: unsatisfiable formula
+                            ok = intVecPush(&starts, lits.size);
+                        }
+                    } else {
+                        if (!clauseOpen) {
+                            ok = intVecPush(&starts, lits.size);
+                            clauseOpen = 1;
+                        }
+                        if (val > maxVar) maxVar = val;
+                        if (ok) ok = intVecPush(&lits, neg ? -val : val);
+                    }
+                }
+                inNumber = 0; neg = 0; val = 0;
+                lineStart = (ch == '\n') ? 1 : (ch == ' ' || ch == '\t' || ch == '\r') ? lineStart : 0;
+            }
+        }
+    }
+    if (!compressedClose(in)) ok = 0;
+
+    // A final literal without trailing whitespace or a missing final 0
+    if (ok && inNumber && val != 0) {
+        if (!clauseOpen) { ok = intVecPush(&starts, lits.size); clauseOpen = 1; }
+        if (val > maxVar) maxVar = val;
+        if (ok) ok = intVecPush(&lits, neg ? -val : val);
+    }
+    if (ok && clauseOpen) {
+        int start = starts.data[starts.size - 1];
+        if (!normalizeClause(&lits, start)) starts.size--;
+    }
+
+    CnfFormula *f = ok ? malloc(sizeof(CnfFormula)) : NULL;
+    if (!f || !intVecPush(&starts, lits.size)) {
+        free(f);
+        free(lits.data);
+        free(starts.data);
+        return NULL;
+    }
+
+    f->numVars = maxVar > headerVars ? maxVar : headerVars;
+    f->numClauses = starts.size - 1;
+    f->lits = lits.data;
+    f->clauseStart = starts.data;
+    return f;
+}
+
+/**
+ * @copydoc writeCnfFormula
+ */
+int writeCnfFormula(const CnfFormula *f, FILE *out) {
+    fprintf(out, "p cnf %d %d\n", f->numVars, f->numClauses);
+    for (int c = 0; c < f->numClauses; c++) {
+        const int *lits = cnfClause(f, c);
+        for (int k = 0; k < cnfClauseSize(f, c); k++) fprintf(out, "%d ", lits[k]);
+        fputs("0\n", out);
+    }
+    return !ferror(out);
+}
+
+/**
+ * @copydoc freeCnfFormula
+ */
+void freeCnfFormula(CnfFormula *f) {
+    if (!f) return;
+    free(f->lits);
+    free(f->clauseStart);
+    free(f);
+}
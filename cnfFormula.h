@@ -0,0 +1,74 @@
+/**
+ * @file cnfFormula.h
+ * @brief Clause-set representation of a DIMACS CNF formula.
+ */
+
+#ifndef CNF_FORMULA_H
+#define CNF_FORMULA_H
+
+#include <stdio.h>
+
+/**
+ * @brief A CNF formula stored as flat clause arrays.
+ *
+ * Literals use DIMACS numbering: variable v is the literal v, its negation
+ * is -v. Clause i occupies lits[clauseStart[i]] .. lits[clauseStart[i+1]-1],
+ * so clauseStart has numClauses + 1 entries.
+ */
+typedef struct {
+    int numVars;        /**< Number of variables (max of header and file) */
+    int numClauses;     /**< Number of stored clauses */
+    int *lits;          /**< All clause literals, back to back */
+    int *clauseStart;   /**< Offset of each clause in lits, plus end marker */
+} CnfFormula;
+
+/**
+ * @brief Reads a DIMACS CNF file into a clause set.
+ *
+ * Duplicate literals are removed and tautological clauses are dropped;
+ * neither changes the set of models over numVars variables.
+ *
+ * @param filename Path to the CNF file.
+ * @return Newly allocated formula, or NULL on error. Free with freeCnfFormula.
+ */
+CnfFormula *readCnfFormula(const char *filename);
+
+/**
+ * @brief Reads DIMACS CNF text from an open stream (file, pipe or
+ *        fmemopen buffer) until end of input; the stream is not closed.
+ *        gzip, xz and bzip2 input is recognized by its magic bytes and
+ *        decompressed on the fly.
+ * @param fp Input stream.
+ * @return Newly allocated formula, or NULL on error.
+ */
+CnfFormula *readCnfFormulaStream(FILE *fp);
+
+/**
+ * @brief Writes a clause set in DIMACS format.
+ * @param f Formula.
+ * @param out Destination stream.
+ * @return 1 on success, 0 on a write error.
+ */
+int writeCnfFormula(const CnfFormula *f, FILE *out);
+
+/**
+ * @brief Frees a formula returned by readCnfFormula.
+ * @param f Formula to free (may be NULL).
+ */
+void freeCnfFormula(CnfFormula *f);
+
+/**
+ * @brief Returns the length of clause i.
+ */
+static inline int cnfClauseSize(const CnfFormula *f, int i) {
+    return f->clauseStart[i + 1] - f->clauseStart[i];
+}
+
+/**
+ * @brief Returns a pointer to the first literal of clause i.
+ */
+static inline const int *cnfClause(const CnfFormula *f, int i) {
+    return f->lits + f->clauseStart[i];
+}
+
+#endif
@@ -1,64 +1,88 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "cnfReader.h"
+#include "compressedInput.h"
 
-#define BUF_SZ 2048
-#define OUT_MAX 2000000
+/**
+ * @brief Growable output string; appends are amortized O(1).
+ */
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} StrBuf;
 
 /**
- * @copydoc cnfToInfix
+ * @brief Appends n bytes, doubling the capacity when needed.
+ * @return 1 on success, 0 on malloc failure.
  */
-char *cnfToInfix(const char *filename) {
-    FILE *f = fopen(filename, "r");
-    if (!f) {
-        perror("fopen");
-        return NULL;
+static int strBufAppend(StrBuf *b, const char *s, size_t n) {
+    if (b->len + n + 1 > b->cap) {
+        size_t ncap = b->cap ? b->cap : 4096;
+        while (b->len + n + 1 > ncap) ncap *= 2;
+        char *nd = realloc(b->data, ncap);
+        if (!nd) { perror("realloc"); return 0; }
+        b->data = nd;
+        b->cap = ncap;
     }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+    return 1;
+}
 
-    char *out = (char*) malloc(OUT_MAX);
-    if (!out) { fclose(f); return NULL; }
-    out[0] = '\0';
+/**
+ * @copydoc cnfToInfix
+ */
+char *cnfToInfix(const char *filename) {
+    CompressedInput *f = compressedOpenFile(filename);
+    if (!f) return NULL;
 
-    char line[BUF_SZ];
+    StrBuf out = { NULL, 0, 0 };
+    int ok = strBufAppend(&out, "", 0);
+    char *line = NULL;
+    size_t lineCap = 0;
     int firstClause = 1;
 
-    while (fgets(line, sizeof(line), f) != NULL) {
+    while (ok && compressedGetline(f, &line, &lineCap) != -1) {
         char *ptr = line;
         while (*ptr == ' ' || *ptr == '\t') ptr++;
         if (*ptr == 'c' || *ptr == 'p' || *ptr == '\n' || *ptr == '\0') continue;
 
-        char *tok = strtok(line, " \t\r\n");
+        char *save = NULL;
+        char *tok = strtok_r(line, " \t\r\n", &save);
         if (!tok) continue;
 
-        int lit;
-        char clause[BUF_SZ];
-        clause[0] = '\0';
         int firstLit = 1;
-
-        while (tok) {
-            lit = atoi(tok);
+        while (ok && tok) {
+            int lit = atoi(tok);
             if (lit == 0) break;
             char litstr[64];
-            if (lit > 0) snprintf(litstr, sizeof(litstr), "x%d", lit);
-            else snprintf(litstr, sizeof(litstr), "~x%d", -lit);
+            int n = lit > 0 ? snprintf(litstr, sizeof(litstr), "x%d", lit)
+                            : snprintf(litstr, sizeof(litstr), "~x%d", -lit);
 
-            if (!firstLit) strncat(clause, " + ", sizeof(clause)-strlen(clause)-1);
-            strncat(clause, litstr, sizeof(clause)-strlen(clause)-1);
+            if (firstLit) ok = strBufAppend(&out, firstClause ? "(" : " * (", firstClause ? 1 : 4);
+            else ok = strBufAppend(&out, " + ", 3);
+            ok = ok && strBufAppend(&out, litstr, (size_t)n);
             firstLit = 0;
 
-            tok = strtok(NULL, " \t\r\n");
+            tok = strtok_r(NULL, " \t\r\n", &save);
         }
 
-        if (clause[0] != '\0') {
-            if (!firstClause) strncat(out, " * ", OUT_MAX - strlen(out) - 1);
-            strncat(out, "(", OUT_MAX - strlen(out) - 1);
-            strncat(out, clause, OUT_MAX - strlen(out) - 1);
-            strncat(out, ")", OUT_MAX - strlen(out) - 1);
+        if (ok && !firstLit) {
+            ok = strBufAppend(&out, ")", 1);
             firstClause = 0;
         }
     }
 
-    fclose(f);
-    return out;
+    free(line);
+    if (!compressedClose(f)) ok = 0;
+    if (!ok) {
+        free(out.data);
+        return NULL;
+    }
+    return out.data;
 }
@@ -0,0 +1,336 @@
+/**
+ * @file cnfReorder.c
+ * @brief Bandwidth-reducing renumbering of clause sets.
+ *
+ * Benchmark generators often scramble variable numbers (the *.shuffled
+ * instances do so on purpose), so every array indexed by variable or by
+ * clause - assignments, occurrence lists, clause counters - is accessed
+ * at random during propagation. Renumbering in Cuthill-McKee order puts
+ * the variables and clauses of one neighbourhood next to each other.
+ * @section algo Algorithm: Reverse Cuthill-McKee on the bipartite graph
+ *   - Nodes are variables and clauses, edges are occurrences, stored as
+ *     CSR adjacency lists
+ *   - Per connected component the search starts at a pseudo-peripheral
+ *     variable (George-Liu): a minimum-degree variable of the deepest
+ *     level of a breadth-first search from the first unvisited one
+ *   - Breadth-first search from it visits the unvisited neighbours of
+ *     each node in increasing degree; the visit order, reversed, numbers
+ *     variables and clauses at once. Variables that occur nowhere go last
+ * @section time Time Complexity: O(L log d) for L literals and largest
+ *           degree d
+ * @section space Space Complexity: O(n + m + L)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cnfReorder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/** Breadth-first searches per component when looking for a start
+    variable; later rounds rarely move it far but each costs a full pass. */
+#define PERIPHERAL_ROUNDS 1
+
+/** Shorter runs are sorted by insertion. */
+#define SMALL_SORT 16
+
+/**
+ * @brief Variable-clause graph in CSR form. Node v (1..n) is variable v,
+ *        node n+1+c is clause c.
+ */
+typedef struct {
+    int numNodes;
+    int *adjStart;      /**< Neighbours of u: adj[adjStart[u] .. adjStart[u+1]-1] */
+    int *adj;
+    int *stamp;         /**< Per node: epoch of the last search that reached it */
+    int *level;         /**< Per node: level in that search */
+    int *queue;
+    int epoch;
+} VarClauseGraph;
+
+static void freeGraph(VarClauseGraph *g) {
+    free(g->adjStart);
+    free(g->adj);
+    free(g->stamp);
+    free(g->level);
+    free(g->queue);
+}
+
+static int degree(const VarClauseGraph *g, int u) {
+    return g->adjStart[u + 1] - g->adjStart[u];
+}
+
+static int buildGraph(VarClauseGraph *g, const CnfFormula *f) {
+    int n = f->numVars, m = f->numClauses;
+    size_t total = (size_t)f->clauseStart[m];
+    memset(g, 0, sizeof(*g));
+    g->numNodes = n + m + 1;
+    g->adjStart = calloc((size_t)g->numNodes + 1, sizeof(int));
+    g->adj = malloc((2 * total + 1) * sizeof(int));
+    g->stamp = calloc((size_t)g->numNodes, sizeof(int));
+    g->level = malloc((size_t)g->numNodes * sizeof(int));
+    g->queue = malloc((size_t)g->numNodes * sizeof(int));
+    if (!g->adjStart || !g->adj || !g->stamp || !g->level || !g->queue) {
+        perror("malloc");
+        freeGraph(g);
+        return 0;
+    }
+    for (size_t i = 0; i < total; i++) g->adjStart[abs(f->lits[i]) + 1]++;
+    for (int c = 0; c < m; c++) g->adjStart[n + 2 + c] = cnfClauseSize(f, c);
+    for (int u = 0; u < g->numNodes; u++) g->adjStart[u + 1] += g->adjStart[u];
+    int *fill = g->level;    /* free until the first search */
+    memcpy(fill, g->adjStart, (size_t)g->numNodes * sizeof(int));
+    for (int c = 0; c < m; c++) {
+        const int *lits = cnfClause(f, c);
+        for (int k = 0; k < cnfClauseSize(f, c); k++) {
+            int v = abs(lits[k]);
+            g->adj[fill[v]++] = n + 1 + c;
+            g->adj[fill[n + 1 + c]++] = v;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Breadth-first search from a variable.
+ * @param far Output: a minimum-degree variable of the deepest variable level.
+ * @return Depth of that level.
+ */
+static int searchLevels(VarClauseGraph *g, int start, int *far) {
+    int head = 0, tail = 0, epoch = ++g->epoch;
+    g->queue[tail++] = start;
+    g->stamp[start] = epoch;
+    g->level[start] = 0;
+    while (head < tail) {
+        int u = g->queue[head++];
+        for (int k = g->adjStart[u]; k < g->adjStart[u + 1]; k++) {
+            int w = g->adj[k];
+            if (g->stamp[w] != epoch) {
+                g->stamp[w] = epoch;
+                g->level[w] = g->level[u] + 1;
+                g->queue[tail++] = w;
+            }
+        }
+    }
+    /* Variables sit at even levels, clauses at odd ones */
+    int depth = g->level[g->queue[tail - 1]] & ~1;
+    *far = start;
+    for (int i = tail - 1; i >= 0 && g->level[g->queue[i]] >= depth; i--) {
+        int u = g->queue[i];
+        if (g->level[u] == depth && (*far == start || degree(g, u) < degree(g, *far))) *far = u;
+    }
+    return depth;
+}
+
+/**
+ * @brief Pseudo-peripheral variable of v's component: the far end of a
+ *        search from v, moved to the far end of a search from there while
+ *        that gets deeper.
+ */
+static int peripheralVariable(VarClauseGraph *g, int v) {
+    int far, depth = searchLevels(g, v, &far);
+    for (int round = 1; round < PERIPHERAL_ROUNDS && far != v; round++) {
+        int next, d = searchLevels(g, far, &next);
+        if (d <= depth) break;
+        v = far;
+        far = next;
+        depth = d;
+    }
+    return far;
+}
+
+static int cmpKey(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmpVar(const void *a, const void *b) {
+    return abs(*(const int *)a) - abs(*(const int *)b);
+}
+
+static void sortKeys(uint64_t *keys, int n) {
+    if (n > SMALL_SORT) {
+        qsort(keys, (size_t)n, sizeof(uint64_t), cmpKey);
+        return;
+    }
+    for (int i = 1; i < n; i++) {
+        uint64_t k = keys[i];
+        int j = i;
+        for (; j > 0 && keys[j - 1] > k; j--) keys[j] = keys[j - 1];
+        keys[j] = k;
+    }
+}
+
+static void sortByVariable(int *lits, int n) {
+    if (n > SMALL_SORT) {
+        qsort(lits, (size_t)n, sizeof(int), cmpVar);
+        return;
+    }
+    for (int i = 1; i < n; i++) {
+        int l = lits[i];
+        int j = i;
+        for (; j > 0 && abs(lits[j - 1]) > abs(l); j--) lits[j] = lits[j - 1];
+        lits[j] = l;
+    }
+}
+
+/**
+ * @brief Cuthill-McKee visit order of all nodes reached from the
+ *        variables that occur somewhere.
+ * @return Number of nodes written to order, or -1 on malloc failure.
+ */
+static int cuthillMcKee(VarClauseGraph *g, int n, int *order, int *components) {
+    int count = 0;
+    unsigned char *visited = calloc((size_t)g->numNodes, 1);
+    uint64_t *keys = malloc((size_t)g->numNodes * sizeof(uint64_t));
+    if (!visited || !keys) {
+        perror("malloc");
+        free(visited);
+        free(keys);
+        return -1;
+    }
+    *components = 0;
+    for (int v = 1; v <= n; v++) {
+        if (visited[v] || degree(g, v) == 0) continue;
+        int start = peripheralVariable(g, v);
+        (*components)++;
+        int head = count;
+        visited[start] = 1;
+        order[count++] = start;
+        while (head < count) {
+            int u = order[head++], k = 0;
+            for (int j = g->adjStart[u]; j < g->adjStart[u + 1]; j++) {
+                int w = g->adj[j];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    keys[k++] = (uint64_t)degree(g, w) << 32 | (uint32_t)w;
+                }
+            }
+            sortKeys(keys, k);
+            for (int i = 0; i < k; i++) order[count++] = (int)(uint32_t)keys[i];
+        }
+    }
+    free(visited);
+    free(keys);
+    return count;
+}
+
+/**
+ * @copydoc cnfClauseSpan
+ */
+long long cnfClauseSpan(const CnfFormula *f, int *bandwidth) {
+    long long total = 0;
+    int widest = 0;
+    for (int c = 0; c < f->numClauses; c++) {
+        const int *lits = cnfClause(f, c);
+        int size = cnfClauseSize(f, c);
+        if (size == 0) continue;
+        int lo = abs(lits[0]), hi = lo;
+        for (int k = 1; k < size; k++) {
+            int v = abs(lits[k]);
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        total += hi - lo;
+        if (hi - lo > widest) widest = hi - lo;
+    }
+    if (bandwidth) *bandwidth = widest;
+    return total;
+}
+
+/**
+ * @copydoc freeCnfRenumbering
+ */
+void freeCnfRenumbering(CnfRenumbering *map) {
+    free(map->newOfOld);
+    free(map->oldOfNew);
+    free(map->clauseOfNew);
+    memset(map, 0, sizeof(*map));
+}
+
+/**
+ * @copydoc translateModel
+ */
+void translateModel(const CnfRenumbering *map, const int *values, int *out) {
+    for (int v = 1; v <= map->numVars; v++) out[v] = values[map->newOfOld[v]];
+}
+
+/**
+ * @copydoc reorderCnfFormula
+ */
+CnfFormula *reorderCnfFormula(const CnfFormula *f, CnfRenumbering *map, ReorderStats *st) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int n = f->numVars, m = f->numClauses;
+    memset(map, 0, sizeof(*map));
+    map->numVars = n;
+    map->numClauses = m;
+    map->newOfOld = malloc(((size_t)n + 1) * sizeof(int));
+    map->oldOfNew = malloc(((size_t)n + 1) * sizeof(int));
+    map->clauseOfNew = malloc(((size_t)m + 1) * sizeof(int));
+    CnfFormula *out = calloc(1, sizeof(CnfFormula));
+    if (out) {
+        out->lits = malloc(((size_t)f->clauseStart[m] + 1) * sizeof(int));
+        out->clauseStart = malloc(((size_t)m + 1) * sizeof(int));
+    }
+    VarClauseGraph g;
+    int *order = NULL, count = -1, components = 0;
+    if (map->newOfOld && map->oldOfNew && map->clauseOfNew && out && out->lits && out->clauseStart
+        && buildGraph(&g, f)) {
+        order = malloc((size_t)g.numNodes * sizeof(int));
+        if (order) count = cuthillMcKee(&g, n, order, &components);
+        else perror("malloc");
+        freeGraph(&g);
+    } else {
+        perror("malloc");
+    }
+    if (count < 0) {
+        free(order);
+        freeCnfRenumbering(map);
+        freeCnfFormula(out);
+        return NULL;
+    }
+
+    /* Reverse the visit order; isolated variables and empty clauses last */
+    int nextVar = 0, nextClause = 0;
+    memset(map->newOfOld, 0, ((size_t)n + 1) * sizeof(int));
+    for (int i = count - 1; i >= 0; i--) {
+        int u = order[i];
+        if (u <= n) map->newOfOld[u] = ++nextVar;
+        else map->clauseOfNew[nextClause++] = u - n - 1;
+    }
+    free(order);
+    for (int v = 1; v <= n; v++) {
+        if (!map->newOfOld[v]) map->newOfOld[v] = ++nextVar;
+    }
+    for (int c = 0; c < m; c++) {
+        if (cnfClauseSize(f, c) == 0) map->clauseOfNew[nextClause++] = c;
+    }
+    map->oldOfNew[0] = 0;
+    for (int v = 1; v <= n; v++) map->oldOfNew[map->newOfOld[v]] = v;
+
+    out->numVars = n;
+    out->numClauses = m;
+    int pos = 0;
+    for (int c = 0; c < m; c++) {
+        int old = map->clauseOfNew[c], size = cnfClauseSize(f, old);
+        const int *lits = cnfClause(f, old);
+        out->clauseStart[c] = pos;
+        for (int k = 0; k < size; k++) out->lits[pos + k] = renumberLiteral(map, lits[k]);
+        sortByVariable(out->lits + pos, size);
+        pos += size;
+    }
+    out->clauseStart[m] = pos;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (st) {
+        st->spanBefore = cnfClauseSpan(f, &st->bandwidthBefore);
+        st->spanAfter = cnfClauseSpan(out, &st->bandwidthAfter);
+        st->components = components;
+        st->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    }
+    return out;
+}
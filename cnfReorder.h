@@ -0,0 +1,84 @@
+/**
+ * @file cnfReorder.h
+ * @brief Header for renumbering the variables and clauses of a clause set
+ *        for memory locality.
+ */
+
+#ifndef CNF_REORDER_H
+#define CNF_REORDER_H
+
+#include "cnfFormula.h"
+
+/**
+ * @brief Mapping between the numbering of a formula and its reordered
+ *        copy. Variable arrays are 1-based; entry 0 is unused.
+ */
+typedef struct {
+    int numVars;
+    int numClauses;
+    int *newOfOld;      /**< New number of each original variable */
+    int *oldOfNew;      /**< Original number of each new variable */
+    int *clauseOfNew;   /**< Original index of each new clause */
+} CnfRenumbering;
+
+/**
+ * @brief Locality measures of one numbering.
+ */
+typedef struct {
+    long long spanBefore;    /**< Sum over clauses of max - min variable */
+    long long spanAfter;
+    int bandwidthBefore;     /**< Largest span of one clause */
+    int bandwidthAfter;
+    int components;          /**< Connected components of the variable-clause graph */
+    double seconds;          /**< Time to compute the ordering and the copy */
+} ReorderStats;
+
+/**
+ * @brief Copies a clause set with variables and clauses renumbered in
+ *        reverse Cuthill-McKee order of its variable-clause graph, so
+ *        that variables sharing clauses get nearby numbers and clauses
+ *        over nearby variables are stored next to each other. The copy
+ *        has the same models up to the renaming; literals within each
+ *        clause stay sorted by variable.
+ * @param f Clause set.
+ * @param map Output: the renumbering (free with freeCnfRenumbering).
+ * @param st Locality measures (may be NULL).
+ * @return Reordered copy (free with freeCnfFormula), or NULL on malloc
+ *         failure.
+ */
+CnfFormula *reorderCnfFormula(const CnfFormula *f, CnfRenumbering *map, ReorderStats *st);
+
+/**
+ * @brief Frees the arrays of a renumbering.
+ */
+void freeCnfRenumbering(CnfRenumbering *map);
+
+/**
+ * @brief Sum of clause spans (max - min variable) of a clause set.
+ * @param bandwidth Output: the largest span (may be NULL).
+ */
+long long cnfClauseSpan(const CnfFormula *f, int *bandwidth);
+
+/**
+ * @brief Translates a literal of the original formula to the copy.
+ */
+static inline int renumberLiteral(const CnfRenumbering *map, int lit) {
+    return lit > 0 ? map->newOfOld[lit] : -map->newOfOld[-lit];
+}
+
+/**
+ * @brief Translates a literal of the copy back to the original formula.
+ */
+static inline int originalLiteral(const CnfRenumbering *map, int lit) {
+    return lit > 0 ? map->oldOfNew[lit] : -map->oldOfNew[-lit];
+}
+
+/**
+ * @brief Translates an assignment of the copy back to the original
+ *        variables.
+ * @param values values[v] of new variable v (1-based).
+ * @param out Output: out[v] of original variable v (1-based).
+ */
+void translateModel(const CnfRenumbering *map, const int *values, int *out);
+
+#endif
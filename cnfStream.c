@@ -0,0 +1,426 @@
+/**
+ * @file cnfStream.c
+ * @brief Lazy CNF conversion: clauses are generated one at a time and
+ *        written as DIMACS without building the distributed tree.
+ *
+ * distributeOr in task6.c rewrites the tree in place, so the whole CNF,
+ * exponential in the worst case, is held in memory before printCNF sees
+ * the first clause. The clauses of an NNF formula follow directly from
+ * its structure: a literal is one clause, A * B has the clauses of A
+ * followed by those of B, and A + B has one clause per pair of a clause
+ * of A and a clause of B. Walking that product like an odometer yields
+ * every clause in turn from O(n) state.
+ * @section algo Algorithm:
+ *   - Task 6 steps 1-2 (implications, negations) on a copy, then runs of
+ *     one operator flattened into n-ary nodes with constants folded
+ *   - State: the selected operand of each '*' node; the current clause is
+ *     the literals reachable through the selections ('+' selects all)
+ *   - Next clause: advance the last operand of the root that does not
+ *     wrap around, resetting those after it, recursively
+ *   - Count for the header: 1 per literal, sums at '*', products at '+'
+ * @section time Time Complexity: O(n) preparation, O(n) worst case per
+ *   clause and usually O(clause width)
+ * @section space Space Complexity: O(n + v), independent of the output
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cnfStream.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "simplify.h"
+#include "task5.h"
+
+/* Results of flattening besides a node index */
+#define FOLD_TRUE  (-1)
+#define FOLD_FALSE (-2)
+#define FOLD_ERROR (-3)
+
+#define WRITER_BYTES (1 << 16)
+
+enum { SN_LIT, SN_AND, SN_OR };
+
+/**
+ * @brief One node of the flattened NNF; operands are kids[first ..
+ *        first + count).
+ */
+typedef struct {
+    int op;
+    int lit;          /**< DIMACS literal of SN_LIT */
+    int first;
+    int count;
+    int cur;          /**< Selected operand of SN_AND */
+} StreamNode;
+
+struct CnfStream {
+    StreamNode *nodes;
+    int numNodes, nodeCap;
+    int *kids;
+    int numKids, kidCap;
+    int root;             /**< Node index, FOLD_TRUE or FOLD_FALSE */
+    int numVars;
+    int numLits;          /**< SN_LIT nodes, the widest possible clause */
+    int started, done;
+    int *clause;
+    int size;
+    int tautology;
+    unsigned *posSeen;    /**< Stamp of the last clause holding v, per polarity */
+    unsigned *negSeen;
+    unsigned stamp;
+};
+
+/**
+ * @brief Growable array used while flattening one run of an operator.
+ */
+typedef struct {
+    const Node **items;
+    int count, cap;
+} PendingList;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int addNode(CnfStream *s, int op, int lit, int first, int count) {
+    if (s->numNodes == s->nodeCap) {
+        int ncap = s->nodeCap ? s->nodeCap * 2 : 64;
+        StreamNode *nn = realloc(s->nodes, (size_t)ncap * sizeof(StreamNode));
+        if (!nn) { perror("realloc"); return FOLD_ERROR; }
+        s->nodes = nn;
+        s->nodeCap = ncap;
+    }
+    StreamNode *n = &s->nodes[s->numNodes];
+    n->op = op;
+    n->lit = lit;
+    n->first = first;
+    n->count = count;
+    n->cur = 0;
+    if (op == SN_LIT) s->numLits++;
+    return s->numNodes++;
+}
+
+static int pushKid(CnfStream *s, int k) {
+    if (s->numKids == s->kidCap) {
+        int ncap = s->kidCap ? s->kidCap * 2 : 64;
+        int *nk = realloc(s->kids, (size_t)ncap * sizeof(int));
+        if (!nk) { perror("realloc"); return 0; }
+        s->kids = nk;
+        s->kidCap = ncap;
+    }
+    s->kids[s->numKids++] = k;
+    return 1;
+}
+
+static int pushPending(PendingList *l, const Node *n) {
+    if (l->count == l->cap) {
+        int ncap = l->cap ? l->cap * 2 : 16;
+        const Node **ni = realloc(l->items, (size_t)ncap * sizeof(Node*));
+        if (!ni) { perror("realloc"); return 0; }
+        l->items = ni;
+        l->cap = ncap;
+    }
+    l->items[l->count++] = n;
+    return 1;
+}
+
+static int flatten(CnfStream *s, const Node *n, VarMap *vm);
+
+/**
+ * @brief Flattens the run of one operator rooted at n into an n-ary node,
+ *        folding constant operands.
+ */
+static int flattenRun(CnfStream *s, const Node *n, VarMap *vm, int op) {
+    int absorbing = op == SN_AND ? FOLD_FALSE : FOLD_TRUE;
+    int neutral = op == SN_AND ? FOLD_TRUE : FOLD_FALSE;
+    PendingList pending = { NULL, 0, 0 };
+    int *operands = NULL, count = 0, cap = 0;
+    int result = pushPending(&pending, n) ? neutral : FOLD_ERROR;
+
+    while (result == neutral && pending.count > 0) {
+        const Node *m = pending.items[--pending.count];
+        if (m && m->tok && !isVariableLeaf(m) && strcmp(m->tok, n->tok) == 0) {
+            // Right first, so operands come off the stack left to right
+            if (!pushPending(&pending, m->right) || !pushPending(&pending, m->left)) result = FOLD_ERROR;
+            continue;
+        }
+        int k = flatten(s, m, vm);
+        if (k == FOLD_ERROR || k == absorbing) {
+            result = k;
+        } else if (k != neutral) {
+            if (count == cap) {
+                int ncap = cap ? cap * 2 : 16;
+                int *no = realloc(operands, (size_t)ncap * sizeof(int));
+                if (!no) { perror("realloc"); result = FOLD_ERROR; continue; }
+                operands = no;
+                cap = ncap;
+            }
+            operands[count++] = k;
+        }
+    }
+    if (result == neutral && count == 1) {
+        result = operands[0];
+    } else if (result == neutral && count > 1) {
+        int first = s->numKids;
+        for (int i = 0; i < count && result != FOLD_ERROR; i++)
+            if (!pushKid(s, operands[i])) result = FOLD_ERROR;
+        if (result != FOLD_ERROR) result = addNode(s, op, 0, first, count);
+    }
+    free(pending.items);
+    free(operands);
+    return result;
+}
+
+/**
+ * @brief Flattens an NNF subtree.
+ * @return Node index, FOLD_TRUE/FOLD_FALSE for a constant subtree, or
+ *         FOLD_ERROR.
+ */
+static int flatten(CnfStream *s, const Node *n, VarMap *vm) {
+    if (!n || !n->tok) return FOLD_ERROR;
+    int negated = 0;
+    if (strcmp(n->tok, "~") == 0) {
+        // Negations sit directly above leaves in NNF
+        n = n->right;
+        if (!n || !n->tok || !isVariableLeaf(n)) return FOLD_ERROR;
+        negated = 1;
+    }
+    if (isVariableLeaf(n)) {
+        int c = constantValue(n->tok);
+        if (c >= 0) return c != negated ? FOLD_TRUE : FOLD_FALSE;
+        int v = varMapIntern(vm, n->tok);
+        return v ? addNode(s, SN_LIT, negated ? -v : v, 0, 0) : FOLD_ERROR;
+    }
+    if (strcmp(n->tok, "*") == 0) return flattenRun(s, n, vm, SN_AND);
+    if (strcmp(n->tok, "+") == 0) return flattenRun(s, n, vm, SN_OR);
+    return FOLD_ERROR;
+}
+
+/**
+ * @copydoc cnfStreamNew
+ */
+CnfStream *cnfStreamNew(const Node *root, VarMap *vm) {
+    CnfStream *s = calloc(1, sizeof(CnfStream));
+    if (!s) { perror("calloc"); return NULL; }
+    Node *nnf = root ? moveNotInwards(eliminateImplications(copyTree((Node*)root))) : NULL;
+    s->root = nnf ? flatten(s, nnf, vm) : FOLD_ERROR;
+    freeTree(nnf);
+    if (s->root == FOLD_ERROR) {
+        cnfStreamFree(s);
+        return NULL;
+    }
+    s->numVars = vm->count;
+    s->clause = malloc((size_t)(s->numLits ? s->numLits : 1) * sizeof(int));
+    s->posSeen = calloc((size_t)s->numVars + 1, sizeof(unsigned));
+    s->negSeen = calloc((size_t)s->numVars + 1, sizeof(unsigned));
+    if (!s->clause || !s->posSeen || !s->negSeen) {
+        perror("malloc");
+        cnfStreamFree(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * @copydoc cnfStreamFree
+ */
+void cnfStreamFree(CnfStream *s) {
+    if (!s) return;
+    free(s->nodes);
+    free(s->kids);
+    free(s->clause);
+    free(s->posSeen);
+    free(s->negSeen);
+    free(s);
+}
+
+/**
+ * @copydoc cnfStreamCount
+ */
+long long cnfStreamCount(const CnfStream *s) {
+    if (s->root == FOLD_TRUE) return 0;
+    if (s->root == FOLD_FALSE) return 1;
+    long long *count = malloc((size_t)s->numNodes * sizeof(long long));
+    if (!count) { perror("malloc"); return -1; }
+    // Operands are added before the node that holds them
+    for (int i = 0; i < s->numNodes; i++) {
+        const StreamNode *n = &s->nodes[i];
+        long long c = n->op == SN_OR;
+        for (int k = 0; k < n->count && c >= 0; k++) {
+            long long kc = count[s->kids[n->first + k]];
+            if (kc < 0 || (n->op == SN_AND ? __builtin_add_overflow(c, kc, &c)
+                                           : __builtin_mul_overflow(c, kc, &c))) c = -1;
+        }
+        count[i] = n->op == SN_LIT ? 1 : c;
+    }
+    long long total = count[s->root];
+    free(count);
+    return total;
+}
+
+/**
+ * @brief Appends the literals selected below node i to the clause.
+ */
+static void collect(CnfStream *s, int i) {
+    const StreamNode *n = &s->nodes[i];
+    if (n->op == SN_AND) {
+        collect(s, s->kids[n->first + n->cur]);
+    } else if (n->op == SN_OR) {
+        for (int k = 0; k < n->count; k++) collect(s, s->kids[n->first + k]);
+    } else {
+        int v = abs(n->lit);
+        unsigned *same = n->lit > 0 ? s->posSeen : s->negSeen;
+        unsigned *other = n->lit > 0 ? s->negSeen : s->posSeen;
+        if (same[v] == s->stamp) return;
+        same[v] = s->stamp;
+        if (other[v] == s->stamp) s->tautology = 1;
+        s->clause[s->size++] = n->lit;
+    }
+}
+
+/**
+ * @brief Moves node i to its next clause.
+ * @return 1, or 0 if it wrapped around to its first clause.
+ */
+static int advance(CnfStream *s, int i) {
+    StreamNode *n = &s->nodes[i];
+    if (n->op == SN_AND) {
+        if (advance(s, s->kids[n->first + n->cur])) return 1;
+        if (++n->cur < n->count) return 1;
+        n->cur = 0;
+    } else if (n->op == SN_OR) {
+        for (int k = n->count - 1; k >= 0; k--)
+            if (advance(s, s->kids[n->first + k])) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @copydoc cnfStreamNext
+ */
+int cnfStreamNext(CnfStream *s, const int **lits, int *size, int *tautology) {
+    if (s->done || s->root == FOLD_TRUE) return 0;
+    if (s->started && (s->root == FOLD_FALSE || !advance(s, s->root))) {
+        s->done = 1;
+        return 0;
+    }
+    s->started = 1;
+    s->size = 0;
+    s->tautology = 0;
+    if (++s->stamp == 0) {
+        memset(s->posSeen, 0, ((size_t)s->numVars + 1) * sizeof(unsigned));
+        memset(s->negSeen, 0, ((size_t)s->numVars + 1) * sizeof(unsigned));
+        s->stamp = 1;
+    }
+    if (s->root != FOLD_FALSE) collect(s, s->root);
+    *lits = s->clause;
+    *size = s->size;
+    if (tautology) *tautology = s->tautology;
+    return 1;
+}
+
+/* ----- buffered DIMACS writer ----- */
+
+typedef struct {
+    FILE *out;
+    size_t len;
+    int ok;
+    char buf[WRITER_BYTES];
+} DimacsWriter;
+
+static void writerFlush(DimacsWriter *w) {
+    if (w->len && fwrite(w->buf, 1, w->len, w->out) != w->len) w->ok = 0;
+    w->len = 0;
+}
+
+static void writerText(DimacsWriter *w, const char *text) {
+    for (size_t n = strlen(text); n > 0; ) {
+        if (w->len == WRITER_BYTES) writerFlush(w);
+        size_t chunk = WRITER_BYTES - w->len < n ? WRITER_BYTES - w->len : n;
+        memcpy(w->buf + w->len, text, chunk);
+        w->len += chunk;
+        text += chunk;
+        n -= chunk;
+    }
+}
+
+/**
+ * @brief Appends a number and a separator.
+ */
+static void writerInt(DimacsWriter *w, long long x, char sep) {
+    if (w->len + 24 > WRITER_BYTES) writerFlush(w);
+    char digits[24];
+    int n = 0;
+    unsigned long long u = x < 0 ? 0ULL - (unsigned long long)x : (unsigned long long)x;
+    do { digits[n++] = (char)('0' + u % 10); u /= 10; } while (u);
+    if (x < 0) w->buf[w->len++] = '-';
+    while (n > 0) w->buf[w->len++] = digits[--n];
+    w->buf[w->len++] = sep;
+}
+
+/**
+ * @copydoc writeCnfStreamDimacs
+ */
+int writeCnfStreamDimacs(const Node *root, FILE *out, CnfStreamReport *rep) {
+    double t0 = nowSeconds();
+    VarMap vm;
+    varMapInit(&vm);
+    CnfStream *s = cnfStreamNew(root, &vm);
+    if (!s) {
+        printf("Error: Cannot convert a malformed formula to CNF.\n");
+        varMapFree(&vm);
+        return 0;
+    }
+    long long total = cnfStreamCount(s);
+    DimacsWriter *w = total >= 0 ? malloc(sizeof(DimacsWriter)) : NULL;
+    if (!w) {
+        if (total < 0) printf("Error: The CNF has more than 2^63 clauses.\n");
+        else perror("malloc");
+        cnfStreamFree(s);
+        varMapFree(&vm);
+        return 0;
+    }
+    w->out = out;
+    w->len = 0;
+    w->ok = 1;
+
+    CnfStreamReport r;
+    memset(&r, 0, sizeof(r));
+    r.numVars = vm.count;
+    r.streamNodes = s->numNodes;
+    r.memoryBytes = sizeof(CnfStream) + sizeof(DimacsWriter) + (size_t)s->nodeCap * sizeof(StreamNode)
+                    + (size_t)s->kidCap * sizeof(int) + (size_t)(s->numLits + 1) * sizeof(int)
+                    + 2 * ((size_t)s->numVars + 1) * sizeof(unsigned);
+
+    for (int v = 0; v < vm.count; v++) {
+        writerText(w, "c var ");
+        writerInt(w, v + 1, ' ');
+        writerText(w, vm.names[v]);
+        writerText(w, "\n");
+    }
+    writerText(w, "p cnf ");
+    writerInt(w, vm.count, ' ');
+    writerInt(w, total, '\n');
+
+    const int *lits;
+    int size, taut;
+    while (w->ok && cnfStreamNext(s, &lits, &size, &taut)) {
+        for (int k = 0; k < size; k++) writerInt(w, lits[k], ' ');
+        writerText(w, "0\n");
+        r.clauses++;
+        r.tautologies += taut;
+        r.literals += size;
+        if (size > r.maxWidth) r.maxWidth = size;
+    }
+    writerFlush(w);
+    int ok = w->ok && fflush(out) == 0;
+    if (!ok) perror("write");
+    r.seconds = nowSeconds() - t0;
+    if (rep) *rep = r;
+    free(w);
+    cnfStreamFree(s);
+    varMapFree(&vm);
+    return ok;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file cnfStream.h
+ * @brief Header for converting a formula to CNF one clause at a time.
+ */
+
+#ifndef CNF_STREAM_H
+#define CNF_STREAM_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "common.h"
+#include "varMap.h"
+
+/**
+ * @brief Opaque clause generator over the NNF of a formula.
+ */
+typedef struct CnfStream CnfStream;
+
+/**
+ * @brief Totals of one conversion.
+ */
+typedef struct {
+    int numVars;
+    long long clauses;       /**< Clauses produced (equal to the header count) */
+    long long tautologies;   /**< Of which contain a literal and its negation */
+    long long literals;      /**< After removing repeats within a clause */
+    int maxWidth;
+    long streamNodes;        /**< Nodes of the flattened NNF */
+    size_t memoryBytes;      /**< Held by the generator, independent of the output */
+    double seconds;
+} CnfStreamReport;
+
+/**
+ * @brief Prepares the clauses of a formula: eliminates implications,
+ *        pushes negations to the leaves and flattens runs of one
+ *        operator. No clause is built yet.
+ *
+ * The clauses are those of full distribution of + over *, in order: the
+ * clauses of A * B are A's then B's, those of A + B every union of a
+ * clause of A with a clause of B, A's outer. Repeated literals within a
+ * clause are dropped; tautologies and repeated clauses are kept, so the
+ * count is known in advance.
+ *
+ * @param root Formula (not kept).
+ * @param vm Variable numbering; variable i of vm is DIMACS variable i
+ *        (updated with the formula's names).
+ * @return Generator, or NULL on a malformed tree or malloc failure.
+ */
+CnfStream *cnfStreamNew(const Node *root, VarMap *vm);
+
+/**
+ * @brief Frees a generator.
+ */
+void cnfStreamFree(CnfStream *s);
+
+/**
+ * @brief Number of clauses the generator will produce, from one pass
+ *        over the flattened formula.
+ * @return Count, or -1 if it does not fit in a long long.
+ */
+long long cnfStreamCount(const CnfStream *s);
+
+/**
+ * @brief Produces the next clause.
+ * @param lits Output: DIMACS literals, valid until the next call.
+ * @param size Output: number of literals (0 for the empty clause of a
+ *        false formula).
+ * @param tautology Output: whether the clause is valid (may be NULL).
+ * @return 1 if a clause was produced, 0 when the stream is exhausted.
+ */
+int cnfStreamNext(CnfStream *s, const int **lits, int *size, int *tautology);
+
+/**
+ * @brief Writes the CNF of a formula as DIMACS through a buffered writer,
+ *        one clause at a time. Comment lines give the variable names;
+ *        the header counts come from cnfStreamCount.
+ * @param root Formula.
+ * @param out Destination (need not be seekable).
+ * @param rep Totals (may be NULL).
+ * @return 1 on success, 0 on a malformed tree, a count over 2^63, malloc
+ *         failure or a write error (reported on stdout).
+ */
+int writeCnfStreamDimacs(const Node *root, FILE *out, CnfStreamReport *rep);
+
+#endif
@@ -1,4 +1,5 @@
 #include "common.h"
+#include "instrument.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -10,6 +11,7 @@ char *strdup_s(const char *s) {
     if (!s) return NULL;
     char *r = malloc(strlen(s) + 1);
     if (!r) { perror("malloc"); return NULL; }
+    phaseNoteAlloc(0, strlen(s) + 1);
     strcpy(r, s);
     return r;
 }
@@ -20,6 +22,7 @@ char *strdup_s(const char *s) {
 Node* newNode(const char *tok) {
     Node *n = (Node*)malloc(sizeof(Node));
     if (!n) { perror("malloc"); return NULL; }
+    phaseNoteAlloc(1, sizeof(Node));
     n->tok = strdup_s(tok);
     n->left = NULL;
     n->right = NULL;
@@ -0,0 +1,185 @@
+/**
+ * @file compiledFormula.c
+ * @brief Compiles parse trees into straight-line bitwise code.
+ *
+ * evaluateFormula in task5.c walks the tree and resolves every leaf by
+ * strcmp against an assignment list, once per row. Compiling once to a
+ * postorder instruction array with integer variable indices, and running
+ * each instruction on whole words of assignments, removes both costs.
+ * @section algo Algorithm: Postorder flattening + bit-sliced evaluation
+ * @section time Time Complexity: O(n) compile, O(n × width) per block
+ * @section space Space Complexity: O(n × width) slots
+ */
+
+#include "compiledFormula.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+
+/**
+ * @brief Appends one instruction, growing the code array.
+ * @return Slot index of the instruction, or -1 on malloc failure.
+ */
+static int emit(CompiledFormula *cf, int *cap, int op, int a, int b) {
+    if (cf->numInstrs == *cap) {
+        int ncap = *cap ? *cap * 2 : 64;
+        FormulaInstr *nc = realloc(cf->code, (size_t)ncap * sizeof(FormulaInstr));
+        if (!nc) { perror("realloc"); return -1; }
+        cf->code = nc;
+        *cap = ncap;
+    }
+    cf->code[cf->numInstrs].op = op;
+    cf->code[cf->numInstrs].a = a;
+    cf->code[cf->numInstrs].b = b;
+    return cf->numInstrs++;
+}
+
+/**
+ * @brief Recursively emits code for a subtree.
+ * @return Slot holding the subtree's value, or -1 on error.
+ */
+static int compileRec(CompiledFormula *cf, int *cap, const Node *n, VarMap *vm) {
+    if (!n || !n->tok) return -1;
+    if (isVariableLeaf(n)) {
+        int v = varMapIntern(vm, n->tok);
+        return v ? emit(cf, cap, FOP_VAR, v - 1, 0) : -1;
+    }
+    if (strcmp(n->tok, "~") == 0) {
+        int x = compileRec(cf, cap, n->right, vm);
+        return x < 0 ? -1 : emit(cf, cap, FOP_NOT, x, 0);
+    }
+
+    int op;
+    if (strcmp(n->tok, "*") == 0) op = FOP_AND;
+    else if (strcmp(n->tok, "+") == 0) op = FOP_OR;
+    else if (strcmp(n->tok, ">") == 0) op = FOP_IMPLIES;
+    else return -1;
+
+    int l = compileRec(cf, cap, n->left, vm);
+    int r = l < 0 ? -1 : compileRec(cf, cap, n->right, vm);
+    return r < 0 ? -1 : emit(cf, cap, op, l, r);
+}
+
+/**
+ * @copydoc compileFormula
+ */
+CompiledFormula *compileFormula(const Node *root, VarMap *vm) {
+    CompiledFormula *cf = calloc(1, sizeof(CompiledFormula));
+    if (!cf) { perror("calloc"); return NULL; }
+    int cap = 0;
+    if (compileRec(cf, &cap, root, vm) < 0) {
+        freeCompiledFormula(cf);
+        return NULL;
+    }
+    cf->numVars = vm->count;
+    return cf;
+}
+
+/**
+ * @copydoc freeCompiledFormula
+ */
+void freeCompiledFormula(CompiledFormula *cf) {
+    if (!cf) return;
+    if (cf->nativeHandle) dlclose(cf->nativeHandle);
+    free(cf->code);
+    free(cf);
+}
+
+#if defined(__GNUC__)
+/* Unaligned, aliasing-safe view of four words as one SIMD register */
+typedef uint64_t WordVec __attribute__((vector_size(32), aligned(8), may_alias));
+#define VEC_WORDS 4
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__) && !defined(__clang__) \
+    && !defined(__SANITIZE_THREAD__)
+/* Runtime dispatch: an AVX2 build of the kernel is picked when the CPU has it.
+   Not under TSan, whose runtime is not yet up when ifunc resolvers run. */
+#define EVAL_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define EVAL_TARGETS
+#endif
+
+/**
+ * @copydoc evalCompiledBlock
+ */
+EVAL_TARGETS
+const uint64_t *evalCompiledBlock(const CompiledFormula *cf, const uint64_t *vars, int width, uint64_t *slots) {
+    if (cf->native) {
+        cf->native(vars, width, slots);
+        return slots;
+    }
+    for (int i = 0; i < cf->numInstrs; i++) {
+        const FormulaInstr *in = &cf->code[i];
+        uint64_t *d = slots + (size_t)i * width;
+        const uint64_t *a = (in->op == FOP_VAR ? vars : slots) + (size_t)in->a * width;
+        const uint64_t *b = slots + (size_t)in->b * width;
+        int w = 0;
+#ifdef VEC_WORDS
+        int vecEnd = width - width % VEC_WORDS;
+        WordVec *dv = (WordVec*)d;
+        const WordVec *av = (const WordVec*)a, *bv = (const WordVec*)b;
+        switch (in->op) {
+        case FOP_VAR:     for (int k = 0; k < vecEnd / VEC_WORDS; k++) dv[k] = av[k]; break;
+        case FOP_NOT:     for (int k = 0; k < vecEnd / VEC_WORDS; k++) dv[k] = ~av[k]; break;
+        case FOP_AND:     for (int k = 0; k < vecEnd / VEC_WORDS; k++) dv[k] = av[k] & bv[k]; break;
+        case FOP_OR:      for (int k = 0; k < vecEnd / VEC_WORDS; k++) dv[k] = av[k] | bv[k]; break;
+        case FOP_IMPLIES: for (int k = 0; k < vecEnd / VEC_WORDS; k++) dv[k] = ~av[k] | bv[k]; break;
+        }
+        w = vecEnd;
+#endif
+        switch (in->op) {
+        case FOP_VAR:     for (; w < width; w++) d[w] = a[w]; break;
+        case FOP_NOT:     for (; w < width; w++) d[w] = ~a[w]; break;
+        case FOP_AND:     for (; w < width; w++) d[w] = a[w] & b[w]; break;
+        case FOP_OR:      for (; w < width; w++) d[w] = a[w] | b[w]; break;
+        case FOP_IMPLIES: for (; w < width; w++) d[w] = ~a[w] | b[w]; break;
+        }
+    }
+    return slots + (size_t)(cf->numInstrs - 1) * width;
+}
+
+/**
+ * @copydoc setTableRowInputs
+ */
+void setTableRowInputs(uint64_t *vars, int numVars, int width, uint64_t base) {
+    static const uint64_t lowPattern[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    for (int v = 0; v < numVars; v++) {
+        for (int w = 0; w < width; w++) {
+            vars[(size_t)v * width + w] = v < 6 ? lowPattern[v]
+                : (((base + (uint64_t)w * 64) >> v) & 1) ? ~0ULL : 0;
+        }
+    }
+}
+
+/**
+ * @copydoc countCompiledModels
+ */
+double countCompiledModels(const CompiledFormula *cf) {
+    int n = cf->numVars;
+    if (n > MAX_COUNT_VARS) return -1;
+    uint64_t rows = 1ULL << n;
+    int width = rows >= 4096 ? 64 : 1;
+    uint64_t *vars = malloc((size_t)(n ? n : 1) * width * sizeof(uint64_t));
+    uint64_t *slots = malloc((size_t)cf->numInstrs * width * sizeof(uint64_t));
+    if (!vars || !slots) {
+        perror("malloc");
+        free(vars);
+        free(slots);
+        return -1;
+    }
+    uint64_t valid = rows >= 64 ? ~0ULL : (1ULL << rows) - 1;
+    double models = 0;
+    for (uint64_t base = 0; base < rows; base += (uint64_t)width * 64) {
+        setTableRowInputs(vars, n, width, base);
+        const uint64_t *res = evalCompiledBlock(cf, vars, width, slots);
+        for (int w = 0; w < width; w++) models += __builtin_popcountll(res[w] & valid);
+    }
+    free(vars);
+    free(slots);
+    return models;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file compiledFormula.h
+ * @brief Header for flattened, bit-parallel formula evaluation.
+ */
+
+#ifndef COMPILED_FORMULA_H
+#define COMPILED_FORMULA_H
+
+#include <stdint.h>
+#include "common.h"
+#include "varMap.h"
+
+/**
+ * @brief Instruction opcodes of a compiled formula.
+ */
+typedef enum {
+    FOP_VAR,      /**< slot = variable a */
+    FOP_NOT,      /**< slot = ~slot[a] */
+    FOP_AND,      /**< slot = slot[a] & slot[b] */
+    FOP_OR,       /**< slot = slot[a] | slot[b] */
+    FOP_IMPLIES   /**< slot = ~slot[a] | slot[b] */
+} FormulaOp;
+
+/**
+ * @brief One instruction; its result goes to the slot with its own index.
+ */
+typedef struct {
+    int op;
+    int a;        /**< Variable index (0-based) for FOP_VAR, else operand slot */
+    int b;        /**< Second operand slot of binary operators */
+} FormulaInstr;
+
+/**
+ * @brief Machine-code version of a formula: out[w] is the formula on word
+ *        w of the variables, laid out as for evalCompiledBlock.
+ */
+typedef void (*NativeKernelFn)(const uint64_t *vars, long width, uint64_t *out);
+
+/**
+ * @brief A parse tree flattened into postorder straight-line code.
+ *
+ * Evaluating the code over 64-bit words evaluates the formula on 64
+ * assignments at once; the result is the last slot.
+ */
+typedef struct {
+    int numVars;          /**< Variables referenced (indices of the VarMap) */
+    int numInstrs;
+    FormulaInstr *code;
+    NativeKernelFn native;   /**< Set by nativeKernelAttach, else NULL */
+    void *nativeHandle;      /**< dlopen handle of the kernel */
+} CompiledFormula;
+
+/**
+ * @brief Flattens a parse tree.
+ *
+ * Variable indices come from vm; names not yet in vm are interned, so two
+ * formulas compiled with the same map share one variable numbering.
+ *
+ * @param root Root of the parse tree.
+ * @param vm Variable map (updated).
+ * @return Compiled formula, or NULL if the tree is malformed or malloc fails.
+ */
+CompiledFormula *compileFormula(const Node *root, VarMap *vm);
+
+/**
+ * @brief Frees a compiled formula and unloads its native kernel.
+ */
+void freeCompiledFormula(CompiledFormula *cf);
+
+/**
+ * @brief Evaluates the formula on width×64 assignments at once.
+ *
+ * Variable v's values are vars[v*width .. v*width+width-1]; bit j of word
+ * w is assignment w*64+j. Each instruction runs as a loop over width
+ * words in 256-bit vector steps (AVX2 when the CPU supports it); with a
+ * native kernel attached, the kernel runs instead.
+ *
+ * @param cf Compiled formula.
+ * @param vars Bit-sliced variable values (numVars × width words).
+ * @param width Words per slot.
+ * @param slots Scratch of numInstrs × width words.
+ * @return Pointer to the result words (inside slots).
+ */
+const uint64_t *evalCompiledBlock(const CompiledFormula *cf, const uint64_t *vars, int width, uint64_t *slots);
+
+/**
+ * @brief Fills the variable words of the truth-table rows base ..
+ *        base + width×64 - 1, in the layout evalCompiledBlock expects.
+ *
+ * Row r assigns bit v of r to variable v, so variables 0-5 vary inside a
+ * word and the others are constant per word.
+ *
+ * @param vars Output: numVars × width words.
+ * @param numVars Variables of the formula.
+ * @param width Words per variable.
+ * @param base First row (a multiple of 64).
+ */
+void setTableRowInputs(uint64_t *vars, int numVars, int width, uint64_t base);
+
+/** @brief Largest number of variables countCompiledModels enumerates. */
+#define MAX_COUNT_VARS 30
+
+/**
+ * @brief Counts satisfying assignments by evaluating every row of the
+ *        truth table, 4096 rows per block.
+ * @param cf Compiled formula.
+ * @return Number of models over cf->numVars variables, or -1 if there are
+ *         more than MAX_COUNT_VARS variables or malloc fails.
+ */
+double countCompiledModels(const CompiledFormula *cf);
+
+#endif
@@ -0,0 +1,452 @@
+/**
+ * @file compressedInput.c
+ * @brief Streaming decompression of gzip, xz and bzip2 DIMACS files.
+ *
+ * Benchmark archives are kept compressed; text CNF shrinks five- to
+ * tenfold. Rather than decompressing to a temporary file, a decoder
+ * thread inflates the input into a ring of fixed buffers while the
+ * caller parses the buffer it holds, so decoding and parsing overlap
+ * and only the compressed bytes are read from disk.
+ * @section algo Algorithm: single-producer / single-consumer ring
+ *   - The format is taken from the magic bytes of the first chunk, never
+ *     from the file name
+ *   - Producer: reads compressed chunks, decodes into the next free slot
+ *     and publishes it when full; concatenated members (pigz, pbzip2,
+ *     multi-stream xz) are decoded back to back
+ *   - Consumer: takes the oldest full slot and parses it in place; the
+ *     slot returns to the producer on the next read
+ *   - A consumer that stops early (e.g. at a SATLIB "%" line) cancels the
+ *     producer, which is waiting for a free slot at worst
+ * @section time Time Complexity: O(compressed + decoded bytes)
+ * @section space Space Complexity: O(RING_SLOTS * SLOT_BYTES), independent
+ *   of the file size
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "compressedInput.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <lzma.h>
+#include <bzlib.h>
+
+#define READ_CHUNK (1 << 16)
+#define RING_SLOTS 4
+#define SLOT_BYTES (1 << 18)
+
+/**
+ * @brief Decoder state of the active format.
+ */
+typedef union {
+    z_stream gz;
+    lzma_stream xz;
+    bz_stream bz;
+} Codec;
+
+struct CompressedInput {
+    FILE *fp;
+    int ownsFile;
+    CompressFormat format;
+
+    /* Plain input: one buffer, refilled by compressedRead */
+    char *plain;
+    size_t firstLen;        /**< Bytes of the sniffed first chunk not yet handed out */
+
+    /* Compressed input: the ring and its decoder thread */
+    char *slots[RING_SLOTS];
+    size_t fill[RING_SLOTS];
+    int head;               /**< Next slot the producer fills */
+    int tail;               /**< Oldest full slot */
+    int count;              /**< Full slots, including the one the consumer holds */
+    int holding;            /**< The consumer holds slots[tail] */
+    int finished;           /**< The producer has published its last slot */
+    int failed;             /**< Corrupt, truncated or unreadable input */
+    int cancel;
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_t thread;
+    int threadStarted;
+    unsigned char *inBuf;
+    size_t inLen;           /**< Bytes of the sniffed first chunk in inBuf */
+    Codec codec;
+
+    /* compressedGetline: unread part of the current buffer */
+    const char *cur;
+    size_t curLen;
+};
+
+/**
+ * @copydoc detectCompression
+ */
+CompressFormat detectCompression(const unsigned char *head, size_t n) {
+    static const unsigned char xzMagic[6] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+    static const unsigned char zstdMagic[4] = { 0x28, 0xb5, 0x2f, 0xfd };
+    if (n >= 2 && head[0] == 0x1f && head[1] == 0x8b) return COMPRESS_GZIP;
+    if (n >= 6 && memcmp(head, xzMagic, 6) == 0) return COMPRESS_XZ;
+    if (n >= 4 && head[0] == 'B' && head[1] == 'Z' && head[2] == 'h' && head[3] >= '1' && head[3] <= '9')
+        return COMPRESS_BZIP2;
+    if (n >= 4 && memcmp(head, zstdMagic, 4) == 0) return COMPRESS_ZSTD;
+    return COMPRESS_NONE;
+}
+
+/**
+ * @copydoc compressFormatName
+ */
+const char *compressFormatName(CompressFormat format) {
+    switch (format) {
+    case COMPRESS_GZIP: return "gzip";
+    case COMPRESS_XZ: return "xz";
+    case COMPRESS_BZIP2: return "bzip2";
+    case COMPRESS_ZSTD: return "zstd";
+    default: return "plain";
+    }
+}
+
+/**
+ * @copydoc isCnfPath
+ */
+int isCnfPath(const char *path) {
+    static const char *const suffixes[] = { ".cnf", ".cnf.gz", ".cnf.xz", ".cnf.bz2" };
+    size_t len = strlen(path);
+    for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+        size_t n = strlen(suffixes[i]);
+        if (len > n && strcmp(path + len - n, suffixes[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+/* ----- codecs ----- */
+
+static int codecInit(CompressedInput *in) {
+    memset(&in->codec, 0, sizeof(in->codec));
+    switch (in->format) {
+    case COMPRESS_GZIP:
+        return inflateInit2(&in->codec.gz, 15 + 32) == Z_OK;   /* gzip or zlib header */
+    case COMPRESS_XZ:
+        return lzma_stream_decoder(&in->codec.xz, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK;
+    default:
+        return BZ2_bzDecompressInit(&in->codec.bz, 0, 0) == BZ_OK;
+    }
+}
+
+static void codecEnd(CompressedInput *in) {
+    switch (in->format) {
+    case COMPRESS_GZIP: inflateEnd(&in->codec.gz); break;
+    case COMPRESS_XZ: lzma_end(&in->codec.xz); break;
+    default: BZ2_bzDecompressEnd(&in->codec.bz); break;
+    }
+}
+
+/**
+ * @brief Decodes from *src into *dst as far as either allows, advancing
+ *        both.
+ * @param finish The input has ended (xz needs to be told).
+ * @return 0 to continue, 1 at the end of a stream, -1 on corrupt input.
+ */
+static int codecStep(CompressedInput *in, const unsigned char **src, size_t *srcLen,
+                     char **dst, size_t *dstLen, int finish) {
+    int rc;
+    switch (in->format) {
+    case COMPRESS_GZIP: {
+        z_stream *z = &in->codec.gz;
+        z->next_in = (Bytef *)*src;
+        z->avail_in = (uInt)*srcLen;
+        z->next_out = (Bytef *)*dst;
+        z->avail_out = (uInt)*dstLen;
+        int zr = inflate(z, Z_NO_FLUSH);
+        rc = zr == Z_STREAM_END ? 1 : zr == Z_OK || zr == Z_BUF_ERROR ? 0 : -1;
+        *src = z->next_in;
+        *srcLen = z->avail_in;
+        *dst = (char *)z->next_out;
+        *dstLen = z->avail_out;
+        return rc;
+    }
+    case COMPRESS_XZ: {
+        lzma_stream *x = &in->codec.xz;
+        x->next_in = *src;
+        x->avail_in = *srcLen;
+        x->next_out = (uint8_t *)*dst;
+        x->avail_out = *dstLen;
+        lzma_ret xr = lzma_code(x, finish ? LZMA_FINISH : LZMA_RUN);
+        rc = xr == LZMA_STREAM_END ? 1 : xr == LZMA_OK || xr == LZMA_BUF_ERROR ? 0 : -1;
+        *src = x->next_in;
+        *srcLen = x->avail_in;
+        *dst = (char *)x->next_out;
+        *dstLen = x->avail_out;
+        return rc;
+    }
+    default: {
+        bz_stream *b = &in->codec.bz;
+        b->next_in = (char *)*src;
+        b->avail_in = (unsigned)*srcLen;
+        b->next_out = *dst;
+        b->avail_out = (unsigned)*dstLen;
+        int br = BZ2_bzDecompress(b);
+        rc = br == BZ_STREAM_END ? 1 : br == BZ_OK ? 0 : -1;
+        *src = (const unsigned char *)b->next_in;
+        *srcLen = b->avail_in;
+        *dst = b->next_out;
+        *dstLen = b->avail_out;
+        return rc;
+    }
+    }
+}
+
+/* ----- ring (producer side) ----- */
+
+/**
+ * @brief Waits for a free slot.
+ * @return Its index, or -1 if the consumer cancelled.
+ */
+static int acquireSlot(CompressedInput *in) {
+    pthread_mutex_lock(&in->lock);
+    while (in->count == RING_SLOTS && !in->cancel) pthread_cond_wait(&in->notFull, &in->lock);
+    int slot = in->cancel ? -1 : in->head;
+    pthread_mutex_unlock(&in->lock);
+    return slot;
+}
+
+static void publishSlot(CompressedInput *in, size_t n) {
+    pthread_mutex_lock(&in->lock);
+    in->fill[in->head] = n;
+    in->head = (in->head + 1) % RING_SLOTS;
+    in->count++;
+    pthread_cond_signal(&in->notEmpty);
+    pthread_mutex_unlock(&in->lock);
+}
+
+static void finishProducer(CompressedInput *in, int failed) {
+    pthread_mutex_lock(&in->lock);
+    in->finished = 1;
+    in->failed = failed;
+    pthread_cond_broadcast(&in->notEmpty);
+    pthread_mutex_unlock(&in->lock);
+}
+
+/**
+ * @brief Reads the next compressed chunk once the current one is used up.
+ * @return 0 on a read error.
+ */
+static int refillInput(CompressedInput *in, const unsigned char **src, size_t *srcLen, int *inputEnded) {
+    if (*srcLen > 0 || *inputEnded) return 1;
+    *srcLen = fread(in->inBuf, 1, READ_CHUNK, in->fp);
+    *src = in->inBuf;
+    if (*srcLen == 0) *inputEnded = 1;
+    return !ferror(in->fp);
+}
+
+/**
+ * @brief Decoder thread: compressed chunks in, full slots out.
+ */
+static void *decodeThread(void *arg) {
+    CompressedInput *in = arg;
+    const unsigned char *src = in->inBuf;
+    size_t srcLen = in->inLen;
+    int inputEnded = 0, failed = 0;
+    int slot = acquireSlot(in);
+    char *dst = slot >= 0 ? in->slots[slot] : NULL;
+    size_t dstLen = SLOT_BYTES;
+
+    while (slot >= 0) {
+        if (!refillInput(in, &src, &srcLen, &inputEnded)) { failed = 1; break; }
+        size_t srcBefore = srcLen, dstBefore = dstLen;
+        int rc = codecStep(in, &src, &srcLen, &dst, &dstLen, inputEnded);
+        if (rc < 0) { failed = 1; break; }
+        if (dstLen == 0) {
+            publishSlot(in, SLOT_BYTES);
+            slot = acquireSlot(in);
+            dst = slot >= 0 ? in->slots[slot] : NULL;
+            dstLen = SLOT_BYTES;
+        }
+        if (rc == 1) {
+            /* End of a member: stop, or start over on the next one */
+            if (!refillInput(in, &src, &srcLen, &inputEnded)) { failed = 1; break; }
+            if (srcLen == 0 || in->format == COMPRESS_XZ) break;
+            codecEnd(in);
+            if (!codecInit(in)) { failed = 1; break; }
+        } else if (srcBefore == srcLen && dstBefore == dstLen && inputEnded) {
+            failed = 1;   /* truncated: the decoder wants input that does not exist */
+            break;
+        }
+    }
+    if (slot >= 0 && dstLen < SLOT_BYTES) publishSlot(in, SLOT_BYTES - dstLen);
+    finishProducer(in, failed);
+    return NULL;
+}
+
+/* ----- consumer side ----- */
+
+/**
+ * @copydoc compressedOpen
+ */
+CompressedInput *compressedOpen(FILE *fp) {
+    CompressedInput *in = calloc(1, sizeof(CompressedInput));
+    unsigned char *first = malloc(READ_CHUNK);
+    if (!in || !first) {
+        perror("malloc");
+        free(in);
+        free(first);
+        return NULL;
+    }
+    in->fp = fp;
+    size_t n = fread(first, 1, READ_CHUNK, fp);
+    in->format = detectCompression(first, n);
+
+    if (in->format == COMPRESS_NONE) {
+        in->plain = (char *)first;
+        in->firstLen = n;
+        return in;
+    }
+    if (in->format == COMPRESS_ZSTD) {
+        printf("Error: zstd-compressed input is not supported; decompress it with 'zstd -d' first.\n");
+        free(first);
+        free(in);
+        return NULL;
+    }
+
+    in->inBuf = first;
+    in->inLen = n;
+    int ok = codecInit(in);
+    if (!ok) printf("Error: Could not start the %s decoder.\n", compressFormatName(in->format));
+    for (int i = 0; ok && i < RING_SLOTS; i++) {
+        in->slots[i] = malloc(SLOT_BYTES);
+        if (!in->slots[i]) { perror("malloc"); ok = 0; }
+    }
+    if (ok) {
+        pthread_mutex_init(&in->lock, NULL);
+        pthread_cond_init(&in->notEmpty, NULL);
+        pthread_cond_init(&in->notFull, NULL);
+        ok = pthread_create(&in->thread, NULL, decodeThread, in) == 0;
+        if (!ok) {
+            printf("Error: Could not start the decoder thread.\n");
+            pthread_mutex_destroy(&in->lock);
+            pthread_cond_destroy(&in->notEmpty);
+            pthread_cond_destroy(&in->notFull);
+            codecEnd(in);
+        }
+    }
+    if (!ok) {
+        for (int i = 0; i < RING_SLOTS; i++) free(in->slots[i]);
+        free(first);
+        free(in);
+        return NULL;
+    }
+    in->threadStarted = 1;
+    return in;
+}
+
+/**
+ * @copydoc compressedOpenFile
+ */
+CompressedInput *compressedOpenFile(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror("fopen");
+        return NULL;
+    }
+    CompressedInput *in = compressedOpen(fp);
+    if (!in) {
+        fclose(fp);
+        return NULL;
+    }
+    in->ownsFile = 1;
+    return in;
+}
+
+/**
+ * @copydoc compressedFormat
+ */
+CompressFormat compressedFormat(const CompressedInput *in) {
+    return in->format;
+}
+
+/**
+ * @copydoc compressedRead
+ */
+size_t compressedRead(CompressedInput *in, const char **data) {
+    if (!in->threadStarted) {
+        size_t n = in->firstLen;
+        in->firstLen = 0;
+        if (n == 0) n = fread(in->plain, 1, READ_CHUNK, in->fp);
+        *data = in->plain;
+        return n;
+    }
+
+    pthread_mutex_lock(&in->lock);
+    if (in->holding) {
+        in->tail = (in->tail + 1) % RING_SLOTS;
+        in->count--;
+        in->holding = 0;
+        pthread_cond_signal(&in->notFull);
+    }
+    while (in->count == 0 && !in->finished) pthread_cond_wait(&in->notEmpty, &in->lock);
+    size_t n = 0;
+    if (in->count > 0) {
+        in->holding = 1;
+        *data = in->slots[in->tail];
+        n = in->fill[in->tail];
+    }
+    pthread_mutex_unlock(&in->lock);
+    return n;
+}
+
+/**
+ * @copydoc compressedGetline
+ */
+ssize_t compressedGetline(CompressedInput *in, char **line, size_t *cap) {
+    size_t len = 0;
+    for (;;) {
+        if (in->curLen == 0) {
+            in->curLen = compressedRead(in, &in->cur);
+            if (in->curLen == 0) break;
+        }
+        const char *nl = memchr(in->cur, '\n', in->curLen);
+        size_t take = nl ? (size_t)(nl - in->cur) + 1 : in->curLen;
+        if (len + take + 1 > *cap) {
+            size_t ncap = *cap ? *cap : 256;
+            while (len + take + 1 > ncap) ncap *= 2;
+            char *nl2 = realloc(*line, ncap);
+            if (!nl2) { perror("realloc"); return -1; }
+            *line = nl2;
+            *cap = ncap;
+        }
+        memcpy(*line + len, in->cur, take);
+        len += take;
+        in->cur += take;
+        in->curLen -= take;
+        if (nl) break;
+    }
+    if (len == 0) return -1;
+    (*line)[len] = '\0';
+    return (ssize_t)len;
+}
+
+/**
+ * @copydoc compressedClose
+ */
+int compressedClose(CompressedInput *in) {
+    if (!in) return 1;
+    int ok = !ferror(in->fp);
+    if (in->threadStarted) {
+        pthread_mutex_lock(&in->lock);
+        in->cancel = 1;
+        pthread_cond_broadcast(&in->notFull);
+        pthread_mutex_unlock(&in->lock);
+        pthread_join(in->thread, NULL);
+        ok = !in->failed;
+        codecEnd(in);
+        pthread_mutex_destroy(&in->lock);
+        pthread_cond_destroy(&in->notEmpty);
+        pthread_cond_destroy(&in->notFull);
+        for (int i = 0; i < RING_SLOTS; i++) free(in->slots[i]);
+        free(in->inBuf);
+    }
+    if (!ok) printf("Error: Corrupt, truncated or unreadable %s input.\n", compressFormatName(in->format));
+    if (in->ownsFile) fclose(in->fp);
+    free(in->plain);
+    free(in);
+    return ok;
+}
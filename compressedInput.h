@@ -0,0 +1,91 @@
+/**
+ * @file compressedInput.h
+ * @brief Header for reading plain or compressed DIMACS input as a stream
+ *        of buffers.
+ */
+
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+/**
+ * @brief Container formats recognized from the first bytes of a file.
+ */
+typedef enum {
+    COMPRESS_NONE,
+    COMPRESS_GZIP,    /**< gzip or zlib (1f 8b) */
+    COMPRESS_XZ,      /**< xz (fd 37 7a 58 5a 00) */
+    COMPRESS_BZIP2,   /**< bzip2 ("BZh") */
+    COMPRESS_ZSTD     /**< zstd (28 b5 2f fd); recognized but not decoded */
+} CompressFormat;
+
+/**
+ * @brief Opaque reader. Compressed input is decoded by a background
+ *        thread into a small ring of buffers that the caller consumes in
+ *        place; plain input is read directly, without a thread.
+ */
+typedef struct CompressedInput CompressedInput;
+
+/**
+ * @brief Identifies the format from the first bytes of a file.
+ */
+CompressFormat detectCompression(const unsigned char *head, size_t n);
+
+/**
+ * @brief Name of a format ("plain", "gzip", "xz", "bzip2", "zstd").
+ */
+const char *compressFormatName(CompressFormat format);
+
+/**
+ * @brief Whether a path names a CNF file: ".cnf", optionally followed by
+ *        ".gz", ".xz" or ".bz2".
+ */
+int isCnfPath(const char *path);
+
+/**
+ * @brief Starts reading an open stream; the format is detected from its
+ *        first bytes. The stream must not be used by the caller until
+ *        compressedClose, which does not close it.
+ * @return Reader, or NULL on an unsupported format or allocation failure
+ *         (reported on stdout).
+ */
+CompressedInput *compressedOpen(FILE *fp);
+
+/**
+ * @brief Opens a file by name and starts reading it; the file is closed
+ *        by compressedClose.
+ * @return Reader, or NULL on error.
+ */
+CompressedInput *compressedOpenFile(const char *path);
+
+/**
+ * @brief Format of the input being read.
+ */
+CompressFormat compressedFormat(const CompressedInput *in);
+
+/**
+ * @brief Hands out the next buffer of decoded bytes; it stays valid until
+ *        the next call.
+ * @param data Output: start of the buffer.
+ * @return Bytes in the buffer, 0 at the end of input or on error.
+ */
+size_t compressedRead(CompressedInput *in, const char **data);
+
+/**
+ * @brief Reads one line, like getline(3).
+ * @return Length of the line including its newline, or -1 at the end of
+ *         input, on error, or on malloc failure.
+ */
+ssize_t compressedGetline(CompressedInput *in, char **line, size_t *cap);
+
+/**
+ * @brief Stops the decoder thread (even before the end of input) and
+ *        frees the reader.
+ * @return 1 if everything read so far was decoded without error, 0 if the
+ *         input was corrupt, truncated or unreadable (reported on stdout).
+ */
+int compressedClose(CompressedInput *in);
+
+#endif
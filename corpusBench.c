@@ -0,0 +1,511 @@
+/**
+ * @file corpusBench.c
+ * @brief Benchmark over the bundled CNF corpus with baseline comparison.
+ *
+ * Runs the selected analyses on a subset of sat-2002-beta (or any
+ * directory or list file), each repetition in a forked child with an
+ * alarm so that one hard instance cannot stall the run or take down the
+ * benchmark. Reports median-of-N timings and peak memory per instance,
+ * totals per family, and the changes against a stored baseline; the
+ * exit status fails when anything regressed, so it can gate changes.
+ * @section algo Algorithm:
+ *   - Per repetition: fork, alarm(timeout), analyze, send times over a pipe
+ *   - Per instance: median of the repetitions, maximum peak RSS
+ *   - Per family (grandparent directory): totals and geometric-mean ratio
+ *   - Baseline: sorted table, binary search per instance; a change counts
+ *     when it exceeds both the relative threshold and the absolute floor
+ * @section time Time Complexity: O(instances × reps × analysis)
+ * @section space Space Complexity: O(instances)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "batchDriver.h"
+#include "cnfFormula.h"
+#include "satSolver.h"
+#include "modelCount.h"
+#include "common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#define MAX_REPS 64
+#define FAMILY_LEN 256
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Benchmark settings.
+ */
+typedef struct {
+    BatchOptions analyses;    /**< Analyses and SAT conflict budget */
+    int reps;                 /**< Repetitions per instance (median taken) */
+    int timeout;              /**< Seconds per repetition */
+    int every;                /**< Keep every k-th instance of the sorted list */
+    int limit;                /**< Stop after this many instances (0: all) */
+    const char *match;        /**< Keep paths containing this text (may be NULL) */
+    const char *baseline;     /**< Baseline to compare against (may be NULL) */
+    const char *save;         /**< Where to write this run as a baseline (may be NULL) */
+    double threshold;         /**< Relative change that counts (0.20 = 20%) */
+    double floor;             /**< Absolute change that counts, seconds */
+} BenchOptions;
+
+/**
+ * @brief What a child reports for one repetition.
+ */
+typedef struct {
+    double parse, sat, count;  /**< Seconds per analysis */
+    int satResult;             /**< SOLVER_* code, or -1 if not run */
+    long rssKb;                /**< Child's peak RSS */
+} RunSample;
+
+typedef enum { RUN_OK, RUN_TIMEOUT, RUN_FAILED } RunStatus;
+
+static const char *statusName[] = { "ok", "timeout", "failed" };
+
+/**
+ * @brief Result of one instance over all repetitions.
+ */
+typedef struct {
+    const char *path;
+    char family[FAMILY_LEN];
+    RunStatus status;
+    double total;              /**< Median seconds of all selected analyses */
+    double parse, sat, count;  /**< Medians per analysis */
+    long rssKb;                /**< Maximum over repetitions */
+    int satResult;
+} InstanceResult;
+
+/* ----- one repetition ----- */
+
+/**
+ * @brief Child side: runs the analyses and writes the sample to fd.
+ */
+static void childRun(const char *path, const BatchOptions *o, int fd) {
+    RunSample s = { 0, 0, 0, -1, -1 };
+    double t0 = nowSeconds();
+    CnfFormula *f = readCnfFormula(path);
+    s.parse = nowSeconds() - t0;
+    if (!f) _exit(2);
+
+    if (o->analyses & BATCH_SAT) {
+        t0 = nowSeconds();
+        Solver *sv = solverFromFormula(f);
+        if (!sv) _exit(2);
+        if (o->conflictBudget > 0) solverSetConflictBudget(sv, o->conflictBudget);
+        s.satResult = solverSolve(sv, NULL, 0);
+        solverFree(sv);
+        s.sat = nowSeconds() - t0;
+    }
+    if (o->analyses & BATCH_COUNT) {
+        t0 = nowSeconds();
+        if (countModels(f) < 0) _exit(2);
+        s.count = nowSeconds() - t0;
+    }
+    freeCnfFormula(f);
+
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) s.rssKb = ru.ru_maxrss;
+    if (write(fd, &s, sizeof(s)) != (ssize_t)sizeof(s)) _exit(2);
+    _exit(0);
+}
+
+/**
+ * @brief Runs one repetition in a child process.
+ * @return RUN_OK with *s filled, RUN_TIMEOUT, or RUN_FAILED.
+ */
+static RunStatus runOnce(const char *path, const BenchOptions *opts, RunSample *s) {
+    int fds[2];
+    if (pipe(fds) != 0) { perror("pipe"); return RUN_FAILED; }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return RUN_FAILED;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm((unsigned)opts->timeout);
+        childRun(path, &opts->analyses, fds[1]);
+    }
+    close(fds[1]);
+    size_t got = 0;
+    while (got < sizeof(*s)) {
+        ssize_t r = read(fds[0], (char*)s + got, sizeof(*s) - got);
+        if (r <= 0) break;
+        got += (size_t)r;
+    }
+    close(fds[0]);
+
+    int wstatus;
+    while (waitpid(pid, &wstatus, 0) < 0) {}
+    if (WIFSIGNALED(wstatus) && WTERMSIG(wstatus) == SIGALRM) return RUN_TIMEOUT;
+    if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0 || got != sizeof(*s)) return RUN_FAILED;
+    return RUN_OK;
+}
+
+static int cmpDouble(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, (size_t)n, sizeof(double), cmpDouble);
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/**
+ * @brief Family of an instance: the directory above its own directory
+ *        (sat-2002-beta/generated/gen-10/gen-10.1/x.cnf -> gen-10).
+ */
+static void familyOf(const char *path, char *family) {
+    const char *end = strrchr(path, '/');
+    const char *start = end;
+    if (end) {
+        while (start > path && start[-1] != '/') start--;   /* own directory */
+        end = start > path ? start - 1 : NULL;
+    }
+    if (!end) {
+        strcpy(family, ".");
+        return;
+    }
+    start = end;
+    while (start > path && start[-1] != '/') start--;
+    size_t len = (size_t)(end - start);
+    if (len == 0 || len >= FAMILY_LEN) len = 0;
+    memcpy(family, start, len);
+    family[len] = '\0';
+    if (len == 0) strcpy(family, ".");
+}
+
+/**
+ * @brief Runs all repetitions of one instance.
+ */
+static void benchInstance(const char *path, const BenchOptions *opts, InstanceResult *r) {
+    double total[MAX_REPS], parse[MAX_REPS], sat[MAX_REPS], count[MAX_REPS];
+    int n = 0;
+    memset(r, 0, sizeof(*r));
+    r->path = path;
+    familyOf(path, r->family);
+    r->status = RUN_OK;
+    r->satResult = -1;
+    for (int rep = 0; rep < opts->reps; rep++) {
+        RunSample s;
+        RunStatus st = runOnce(path, opts, &s);
+        if (st != RUN_OK) {
+            r->status = st;
+            return;
+        }
+        parse[n] = s.parse;
+        sat[n] = s.sat;
+        count[n] = s.count;
+        total[n] = s.parse + s.sat + s.count;
+        n++;
+        if (s.rssKb > r->rssKb) r->rssKb = s.rssKb;
+        r->satResult = s.satResult;
+    }
+    r->total = median(total, n);
+    r->parse = median(parse, n);
+    r->sat = median(sat, n);
+    r->count = median(count, n);
+}
+
+/* ----- baseline ----- */
+
+typedef struct {
+    char *path;
+    RunStatus status;
+    double total;
+    long rssKb;
+} BaselineEntry;
+
+static int cmpBaseline(const void *a, const void *b) {
+    return strcmp(((const BaselineEntry*)a)->path, ((const BaselineEntry*)b)->path);
+}
+
+/**
+ * @brief Reads a baseline written by saveBaseline.
+ * @return Number of entries, or -1 on error.
+ */
+static int loadBaseline(const char *file, BaselineEntry **out) {
+    FILE *fp = fopen(file, "r");
+    if (!fp) { perror(file); return -1; }
+    BaselineEntry *v = NULL;
+    int n = 0, cap = 0;
+    char *line = NULL;
+    size_t lineCap = 0;
+    while (getline(&line, &lineCap, fp) > 0) {
+        if (line[0] == '#') continue;
+        char status[16];
+        double total;
+        long rss;
+        char *tab = strchr(line, '\t');
+        if (!tab || sscanf(tab + 1, "%15s %lf %ld", status, &total, &rss) != 3) continue;
+        *tab = '\0';
+        if (n == cap) {
+            cap = cap ? cap * 2 : 256;
+            BaselineEntry *nv = realloc(v, (size_t)cap * sizeof(BaselineEntry));
+            if (!nv) { perror("realloc"); break; }
+            v = nv;
+        }
+        v[n].path = strdup_s(line);
+        v[n].status = strcmp(status, "ok") == 0 ? RUN_OK : strcmp(status, "timeout") == 0 ? RUN_TIMEOUT : RUN_FAILED;
+        v[n].total = total;
+        v[n].rssKb = rss;
+        if (v[n].path) n++;
+    }
+    free(line);
+    fclose(fp);
+    qsort(v, (size_t)n, sizeof(BaselineEntry), cmpBaseline);
+    *out = v;
+    return n;
+}
+
+/**
+ * @brief Writes the run as a baseline: path, status, median seconds, peak RSS.
+ * @return 1 on success, 0 on error.
+ */
+static int saveBaseline(const char *file, const InstanceResult *res, int n, const BenchOptions *opts) {
+    FILE *fp = fopen(file, "w");
+    if (!fp) { perror(file); return 0; }
+    fprintf(fp, "# corpusbench baseline: analyses mask %d, %d reps, timeout %d s, conflicts %lld\n",
+            opts->analyses.analyses, opts->reps, opts->timeout, opts->analyses.conflictBudget);
+    for (int i = 0; i < n; i++)
+        fprintf(fp, "%s\t%s %.9f %ld\n", res[i].path, statusName[res[i].status], res[i].total, res[i].rssKb);
+    return fclose(fp) == 0;
+}
+
+/* ----- reporting ----- */
+
+/**
+ * @brief Per-family totals.
+ */
+typedef struct {
+    char name[FAMILY_LEN];
+    int instances, solved, timeouts, failed;
+    double seconds;           /**< Sum of medians of instances that finished */
+    long maxRssKb;
+    double logRatioSum;       /**< Sum of log(current/baseline) over compared */
+    int compared;
+} FamilyTotals;
+
+static FamilyTotals *familyFor(FamilyTotals **fam, int *n, int *cap, const char *name) {
+    for (int i = 0; i < *n; i++) {
+        if (strcmp((*fam)[i].name, name) == 0) return &(*fam)[i];
+    }
+    if (*n == *cap) {
+        int ncap = *cap ? *cap * 2 : 32;
+        FamilyTotals *nf = realloc(*fam, (size_t)ncap * sizeof(FamilyTotals));
+        if (!nf) { perror("realloc"); return NULL; }
+        *fam = nf;
+        *cap = ncap;
+    }
+    FamilyTotals *f = &(*fam)[(*n)++];
+    memset(f, 0, sizeof(*f));
+    strcpy(f->name, name);
+    return f;
+}
+
+/**
+ * @brief Compares one instance with its baseline entry.
+ * @return 1 regression, -1 improvement, 0 unchanged.
+ */
+static int classifyChange(const InstanceResult *r, const BaselineEntry *b, const BenchOptions *opts) {
+    if (b->status == RUN_OK && r->status != RUN_OK) return 1;
+    if (b->status != RUN_OK && r->status == RUN_OK) return -1;
+    if (r->status != RUN_OK) return 0;
+    double diff = r->total - b->total;
+    if (diff > opts->floor && r->total > b->total * (1 + opts->threshold)) return 1;
+    if (-diff > opts->floor && b->total > r->total * (1 + opts->threshold)) return -1;
+    return 0;
+}
+
+/**
+ * @brief Prints the family table and, with a baseline, the changes.
+ * @return Number of regressions.
+ */
+static int report(const InstanceResult *res, int n, const BaselineEntry *base, int nBase, const BenchOptions *opts) {
+    FamilyTotals *fam = NULL;
+    int nFam = 0, capFam = 0, regressions = 0, improvements = 0, compared = 0;
+    double logSum = 0;
+
+    if (base) printf("\nChanges against %s (threshold %.0f%%, floor %.3f s):\n",
+                     opts->baseline, opts->threshold * 100, opts->floor);
+    for (int i = 0; i < n; i++) {
+        const InstanceResult *r = &res[i];
+        FamilyTotals *f = familyFor(&fam, &nFam, &capFam, r->family);
+        if (!f) break;
+        f->instances++;
+        if (r->status == RUN_OK) {
+            f->solved++;
+            f->seconds += r->total;
+        } else if (r->status == RUN_TIMEOUT) {
+            f->timeouts++;
+        } else {
+            f->failed++;
+        }
+        if (r->rssKb > f->maxRssKb) f->maxRssKb = r->rssKb;
+
+        if (!base) continue;
+        BaselineEntry key = { (char*)r->path, RUN_OK, 0, 0 };
+        const BaselineEntry *b = bsearch(&key, base, (size_t)nBase, sizeof(BaselineEntry), cmpBaseline);
+        if (!b) continue;
+        if (r->status == RUN_OK && b->status == RUN_OK && r->total > 0 && b->total > 0) {
+            double lr = log(r->total / b->total);
+            f->logRatioSum += lr;
+            f->compared++;
+            logSum += lr;
+            compared++;
+        }
+        int change = classifyChange(r, b, opts);
+        if (change == 0) continue;
+        if (change > 0) regressions++;
+        else improvements++;
+        printf("  %-11s %s: %s %.4f s -> %s %.4f s\n", change > 0 ? "REGRESSION" : "improvement",
+               r->path, statusName[b->status], b->total, statusName[r->status], r->total);
+    }
+
+    printf("\n%-28s %6s %6s %8s %7s %12s %10s%s\n", "family", "inst", "ok", "timeout", "failed",
+           "median sum", "peak KB", base ? "   vs base" : "");
+    for (int i = 0; i < nFam; i++) {
+        const FamilyTotals *f = &fam[i];
+        printf("%-28s %6d %6d %8d %7d %10.4f s %10ld", f->name, f->instances, f->solved,
+               f->timeouts, f->failed, f->seconds, f->maxRssKb);
+        if (base && f->compared) printf("   x%.3f", exp(f->logRatioSum / f->compared));
+        printf("\n");
+    }
+    if (base) {
+        printf("\nCompared %d instances: geometric-mean time ratio x%.3f, %d regressions, %d improvements\n",
+               compared, compared ? exp(logSum / compared) : 1.0, regressions, improvements);
+    }
+    free(fam);
+    return regressions;
+}
+
+/* ----- driver ----- */
+
+static void printBenchUsage(const char *prog) {
+    printf("Usage: %s [options] DIR|LIST|FILE.cnf\n", prog);
+    printf("  --analyses LIST   parse,tautology,sat,count (default parse,sat)\n");
+    printf("  --conflicts N     SAT conflict budget per instance (default none)\n");
+    printf("  --reps N          repetitions per instance, median reported (default 3)\n");
+    printf("  --timeout S       seconds per repetition (default 10)\n");
+    printf("  --every K         keep every K-th instance (default 1)\n");
+    printf("  --limit N         stop after N instances\n");
+    printf("  --match TEXT      keep paths containing TEXT\n");
+    printf("  --baseline FILE   compare against FILE; exit 1 on regressions\n");
+    printf("  --save FILE       write this run as a baseline\n");
+    printf("  --threshold PCT   relative change that counts (default 20)\n");
+    printf("  --floor MS        absolute change that counts (default 10)\n");
+}
+
+static int optionValue(int argc, char *argv[], int *i, double *out) {
+    if (*i + 1 >= argc) {
+        printf("Error: Option '%s' needs a value.\n", argv[*i]);
+        return 0;
+    }
+    char *end;
+    *out = strtod(argv[++*i], &end);
+    if (*end != '\0') {
+        printf("Error: Option '%s' expects a number, got '%s'.\n", argv[*i - 1], argv[*i]);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Entry point of the corpus benchmark.
+ * @return 0 if nothing regressed against the baseline, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    BenchOptions opts = { defaultBatchOptions(), 3, 10, 1, 0, NULL, NULL, NULL, 0.20, 0.010 };
+    const char *input = NULL;
+    for (int i = 1; i < argc; i++) {
+        double v;
+        const char *a = argv[i];
+        if (strcmp(a, "--analyses") == 0 && i + 1 < argc) {
+            if (!parseBatchAnalyses(argv[++i], &opts.analyses.analyses)) return 1;
+        } else if (strcmp(a, "--match") == 0 && i + 1 < argc) {
+            opts.match = argv[++i];
+        } else if (strcmp(a, "--baseline") == 0 && i + 1 < argc) {
+            opts.baseline = argv[++i];
+        } else if (strcmp(a, "--save") == 0 && i + 1 < argc) {
+            opts.save = argv[++i];
+        } else if (strcmp(a, "--conflicts") == 0 || strcmp(a, "--reps") == 0 || strcmp(a, "--timeout") == 0
+                   || strcmp(a, "--every") == 0 || strcmp(a, "--limit") == 0
+                   || strcmp(a, "--threshold") == 0 || strcmp(a, "--floor") == 0) {
+            if (!optionValue(argc, argv, &i, &v)) return 1;
+            if (strcmp(a, "--conflicts") == 0) opts.analyses.conflictBudget = (long long)v;
+            else if (strcmp(a, "--reps") == 0) opts.reps = (int)v;
+            else if (strcmp(a, "--timeout") == 0) opts.timeout = (int)v;
+            else if (strcmp(a, "--every") == 0) opts.every = (int)v;
+            else if (strcmp(a, "--limit") == 0) opts.limit = (int)v;
+            else if (strcmp(a, "--threshold") == 0) opts.threshold = v / 100;
+            else opts.floor = v / 1000;
+        } else if (!input && a[0] != '-') {
+            input = a;
+        } else {
+            printBenchUsage(argv[0]);
+            return strcmp(a, "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (!input) {
+        printBenchUsage(argv[0]);
+        return 1;
+    }
+    if (opts.reps < 1) opts.reps = 1;
+    if (opts.reps > MAX_REPS) opts.reps = MAX_REPS;
+    if (opts.timeout < 1) opts.timeout = 1;
+    if (opts.every < 1) opts.every = 1;
+
+    char **files;
+    int nFiles = collectBatchInputs(input, &files);
+    if (nFiles < 0) return 1;
+    InstanceResult *res = malloc((size_t)(nFiles ? nFiles : 1) * sizeof(InstanceResult));
+    if (!res) { perror("malloc"); return 1; }
+
+    printf("%-70s %-8s %10s %10s %10s %10s %9s\n", "instance", "status", "median s", "parse s",
+           "sat s", "count s", "peak KB");
+    int n = 0, kept = 0, incomplete = 0;
+    double start = nowSeconds();
+    for (int i = 0; i < nFiles; i++) {
+        if (opts.match && !strstr(files[i], opts.match)) continue;
+        if (kept++ % opts.every != 0) continue;
+        if (opts.limit > 0 && n >= opts.limit) break;
+        InstanceResult *r = &res[n++];
+        benchInstance(files[i], &opts, r);
+        if (r->status != RUN_OK) incomplete++;
+        printf("%-70s %-8s %10.4f %10.4f %10.4f %10.4f %9ld%s\n", r->path, statusName[r->status],
+               r->total, r->parse, r->sat, r->count, r->rssKb,
+               r->satResult == SOLVER_SAT ? "  SAT" : r->satResult == SOLVER_UNSAT ? "  UNSAT"
+               : r->satResult == SOLVER_UNKNOWN ? "  UNKNOWN" : "");
+    }
+    printf("\n%d instances, %d timed out or failed, %.1f s wall (%d reps, timeout %d s)\n",
+           n, incomplete, nowSeconds() - start, opts.reps, opts.timeout);
+
+    BaselineEntry *base = NULL;
+    int nBase = 0, status = 0;
+    if (opts.baseline && (nBase = loadBaseline(opts.baseline, &base)) < 0) status = 1;
+    if (report(res, n, base, nBase, &opts) > 0) status = 1;
+    if (opts.save && saveBaseline(opts.save, res, n, &opts))
+        printf("Baseline written to %s\n", opts.save);
+
+    for (int i = 0; i < nBase; i++) free(base[i].path);
+    free(base);
+    for (int i = 0; i < nFiles; i++) free(files[i]);
+    free(files);
+    free(res);
+    return status;
+}
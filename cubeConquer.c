@@ -0,0 +1,474 @@
+/**
+ * @file cubeConquer.c
+ * @brief Cube-and-conquer: lookahead splitting plus parallel CDCL.
+ *
+ * A lookahead pass splits the formula into disjoint cubes (conjunctions
+ * of assumption literals). The cubes are scheduled on a work-stealing
+ * pool; each worker keeps one solver (or one counting engine) and solves
+ * all of its cubes incrementally under assumptions, reusing learned
+ * clauses across cubes.
+ * @section algo Algorithm:
+ *   Step 1: Lookahead. At each node, score candidate variables x by
+ *           (|UP(x)|+1) * (|UP(~x)|+1); failed literals are forced,
+ *           a node where both sides fail is refuted.
+ *   Step 2: Branch on the best variable until the depth limit, the free
+ *           variable limit, or all clauses are satisfied; leaves are cubes.
+ *   Step 3: Conquer. Workers solve cubes; the first SAT cube stops the run.
+ * @section time Time Complexity: O(2^d × k × L) for cube generation
+ *   - d = max depth, k = candidates, L = literal occurrences propagated
+ *   - Conquer phase: exponential in the worst case, divided across cores
+ * @section space Space Complexity: O(W × L + 2^d × d)
+ *   - One solver per worker, cube literals stored flat
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cubeConquer.h"
+#include "satSolver.h"
+#include "unitProp.h"
+#include "modelCount.h"
+#include "workSteal.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Flat list of cubes: cube i is lits[start[i] .. start[i+1]).
+ */
+typedef struct {
+    int *lits;
+    int numLits;
+    int litCap;
+    int *start;
+    int count;
+    int startCap;
+} CubeList;
+
+/**
+ * @brief State of the recursive cube generator.
+ */
+typedef struct {
+    UnitProp *up;
+    const CubeOptions *opt;
+    int *path;           /* decisions and forced literals of the current node */
+    int pathSize;
+    double *score;       /* candidate scratch, per variable */
+    int *cand;
+    CubeList *cubes;
+    int refuted;
+    int ok;
+} CubeGen;
+
+/**
+ * @brief Shared state of the parallel conquer phase.
+ */
+typedef struct {
+    const CnfFormula *f;
+    const CubeList *cubes;
+    int countMode;
+    volatile int stop;
+    pthread_mutex_t lock;
+    int result;
+    int *model;
+    double count;
+    int solved;
+    int unknown;
+    double *cubeSeconds;
+    long long *workerSolved;
+    Solver **solvers;       /* per worker, created on first use */
+    UnitProp **engines;     /* per worker, counting mode */
+} ConquerRun;
+
+typedef struct {
+    ConquerRun *run;
+    int index;
+} CubeTask;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @copydoc defaultCubeOptions
+ */
+CubeOptions defaultCubeOptions(void) {
+    CubeOptions o;
+    o.numThreads = 0;
+    o.maxDepth = 10;
+    o.minFreeVars = 30;
+    o.candidates = 8;
+    o.countModels = 0;
+    return o;
+}
+
+// --- Cube generation ---
+
+/**
+ * @brief Appends the current path as a new cube.
+ */
+static void emitCube(CubeGen *g) {
+    CubeList *cl = g->cubes;
+    if (cl->count + 1 >= cl->startCap) {
+        int ncap = cl->startCap ? cl->startCap * 2 : 256;
+        int *ns = realloc(cl->start, (size_t)ncap * sizeof(int));
+        if (!ns) { perror("realloc"); g->ok = 0; return; }
+        cl->start = ns;
+        cl->startCap = ncap;
+    }
+    if (cl->numLits + g->pathSize > cl->litCap) {
+        int ncap = cl->litCap ? cl->litCap : 1024;
+        while (ncap < cl->numLits + g->pathSize) ncap *= 2;
+        int *nl = realloc(cl->lits, (size_t)ncap * sizeof(int));
+        if (!nl) { perror("realloc"); g->ok = 0; return; }
+        cl->lits = nl;
+        cl->litCap = ncap;
+    }
+    cl->start[cl->count] = cl->numLits;
+    memcpy(cl->lits + cl->numLits, g->path, (size_t)g->pathSize * sizeof(int));
+    cl->numLits += g->pathSize;
+    cl->count++;
+    cl->start[cl->count] = cl->numLits;
+}
+
+/**
+ * @brief Selects up to opt->candidates unassigned variables by weighted
+ *        occurrence in open clauses (short clauses weigh more).
+ * @return Number of candidates written to g->cand.
+ */
+static int preselect(CubeGen *g) {
+    const CnfFormula *f = g->up->f;
+    UnitProp *up = g->up;
+    for (int v = 1; v <= f->numVars; v++) g->score[v] = 0.0;
+
+    for (int c = 0; c < f->numClauses; c++) {
+        if (up->satCount[c] > 0) continue;
+        double w = 1.0 / (double)(1 << (up->freeCount[c] < 16 ? up->freeCount[c] : 16));
+        const int *lits = cnfClause(f, c);
+        for (int k = 0; k < cnfClauseSize(f, c); k++)
+            if (unitPropLitValue(up, lits[k]) < 0) g->score[abs(lits[k])] += w;
+    }
+
+    // Partial selection of the top-k scores
+    int k = 0;
+    for (int v = 1; v <= f->numVars; v++) {
+        if (g->score[v] <= 0.0) continue;
+        if (k < g->opt->candidates) {
+            g->cand[k++] = v;
+        } else {
+            int worst = 0;
+            for (int i = 1; i < k; i++) if (g->score[g->cand[i]] < g->score[g->cand[worst]]) worst = i;
+            if (g->score[v] > g->score[g->cand[worst]]) g->cand[worst] = v;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief Size of the unit-propagation closure of one literal.
+ * @return Number of implied assignments, or -1 if the literal fails.
+ */
+static int lookahead(UnitProp *up, int lit) {
+    int mark = up->trailSize;
+    int ok = unitPropAssign(up, lit) && unitPropPropagate(up);
+    int implied = up->trailSize - mark;
+    unitPropBacktrack(up, mark);
+    return ok ? implied : -1;
+}
+
+/**
+ * @brief Assigns and propagates a literal and records it on the path.
+ * @return 1 on success, 0 on conflict.
+ */
+static int pushPath(CubeGen *g, int lit) {
+    g->path[g->pathSize++] = lit;
+    return unitPropAssign(g->up, lit) && unitPropPropagate(g->up);
+}
+
+/**
+ * @brief Recursively splits the current node into cubes.
+ */
+static void splitNode(CubeGen *g, int depth) {
+    UnitProp *up = g->up;
+    int mark = up->trailSize, pathMark = g->pathSize;
+    int best = 0;
+
+    for (;;) {
+        if (up->numSatisfied == up->f->numClauses || depth >= g->opt->maxDepth ||
+            up->f->numVars - up->trailSize <= g->opt->minFreeVars) {
+            emitCube(g);
+            goto done;
+        }
+
+        int k = preselect(g);
+        if (k == 0) { emitCube(g); goto done; }
+
+        double bestScore = -1.0;
+        int forced = 0;
+        best = 0;
+        for (int i = 0; i < k && !forced; i++) {
+            int v = g->cand[i];
+            int pos = lookahead(up, v);
+            int neg = lookahead(up, -v);
+            if (pos < 0 && neg < 0) {
+                g->refuted++;
+                goto done;
+            }
+            if (pos < 0 || neg < 0) {
+                // Failed literal: the opposite value is implied
+                if (!pushPath(g, pos < 0 ? -v : v)) { g->refuted++; goto done; }
+                forced = 1;
+                break;
+            }
+            double s = (double)(pos + 1) * (double)(neg + 1);
+            if (s > bestScore) { bestScore = s; best = v; }
+        }
+        if (!forced) break;
+    }
+
+    for (int side = 0; side < 2 && g->ok; side++) {
+        int lit = side == 0 ? best : -best;
+        int m = up->trailSize, pm = g->pathSize;
+        if (pushPath(g, lit)) splitNode(g, depth + 1);
+        else g->refuted++;
+        unitPropBacktrack(up, m);
+        g->pathSize = pm;
+    }
+
+done:
+    unitPropBacktrack(up, mark);
+    g->pathSize = pathMark;
+}
+
+/**
+ * @brief Generates the cube list for a formula.
+ * @return 1 on success, 0 on allocation failure.
+ */
+static int generateCubes(const CnfFormula *f, const CubeOptions *opt, CubeList *cubes, int *refuted) {
+    CubeGen g;
+    memset(&g, 0, sizeof(g));
+    g.opt = opt;
+    g.cubes = cubes;
+    g.ok = 1;
+    g.up = unitPropNew(f);
+    g.path = malloc((size_t)(f->numVars + 1) * sizeof(int));
+    g.score = malloc((size_t)(f->numVars + 1) * sizeof(double));
+    g.cand = malloc((size_t)(opt->candidates > 0 ? opt->candidates : 1) * sizeof(int));
+    if (!g.up || !g.path || !g.score || !g.cand) {
+        perror("malloc");
+        g.ok = 0;
+    } else if (unitPropPropagate(g.up)) {
+        splitNode(&g, 0);
+    } else {
+        g.refuted = 1;
+    }
+    *refuted = g.refuted;
+    unitPropFree(g.up);
+    free(g.path);
+    free(g.score);
+    free(g.cand);
+    return g.ok;
+}
+
+// --- Conquer phase ---
+
+/**
+ * @brief Worker task: solve or count one cube.
+ */
+static void solveCubeTask(void *arg, int worker) {
+    CubeTask *t = arg;
+    ConquerRun *run = t->run;
+    if (run->stop) return;
+
+    const CubeList *cl = run->cubes;
+    const int *cube = cl->lits + cl->start[t->index];
+    int n = cl->start[t->index + 1] - cl->start[t->index];
+    double t0 = nowSeconds();
+
+    if (run->countMode) {
+        if (!run->engines[worker]) {
+            run->engines[worker] = unitPropNew(run->f);
+            if (run->engines[worker]) unitPropPropagate(run->engines[worker]);
+        }
+        double c = run->engines[worker] ? countModelsUnder(run->engines[worker], cube, n) : -1.0;
+        pthread_mutex_lock(&run->lock);
+        if (c < 0) run->unknown++;
+        else run->count += c;
+        run->solved++;
+        pthread_mutex_unlock(&run->lock);
+    } else {
+        if (!run->solvers[worker]) {
+            run->solvers[worker] = solverFromFormula(run->f);
+            if (run->solvers[worker]) solverSetInterrupt(run->solvers[worker], &run->stop);
+        }
+        Solver *s = run->solvers[worker];
+        int res = s ? solverSolve(s, cube, n) : SOLVER_UNKNOWN;
+        pthread_mutex_lock(&run->lock);
+        run->solved++;
+        if (res == SOLVER_SAT && run->result != SOLVER_SAT) {
+            run->result = SOLVER_SAT;
+            for (int v = 1; v <= run->f->numVars; v++) run->model[v] = solverModelValue(s, v);
+            run->stop = 1;
+        } else if (res == SOLVER_UNKNOWN && !run->stop) {
+            run->unknown++;
+        }
+        pthread_mutex_unlock(&run->lock);
+    }
+    run->cubeSeconds[t->index] = nowSeconds() - t0;
+    run->workerSolved[worker]++;
+}
+
+/**
+ * @copydoc cubeAndConquer
+ */
+int cubeAndConquer(const CnfFormula *f, const CubeOptions *opt, CubeReport *report) {
+    memset(report, 0, sizeof(*report));
+    report->result = SOLVER_UNKNOWN;
+
+    CubeList cubes;
+    memset(&cubes, 0, sizeof(cubes));
+    double t0 = nowSeconds();
+    if (!generateCubes(f, opt, &cubes, &report->refutedByLookahead)) {
+        free(cubes.lits);
+        free(cubes.start);
+        return 0;
+    }
+    report->generateSeconds = nowSeconds() - t0;
+    report->numCubes = cubes.count;
+
+    WsPool *pool = cubes.count > 0 ? wsPoolCreate(opt->numThreads) : NULL;
+    int workers = pool ? wsPoolNumWorkers(pool) : 0;
+
+    ConquerRun run;
+    memset(&run, 0, sizeof(run));
+    run.f = f;
+    run.cubes = &cubes;
+    run.countMode = opt->countModels;
+    run.result = SOLVER_UNSAT;
+    pthread_mutex_init(&run.lock, NULL);
+    run.model = calloc((size_t)(f->numVars + 1), sizeof(int));
+    run.cubeSeconds = calloc((size_t)(cubes.count + 1), sizeof(double));
+    run.workerSolved = calloc((size_t)(workers + 1), sizeof(long long));
+    run.solvers = calloc((size_t)(workers + 1), sizeof(Solver*));
+    run.engines = calloc((size_t)(workers + 1), sizeof(UnitProp*));
+    CubeTask *tasks = malloc((size_t)(cubes.count + 1) * sizeof(CubeTask));
+    int ok = run.model && run.cubeSeconds && run.workerSolved && run.solvers && run.engines && tasks &&
+             (pool || cubes.count == 0);
+
+    if (ok) {
+        // Contiguous blocks per worker keep related cubes (shared prefixes)
+        // on one solver; stealing rebalances whatever is left over.
+        t0 = nowSeconds();
+        for (int i = 0; i < cubes.count; i++) {
+            tasks[i].run = &run;
+            tasks[i].index = i;
+            wsPoolSubmit(pool, (int)((long long)i * workers / cubes.count), solveCubeTask, &tasks[i]);
+        }
+        if (pool) wsPoolWait(pool);
+        report->solveSeconds = nowSeconds() - t0;
+
+        if (run.countMode) {
+            report->modelCount = run.count;
+            report->result = run.unknown ? SOLVER_UNKNOWN : (run.count > 0 ? SOLVER_SAT : SOLVER_UNSAT);
+        } else if (run.result == SOLVER_SAT) {
+            report->result = SOLVER_SAT;
+            report->model = run.model;
+            run.model = NULL;
+        } else {
+            report->result = run.unknown ? SOLVER_UNKNOWN : SOLVER_UNSAT;
+        }
+        report->cubesSolved = run.solved;
+
+        int timed = 0;
+        double sum = 0.0;
+        report->minCubeSeconds = 0.0;
+        for (int i = 0; i < cubes.count; i++) {
+            double s = run.cubeSeconds[i];
+            if (s <= 0.0) continue;
+            if (timed == 0 || s < report->minCubeSeconds) report->minCubeSeconds = s;
+            if (s > report->maxCubeSeconds) report->maxCubeSeconds = s;
+            sum += s;
+            timed++;
+        }
+        report->meanCubeSeconds = timed ? sum / timed : 0.0;
+
+        report->numWorkers = workers;
+        report->workerBusy = calloc((size_t)(workers + 1), sizeof(double));
+        report->workerCubes = calloc((size_t)(workers + 1), sizeof(long long));
+        report->workerSteals = calloc((size_t)(workers + 1), sizeof(long long));
+        if (report->workerBusy && report->workerCubes && report->workerSteals) {
+            for (int w = 0; w < workers; w++) {
+                WsWorkerStats st = wsPoolWorkerStats(pool, w);
+                report->workerBusy[w] = st.busySeconds;
+                report->workerCubes[w] = run.workerSolved[w];
+                report->workerSteals[w] = st.steals;
+            }
+        } else {
+            report->numWorkers = 0;
+        }
+    }
+
+    wsPoolDestroy(pool);
+    for (int w = 0; w < workers; w++) {
+        solverFree(run.solvers[w]);
+        unitPropFree(run.engines[w]);
+    }
+    pthread_mutex_destroy(&run.lock);
+    free(run.model);
+    free(run.cubeSeconds);
+    free(run.workerSolved);
+    free(run.solvers);
+    free(run.engines);
+    free(tasks);
+    free(cubes.lits);
+    free(cubes.start);
+    return ok;
+}
+
+/**
+ * @copydoc printCubeReport
+ */
+void printCubeReport(const CubeReport *r, int countMode) {
+    const char *res = r->result == SOLVER_SAT ? "SATISFIABLE" :
+                      r->result == SOLVER_UNSAT ? "UNSATISFIABLE" : "UNKNOWN";
+    printf("Result: %s\n", res);
+    if (countMode) printf("Model count: %.0f\n", r->modelCount);
+
+    printf("Cubes: %d (refuted by lookahead: %d, solved: %d)\n",
+           r->numCubes, r->refutedByLookahead, r->cubesSolved);
+    printf("Cube generation time: %f seconds\n", r->generateSeconds);
+    printf("Conquer time: %f seconds\n", r->solveSeconds);
+    printf("Cube time min/mean/max: %f / %f / %f seconds\n",
+           r->minCubeSeconds, r->meanCubeSeconds, r->maxCubeSeconds);
+
+    double totalBusy = 0.0, maxBusy = 0.0;
+    for (int w = 0; w < r->numWorkers; w++) {
+        totalBusy += r->workerBusy[w];
+        if (r->workerBusy[w] > maxBusy) maxBusy = r->workerBusy[w];
+    }
+    if (r->numWorkers > 0 && totalBusy > 0.0)
+        printf("Balance (max/mean worker busy time): %.2f\n", maxBusy / (totalBusy / r->numWorkers));
+
+    for (int w = 0; w < r->numWorkers; w++) {
+        double util = r->solveSeconds > 0.0 ? 100.0 * r->workerBusy[w] / r->solveSeconds : 0.0;
+        printf("  Worker %d: %lld cubes, %lld stolen, busy %f s, utilization %.1f%%\n",
+               w, r->workerCubes[w], r->workerSteals[w], r->workerBusy[w], util);
+    }
+}
+
+/**
+ * @copydoc freeCubeReport
+ */
+void freeCubeReport(CubeReport *r) {
+    free(r->model);
+    free(r->workerBusy);
+    free(r->workerCubes);
+    free(r->workerSteals);
+    r->model = NULL;
+    r->workerBusy = NULL;
+    r->workerCubes = NULL;
+    r->workerSteals = NULL;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file cubeConquer.h
+ * @brief Header for cube-and-conquer parallel solving and counting.
+ */
+
+#ifndef CUBE_CONQUER_H
+#define CUBE_CONQUER_H
+
+#include "cnfFormula.h"
+
+/**
+ * @brief Tuning knobs for cube-and-conquer.
+ */
+typedef struct {
+    int numThreads;      /**< Worker threads (< 1: one per core) */
+    int maxDepth;        /**< Maximum decisions per cube */
+    int minFreeVars;     /**< Stop splitting once this few variables remain */
+    int candidates;      /**< Variables scored by lookahead at each split */
+    int countModels;     /**< Non-zero: count models instead of deciding SAT */
+} CubeOptions;
+
+/**
+ * @brief Outcome and scheduling statistics of a cube-and-conquer run.
+ */
+typedef struct {
+    int result;              /**< SOLVER_SAT, SOLVER_UNSAT or SOLVER_UNKNOWN */
+    double modelCount;       /**< Sum of per-cube counts (countModels mode) */
+    int *model;              /**< Satisfying assignment, 1-based, when SAT */
+    int numCubes;            /**< Cubes handed to the workers */
+    int refutedByLookahead;  /**< Branches closed while generating cubes */
+    int cubesSolved;         /**< Cubes actually solved (SAT stops early) */
+    double generateSeconds;  /**< Time spent generating cubes */
+    double solveSeconds;     /**< Wall time of the parallel phase */
+    double minCubeSeconds;   /**< Fastest cube */
+    double maxCubeSeconds;   /**< Slowest cube */
+    double meanCubeSeconds;  /**< Average cube */
+    int numWorkers;
+    double *workerBusy;      /**< Per-worker busy seconds */
+    long long *workerCubes;  /**< Per-worker cubes solved */
+    long long *workerSteals; /**< Per-worker cubes stolen from others */
+} CubeReport;
+
+/**
+ * @brief Default options: one thread per core, cubes of at most 10
+ *        decisions, no splitting once 30 or fewer variables are free,
+ *        8 candidates, solving rather than counting.
+ */
+CubeOptions defaultCubeOptions(void);
+
+/**
+ * @brief Splits a formula into cubes and solves (or counts) them in parallel.
+ *
+ * Results are combined as: any SAT cube gives SAT, all cubes UNSAT gives
+ * UNSAT. Cubes are disjoint, so model counts add up exactly.
+ *
+ * @param f Parsed CNF formula.
+ * @param opt Options.
+ * @param report Output report; release with freeCubeReport.
+ * @return 1 on success, 0 on allocation failure.
+ */
+int cubeAndConquer(const CnfFormula *f, const CubeOptions *opt, CubeReport *report);
+
+/**
+ * @brief Prints a human-readable summary of a report.
+ */
+void printCubeReport(const CubeReport *r, int countMode);
+
+/**
+ * @brief Frees arrays held by a report.
+ */
+void freeCubeReport(CubeReport *r);
+
+#endif
@@ -0,0 +1,915 @@
+/**
+ * @file dnnf.c
+ * @brief Knowledge compilation of clause sets into decision-DNNF.
+ *
+ * A run of related questions over one clause set (how many models with
+ * these inputs fixed, which literals follow from them) otherwise costs a
+ * search per question. Compiling once into a decision-DNNF circuit moves
+ * the search up front: afterwards conditioning, counting and entailment
+ * are single passes over the node array.
+ * @section algo Algorithm: exhaustive DPLL tracing (as in c2d / Dsharp)
+ *   - Propagation: the counter-based engine of unitProp.c; literals it
+ *     implies become literal nodes of the branch
+ *   - Decomposition: the open clauses of a branch are split into
+ *     variable-disjoint components, compiled independently and joined by
+ *     a decomposable AND node
+ *   - Branching: the variable with most free occurrences in the component
+ *     becomes a decision node over the two sub-circuits
+ *   - Caching: a component is determined by its variables and clause ids
+ *     (every other literal of its clauses is false), so that key maps to
+ *     the node already compiled for it
+ *   - Smoothing: variables a branch no longer constrains are collected in
+ *     a FREE node, so both branches of every decision mention the same
+ *     variables and model counts need no correction
+ * @section time Time Complexity: compilation O(2^n) worst case, linear in
+ *   the circuit times propagation cost per node; every query O(circuit)
+ * @section space Space Complexity: O(circuit + cached component keys)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "dnnf.h"
+#include "unitProp.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+
+#define FALSE_NODE 0
+#define TRUE_NODE 1
+#define LINE_MAX_LEN 65536
+
+static const char dnnfMagic[8] = { 'L', 'O', 'G', 'I', 'C', 'D', 'N', '1' };
+
+/**
+ * @brief Layout of the start of a saved circuit; the nodes and then the
+ *        child array follow.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t byteOrder;     /**< 0x01020304 as written */
+    int32_t numVars;
+    int32_t numNodes;
+    int32_t root;
+    int64_t numKids;
+} DnnfFileHeader;
+
+/**
+ * @brief A connected set of open clauses under the current assignment.
+ */
+typedef struct {
+    int *vars;          /**< Free variables, ascending */
+    int numVars;
+    int *clauses;       /**< Clause ids, ascending */
+    int numClauses;
+    int branchVar;      /**< Variable with most free occurrences */
+} Component;
+
+/**
+ * @brief Component cache entry; node < 0 marks an empty slot.
+ */
+typedef struct {
+    uint64_t hash;
+    long key;           /**< Offset of {numVars, numClauses, vars, clauses} in pool */
+    int node;
+} CacheSlot;
+
+/**
+ * @brief State of one compilation.
+ */
+typedef struct {
+    UnitProp *up;
+    Dnnf *d;
+    long maxNodes;
+    int failed;             /**< 1: out of memory, 2: node limit */
+    int *litNode;           /**< Literal node by literal index, -1 until built */
+    int *varStamp;
+    int varEpoch;
+    int *clauseStamp;
+    int clauseEpoch;
+    int *score;             /**< Free occurrences within the component being built */
+    int *varBuf;
+    int *clauseBuf;
+    CacheSlot *slots;
+    long slotCap;
+    long slotCount;
+    int *pool;
+    long poolSize;
+    long poolCap;
+    DnnfCompileStats st;
+} Compiler;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int litIndex(int lit) {
+    return lit > 0 ? 2 * lit : 2 * (-lit) + 1;
+}
+
+/**
+ * @brief Allocates a circuit holding only the FALSE and TRUE nodes.
+ */
+static Dnnf *newDnnf(int numVars) {
+    Dnnf *d = calloc(1, sizeof(Dnnf));
+    if (!d) { perror("calloc"); return NULL; }
+    d->numVars = numVars;
+    d->nodeCap = 1024;
+    d->kidCap = 1024;
+    d->nodes = malloc((size_t)d->nodeCap * sizeof(DnnfNode));
+    d->kids = malloc((size_t)d->kidCap * sizeof(int));
+    if (!d->nodes || !d->kids) {
+        perror("malloc");
+        freeDnnf(d);
+        return NULL;
+    }
+    d->nodes[FALSE_NODE] = (DnnfNode){ DNNF_FALSE, 0, 0, 0 };
+    d->nodes[TRUE_NODE] = (DnnfNode){ DNNF_TRUE, 0, 0, 0 };
+    d->numNodes = 2;
+    d->root = FALSE_NODE;
+    return d;
+}
+
+/**
+ * @copydoc freeDnnf
+ */
+void freeDnnf(Dnnf *d) {
+    if (!d) return;
+    free(d->nodes);
+    free(d->kids);
+    free(d);
+}
+
+/**
+ * @brief Appends a node.
+ * @return Its id, or -1 on malloc failure.
+ */
+static int pushNode(Dnnf *d, int kind, int a, int b, int c) {
+    if (d->numNodes == d->nodeCap) {
+        if (d->nodeCap > INT_MAX / 2) return -1;
+        DnnfNode *nn = realloc(d->nodes, (size_t)d->nodeCap * 2 * sizeof(DnnfNode));
+        if (!nn) { perror("realloc"); return -1; }
+        d->nodes = nn;
+        d->nodeCap *= 2;
+    }
+    d->nodes[d->numNodes] = (DnnfNode){ kind, a, b, c };
+    return d->numNodes++;
+}
+
+/**
+ * @brief Appends an AND or FREE node over n entries of the child array.
+ * @return Its id, or -1 on malloc failure.
+ */
+static int pushListNode(Dnnf *d, int kind, const int *items, int n) {
+    if (d->numKids + n > INT_MAX) return -1;
+    if (d->numKids + n > d->kidCap) {
+        long ncap = d->kidCap * 2;
+        while (ncap < d->numKids + n) ncap *= 2;
+        int *nk = realloc(d->kids, (size_t)ncap * sizeof(int));
+        if (!nk) { perror("realloc"); return -1; }
+        d->kids = nk;
+        d->kidCap = ncap;
+    }
+    memcpy(d->kids + d->numKids, items, (size_t)n * sizeof(int));
+    int id = pushNode(d, kind, (int)d->numKids, n, 0);
+    if (id >= 0) d->numKids += n;
+    return id;
+}
+
+/* ---- Compilation ---- */
+
+/**
+ * @brief Adds a node unless the compilation has failed or hit its limit.
+ * @return Node id (FALSE_NODE once failed).
+ */
+static int compilerNode(Compiler *cp, int kind, int a, int b, int c, const int *items) {
+    if (cp->failed) return FALSE_NODE;
+    if (cp->maxNodes > 0 && cp->d->numNodes >= cp->maxNodes) {
+        cp->failed = 2;
+        return FALSE_NODE;
+    }
+    int id = items ? pushListNode(cp->d, kind, items, b) : pushNode(cp->d, kind, a, b, c);
+    if (id < 0) {
+        cp->failed = 1;
+        return FALSE_NODE;
+    }
+    return id;
+}
+
+static int literalNode(Compiler *cp, int lit) {
+    int *slot = &cp->litNode[litIndex(lit)];
+    if (*slot < 0) *slot = compilerNode(cp, DNNF_LIT, lit, 0, 0, NULL);
+    return *slot;
+}
+
+static int cmpInt(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void freeComponents(Component *comps, int n) {
+    for (int i = 0; i < n; i++) {
+        free(comps[i].vars);
+        free(comps[i].clauses);
+    }
+    free(comps);
+}
+
+/**
+ * @brief Splits the open clauses among the given ones into connected
+ *        components over their free variables.
+ * @param out Output: components (free with freeComponents).
+ * @return Number of components, or -1 on malloc failure.
+ */
+static int findComponents(Compiler *cp, const int *clauses, int nc, Component **out) {
+    UnitProp *up = cp->up;
+    const CnfFormula *f = up->f;
+    int active = ++cp->clauseEpoch, visited = ++cp->clauseEpoch;
+    int varSeen = ++cp->varEpoch;
+    for (int i = 0; i < nc; i++)
+        if (up->satCount[clauses[i]] == 0) cp->clauseStamp[clauses[i]] = active;
+
+    Component *comps = NULL;
+    int count = 0, cap = 0;
+    for (int i = 0; i < nc; i++) {
+        if (cp->clauseStamp[clauses[i]] != active) continue;
+        int nClauses = 0, nVars = 0;
+        cp->clauseStamp[clauses[i]] = visited;
+        cp->clauseBuf[nClauses++] = clauses[i];
+        for (int q = 0; q < nClauses; q++) {
+            int c = cp->clauseBuf[q];
+            const int *lits = cnfClause(f, c);
+            for (int k = 0; k < cnfClauseSize(f, c); k++) {
+                if (unitPropLitValue(up, lits[k]) >= 0) continue;
+                int v = abs(lits[k]);
+                cp->score[v] = cp->varStamp[v] == varSeen ? cp->score[v] + 1 : 1;
+                if (cp->varStamp[v] == varSeen) continue;
+                cp->varStamp[v] = varSeen;
+                cp->varBuf[nVars++] = v;
+                for (int sign = 0; sign < 2; sign++) {
+                    int li = litIndex(sign ? -v : v);
+                    for (int o = up->occStart[li]; o < up->occStart[li + 1]; o++) {
+                        int oc = up->occ[o];
+                        if (cp->clauseStamp[oc] != active) continue;
+                        cp->clauseStamp[oc] = visited;
+                        cp->clauseBuf[nClauses++] = oc;
+                    }
+                }
+            }
+        }
+
+        if (count == cap) {
+            int ncap = cap ? cap * 2 : 4;
+            Component *nc2 = realloc(comps, (size_t)ncap * sizeof(Component));
+            if (!nc2) { perror("realloc"); freeComponents(comps, count); return -1; }
+            comps = nc2;
+            cap = ncap;
+        }
+        Component *comp = &comps[count];
+        comp->vars = malloc((size_t)nVars * sizeof(int));
+        comp->clauses = malloc((size_t)nClauses * sizeof(int));
+        if (!comp->vars || !comp->clauses) {
+            perror("malloc");
+            free(comp->vars);
+            free(comp->clauses);
+            freeComponents(comps, count);
+            return -1;
+        }
+        count++;
+        int best = cp->varBuf[0];
+        for (int k = 1; k < nVars; k++) {
+            int v = cp->varBuf[k];
+            if (cp->score[v] > cp->score[best] || (cp->score[v] == cp->score[best] && v < best)) best = v;
+        }
+        memcpy(comp->vars, cp->varBuf, (size_t)nVars * sizeof(int));
+        memcpy(comp->clauses, cp->clauseBuf, (size_t)nClauses * sizeof(int));
+        qsort(comp->vars, (size_t)nVars, sizeof(int), cmpInt);
+        qsort(comp->clauses, (size_t)nClauses, sizeof(int), cmpInt);
+        comp->numVars = nVars;
+        comp->numClauses = nClauses;
+        comp->branchVar = best;
+    }
+    *out = comps;
+    return count;
+}
+
+static uint64_t hashComponent(const Component *c) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (uint64_t)c->numVars;
+    for (int i = 0; i < c->numVars; i++) h = (h ^ (uint64_t)c->vars[i]) * 0x100000001b3ULL;
+    h ^= (uint64_t)c->numClauses << 32;
+    for (int i = 0; i < c->numClauses; i++) h = (h ^ (uint64_t)c->clauses[i]) * 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+static int keyMatches(const Compiler *cp, long key, const Component *c) {
+    const int *k = cp->pool + key;
+    return k[0] == c->numVars && k[1] == c->numClauses &&
+           memcmp(k + 2, c->vars, (size_t)c->numVars * sizeof(int)) == 0 &&
+           memcmp(k + 2 + c->numVars, c->clauses, (size_t)c->numClauses * sizeof(int)) == 0;
+}
+
+/**
+ * @return Cached node of the component, or -1.
+ */
+static int cacheFind(const Compiler *cp, const Component *c, uint64_t h) {
+    if (!cp->slots) return -1;
+    for (long i = (long)(h & (uint64_t)(cp->slotCap - 1));; i = (i + 1) & (cp->slotCap - 1)) {
+        const CacheSlot *s = &cp->slots[i];
+        if (s->node < 0) return -1;
+        if (s->hash == h && keyMatches(cp, s->key, c)) return s->node;
+    }
+}
+
+static int cacheGrow(Compiler *cp) {
+    long ncap = cp->slotCap ? cp->slotCap * 2 : 4096;
+    CacheSlot *ns = malloc((size_t)ncap * sizeof(CacheSlot));
+    if (!ns) { perror("malloc"); return 0; }
+    for (long i = 0; i < ncap; i++) ns[i].node = -1;
+    for (long i = 0; i < cp->slotCap; i++) {
+        if (cp->slots[i].node < 0) continue;
+        long j = (long)(cp->slots[i].hash & (uint64_t)(ncap - 1));
+        while (ns[j].node >= 0) j = (j + 1) & (ncap - 1);
+        ns[j] = cp->slots[i];
+    }
+    free(cp->slots);
+    cp->slots = ns;
+    cp->slotCap = ncap;
+    return 1;
+}
+
+/**
+ * @brief Remembers the node of a component (a failed insert only costs
+ *        recompilation, so it is not an error).
+ */
+static void cacheInsert(Compiler *cp, const Component *c, uint64_t h, int node) {
+    if (2 * (cp->slotCount + 1) > cp->slotCap && !cacheGrow(cp)) return;
+    long need = 2L + c->numVars + c->numClauses;
+    if (cp->poolSize + need > cp->poolCap) {
+        long ncap = cp->poolCap ? cp->poolCap * 2 : 65536;
+        while (ncap < cp->poolSize + need) ncap *= 2;
+        int *np = realloc(cp->pool, (size_t)ncap * sizeof(int));
+        if (!np) { perror("realloc"); return; }
+        cp->pool = np;
+        cp->poolCap = ncap;
+    }
+    int *k = cp->pool + cp->poolSize;
+    k[0] = c->numVars;
+    k[1] = c->numClauses;
+    memcpy(k + 2, c->vars, (size_t)c->numVars * sizeof(int));
+    memcpy(k + 2 + c->numVars, c->clauses, (size_t)c->numClauses * sizeof(int));
+
+    long i = (long)(h & (uint64_t)(cp->slotCap - 1));
+    while (cp->slots[i].node >= 0) i = (i + 1) & (cp->slotCap - 1);
+    cp->slots[i] = (CacheSlot){ h, cp->poolSize, node };
+    cp->slotCount++;
+    cp->poolSize += need;
+    cp->st.cacheInts += need;
+}
+
+static int compileComponent(Compiler *cp, const Component *comp);
+
+/**
+ * @brief Compiles the residual of a scope after deciding lit (0: no
+ *        decision, the root): implied literals, unconstrained variables
+ *        and the components of the remaining open clauses, conjoined.
+ * @param scope Variables the result must mention.
+ * @param clauses Clauses that may still be open.
+ */
+static int compileBranch(Compiler *cp, const int *scope, int nScope, const int *clauses, int nc, int lit) {
+    UnitProp *up = cp->up;
+    int mark = lit ? up->trailSize : 0;
+    if (cp->failed) return FALSE_NODE;
+    if ((lit && !unitPropAssign(up, lit)) || !unitPropPropagate(up)) {
+        unitPropBacktrack(up, mark);
+        return FALSE_NODE;
+    }
+
+    Component *subs = NULL;
+    int ns = findComponents(cp, clauses, nc, &subs);
+    int *kids = ns < 0 ? NULL : malloc((size_t)(up->trailSize - mark + ns + 1) * sizeof(int));
+    if (!kids) {
+        if (ns >= 0) perror("malloc");
+        cp->failed = 1;
+        freeComponents(subs, ns < 0 ? 0 : ns);
+        unitPropBacktrack(up, mark);
+        return FALSE_NODE;
+    }
+
+    /* Literal nodes and the FREE node are built before recursing, while
+       varStamp and varBuf still belong to this branch. */
+    int nk = 0, epoch = ++cp->varEpoch;
+    if (lit) cp->varStamp[abs(lit)] = epoch;
+    for (int t = mark; t < up->trailSize; t++) {
+        if (up->trail[t] == lit) continue;
+        cp->varStamp[abs(up->trail[t])] = epoch;
+        kids[nk++] = literalNode(cp, up->trail[t]);
+    }
+    for (int s = 0; s < ns; s++)
+        for (int k = 0; k < subs[s].numVars; k++) cp->varStamp[subs[s].vars[k]] = epoch;
+    int nFree = 0;
+    for (int k = 0; k < nScope; k++)
+        if (cp->varStamp[scope[k]] != epoch) cp->varBuf[nFree++] = scope[k];
+    if (nFree) kids[nk++] = compilerNode(cp, DNNF_FREE, 0, nFree, 0, cp->varBuf);
+
+    int result = -1;
+    for (int s = 0; s < ns && result < 0; s++) {
+        int child = compileComponent(cp, &subs[s]);
+        if (child == FALSE_NODE) result = FALSE_NODE;
+        else if (child != TRUE_NODE) kids[nk++] = child;
+    }
+    if (result < 0)
+        result = nk == 0 ? TRUE_NODE : nk == 1 ? kids[0] : compilerNode(cp, DNNF_AND, 0, nk, 0, kids);
+
+    free(kids);
+    freeComponents(subs, ns);
+    unitPropBacktrack(up, mark);
+    return cp->failed ? FALSE_NODE : result;
+}
+
+/**
+ * @brief Compiles a component into a decision node, or finds it cached.
+ */
+static int compileComponent(Compiler *cp, const Component *comp) {
+    uint64_t h = hashComponent(comp);
+    int node = cacheFind(cp, comp, h);
+    if (node >= 0) {
+        cp->st.cacheHits++;
+        return node;
+    }
+    cp->st.components++;
+    int x = comp->branchVar;
+    int hi = compileBranch(cp, comp->vars, comp->numVars, comp->clauses, comp->numClauses, x);
+    int lo = compileBranch(cp, comp->vars, comp->numVars, comp->clauses, comp->numClauses, -x);
+    if (cp->failed) return FALSE_NODE;
+    node = FALSE_NODE;
+    if (hi != FALSE_NODE || lo != FALSE_NODE) {
+        node = compilerNode(cp, DNNF_DECISION, x, hi, lo, NULL);
+        cp->st.decisions++;
+    }
+    if (!cp->failed) cacheInsert(cp, comp, h, node);
+    return node;
+}
+
+/**
+ * @copydoc compileDnnf
+ */
+Dnnf *compileDnnf(const CnfFormula *f, long maxNodes, DnnfCompileStats *st) {
+    Compiler cp;
+    memset(&cp, 0, sizeof(cp));
+    cp.maxNodes = maxNodes;
+    int n = f->numVars;
+    cp.d = newDnnf(n);
+    cp.up = cp.d ? unitPropNew(f) : NULL;
+    cp.litNode = malloc((size_t)(2 * n + 2) * sizeof(int));
+    cp.varStamp = calloc((size_t)n + 1, sizeof(int));
+    cp.score = calloc((size_t)n + 1, sizeof(int));
+    cp.varBuf = malloc(((size_t)n + 1) * sizeof(int));
+    cp.clauseStamp = calloc((size_t)f->numClauses + 1, sizeof(int));
+    cp.clauseBuf = malloc(((size_t)f->numClauses + 1) * sizeof(int));
+    int *all = malloc(((size_t)(n > f->numClauses ? n : f->numClauses) + 1) * sizeof(int));
+    int *allVars = malloc(((size_t)n + 1) * sizeof(int));
+
+    if (!cp.d || !cp.up || !cp.litNode || !cp.varStamp || !cp.score || !cp.varBuf ||
+        !cp.clauseStamp || !cp.clauseBuf || !all || !allVars) {
+        perror("malloc");
+        cp.failed = 1;
+    } else {
+        for (int i = 0; i < 2 * n + 2; i++) cp.litNode[i] = -1;
+        for (int c = 0; c < f->numClauses; c++) all[c] = c;
+        for (int v = 1; v <= n; v++) allVars[v - 1] = v;
+        cp.d->root = cp.up->rootConflict ? FALSE_NODE
+                                         : compileBranch(&cp, allVars, n, all, f->numClauses, 0);
+    }
+
+    if (cp.failed == 2) printf("Error: Circuit exceeds %ld nodes.\n", maxNodes);
+    else if (cp.failed) printf("Error: Out of memory while compiling the circuit.\n");
+    if (st) *st = cp.st;
+    if (cp.up) unitPropFree(cp.up);
+    free(cp.litNode);
+    free(cp.varStamp);
+    free(cp.score);
+    free(cp.varBuf);
+    free(cp.clauseStamp);
+    free(cp.clauseBuf);
+    free(cp.slots);
+    free(cp.pool);
+    free(all);
+    free(allVars);
+    if (cp.failed) {
+        freeDnnf(cp.d);
+        return NULL;
+    }
+    return cp.d;
+}
+
+/* ---- Queries ---- */
+
+/**
+ * @brief Literal weights of an assumption set: allowed[litIndex(l)] is 0
+ *        iff the assumptions contain the negation of l.
+ * @return Array of 2*numVars+2 flags, or NULL on malloc failure or a
+ *         variable outside the circuit (reported).
+ */
+static unsigned char *allowedLiterals(const Dnnf *d, const int *lits, int n) {
+    unsigned char *w = malloc((size_t)(2 * d->numVars + 2));
+    if (!w) { perror("malloc"); return NULL; }
+    memset(w, 1, (size_t)(2 * d->numVars + 2));
+    for (int i = 0; i < n; i++) {
+        if (lits[i] == 0 || abs(lits[i]) > d->numVars) {
+            printf("Error: Literal %d is outside the circuit's %d variables.\n", lits[i], d->numVars);
+            free(w);
+            return NULL;
+        }
+        w[litIndex(-lits[i])] = 0;
+    }
+    return w;
+}
+
+/**
+ * @copydoc dnnfCount
+ */
+double dnnfCount(const Dnnf *d, const int *assumptions, int n) {
+    unsigned char *w = allowedLiterals(d, assumptions, n);
+    double *val = malloc((size_t)d->numNodes * sizeof(double));
+    if (!w || !val) {
+        if (w) perror("malloc");
+        free(w);
+        free(val);
+        return -1;
+    }
+    for (int i = 0; i < d->numNodes; i++) {
+        const DnnfNode *nd = &d->nodes[i];
+        double x = 1.0;
+        switch (nd->kind) {
+        case DNNF_FALSE: x = 0.0; break;
+        case DNNF_TRUE: break;
+        case DNNF_LIT: x = w[litIndex(nd->a)]; break;
+        case DNNF_AND:
+            for (int k = nd->a; k < nd->a + nd->b; k++) x *= val[d->kids[k]];
+            break;
+        case DNNF_DECISION:
+            x = w[litIndex(nd->a)] * val[nd->b] + w[litIndex(-nd->a)] * val[nd->c];
+            break;
+        default:
+            for (int k = nd->a; k < nd->a + nd->b; k++)
+                x *= w[2 * d->kids[k]] + w[2 * d->kids[k] + 1];
+            break;
+        }
+        val[i] = x;
+    }
+    double count = val[d->root];
+    free(val);
+    free(w);
+    return count;
+}
+
+/**
+ * @copydoc dnnfEntailed
+ */
+int dnnfEntailed(const Dnnf *d, const int *assumptions, int n, int *out) {
+    unsigned char *w = allowedLiterals(d, assumptions, n);
+    unsigned char *sat = calloc((size_t)d->numNodes, 1);
+    unsigned char *used = calloc((size_t)d->numNodes, 1);
+    unsigned char *possible = calloc((size_t)(2 * d->numVars + 2), 1);
+    if (!w || !sat || !used || !possible) {
+        if (w) perror("malloc");
+        free(w);
+        free(sat);
+        free(used);
+        free(possible);
+        return -2;
+    }
+
+    /* Upward: which nodes have a model under the assumptions. */
+    for (int i = 0; i < d->numNodes; i++) {
+        const DnnfNode *nd = &d->nodes[i];
+        int s = 1;
+        switch (nd->kind) {
+        case DNNF_FALSE: s = 0; break;
+        case DNNF_TRUE: break;
+        case DNNF_LIT: s = w[litIndex(nd->a)]; break;
+        case DNNF_AND:
+            for (int k = nd->a; k < nd->a + nd->b && s; k++) s = sat[d->kids[k]];
+            break;
+        case DNNF_DECISION:
+            s = (w[litIndex(nd->a)] && sat[nd->b]) || (w[litIndex(-nd->a)] && sat[nd->c]);
+            break;
+        default:
+            for (int k = nd->a; k < nd->a + nd->b && s; k++)
+                s = w[2 * d->kids[k]] || w[2 * d->kids[k] + 1];
+            break;
+        }
+        sat[i] = (unsigned char)s;
+    }
+
+    /* Downward: which nodes and literals take part in some root model. */
+    int count = -1;
+    if (sat[d->root]) {
+        used[d->root] = 1;
+        for (int i = d->numNodes - 1; i >= 0; i--) {
+            const DnnfNode *nd = &d->nodes[i];
+            if (!used[i]) continue;
+            switch (nd->kind) {
+            case DNNF_LIT: possible[litIndex(nd->a)] = 1; break;
+            case DNNF_AND:
+                for (int k = nd->a; k < nd->a + nd->b; k++) used[d->kids[k]] = 1;
+                break;
+            case DNNF_DECISION:
+                if (w[litIndex(nd->a)] && sat[nd->b]) {
+                    used[nd->b] = 1;
+                    possible[litIndex(nd->a)] = 1;
+                }
+                if (w[litIndex(-nd->a)] && sat[nd->c]) {
+                    used[nd->c] = 1;
+                    possible[litIndex(-nd->a)] = 1;
+                }
+                break;
+            case DNNF_FREE:
+                for (int k = nd->a; k < nd->a + nd->b; k++) {
+                    possible[2 * d->kids[k]] |= w[2 * d->kids[k]];
+                    possible[2 * d->kids[k] + 1] |= w[2 * d->kids[k] + 1];
+                }
+                break;
+            default: break;
+            }
+        }
+        count = 0;
+        for (int v = 1; v <= d->numVars; v++) {
+            if (!w[2 * v] || !w[2 * v + 1]) continue;   /* assumed */
+            if (possible[2 * v] && !possible[2 * v + 1]) out[count++] = v;
+            else if (possible[2 * v + 1] && !possible[2 * v]) out[count++] = -v;
+        }
+    }
+    free(w);
+    free(sat);
+    free(used);
+    free(possible);
+    return count;
+}
+
+/**
+ * @copydoc dnnfCondition
+ */
+Dnnf *dnnfCondition(const Dnnf *d, const int *lits, int n) {
+    unsigned char *w = allowedLiterals(d, lits, n);
+    unsigned char *reach = calloc((size_t)d->numNodes, 1);
+    int *map = malloc((size_t)d->numNodes * sizeof(int));
+    int *items = malloc(((size_t)(d->numKids > d->numVars ? d->numKids : d->numVars) + 1) * sizeof(int));
+    Dnnf *c = w && reach && map && items ? newDnnf(d->numVars) : NULL;
+    if (!c) {
+        if (w) perror("malloc");
+        free(w);
+        free(reach);
+        free(map);
+        free(items);
+        return NULL;
+    }
+
+    /* Only nodes still reachable once decisions on assumed variables
+       collapse are copied. */
+    reach[d->root] = 1;
+    for (int i = d->numNodes - 1; i >= 0; i--) {
+        const DnnfNode *nd = &d->nodes[i];
+        if (!reach[i]) continue;
+        if (nd->kind == DNNF_AND) {
+            for (int k = nd->a; k < nd->a + nd->b; k++) reach[d->kids[k]] = 1;
+        } else if (nd->kind == DNNF_DECISION) {
+            if (w[litIndex(nd->a)]) reach[nd->b] = 1;
+            if (w[litIndex(-nd->a)]) reach[nd->c] = 1;
+        }
+    }
+
+    int ok = 1;
+    for (int i = 0; i < d->numNodes && ok; i++) {
+        const DnnfNode *nd = &d->nodes[i];
+        if (!reach[i]) continue;
+        int pos, neg, m = 0, id = FALSE_NODE;
+        switch (nd->kind) {
+        case DNNF_FALSE: id = FALSE_NODE; break;
+        case DNNF_TRUE: id = TRUE_NODE; break;
+        case DNNF_LIT:
+            pos = w[litIndex(nd->a)];
+            neg = w[litIndex(-nd->a)];
+            id = !pos ? FALSE_NODE : !neg ? TRUE_NODE : pushNode(c, DNNF_LIT, nd->a, 0, 0);
+            break;
+        case DNNF_DECISION: {
+            pos = w[litIndex(nd->a)];
+            neg = w[litIndex(-nd->a)];
+            int hi = pos ? map[nd->b] : FALSE_NODE, lo = neg ? map[nd->c] : FALSE_NODE;
+            if (pos != neg) id = pos ? hi : lo;
+            else if (pos && (hi != FALSE_NODE || lo != FALSE_NODE))
+                id = pushNode(c, DNNF_DECISION, nd->a, hi, lo);
+            break;
+        }
+        case DNNF_AND:
+            id = TRUE_NODE;
+            for (int k = nd->a; k < nd->a + nd->b; k++) {
+                int kid = map[d->kids[k]];
+                if (kid == FALSE_NODE) { id = FALSE_NODE; break; }
+                if (kid != TRUE_NODE) items[m++] = kid;
+            }
+            if (id == TRUE_NODE && m > 0) id = m == 1 ? items[0] : pushListNode(c, DNNF_AND, items, m);
+            break;
+        default:
+            id = TRUE_NODE;
+            for (int k = nd->a; k < nd->a + nd->b; k++) {
+                int v = d->kids[k];
+                if (!w[2 * v] && !w[2 * v + 1]) { id = FALSE_NODE; break; }
+                if (w[2 * v] && w[2 * v + 1]) items[m++] = v;
+            }
+            if (id == TRUE_NODE && m > 0) id = pushListNode(c, DNNF_FREE, items, m);
+            break;
+        }
+        ok = id >= 0;
+        map[i] = id;
+    }
+    c->root = ok ? map[d->root] : FALSE_NODE;
+    free(w);
+    free(reach);
+    free(map);
+    free(items);
+    if (!ok) {
+        freeDnnf(c);
+        return NULL;
+    }
+    return c;
+}
+
+/* ---- Files ---- */
+
+/**
+ * @copydoc saveDnnf
+ */
+int saveDnnf(const Dnnf *d, const char *path) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen");
+        return 0;
+    }
+    DnnfFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, dnnfMagic, sizeof(h.magic));
+    h.byteOrder = 0x01020304u;
+    h.numVars = d->numVars;
+    h.numNodes = d->numNodes;
+    h.root = d->root;
+    h.numKids = d->numKids;
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+             fwrite(d->nodes, sizeof(DnnfNode), (size_t)d->numNodes, fp) == (size_t)d->numNodes &&
+             fwrite(d->kids, sizeof(int), (size_t)d->numKids, fp) == (size_t)d->numKids;
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) printf("Error: Could not write '%s'.\n", path);
+    return ok;
+}
+
+/**
+ * @brief Checks that every node refers only to earlier nodes, valid
+ *        variables and its own part of the child array.
+ */
+static int validDnnf(const Dnnf *d) {
+    if (d->numNodes < 2 || d->nodes[0].kind != DNNF_FALSE || d->nodes[1].kind != DNNF_TRUE ||
+        d->root < 0 || d->root >= d->numNodes)
+        return 0;
+    for (int i = 2; i < d->numNodes; i++) {
+        const DnnfNode *nd = &d->nodes[i];
+        switch (nd->kind) {
+        case DNNF_LIT:
+            if (nd->a == 0 || abs(nd->a) > d->numVars) return 0;
+            break;
+        case DNNF_DECISION:
+            if (nd->a < 1 || nd->a > d->numVars || nd->b < 0 || nd->b >= i || nd->c < 0 || nd->c >= i)
+                return 0;
+            break;
+        case DNNF_AND:
+        case DNNF_FREE:
+            if (nd->a < 0 || nd->b < 0 || (long)nd->a + nd->b > d->numKids) return 0;
+            for (int k = nd->a; k < nd->a + nd->b; k++) {
+                int x = d->kids[k];
+                if (nd->kind == DNNF_AND ? x < 0 || x >= i : x < 1 || x > d->numVars) return 0;
+            }
+            break;
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @copydoc loadDnnf
+ */
+Dnnf *loadDnnf(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("Error: Cannot open file '%s'\n", path);
+        return NULL;
+    }
+    DnnfFileHeader h;
+    Dnnf *d = NULL;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, dnnfMagic, sizeof(h.magic)) != 0 ||
+        h.byteOrder != 0x01020304u || h.numVars < 0 || h.numNodes < 2 || h.numKids < 0 ||
+        h.numKids > INT_MAX) {
+        printf("Error: '%s' is not a circuit file of this build.\n", path);
+        fclose(fp);
+        return NULL;
+    }
+    d = calloc(1, sizeof(Dnnf));
+    if (d) {
+        d->numVars = h.numVars;
+        d->numNodes = d->nodeCap = h.numNodes;
+        d->numKids = h.numKids;
+        d->kidCap = h.numKids > 0 ? h.numKids : 1;
+        d->root = h.root;
+        d->nodes = malloc((size_t)d->nodeCap * sizeof(DnnfNode));
+        d->kids = malloc((size_t)d->kidCap * sizeof(int));
+    }
+    if (!d || !d->nodes || !d->kids) {
+        perror("malloc");
+        freeDnnf(d);
+        fclose(fp);
+        return NULL;
+    }
+    int ok = fread(d->nodes, sizeof(DnnfNode), (size_t)d->numNodes, fp) == (size_t)d->numNodes &&
+             fread(d->kids, sizeof(int), (size_t)d->numKids, fp) == (size_t)d->numKids &&
+             validDnnf(d);
+    fclose(fp);
+    if (!ok) {
+        printf("Error: Circuit file '%s' is truncated or corrupt.\n", path);
+        freeDnnf(d);
+        return NULL;
+    }
+    return d;
+}
+
+/* ---- Query scripts ---- */
+
+/**
+ * @brief Parses a 0-terminated literal list.
+ * @return Number of literals, or -1 if the list is not 0-terminated.
+ */
+static int parseLits(char *text, int *lits, int max) {
+    int n = 0;
+    char *save = NULL;
+    char *tok = strtok_r(text, " \t\r\n", &save);
+    while (tok) {
+        int lit = atoi(tok);
+        if (lit == 0) return n;
+        if (n == max) return -1;
+        lits[n++] = lit;
+        tok = strtok_r(NULL, " \t\r\n", &save);
+    }
+    return -1;
+}
+
+/**
+ * @copydoc runDnnfQueries
+ */
+int runDnnfQueries(const Dnnf *d, FILE *in, FILE *out, DnnfQueryReport *report) {
+    memset(report, 0, sizeof(*report));
+    char *line = malloc(LINE_MAX_LEN);
+    int *lits = malloc(LINE_MAX_LEN * sizeof(int));
+    int *entailed = malloc(((size_t)d->numVars + 1) * sizeof(int));
+    int ok = line && lits && entailed;
+    if (!ok) perror("malloc");
+
+    while (ok && fgets(line, LINE_MAX_LEN, in)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == 'c' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        char kind = *p++;
+        int n = parseLits(p, lits, LINE_MAX_LEN);
+        if ((kind != 'm' && kind != 's' && kind != 'e') || n < 0) {
+            printf("Error: Malformed query line: %s", line);
+            ok = 0;
+            break;
+        }
+
+        double t0 = nowSeconds();
+        if (kind == 'e') {
+            int k = dnnfEntailed(d, lits, n, entailed);
+            if (k < -1) { ok = 0; break; }
+            if (k < 0) {
+                fprintf(out, "UNSAT\n");
+            } else {
+                fprintf(out, "entailed:");
+                for (int i = 0; i < k; i++) fprintf(out, " %d", entailed[i]);
+                fprintf(out, "\n");
+            }
+        } else {
+            double count = dnnfCount(d, lits, n);
+            if (count < 0) { ok = 0; break; }
+            if (kind == 'm') fprintf(out, "%.0f\n", count);
+            else fprintf(out, count > 0 ? "SAT\n" : "UNSAT\n");
+        }
+        report->seconds += nowSeconds() - t0;
+        report->queries++;
+    }
+    free(line);
+    free(lits);
+    free(entailed);
+    return ok;
+}
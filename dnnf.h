@@ -0,0 +1,139 @@
+/**
+ * @file dnnf.h
+ * @brief Header for compiling clause sets into decision-DNNF circuits.
+ */
+
+#ifndef DNNF_H
+#define DNNF_H
+
+#include <stdio.h>
+#include "cnfFormula.h"
+
+/**
+ * @brief Node kinds. Nodes 0 and 1 of every circuit are FALSE and TRUE.
+ */
+typedef enum {
+    DNNF_FALSE,
+    DNNF_TRUE,
+    DNNF_LIT,        /**< The literal a */
+    DNNF_AND,        /**< Conjunction of kids[a .. a+b-1], over disjoint variables */
+    DNNF_DECISION,   /**< Variable a ? node b : node c */
+    DNNF_FREE        /**< Variables kids[a .. a+b-1], each either value */
+} DnnfKind;
+
+/**
+ * @brief One circuit node; children always precede their parents.
+ */
+typedef struct {
+    int kind;
+    int a;
+    int b;
+    int c;
+} DnnfNode;
+
+/**
+ * @brief A smooth decision-DNNF circuit as a flat node array.
+ *
+ * Both branches of a decision and every model of the root mention the
+ * same variables (unconstrained ones through FREE nodes), so counts need
+ * no correction for missing variables and every query below is a single
+ * pass over the array.
+ */
+typedef struct {
+    int numVars;
+    int numNodes;
+    int nodeCap;
+    DnnfNode *nodes;
+    long numKids;
+    long kidCap;
+    int *kids;       /**< Children of AND nodes, variables of FREE nodes */
+    int root;
+} Dnnf;
+
+/**
+ * @brief Counters of one compilation.
+ */
+typedef struct {
+    long decisions;      /**< Decision nodes built */
+    long components;     /**< Components compiled (cache misses) */
+    long cacheHits;      /**< Components found in the cache */
+    long cacheInts;      /**< Size of the cached component keys, in ints */
+} DnnfCompileStats;
+
+/**
+ * @brief Compiles a clause set by exhaustive DPLL with unit propagation,
+ *        splitting the residual clauses into variable-disjoint components
+ *        and caching each component's node under its variables and clause
+ *        ids.
+ * @param f Clause set.
+ * @param maxNodes Give up beyond this many nodes (<= 0: no limit).
+ * @param st Counters (may be NULL).
+ * @return Circuit (free with freeDnnf), or NULL if over the limit or
+ *         out of memory (reported on stdout).
+ */
+Dnnf *compileDnnf(const CnfFormula *f, long maxNodes, DnnfCompileStats *st);
+
+/**
+ * @brief Frees a circuit.
+ */
+void freeDnnf(Dnnf *d);
+
+/**
+ * @brief Models over all variables that contain the assumptions.
+ * @param assumptions DIMACS literals (may be NULL).
+ * @param n Number of assumptions.
+ * @return Model count (as in countModels), or -1 on malloc failure.
+ */
+double dnnfCount(const Dnnf *d, const int *assumptions, int n);
+
+/**
+ * @brief Literals entailed by the circuit together with the assumptions
+ *        (the assumed literals are left out).
+ * @param out Output: up to numVars DIMACS literals.
+ * @return Number written, -1 if the assumptions are inconsistent with the
+ *         circuit (everything is entailed), -2 on malloc failure.
+ */
+int dnnfEntailed(const Dnnf *d, const int *assumptions, int n, int *out);
+
+/**
+ * @brief Conditions the circuit on literals: assumed variables are
+ *        removed, decisions on them collapse, and constants propagate.
+ * @return New circuit over the same variable numbering, or NULL on
+ *         malloc failure.
+ */
+Dnnf *dnnfCondition(const Dnnf *d, const int *lits, int n);
+
+/**
+ * @brief Writes a circuit to a binary file.
+ * @return 1 on success, 0 on error.
+ */
+int saveDnnf(const Dnnf *d, const char *path);
+
+/**
+ * @brief Reads a circuit written by saveDnnf and checks its structure.
+ * @return Circuit, or NULL on error.
+ */
+Dnnf *loadDnnf(const char *path);
+
+/**
+ * @brief Summary of a query script run.
+ */
+typedef struct {
+    int queries;
+    double seconds;      /**< Wall time spent answering */
+} DnnfQueryReport;
+
+/**
+ * @brief Answers a query script from a compiled circuit.
+ *
+ * Script lines (DIMACS literals, each list terminated by 0):
+ *   - "m l1 l2 ... 0"  model count under the assumptions
+ *   - "s l1 l2 ... 0"  SAT or UNSAT under the assumptions
+ *   - "e l1 l2 ... 0"  literals entailed under the assumptions
+ *   - lines starting with 'c' are comments
+ *
+ * @return 1 on success, 0 on a malformed line or allocation failure.
+ */
+int runDnnfQueries(const Dnnf *d, FILE *in, FILE *out, DnnfQueryReport *report);
+
+#endif
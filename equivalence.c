@@ -0,0 +1,222 @@
+/**
+ * @file equivalence.c
+ * @brief Two-phase equivalence checking: simulation signatures, then SAT.
+ *
+ * Replaces "print both truth tables and diff them". Non-equivalent
+ * formulas almost always differ on some of a few thousand random
+ * assignments, which bit-parallel simulation finds in microseconds;
+ * only formulas whose signatures agree pay for an exact check.
+ * @section algo Algorithm:
+ *   Step 1: Compile both trees over a shared variable numbering
+ *   Step 2: Simulate blocks of 64 words (4096 assignments) per instruction;
+ *           exhaustive patterns when n <= 16, xorshift random otherwise
+ *   Step 3: On a signature match with n > 16, Tseitin-encode both trees,
+ *           assert F xor G and refute it with CDCL
+ * @section time Time Complexity: O((|F|+|G|) × B) simulation + SAT
+ *   - B = simulated blocks
+ * @section space Space Complexity: O((|F|+|G|) × 64) words
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "equivalence.h"
+#include "compiledFormula.h"
+#include "tseitin.h"
+#include "satSolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_WIDTH 64          /* words per block: 4096 assignments */
+#define EXHAUSTIVE_VARS 16    /* 2^16 assignments = 16 blocks */
+#define DEFAULT_SIM_BLOCKS 16
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Fills the variable words of block number blk with the exhaustive
+ *        enumeration: assignment index k sets variable v to bit v of k.
+ */
+static void fillExhaustive(uint64_t *vars, int numVars, long long blk) {
+    static const uint64_t pattern[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    for (int v = 0; v < numVars; v++) {
+        for (int w = 0; w < SIM_WIDTH; w++) {
+            long long word = blk * SIM_WIDTH + w;
+            vars[(size_t)v * SIM_WIDTH + w] = v < 6 ? pattern[v] : (((word >> (v - 6)) & 1) ? ~0ULL : 0ULL);
+        }
+    }
+}
+
+/**
+ * @brief Records the assignment at bit position (w, bit) of the block.
+ */
+static int extractCounterexample(EquivResult *r, const uint64_t *vars, int w, int bit) {
+    r->counterexample = malloc((size_t)(r->vars.count + 1) * sizeof(int));
+    if (!r->counterexample) return 0;
+    for (int v = 0; v < r->vars.count; v++)
+        r->counterexample[v + 1] = (int)((vars[(size_t)v * SIM_WIDTH + w] >> bit) & 1);
+    return 1;
+}
+
+/**
+ * @brief Simulation phase.
+ * @return 0 if a difference was found, 1 if all signatures matched, -1 on error.
+ */
+static int simulate(const CompiledFormula *cf, const CompiledFormula *cg, int simBlocks, EquivResult *r) {
+    int n = r->vars.count;
+    int exhaustive = n <= EXHAUSTIVE_VARS;
+    long long blocks = simBlocks;
+    uint64_t validMask = ~0ULL;
+    if (exhaustive) {
+        long long words = n > 6 ? (1LL << (n - 6)) : 1;
+        blocks = (words + SIM_WIDTH - 1) / SIM_WIDTH;
+        if (n < 6) validMask = (1ULL << (1 << n)) - 1;
+    }
+
+    uint64_t *vars = malloc((size_t)(n ? n : 1) * SIM_WIDTH * sizeof(uint64_t));
+    uint64_t *sf = malloc((size_t)cf->numInstrs * SIM_WIDTH * sizeof(uint64_t));
+    uint64_t *sg = malloc((size_t)cg->numInstrs * SIM_WIDTH * sizeof(uint64_t));
+    int status = -1;
+    if (!vars || !sf || !sg) { perror("malloc"); goto out; }
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    status = 1;
+    for (long long blk = 0; blk < blocks && status == 1; blk++) {
+        long long liveWords = SIM_WIDTH;
+        if (exhaustive) {
+            fillExhaustive(vars, n, blk);
+            long long total = n > 6 ? (1LL << (n - 6)) : 1;
+            if (total - blk * SIM_WIDTH < liveWords) liveWords = total - blk * SIM_WIDTH;
+        } else {
+            for (size_t i = 0; i < (size_t)n * SIM_WIDTH; i++) vars[i] = xorshift64(&rng);
+        }
+        const uint64_t *of = evalCompiledBlock(cf, vars, SIM_WIDTH, sf);
+        const uint64_t *og = evalCompiledBlock(cg, vars, SIM_WIDTH, sg);
+        for (int w = 0; w < liveWords; w++) {
+            uint64_t diff = (of[w] ^ og[w]) & validMask;
+            if (diff) {
+                status = extractCounterexample(r, vars, w, __builtin_ctzll(diff)) ? 0 : -1;
+                break;
+            }
+        }
+        r->simulated += exhaustive && n < 6 ? (1LL << n) : liveWords * 64;
+    }
+    r->decidedBy = exhaustive ? EQ_EXHAUSTIVE_SIMULATION : EQ_RANDOM_SIMULATION;
+
+out:
+    free(vars);
+    free(sf);
+    free(sg);
+    return status;
+}
+
+/**
+ * @brief Exact phase: refute F xor G.
+ * @return 1 if equivalent, 0 if not (counterexample stored), -1 on error.
+ */
+static int satMiter(const Node *f, const Node *g, EquivResult *r) {
+    Solver *s = solverNew(r->vars.count);
+    if (!s) return -1;
+    int status = -1;
+    int lf = tseitinEncode(s, &r->vars, f);
+    int lg = lf ? tseitinEncode(s, &r->vars, g) : 0;
+    if (lf && lg) {
+        int c1[2] = { lf, lg }, c2[2] = { -lf, -lg };
+        solverAddClause(s, c1, 2);
+        solverAddClause(s, c2, 2);
+        int res = solverSolve(s, NULL, 0);
+        if (res == SOLVER_UNSAT) {
+            status = 1;
+        } else if (res == SOLVER_SAT) {
+            r->counterexample = malloc((size_t)(r->vars.count + 1) * sizeof(int));
+            if (r->counterexample) {
+                for (int v = 1; v <= r->vars.count; v++) r->counterexample[v] = solverModelValue(s, v);
+                status = 0;
+            }
+        }
+    }
+    solverFree(s);
+    return status;
+}
+
+/**
+ * @copydoc checkEquivalence
+ */
+int checkEquivalence(const Node *f, const Node *g, int simBlocks, EquivResult *r) {
+    memset(r, 0, sizeof(*r));
+    r->equivalent = -1;
+    varMapInit(&r->vars);
+    if (simBlocks < 1) simBlocks = DEFAULT_SIM_BLOCKS;
+
+    double t0 = nowSeconds();
+    CompiledFormula *cf = compileFormula(f, &r->vars);
+    CompiledFormula *cg = cf ? compileFormula(g, &r->vars) : NULL;
+    if (!cf || !cg) {
+        freeCompiledFormula(cf);
+        return r->equivalent;
+    }
+    int sim = simulate(cf, cg, simBlocks, r);
+    freeCompiledFormula(cf);
+    freeCompiledFormula(cg);
+    r->simSeconds = nowSeconds() - t0;
+
+    if (sim == 0) {
+        r->equivalent = 0;
+    } else if (sim == 1 && r->decidedBy == EQ_EXHAUSTIVE_SIMULATION) {
+        r->equivalent = 1;
+    } else if (sim == 1) {
+        t0 = nowSeconds();
+        r->equivalent = satMiter(f, g, r);
+        r->decidedBy = EQ_SAT_MITER;
+        r->exactSeconds = nowSeconds() - t0;
+    }
+    return r->equivalent;
+}
+
+/**
+ * @copydoc printEquivResult
+ */
+void printEquivResult(const EquivResult *r) {
+    static const char *phaseName[] = { "random simulation", "exhaustive simulation", "SAT miter" };
+    if (r->equivalent < 0) {
+        printf("Error: Could not compare the formulas. Check your input.\n");
+        return;
+    }
+    printf("Result: The formulas are %s.\n", r->equivalent ? "EQUIVALENT" : "NOT EQUIVALENT");
+    printf("Decided by: %s\n", phaseName[r->decidedBy]);
+    printf("Simulation: %lld assignments in %f seconds\n", r->simulated, r->simSeconds);
+    if (r->decidedBy == EQ_SAT_MITER)
+        printf("SAT miter: %f seconds\n", r->exactSeconds);
+    if (!r->equivalent) {
+        printf("Counterexample:");
+        for (int v = 1; v <= r->vars.count; v++)
+            printf(" %s=%d", r->vars.names[v - 1], r->counterexample[v]);
+        printf("\n");
+    }
+}
+
+/**
+ * @copydoc freeEquivResult
+ */
+void freeEquivResult(EquivResult *r) {
+    varMapFree(&r->vars);
+    free(r->counterexample);
+    r->counterexample = NULL;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file equivalence.h
+ * @brief Header for equivalence checking of two parse trees.
+ */
+
+#ifndef EQUIVALENCE_H
+#define EQUIVALENCE_H
+
+#include "common.h"
+#include "varMap.h"
+
+/**
+ * @brief Which phase of the checker produced the answer.
+ */
+typedef enum {
+    EQ_RANDOM_SIMULATION,      /**< Random simulation found a difference */
+    EQ_EXHAUSTIVE_SIMULATION,  /**< Few variables: every assignment simulated */
+    EQ_SAT_MITER               /**< Signatures matched; SAT on the miter decided */
+} EquivPhase;
+
+/**
+ * @brief Outcome of an equivalence check.
+ */
+typedef struct {
+    int equivalent;          /**< 1 equivalent, 0 not, -1 malformed input or error */
+    EquivPhase decidedBy;
+    VarMap vars;             /**< Union of both formulas' variables */
+    int *counterexample;     /**< When not equivalent: value of vars index i (1-based) */
+    long long simulated;     /**< Assignments simulated */
+    double simSeconds;       /**< Time in the simulation phase */
+    double exactSeconds;     /**< Time in the SAT phase (0 if skipped) */
+} EquivResult;
+
+/**
+ * @brief Decides whether two formulas agree on every assignment.
+ *
+ * Both trees are compiled and simulated bit-parallel on random
+ * assignments (4096 per word-op block); the first differing assignment
+ * is returned as a counterexample. With at most 16 variables every
+ * assignment is simulated instead, which is exact. Otherwise, matching
+ * signatures are confirmed by refuting the miter F xor G with CDCL.
+ *
+ * @param f First formula.
+ * @param g Second formula.
+ * @param simBlocks Random 4096-assignment blocks to simulate (<1: default 16).
+ * @param r Output; release with freeEquivResult.
+ * @return r->equivalent.
+ */
+int checkEquivalence(const Node *f, const Node *g, int simBlocks, EquivResult *r);
+
+/**
+ * @brief Prints the verdict, deciding phase, timings and counterexample.
+ */
+void printEquivResult(const EquivResult *r);
+
+/**
+ * @brief Frees memory held by a result.
+ */
+void freeEquivResult(EquivResult *r);
+
+#endif
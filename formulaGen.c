@@ -0,0 +1,445 @@
+/**
+ * @file formulaGen.c
+ * @brief Synthetic formula generators for benchmarks and stress tests.
+ *
+ * The bundled corpus is CNF only, so the infix parser, tree builder and
+ * the CNF conversion never see deep implication chains, skewed trees or
+ * formulas that blow up under distribution. These generators produce
+ * those shapes at any size from a seed.
+ * @section algo Algorithm: Direct emission of fully parenthesized infix
+ *   - kcnf: k distinct variables per clause by rejection, random signs
+ *   - left/right: all opening (or closing) parentheses up front (or at the end)
+ *   - balanced/parity: recursive halving; parity keeps a polarity so that
+ *     XOR and XNOR of the halves need no explicit negated subtrees
+ *   - clause families (DIMACS or infix): random k-SAT at a clause/variable
+ *     ratio, pigeonhole PHP(h+1, h), XOR chains through auxiliaries (two
+ *     contradictory chains for --unsat) and planted k-SAT, where clauses
+ *     falsified by a hidden random model are redrawn
+ * @section time Time Complexity: O(output)
+ * @section space Space Complexity: O(log size) (O(k) for kcnf; O(vars) bits
+ *   for planted, plus a 1 MB output buffer for clause families)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "formulaGen.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+/**
+ * @copydoc genSeed
+ */
+void genSeed(GenRng *r, uint64_t seed) {
+    r->state = seed;
+}
+
+/**
+ * @copydoc genNext
+ */
+uint64_t genNext(GenRng *r) {
+    uint64_t z = (r->state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @copydoc genBelow
+ */
+int genBelow(GenRng *r, int n) {
+    return (int)(((genNext(r) >> 32) * (uint64_t)n) >> 32);
+}
+
+static const char *shapeNames[GEN_NUM_SHAPES] = {
+    "kcnf", "chain", "balanced", "left", "right", "parity"
+};
+
+/**
+ * @copydoc genShapeName
+ */
+const char *genShapeName(GenShape s) {
+    return s >= 0 && s < GEN_NUM_SHAPES ? shapeNames[s] : "?";
+}
+
+/**
+ * @copydoc genShapeFromName
+ */
+int genShapeFromName(const char *name, GenShape *s) {
+    for (int i = 0; i < GEN_NUM_SHAPES; i++) {
+        if (strcmp(name, shapeNames[i]) == 0) { *s = (GenShape)i; return 1; }
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a random, possibly negated, variable from the pool.
+ */
+static void randomLiteral(FILE *out, GenRng *r, int vars) {
+    fprintf(out, "%sx%d", genBelow(r, 4) == 0 ? "~" : "", genBelow(r, vars) + 1);
+}
+
+static void genKcnf(FILE *out, GenRng *r, int clauses, int vars, int k) {
+    int chosen[64];
+    for (int c = 0; c < clauses; c++) {
+        fputs(c ? " * (" : "(", out);
+        for (int j = 0; j < k; j++) {
+            int v, dup;
+            do {
+                v = genBelow(r, vars) + 1;
+                dup = 0;
+                for (int i = 0; i < j; i++) dup |= chosen[i] == v;
+            } while (dup);
+            chosen[j] = v;
+            fprintf(out, "%s%sx%d", j ? " + " : "", genBelow(r, 2) ? "~" : "", v);
+        }
+        fputc(')', out);
+    }
+}
+
+static void genChain(FILE *out, int links) {
+    for (int i = 1; i <= links; i++) fprintf(out, "(x%d > ", i);
+    fprintf(out, "x%d", links + 1);
+    for (int i = 0; i < links; i++) fputc(')', out);
+}
+
+static void genBalanced(FILE *out, GenRng *r, int leaves, int vars, int depth) {
+    if (leaves == 1) {
+        randomLiteral(out, r, vars);
+        return;
+    }
+    fputc('(', out);
+    genBalanced(out, r, leaves / 2, vars, depth + 1);
+    fputs(depth % 2 ? " + " : " * ", out);
+    genBalanced(out, r, leaves - leaves / 2, vars, depth + 1);
+    fputc(')', out);
+}
+
+static void genSkewed(FILE *out, GenRng *r, int leaves, int vars, int leftDeep) {
+    if (leftDeep) {
+        for (int i = 1; i < leaves; i++) fputc('(', out);
+        randomLiteral(out, r, vars);
+        for (int i = 1; i < leaves; i++) {
+            fputs(genBelow(r, 2) ? " + " : " * ", out);
+            randomLiteral(out, r, vars);
+            fputc(')', out);
+        }
+    } else {
+        for (int i = 1; i < leaves; i++) {
+            fputc('(', out);
+            randomLiteral(out, r, vars);
+            fputs(genBelow(r, 2) ? " + " : " * ", out);
+        }
+        randomLiteral(out, r, vars);
+        for (int i = 1; i < leaves; i++) fputc(')', out);
+    }
+}
+
+/**
+ * @brief XOR (positive) or XNOR (negative) of x(first) .. x(first+n-1).
+ */
+static void genParity(FILE *out, int first, int n, int positive) {
+    if (n == 1) {
+        fprintf(out, "%sx%d", positive ? "" : "~", first);
+        return;
+    }
+    int h = n / 2;
+    // XOR(L,R) = (L * ~R) + (~L * R); XNOR(L,R) = (L * R) + (~L * ~R)
+    fputs("((", out);
+    genParity(out, first, h, 1);
+    fputs(" * ", out);
+    genParity(out, first + h, n - h, !positive);
+    fputs(") + (", out);
+    genParity(out, first, h, 0);
+    fputs(" * ", out);
+    genParity(out, first + h, n - h, positive);
+    fputs("))", out);
+}
+
+/**
+ * @copydoc generateFormula
+ */
+int generateFormula(FILE *out, const GenParams *p) {
+    GenRng r;
+    genSeed(&r, p->seed);
+    int vars = p->vars > 0 ? p->vars : p->size;
+    if (p->size < 1) return 0;
+    switch (p->shape) {
+    case GEN_KCNF:
+        if (p->k < 1 || p->k > 64 || p->k > vars) return 0;
+        genKcnf(out, &r, p->size, vars, p->k);
+        return 1;
+    case GEN_CHAIN:    genChain(out, p->size); return 1;
+    case GEN_BALANCED: genBalanced(out, &r, p->size, vars, 0); return 1;
+    case GEN_LEFT:     genSkewed(out, &r, p->size, vars, 1); return 1;
+    case GEN_RIGHT:    genSkewed(out, &r, p->size, vars, 0); return 1;
+    case GEN_PARITY:   genParity(out, 1, p->size, 1); return 1;
+    default:           return 0;
+    }
+}
+
+/**
+ * @copydoc generateFormulaString
+ */
+char *generateFormulaString(const GenParams *p) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+    if (!out) { perror("open_memstream"); return NULL; }
+    int ok = generateFormula(out, p);
+    if (fclose(out) != 0) ok = 0;
+    if (!ok) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
+
+static const char *familyNames[CNF_NUM_FAMILIES] = {
+    "ksat", "pigeonhole", "xorchain", "planted"
+};
+
+/**
+ * @copydoc cnfFamilyName
+ */
+const char *cnfFamilyName(CnfFamily f) {
+    return f >= 0 && f < CNF_NUM_FAMILIES ? familyNames[f] : "?";
+}
+
+/**
+ * @copydoc cnfFamilyFromName
+ */
+int cnfFamilyFromName(const char *name, CnfFamily *f) {
+    for (int i = 0; i < CNF_NUM_FAMILIES; i++) {
+        if (strcmp(name, familyNames[i]) == 0) { *f = (CnfFamily)i; return 1; }
+    }
+    return 0;
+}
+
+/**
+ * @copydoc cnfGenShape
+ */
+int cnfGenShape(const CnfGenParams *p, int *vars, long long *clauses) {
+    switch (p->family) {
+    case CNF_KSAT:
+    case CNF_PLANTED: {
+        if (p->vars < 1 || p->k < 1 || p->k > 64 || p->k > p->vars) return 0;
+        long long m = p->clauses > 0 ? p->clauses : llround(p->ratio * p->vars);
+        if (m < 1) return 0;
+        *vars = p->vars;
+        *clauses = m;
+        return 1;
+    }
+    case CNF_PIGEONHOLE: {
+        long long h = p->holes;
+        if (h < 1 || (h + 1) * h > INT_MAX) return 0;
+        *vars = (int)((h + 1) * h);
+        *clauses = (h + 1) + h * (h + 1) * h / 2;
+        return 1;
+    }
+    case CNF_XORCHAIN: {
+        long long n = p->vars, chains = p->unsat ? 2 : 1;
+        if (n < 2 || n + chains * (n - 1) > INT_MAX) return 0;
+        *vars = (int)(n + chains * (n - 1));
+        *clauses = chains * (4 * (n - 1) + 1);
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+#define WRITER_BYTES (1 << 20)
+
+/**
+ * @brief Buffered clause writer: fprintf costs more than generating the
+ *        clause, so literals are formatted by hand into one large buffer.
+ */
+typedef struct {
+    FILE *out;
+    int dimacs;
+    char *buf;
+    size_t len;
+    int inClause;
+    int ok;
+    CnfGenStats st;
+} ClauseWriter;
+
+static void writerFlush(ClauseWriter *w) {
+    if (w->len && fwrite(w->buf, 1, w->len, w->out) != w->len) w->ok = 0;
+    w->st.bytes += (long long)w->len;
+    w->len = 0;
+}
+
+static void writerPut(ClauseWriter *w, const char *s, size_t n) {
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+/**
+ * @brief Appends one literal (±variable) of the current clause.
+ */
+static void writerLiteral(ClauseWriter *w, int lit) {
+    // a literal never needs more than 32 bytes, so one check per literal
+    if (w->len > WRITER_BYTES - 32) writerFlush(w);
+    if (w->inClause) {
+        if (w->dimacs) w->buf[w->len++] = ' ';
+        else writerPut(w, " + ", 3);
+    } else if (!w->dimacs) {
+        if (w->st.clauses) writerPut(w, " * (", 4);
+        else w->buf[w->len++] = '(';
+    }
+    if (lit < 0) w->buf[w->len++] = w->dimacs ? '-' : '~';
+    if (!w->dimacs) w->buf[w->len++] = 'x';
+    unsigned v = lit < 0 ? -(unsigned)lit : (unsigned)lit;
+    char digits[12];
+    int n = 0;
+    do { digits[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n) w->buf[w->len++] = digits[--n];
+    w->inClause = 1;
+    w->st.literals++;
+}
+
+static void writerEndClause(ClauseWriter *w) {
+    if (w->len > WRITER_BYTES - 32) writerFlush(w);
+    if (w->dimacs) writerPut(w, " 0\n", 3);
+    else w->buf[w->len++] = ')';
+    w->inClause = 0;
+    w->st.clauses++;
+}
+
+/**
+ * @brief Random clauses of k distinct variables; with a planted model,
+ *        clauses it falsifies are redrawn.
+ */
+static void genRandomClauses(ClauseWriter *w, GenRng *r, long long clauses, int vars, int k,
+                             const unsigned char *model) {
+    int lits[64];
+    for (long long c = 0; c < clauses; c++) {
+        int sat;
+        do {
+            sat = !model;
+            for (int j = 0; j < k; j++) {
+                int v, dup;
+                do {
+                    v = genBelow(r, vars) + 1;
+                    dup = 0;
+                    for (int i = 0; i < j; i++) dup |= lits[i] == v || lits[i] == -v;
+                } while (dup);
+                int neg = (int)(genNext(r) & 1);
+                lits[j] = neg ? -v : v;
+                if (model && ((model[(v - 1) >> 3] >> ((v - 1) & 7)) & 1) != neg) sat = 1;
+            }
+        } while (!sat);
+        for (int j = 0; j < k; j++) writerLiteral(w, lits[j]);
+        writerEndClause(w);
+    }
+}
+
+/**
+ * @brief PHP(h+1, h): pigeon p in hole j is variable p*h + j + 1.
+ */
+static void genPigeonhole(ClauseWriter *w, int h) {
+    for (int p = 0; p <= h; p++) {
+        for (int j = 0; j < h; j++) writerLiteral(w, p * h + j + 1);
+        writerEndClause(w);
+    }
+    for (int j = 0; j < h; j++) {
+        for (int p = 0; p <= h; p++) {
+            for (int q = p + 1; q <= h; q++) {
+                writerLiteral(w, -(p * h + j + 1));
+                writerLiteral(w, -(q * h + j + 1));
+                writerEndClause(w);
+            }
+        }
+    }
+}
+
+/**
+ * @brief c <-> a XOR b as four ternary clauses.
+ */
+static void xorClauses(ClauseWriter *w, int a, int b, int c) {
+    const int sign[4][3] = { { -1, -1, -1 }, { 1, 1, -1 }, { 1, -1, 1 }, { -1, 1, 1 } };
+    for (int i = 0; i < 4; i++) {
+        writerLiteral(w, sign[i][0] * a);
+        writerLiteral(w, sign[i][1] * b);
+        writerLiteral(w, sign[i][2] * c);
+        writerEndClause(w);
+    }
+}
+
+/**
+ * @brief One chain t2 = x(o1) ^ x(o2), ti = t(i-1) ^ x(oi), unit on tn.
+ *        order == NULL walks x1..xn; the chain's auxiliaries start at aux.
+ */
+static void genXorChain(ClauseWriter *w, int n, const int *order, int aux, int parity) {
+    int prev = order ? order[0] : 1;
+    for (int i = 1; i < n; i++) {
+        int t = aux + i - 1;
+        xorClauses(w, prev, order ? order[i] : i + 1, t);
+        prev = t;
+    }
+    writerLiteral(w, parity ? prev : -prev);
+    writerEndClause(w);
+}
+
+/**
+ * @copydoc generateCnf
+ */
+int generateCnf(FILE *out, int dimacs, const CnfGenParams *p, CnfGenStats *st) {
+    int vars;
+    long long clauses;
+    if (!cnfGenShape(p, &vars, &clauses)) return 0;
+
+    ClauseWriter w = { out, dimacs, malloc(WRITER_BYTES), 0, 0, 1, { vars, 0, 0, 0 } };
+    if (!w.buf) { perror("malloc"); return 0; }
+    GenRng r;
+    genSeed(&r, p->seed);
+    if (dimacs) {
+        w.len = (size_t)snprintf(w.buf, WRITER_BYTES, "c %s seed %llu\np cnf %d %lld\n",
+                                 cnfFamilyName(p->family), (unsigned long long)p->seed, vars, clauses);
+    }
+
+    switch (p->family) {
+    case CNF_KSAT:
+        genRandomClauses(&w, &r, clauses, vars, p->k, NULL);
+        break;
+    case CNF_PLANTED: {
+        unsigned char *model = malloc(((size_t)vars + 7) / 8);
+        if (!model) { perror("malloc"); w.ok = 0; break; }
+        for (size_t i = 0; i < ((size_t)vars + 7) / 8; i++) model[i] = (unsigned char)genNext(&r);
+        genRandomClauses(&w, &r, clauses, vars, p->k, model);
+        free(model);
+        break;
+    }
+    case CNF_PIGEONHOLE:
+        genPigeonhole(&w, p->holes);
+        break;
+    case CNF_XORCHAIN: {
+        int n = p->vars;
+        int parity = (int)(genNext(&r) & 1);
+        genXorChain(&w, n, NULL, n + 1, parity);
+        if (!p->unsat) break;
+        // the same variables in another order must XOR to the other value
+        int *order = malloc((size_t)n * sizeof(int));
+        if (!order) { perror("malloc"); w.ok = 0; break; }
+        for (int i = 0; i < n; i++) order[i] = i + 1;
+        for (int i = n - 1; i > 0; i--) {
+            int j = genBelow(&r, i + 1), t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        genXorChain(&w, n, order, n + 1 + (n - 1), !parity);
+        free(order);
+        break;
+    }
+    default:
+        break;
+    }
+    if (!dimacs && w.len < WRITER_BYTES) w.buf[w.len++] = '\n';
+    writerFlush(&w);
+    free(w.buf);
+    if (st) *st = w.st;
+    return w.ok && w.st.clauses == clauses;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file formulaGen.h
+ * @brief Header for the synthetic formula generators.
+ */
+
+#ifndef FORMULA_GEN_H
+#define FORMULA_GEN_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @brief Deterministic pseudo-random generator (splitmix64): the same seed
+ *        gives the same formula on every platform.
+ */
+typedef struct {
+    uint64_t state;
+} GenRng;
+
+/**
+ * @brief Seeds a generator.
+ */
+void genSeed(GenRng *r, uint64_t seed);
+
+/**
+ * @brief Returns the next 64 random bits.
+ */
+uint64_t genNext(GenRng *r);
+
+/**
+ * @brief Returns a uniform integer in [0, n).
+ */
+int genBelow(GenRng *r, int n);
+
+/**
+ * @brief Formula shapes.
+ */
+typedef enum {
+    GEN_KCNF,       /**< size random clauses of k distinct literals over vars */
+    GEN_CHAIN,      /**< x1 > (x2 > (... > x(size+1))): depth grows linearly */
+    GEN_BALANCED,   /**< size leaves, levels alternating * and + */
+    GEN_LEFT,       /**< size leaves, left-deep, random * / + and negations */
+    GEN_RIGHT,      /**< size leaves, right-deep, random * / + and negations */
+    GEN_PARITY,     /**< XOR of size variables in ~, *, +: O(size^2) text,
+                         2^(size-1) clauses after distribution */
+    GEN_NUM_SHAPES
+} GenShape;
+
+/**
+ * @brief Parameters of one generated formula.
+ */
+typedef struct {
+    GenShape shape;
+    int size;           /**< Clauses, implications, leaves or parity width */
+    int vars;           /**< Variable pool for kcnf, left, right, balanced (<= 0: size) */
+    int k;              /**< Literals per clause for kcnf */
+    uint64_t seed;
+} GenParams;
+
+/**
+ * @brief Returns the name of a shape ("kcnf", "chain", ...).
+ */
+const char *genShapeName(GenShape s);
+
+/**
+ * @brief Looks up a shape by name.
+ * @return 1 on success, 0 if the name is unknown.
+ */
+int genShapeFromName(const char *name, GenShape *s);
+
+/**
+ * @brief Writes a formula in the infix syntax of Task 1 (variables x1, x2,
+ *        ...), streaming: memory use is independent of the formula's size
+ *        except for the O(log size) recursion of balanced and parity.
+ * @param out Destination.
+ * @param p Shape, size and seed.
+ * @return 1 on success, 0 on invalid parameters.
+ */
+int generateFormula(FILE *out, const GenParams *p);
+
+/**
+ * @brief Generates a formula into a malloc'd string.
+ * @return The formula, or NULL on invalid parameters or malloc failure.
+ */
+char *generateFormulaString(const GenParams *p);
+
+/**
+ * @brief Clause-set families.
+ */
+typedef enum {
+    CNF_KSAT,        /**< Uniform random k-SAT: clauses of k distinct variables */
+    CNF_PIGEONHOLE,  /**< holes+1 pigeons into holes: unsatisfiable */
+    CNF_XORCHAIN,    /**< XOR of vars variables fixed by a chain of auxiliaries */
+    CNF_PLANTED,     /**< Random k-SAT keeping only clauses a hidden model satisfies */
+    CNF_NUM_FAMILIES
+} CnfFamily;
+
+/**
+ * @brief Parameters of a generated clause set.
+ */
+typedef struct {
+    CnfFamily family;
+    int vars;             /**< Variables of ksat, planted and xorchain */
+    long long clauses;    /**< Clauses of ksat/planted (<= 0: ratio × vars) */
+    double ratio;         /**< Clause/variable ratio when clauses <= 0 */
+    int k;                /**< Literals per random clause */
+    int holes;            /**< Holes of pigeonhole */
+    int unsat;            /**< xorchain: add a second chain over a permutation
+                               of the variables with the opposite parity */
+    uint64_t seed;
+} CnfGenParams;
+
+/**
+ * @brief Totals of a generated clause set.
+ */
+typedef struct {
+    int vars;
+    long long clauses;
+    long long literals;
+    long long bytes;      /**< Bytes written */
+} CnfGenStats;
+
+/**
+ * @brief Returns the name of a family ("ksat", "pigeonhole", ...).
+ */
+const char *cnfFamilyName(CnfFamily f);
+
+/**
+ * @brief Looks up a family by name.
+ * @return 1 on success, 0 if the name is unknown.
+ */
+int cnfFamilyFromName(const char *name, CnfFamily *f);
+
+/**
+ * @brief Computes the variable and clause counts without generating.
+ * @return 1 on success, 0 on invalid parameters.
+ */
+int cnfGenShape(const CnfGenParams *p, int *vars, long long *clauses);
+
+/**
+ * @brief Streams a clause set as DIMACS (header first, from cnfGenShape)
+ *        or as an infix conjunction of disjunctions.
+ *
+ * Output goes through a 1 MB buffer with hand-rolled integer formatting;
+ * memory use is O(k) plus one bit per variable for planted.
+ *
+ * @param out Destination.
+ * @param dimacs Non-zero for DIMACS, zero for infix.
+ * @param p Family and parameters.
+ * @param st Totals (may be NULL).
+ * @return 1 on success, 0 on invalid parameters or a write error.
+ */
+int generateCnf(FILE *out, int dimacs, const CnfGenParams *p, CnfGenStats *st);
+
+#endif
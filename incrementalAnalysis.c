@@ -0,0 +1,748 @@
+/**
+ * @file incrementalAnalysis.c
+ * @brief Persistent analysis session: re-analysis after an edit costs the
+ *        edited path, not the whole formula.
+ *
+ * Changing one subformula and re-running Tasks 1-7 recomputes the height,
+ * variables, truth table and CNF of every subtree, although all but the
+ * ones above the edit are unchanged. Here each subtree is interned once
+ * under a structural hash together with its derived results, so an edit
+ * builds the new subtree and a new path to the root and everything else
+ * is found in the table.
+ * @section algo Algorithm: Hash-consing with memoized attributes
+ *   - Subtrees are interned in an open-addressing table keyed by (kind,
+ *     child ids), so equal subtrees are one id and an edit only creates
+ *     the nodes on the path from the edited subtree to the root
+ *   - Per subtree: height (as maxHeightOfParseTree), variable set as a
+ *     persistent treap with fixed priorities (a union shares all but
+ *     O(log n) nodes with its operands), and a 64-bit simulation
+ *     signature: the truth values under 64 fixed random assignments,
+ *     which stands in for the truth table and refutes validity whenever
+ *     it is not all ones
+ *   - CNF clause sets are built lazily per subtree and polarity with the
+ *     rules of Task 6: * of CNFs is a constant-time union node, + and >
+ *     take the pairwise product of clauses (sorted, duplicate literals
+ *     merged, tautologies flagged); ~ swaps polarities. Clause and
+ *     tautology counts are kept per set, so the checkCNFValidity verdict
+ *     is read off the root
+ *   - Validity is refuted by the signature when it is not all ones, then
+ *     by up to 64 falsifying assignments found earlier (evaluated per
+ *     subtree and refreshed lazily); only past the CNF limit is the
+ *     refutation solver run, and its falsifying assignment is kept
+ *   - Every result lives in an arena that is freed with the session
+ * @section time Time Complexity: O(|edit| + d log v) per edit for depth d
+ *           and v variables; products cost the clauses they create
+ * @section space Space Complexity: O(n log v) for n distinct subtrees,
+ *            plus the clauses, kept for the life of the session
+ */
+
+#include "incrementalAnalysis.h"
+#include "simplify.h"
+#include "validity.h"
+#include "varMap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Products beyond these sizes are not built; the CNF is then unknown. */
+#define ANALYSIS_MAX_CLAUSES (1LL << 16)
+#define ANALYSIS_MAX_LITS (1LL << 20)
+#define ARENA_CHUNK_BYTES (1u << 20)
+
+typedef enum { SUB_CONST, SUB_VAR, SUB_NOT, SUB_AND, SUB_OR, SUB_IMPLIES } SubtreeKind;
+
+enum { CNF_NONE, CNF_BUILT, CNF_OVER };
+
+/**
+ * @brief Node of a persistent treap of variable indices. Priorities are a
+ *        hash of the variable, so each set has exactly one shape.
+ */
+typedef struct VarSet {
+    int var;
+    uint32_t prio;
+    int size;
+    const struct VarSet *left;
+    const struct VarSet *right;
+} VarSet;
+
+/**
+ * @brief One clause: DIMACS literals sorted by variable, no duplicates.
+ */
+typedef struct {
+    int size;
+    int tautology;       /**< Contains some x and ~x */
+    int lits[];
+} Clause;
+
+/**
+ * @brief A clause set: either the union of two sets or a clause array.
+ */
+typedef struct ClauseSet {
+    long long count;
+    long long tautologies;
+    long long lits;                  /**< Literals over all clauses */
+    const struct ClauseSet *a;       /**< Union of a and b when set */
+    const struct ClauseSet *b;
+    Clause *const *items;            /**< Otherwise count clauses */
+} ClauseSet;
+
+/**
+ * @brief One interned subtree with its memoized results.
+ */
+typedef struct {
+    SubtreeKind kind;
+    int left;            /**< Child id (-1 for ~); variable index or constant value for leaves */
+    int right;           /**< Child id (-1 for leaves) */
+    uint64_t hash;
+    int height;
+    const VarSet *vars;
+    uint64_t sig;
+    uint64_t cex;                    /**< Values under the kept counterexamples */
+    unsigned cexVersion;             /**< cex is current when equal to the session's */
+    const ClauseSet *cnf[2];         /**< [0] of the subtree, [1] of its negation */
+    unsigned char cnfState[2];
+} Subtree;
+
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t used;
+    size_t cap;
+} Chunk;
+
+struct AnalysisSession {
+    Subtree *nodes;
+    int count, cap;
+    int *slots;          /**< Subtree id + 1, 0 for an empty slot */
+    size_t numSlots;
+    VarMap names;
+    Chunk *chunks;
+    int root;            /**< Current formula, -1 before the first load */
+    uint64_t *cexBits;   /**< Bit k of cexBits[v]: variable v in counterexample k */
+    int cexVars;         /**< Entries of cexBits */
+    int numCex;          /**< Counterexamples kept, at most 64 */
+    int nextCex;         /**< Slot replaced next once all 64 are used */
+    unsigned cexVersion;
+    AnalysisStats stats;
+    int failed;
+};
+
+static Clause emptyClause;
+static Clause *const falseItems[1] = { &emptyClause };
+static const ClauseSet EMPTY_SET = { 0, 0, 0, NULL, NULL, NULL };
+static const ClauseSet FALSE_SET = { 1, 0, 0, NULL, NULL, falseItems };
+
+static void *arenaAlloc(AnalysisSession *s, size_t n) {
+    n = (n + 7) & ~(size_t)7;
+    Chunk *c = s->chunks;
+    if (!c || c->cap - c->used < n) {
+        size_t cap = n > ARENA_CHUNK_BYTES ? n : ARENA_CHUNK_BYTES;
+        c = malloc(sizeof(Chunk) + cap);
+        if (!c) { perror("malloc"); s->failed = 1; return NULL; }
+        c->next = s->chunks;
+        c->used = 0;
+        c->cap = cap;
+        s->chunks = c;
+    }
+    void *p = (unsigned char *)(c + 1) + c->used;
+    c->used += n;
+    return p;
+}
+
+static uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/* ---- Variable sets ---- */
+
+static int varSetAbove(const VarSet *x, const VarSet *y) {
+    return x->prio != y->prio ? x->prio > y->prio : x->var > y->var;
+}
+
+static const VarSet *varSetNode(AnalysisSession *s, const VarSet *like,
+                                const VarSet *left, const VarSet *right) {
+    VarSet *t = arenaAlloc(s, sizeof(VarSet));
+    if (!t) return NULL;
+    t->var = like->var;
+    t->prio = like->prio;
+    t->left = left;
+    t->right = right;
+    t->size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+    return t;
+}
+
+/**
+ * @brief Splits t into the variables below and above var (var itself is
+ *        dropped), copying only the nodes on the search path.
+ */
+static void varSetSplit(AnalysisSession *s, const VarSet *t, int var,
+                        const VarSet **lo, const VarSet **hi) {
+    const VarSet *a, *b;
+    if (!t) {
+        *lo = *hi = NULL;
+    } else if (t->var < var) {
+        varSetSplit(s, t->right, var, &a, &b);
+        *lo = a == t->right ? t : varSetNode(s, t, t->left, a);
+        *hi = b;
+    } else if (t->var > var) {
+        varSetSplit(s, t->left, var, &a, &b);
+        *lo = a;
+        *hi = b == t->left ? t : varSetNode(s, t, b, t->right);
+    } else {
+        *lo = t->left;
+        *hi = t->right;
+    }
+}
+
+static const VarSet *varSetUnion(AnalysisSession *s, const VarSet *a, const VarSet *b) {
+    if (!a || a == b) return b;
+    if (!b) return a;
+    if (varSetAbove(b, a)) {
+        const VarSet *t = a;
+        a = b;
+        b = t;
+    }
+    const VarSet *lo, *hi;
+    varSetSplit(s, b, a->var, &lo, &hi);
+    const VarSet *left = varSetUnion(s, a->left, lo);
+    const VarSet *right = varSetUnion(s, a->right, hi);
+    if (left == a->left && right == a->right) return a;
+    return varSetNode(s, a, left, right);
+}
+
+static void printVarSet(const AnalysisSession *s, const VarSet *t, int *first, FILE *out) {
+    if (!t) return;
+    printVarSet(s, t->left, first, out);
+    fprintf(out, "%s%s", *first ? "" : " ", s->names.names[t->var - 1]);
+    *first = 0;
+    printVarSet(s, t->right, first, out);
+}
+
+/* ---- Clause sets ---- */
+
+static const ClauseSet *unitSet(AnalysisSession *s, int lit) {
+    Clause *c = arenaAlloc(s, sizeof(Clause) + sizeof(int));
+    Clause **items = arenaAlloc(s, sizeof(Clause *));
+    ClauseSet *set = arenaAlloc(s, sizeof(ClauseSet));
+    if (!c || !items || !set) return NULL;
+    c->size = 1;
+    c->tautology = 0;
+    c->lits[0] = lit;
+    items[0] = c;
+    *set = (ClauseSet){ 1, 0, 1, NULL, NULL, items };
+    return set;
+}
+
+static const ClauseSet *setUnion(AnalysisSession *s, const ClauseSet *a, const ClauseSet *b) {
+    if (a->count == 0) return b;
+    if (b->count == 0) return a;
+    ClauseSet *set = arenaAlloc(s, sizeof(ClauseSet));
+    if (!set) return NULL;
+    *set = (ClauseSet){ a->count + b->count, a->tautologies + b->tautologies,
+                        a->lits + b->lits, a, b, NULL };
+    return set;
+}
+
+/**
+ * @brief Lists the clauses of a set in order, into a malloc'd array of
+ *        set->count pointers.
+ */
+static Clause *const *flattenSet(const ClauseSet *set, Clause *const **owned) {
+    *owned = NULL;
+    if (!set->a) return set->items;
+    Clause **list = malloc((size_t)set->count * sizeof(Clause *));
+    size_t cap = 64, top = 0, n = 0;
+    const ClauseSet **stack = malloc(cap * sizeof(*stack));
+    if (!list || !stack) {
+        perror("malloc");
+        free(list);
+        free(stack);
+        return NULL;
+    }
+    stack[top++] = set;
+    while (top) {
+        const ClauseSet *t = stack[--top];
+        if (!t->a) {
+            memcpy(list + n, t->items, (size_t)t->count * sizeof(Clause *));
+            n += (size_t)t->count;
+            continue;
+        }
+        if (top + 2 > cap) {
+            const ClauseSet **ns = realloc(stack, 2 * cap * sizeof(*stack));
+            if (!ns) {
+                perror("realloc");
+                free(list);
+                free(stack);
+                return NULL;
+            }
+            stack = ns;
+            cap *= 2;
+        }
+        stack[top++] = t->b;
+        stack[top++] = t->a;
+    }
+    free(stack);
+    *owned = list;
+    return list;
+}
+
+static int litKey(int lit) {
+    return lit < 0 ? -2 * lit + 1 : 2 * lit;
+}
+
+static Clause *mergeClauses(AnalysisSession *s, const Clause *x, const Clause *y) {
+    Clause *c = arenaAlloc(s, sizeof(Clause) + (size_t)(x->size + y->size) * sizeof(int));
+    if (!c) return NULL;
+    int i = 0, j = 0, n = 0, taut = x->tautology || y->tautology;
+    while (i < x->size || j < y->size) {
+        int lit;
+        if (j == y->size || (i < x->size && litKey(x->lits[i]) <= litKey(y->lits[j]))) {
+            lit = x->lits[i++];
+        } else {
+            lit = y->lits[j++];
+        }
+        if (n && c->lits[n - 1] == lit) continue;
+        if (n && c->lits[n - 1] == -lit) taut = 1;
+        c->lits[n++] = lit;
+    }
+    c->size = n;
+    c->tautology = taut;
+    return c;
+}
+
+/**
+ * @brief Pairwise disjunction of the clauses of a and b.
+ * @return The set, or NULL if it is over the limit or on malloc failure
+ *         (which sets s->failed).
+ */
+static const ClauseSet *setProduct(AnalysisSession *s, const ClauseSet *a, const ClauseSet *b) {
+    if (a->count == 0 || b->count == 0) return &EMPTY_SET;
+    if (a->count > ANALYSIS_MAX_CLAUSES / b->count) return NULL;
+    long long count = a->count * b->count;
+    long long lits = a->lits * b->count + b->lits * a->count;
+    if (lits > ANALYSIS_MAX_LITS) return NULL;
+
+    Clause *const *ownA, *const *ownB;
+    Clause *const *xs = flattenSet(a, &ownA);
+    Clause *const *ys = flattenSet(b, &ownB);
+    Clause **items = arenaAlloc(s, (size_t)count * sizeof(Clause *));
+    ClauseSet *set = arenaAlloc(s, sizeof(ClauseSet));
+    if (!xs || !ys || !items || !set) {
+        s->failed = 1;
+        free((void *)ownA);
+        free((void *)ownB);
+        return NULL;
+    }
+    long long k = 0, taut = 0, total = 0;
+    for (long long i = 0; i < a->count && !s->failed; i++) {
+        for (long long j = 0; j < b->count; j++) {
+            Clause *c = mergeClauses(s, xs[i], ys[j]);
+            if (!c) break;
+            taut += c->tautology;
+            total += c->size;
+            items[k++] = c;
+        }
+    }
+    free((void *)ownA);
+    free((void *)ownB);
+    if (s->failed) return NULL;
+    *set = (ClauseSet){ count, taut, total, NULL, NULL, items };
+    return set;
+}
+
+/**
+ * @brief CNF of a subtree (neg = 0) or of its negation (neg = 1), built
+ *        from the children's memoized sets.
+ * @return The set, or NULL if it is over the limit or on malloc failure.
+ */
+static const ClauseSet *subtreeCnf(AnalysisSession *s, int id, int neg) {
+    Subtree *t = &s->nodes[id];
+    if (t->cnfState[neg] == CNF_BUILT) return t->cnf[neg];
+    if (t->cnfState[neg] == CNF_OVER) return NULL;
+
+    const ClauseSet *res = NULL;
+    if (t->kind == SUB_CONST) {
+        res = (t->left ^ neg) ? &EMPTY_SET : &FALSE_SET;
+    } else if (t->kind == SUB_VAR) {
+        res = unitSet(s, neg ? -t->left : t->left);
+    } else if (t->kind == SUB_NOT) {
+        res = subtreeCnf(s, t->right, !neg);
+    } else {
+        /* A * B: CNF is the union, its negation the product; + the other
+           way round; A > B is ~A + B. */
+        int negLeft = t->kind == SUB_IMPLIES ? !neg : neg;
+        int product = t->kind == SUB_AND ? neg : !neg;
+        int left = t->left, right = t->right;
+        const ClauseSet *x = subtreeCnf(s, left, negLeft);
+        const ClauseSet *y = x ? subtreeCnf(s, right, neg) : NULL;
+        if (x && y) res = product ? setProduct(s, x, y) : setUnion(s, x, y);
+        t = &s->nodes[id];
+    }
+    if (s->failed) return NULL;
+    t->cnf[neg] = res;
+    t->cnfState[neg] = res ? CNF_BUILT : CNF_OVER;
+    if (res) s->stats.clauseSets++;
+    return res;
+}
+
+/* ---- Counterexamples ---- */
+
+/**
+ * @brief Values of a subtree under the kept counterexamples, refreshed
+ *        from its children when the set has changed since it was computed.
+ */
+static uint64_t cexSignature(AnalysisSession *s, int id) {
+    const Subtree *t = &s->nodes[id];
+    if (t->cexVersion == s->cexVersion) return t->cex;
+    uint64_t v, l = 0, r = 0;
+    if (t->kind > SUB_NOT) l = cexSignature(s, t->left);
+    if (t->kind > SUB_VAR) r = cexSignature(s, t->right);
+    t = &s->nodes[id];
+    switch (t->kind) {
+    case SUB_CONST: v = t->left ? ~0ULL : 0; break;
+    case SUB_VAR: v = t->left < s->cexVars ? s->cexBits[t->left] : 0; break;
+    case SUB_NOT: v = ~r; break;
+    case SUB_AND: v = l & r; break;
+    case SUB_OR: v = l | r; break;
+    default: v = ~l | r; break;
+    }
+    s->nodes[id].cex = v;
+    s->nodes[id].cexVersion = s->cexVersion;
+    return v;
+}
+
+/**
+ * @brief Keeps a falsifying assignment, replacing the oldest one when all
+ *        64 slots are in use. Variables it does not mention are false.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int addCounterexample(AnalysisSession *s, const ValidityResult *vr) {
+    int need = s->names.count + 1;
+    if (s->cexVars < need) {
+        uint64_t *nb = realloc(s->cexBits, (size_t)need * sizeof(uint64_t));
+        if (!nb) { perror("realloc"); return 0; }
+        memset(nb + s->cexVars, 0, (size_t)(need - s->cexVars) * sizeof(uint64_t));
+        s->cexBits = nb;
+        s->cexVars = need;
+    }
+    int k = s->numCex < 64 ? s->numCex++ : s->nextCex++ % 64;
+    uint64_t bit = 1ULL << k;
+    for (int v = 0; v < s->cexVars; v++) s->cexBits[v] &= ~bit;
+    for (int i = 1; i <= vr->vars.count; i++) {
+        int v = varMapFind(&s->names, vr->vars.names[i - 1]);
+        if (v && vr->falsifying[i]) s->cexBits[v] |= bit;
+    }
+    s->cexVersion++;
+    return 1;
+}
+
+/* ---- Interning ---- */
+
+static uint64_t hashSubtree(SubtreeKind kind, int left, int right) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)kind;
+    h = (h ^ (uint32_t)left) * 0x100000001b3ULL;
+    h = (h ^ (uint32_t)right) * 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+static int growSlots(AnalysisSession *s) {
+    size_t n = s->numSlots ? s->numSlots * 2 : 1024;
+    int *slots = calloc(n, sizeof(int));
+    if (!slots) { perror("calloc"); return 0; }
+    for (int id = 0; id < s->count; id++) {
+        size_t i = s->nodes[id].hash & (n - 1);
+        while (slots[i]) i = (i + 1) & (n - 1);
+        slots[i] = id + 1;
+    }
+    free(s->slots);
+    s->slots = slots;
+    s->numSlots = n;
+    return 1;
+}
+
+/**
+ * @brief Returns the id of a subtree, creating it and computing its
+ *        attributes from its children if it is new.
+ * @return Id, or -1 on malloc failure.
+ */
+static int intern(AnalysisSession *s, SubtreeKind kind, int left, int right) {
+    uint64_t h = hashSubtree(kind, left, right);
+    size_t mask = s->numSlots - 1, i = h & mask;
+    for (; s->slots[i]; i = (i + 1) & mask) {
+        const Subtree *t = &s->nodes[s->slots[i] - 1];
+        if (t->hash == h && t->kind == kind && t->left == left && t->right == right) {
+            s->stats.reusedNodes++;
+            return s->slots[i] - 1;
+        }
+    }
+
+    if (s->count == s->cap) {
+        int ncap = s->cap ? s->cap * 2 : 256;
+        Subtree *nn = realloc(s->nodes, (size_t)ncap * sizeof(Subtree));
+        if (!nn) { perror("realloc"); s->failed = 1; return -1; }
+        s->nodes = nn;
+        s->cap = ncap;
+    }
+    Subtree t = { kind, left, right, h, 1, NULL, 0, 0, 0, { NULL, NULL }, { CNF_NONE, CNF_NONE } };
+    const Subtree *l = left >= 0 && kind > SUB_VAR ? &s->nodes[left] : NULL;
+    const Subtree *r = right >= 0 ? &s->nodes[right] : NULL;
+    switch (kind) {
+    case SUB_CONST:
+        t.sig = left ? ~0ULL : 0;
+        break;
+    case SUB_VAR: {
+        VarSet leaf = { left, (uint32_t)mix64((uint64_t)left), 1, NULL, NULL };
+        t.vars = varSetNode(s, &leaf, NULL, NULL);
+        t.sig = mix64((uint64_t)left ^ 0x5bd1e995u);
+        break;
+    }
+    case SUB_NOT:
+        t.height = r->height + 1;
+        t.vars = r->vars;
+        t.sig = ~r->sig;
+        break;
+    default:
+        t.height = (l->height > r->height ? l->height : r->height) + 1;
+        t.vars = varSetUnion(s, l->vars, r->vars);
+        t.sig = kind == SUB_AND ? l->sig & r->sig
+              : kind == SUB_OR ? l->sig | r->sig
+              : ~l->sig | r->sig;
+        break;
+    }
+    if (s->failed) return -1;
+
+    int id = s->count++;
+    s->nodes[id] = t;
+    s->slots[i] = id + 1;
+    s->stats.newNodes++;
+    s->stats.totalNodes = s->count;
+    if ((size_t)s->count * 2 > s->numSlots && !growSlots(s)) {
+        s->failed = 1;
+        return -1;
+    }
+    return id;
+}
+
+/**
+ * @brief Interns a parse tree bottom-up.
+ * @return Id, or -1 if the tree is malformed or on malloc failure.
+ */
+static int internTree(AnalysisSession *s, const Node *n) {
+    if (!n || !n->tok) return -1;
+    const char *tok = n->tok;
+    if (strcmp(tok, "~") == 0) {
+        int r = internTree(s, n->right);
+        return r < 0 ? -1 : intern(s, SUB_NOT, -1, r);
+    }
+    SubtreeKind kind = strcmp(tok, "*") == 0 ? SUB_AND
+                     : strcmp(tok, "+") == 0 ? SUB_OR
+                     : strcmp(tok, ">") == 0 ? SUB_IMPLIES : SUB_VAR;
+    if (kind != SUB_VAR) {
+        int l = internTree(s, n->left);
+        int r = l < 0 ? -1 : internTree(s, n->right);
+        return r < 0 ? -1 : intern(s, kind, l, r);
+    }
+    if (n->left || n->right) return -1;
+    int value = constantValue(tok);
+    if (value >= 0) return intern(s, SUB_CONST, value, -1);
+    int var = varMapIntern(&s->names, tok);
+    if (!var) { s->failed = 1; return -1; }
+    return intern(s, SUB_VAR, var, -1);
+}
+
+/* ---- Public interface ---- */
+
+/**
+ * @copydoc analysisSessionNew
+ */
+AnalysisSession *analysisSessionNew(void) {
+    AnalysisSession *s = calloc(1, sizeof(AnalysisSession));
+    if (!s) { perror("calloc"); return NULL; }
+    varMapInit(&s->names);
+    s->root = -1;
+    s->cexVersion = 1;
+    if (!growSlots(s)) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * @copydoc analysisSessionFree
+ */
+void analysisSessionFree(AnalysisSession *s) {
+    if (!s) return;
+    while (s->chunks) {
+        Chunk *next = s->chunks->next;
+        free(s->chunks);
+        s->chunks = next;
+    }
+    varMapFree(&s->names);
+    free(s->cexBits);
+    free(s->nodes);
+    free(s->slots);
+    free(s);
+}
+
+/**
+ * @copydoc analysisLoad
+ */
+int analysisLoad(AnalysisSession *s, const Node *root) {
+    s->stats.newNodes = s->stats.reusedNodes = 0;
+    int id = internTree(s, root);
+    if (id < 0) {
+        if (!s->failed) printf("Error: Malformed parse tree.\n");
+        return 0;
+    }
+    s->root = id;
+    return 1;
+}
+
+/**
+ * @copydoc analysisEdit
+ */
+int analysisEdit(AnalysisSession *s, const char *path, const Node *sub) {
+    if (s->root < 0) {
+        printf("Error: No formula loaded.\n");
+        return 0;
+    }
+    if (strcmp(path, ".") == 0) path = "";
+    int depth = (int)strlen(path);
+    int *spine = malloc((size_t)(depth + 1) * sizeof(int));
+    if (!spine) { perror("malloc"); return 0; }
+
+    spine[0] = s->root;
+    for (int k = 0; k < depth; k++) {
+        const Subtree *t = &s->nodes[spine[k]];
+        int next = path[k] == 'l' && t->kind > SUB_NOT ? t->left
+                 : path[k] == 'r' && t->kind > SUB_VAR ? t->right : -1;
+        if (next < 0) {
+            printf("Error: Path '%s' leaves the formula at step %d.\n", path, k + 1);
+            free(spine);
+            return 0;
+        }
+        spine[k + 1] = next;
+    }
+
+    s->stats.newNodes = s->stats.reusedNodes = 0;
+    int id = internTree(s, sub);
+    for (int k = depth - 1; k >= 0 && id >= 0; k--) {
+        const Subtree *t = &s->nodes[spine[k]];
+        id = path[k] == 'l' ? intern(s, t->kind, id, t->right)
+                            : intern(s, t->kind, t->left, id);
+    }
+    free(spine);
+    if (id < 0) {
+        if (!s->failed) printf("Error: Malformed parse tree.\n");
+        return 0;
+    }
+    s->root = id;
+    return 1;
+}
+
+/**
+ * @copydoc analysisReport
+ */
+int analysisReport(AnalysisSession *s, AnalysisReport *r) {
+    if (s->root < 0) {
+        printf("Error: No formula loaded.\n");
+        return 0;
+    }
+    s->stats.clauseSets = 0;
+    const ClauseSet *cnf = subtreeCnf(s, s->root, 0);
+    if (s->failed) return 0;
+    const Subtree *t = &s->nodes[s->root];
+    r->height = t->height;
+    r->numVars = t->vars ? t->vars->size : 0;
+    r->signature = t->sig;
+    r->clauses = cnf ? cnf->count : -1;
+    r->tautologies = cnf ? cnf->tautologies : -1;
+    r->valid = 0;
+    uint64_t known = s->numCex < 64 ? (1ULL << s->numCex) - 1 : ~0ULL;
+    if (t->sig != ~0ULL) {
+        r->decidedBy = VERDICT_SIGNATURE;
+    } else if (s->numCex && (cexSignature(s, s->root) & known) != known) {
+        r->decidedBy = VERDICT_COUNTEREXAMPLE;
+    } else if (cnf) {
+        r->decidedBy = VERDICT_CNF;
+        r->valid = cnf->count == cnf->tautologies;
+    } else {
+        r->decidedBy = VERDICT_REFUTATION;
+        Node *root = analysisTree(s);
+        if (!root) return 0;
+        ValidityResult vr;
+        checkValidityByRefutation(root, &vr);
+        freeTree(root);
+        r->valid = vr.valid;
+        int ok = vr.valid == 1 || (vr.valid == 0 && vr.falsifying && addCounterexample(s, &vr));
+        freeValidityResult(&vr);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @copydoc analysisGetStats
+ */
+AnalysisStats analysisGetStats(const AnalysisSession *s) {
+    return s->stats;
+}
+
+static Node *buildTree(const AnalysisSession *s, int id) {
+    static const char *const ops[] = { NULL, NULL, "~", "*", "+", ">" };
+    const Subtree *t = &s->nodes[id];
+    if (t->kind == SUB_CONST) return newNode(t->left ? "1" : "0");
+    if (t->kind == SUB_VAR) return newNode(s->names.names[t->left - 1]);
+    Node *n = newNode(ops[t->kind]);
+    if (!n) return NULL;
+    if (t->kind != SUB_NOT && !(n->left = buildTree(s, t->left))) {
+        freeTree(n);
+        return NULL;
+    }
+    if (!(n->right = buildTree(s, t->right))) {
+        freeTree(n);
+        return NULL;
+    }
+    return n;
+}
+
+/**
+ * @copydoc analysisTree
+ */
+Node *analysisTree(const AnalysisSession *s) {
+    return s->root < 0 ? NULL : buildTree(s, s->root);
+}
+
+/**
+ * @copydoc analysisPrintCnf
+ */
+int analysisPrintCnf(AnalysisSession *s, FILE *out) {
+    if (s->root < 0) return 0;
+    const ClauseSet *cnf = subtreeCnf(s, s->root, 0);
+    if (!cnf) return 0;
+    Clause *const *owned;
+    Clause *const *items = flattenSet(cnf, &owned);
+    if (!items && cnf->count) return 0;
+    for (long long i = 0; i < cnf->count; i++) {
+        const Clause *c = items[i];
+        fprintf(out, "(");
+        for (int j = 0; j < c->size; j++) {
+            int v = c->lits[j] < 0 ? -c->lits[j] : c->lits[j];
+            fprintf(out, "%s%s%s", j ? " + " : "", c->lits[j] < 0 ? "~" : "", s->names.names[v - 1]);
+        }
+        fprintf(out, ")%s\n", c->tautology ? "   valid" : "");
+    }
+    free((void *)owned);
+    return 1;
+}
+
+/**
+ * @copydoc analysisPrintVars
+ */
+void analysisPrintVars(const AnalysisSession *s, FILE *out) {
+    int first = 1;
+    if (s->root >= 0) printVarSet(s, s->nodes[s->root].vars, &first, out);
+    fprintf(out, "\n");
+}
@@ -0,0 +1,117 @@
+/**
+ * @file incrementalAnalysis.h
+ * @brief Header for a persistent analysis session that re-analyzes a
+ *        formula after local edits.
+ */
+
+#ifndef INCREMENTAL_ANALYSIS_H
+#define INCREMENTAL_ANALYSIS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "common.h"
+
+/**
+ * @brief Opaque session: every subtree seen so far, hash-consed, with its
+ *        derived results memoized.
+ */
+typedef struct AnalysisSession AnalysisSession;
+
+/**
+ * @brief What decided validity, cheapest first.
+ */
+typedef enum {
+    VERDICT_SIGNATURE,        /**< False under one of the 64 fixed assignments */
+    VERDICT_COUNTEREXAMPLE,   /**< False under a falsifying assignment found earlier */
+    VERDICT_CNF,              /**< Every CNF clause valid, or one is not */
+    VERDICT_REFUTATION        /**< checkValidityByRefutation (CNF over the limit) */
+} AnalysisVerdict;
+
+/**
+ * @brief Results for the current formula.
+ */
+typedef struct {
+    int height;               /**< As maxHeightOfParseTree */
+    int numVars;              /**< Distinct variables */
+    uint64_t signature;       /**< Truth values under 64 fixed random assignments */
+    long long clauses;        /**< Clauses of the Task 6 CNF, -1 if over the limit */
+    long long tautologies;    /**< Of which valid, as counted by checkCNFValidity */
+    int valid;                /**< 1 valid, 0 not valid */
+    AnalysisVerdict decidedBy;
+} AnalysisReport;
+
+/**
+ * @brief Work done by the last load or edit.
+ */
+typedef struct {
+    long newNodes;            /**< Subtrees analyzed for the first time */
+    long reusedNodes;         /**< Subtrees found in the session */
+    long clauseSets;          /**< CNF clause sets built by the last report */
+    long totalNodes;          /**< Distinct subtrees held by the session */
+} AnalysisStats;
+
+/**
+ * @brief Creates an empty session.
+ * @return Session, or NULL on malloc failure.
+ */
+AnalysisSession *analysisSessionNew(void);
+
+/**
+ * @brief Frees a session.
+ */
+void analysisSessionFree(AnalysisSession *s);
+
+/**
+ * @brief Makes a parse tree the current formula; subtrees already in the
+ *        session are not analyzed again.
+ * @param root Parse tree (not kept).
+ * @return 1 on success, 0 on a malformed tree or malloc failure.
+ */
+int analysisLoad(AnalysisSession *s, const Node *root);
+
+/**
+ * @brief Replaces one subtree of the current formula. Only the subtree
+ *        and the path above it are analyzed.
+ * @param path Characters 'l' and 'r' leading from the root to the subtree
+ *        (the operand of ~ is its right child); "" or "." is the root.
+ * @param sub Replacement parse tree (not kept).
+ * @return 1 on success, 0 on a bad path, malformed tree or malloc failure
+ *         (reported on stdout).
+ */
+int analysisEdit(AnalysisSession *s, const char *path, const Node *sub);
+
+/**
+ * @brief Reports on the current formula, building the CNF clause sets of
+ *        subtrees that do not have them yet. When the CNF is over the
+ *        limit and no known assignment falsifies the formula, validity is
+ *        decided by refutation and a falsifying assignment is kept for
+ *        later reports.
+ * @return 1 on success, 0 if no formula is loaded or on error.
+ */
+int analysisReport(AnalysisSession *s, AnalysisReport *r);
+
+/**
+ * @brief Counters of the last load, edit and report.
+ */
+AnalysisStats analysisGetStats(const AnalysisSession *s);
+
+/**
+ * @brief Rebuilds the current formula as a parse tree.
+ * @return Tree (free with freeTree), or NULL if none is loaded or on
+ *         malloc failure.
+ */
+Node *analysisTree(const AnalysisSession *s);
+
+/**
+ * @brief Writes the CNF of the current formula, one clause per line.
+ * @return 1 on success, 0 if there is none or it is over the limit.
+ */
+int analysisPrintCnf(AnalysisSession *s, FILE *out);
+
+/**
+ * @brief Writes the variables of the current formula in order of first
+ *        appearance in the session, separated by spaces.
+ */
+void analysisPrintVars(const AnalysisSession *s, FILE *out);
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file incrementalQuery.c
+ * @brief Answers many related SAT queries with one incremental solver.
+ *
+ * Related questions about one base formula (validity under different
+ * fixings, equivalence of sub-formulas) share most of their search. A
+ * single solver handle keeps learned clauses, variable activities and
+ * watch lists between queries, so later queries start warm.
+ * @section algo Algorithm: Assumption-based incremental CDCL
+ * @section time Time Complexity: one CDCL call per query (warm start)
+ * @section space Space Complexity: O(L) for the shared solver
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "incrementalQuery.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LINE_MAX_LEN 65536
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Parses a 0-terminated literal list.
+ * @return Number of literals, or -1 if the list is not 0-terminated.
+ */
+static int parseLits(char *text, int *lits, int max) {
+    int n = 0;
+    char *save = NULL;
+    char *tok = strtok_r(text, " \t\r\n", &save);
+    while (tok) {
+        int lit = atoi(tok);
+        if (lit == 0) return n;
+        if (n == max) return -1;
+        lits[n++] = lit;
+        tok = strtok_r(NULL, " \t\r\n", &save);
+    }
+    return -1;
+}
+
+/**
+ * @brief Builds a fresh solver from the base formula plus added clauses.
+ */
+static Solver *coldSolver(const CnfFormula *f, const int *extra, int extraLen) {
+    Solver *s = solverFromFormula(f);
+    if (!s) return NULL;
+    int i = 0;
+    while (i < extraLen) {
+        int n = extra[i];
+        solverAddClause(s, extra + i + 1, n);
+        i += n + 1;
+    }
+    return s;
+}
+
+/**
+ * @copydoc runIncrementalQueries
+ */
+int runIncrementalQueries(const CnfFormula *f, FILE *in, FILE *out, int cold, QueryReport *report) {
+    memset(report, 0, sizeof(*report));
+    char *line = malloc(LINE_MAX_LEN);
+    int *lits = malloc(LINE_MAX_LEN * sizeof(int));
+    int *extra = NULL, extraLen = 0, extraCap = 0;   /* added clauses, length-prefixed */
+    double t0 = nowSeconds();
+    Solver *shared = cold ? NULL : solverFromFormula(f);
+    int ok = line && lits && (cold || shared);
+
+    while (ok && fgets(line, LINE_MAX_LEN, in)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == 'c' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        char kind = *p++;
+        int n = parseLits(p, lits, LINE_MAX_LEN);
+        if ((kind != 'a' && kind != 's') || n < 0) {
+            printf("Error: Malformed query line: %s", line);
+            ok = 0;
+            break;
+        }
+
+        if (kind == 'a') {
+            report->added++;
+            if (shared) solverAddClause(shared, lits, n);
+            if (extraLen + n + 1 > extraCap) {
+                int ncap = extraCap ? extraCap * 2 : 1024;
+                while (ncap < extraLen + n + 1) ncap *= 2;
+                int *ne = realloc(extra, (size_t)ncap * sizeof(int));
+                if (!ne) { perror("realloc"); ok = 0; break; }
+                extra = ne;
+                extraCap = ncap;
+            }
+            extra[extraLen++] = n;
+            memcpy(extra + extraLen, lits, (size_t)n * sizeof(int));
+            extraLen += n;
+            continue;
+        }
+
+        Solver *s = shared ? shared : coldSolver(f, extra, extraLen);
+        if (!s) { ok = 0; break; }
+        int res = solverSolve(s, lits, n);
+        report->solves++;
+        if (res == SOLVER_SAT) {
+            report->sat++;
+            fprintf(out, "SAT\n");
+        } else if (res == SOLVER_UNSAT) {
+            const int *failed;
+            int nf = solverFailedAssumptions(s, &failed);
+            report->unsat++;
+            fprintf(out, "UNSAT failed:");
+            for (int i = 0; i < nf; i++) fprintf(out, " %d", failed[i]);
+            fprintf(out, "\n");
+        } else {
+            report->unknown++;
+            fprintf(out, "UNKNOWN\n");
+        }
+        if (!shared) {
+            report->stats.conflicts += solverGetStats(s).conflicts;
+            solverFree(s);
+        }
+    }
+
+    report->seconds = nowSeconds() - t0;
+    if (shared) {
+        report->stats = solverGetStats(shared);
+        solverFree(shared);
+    }
+    free(extra);
+    free(lits);
+    free(line);
+    return ok;
+}
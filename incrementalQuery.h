@@ -0,0 +1,47 @@
+/**
+ * @file incrementalQuery.h
+ * @brief Header for answering query scripts against one solver handle.
+ */
+
+#ifndef INCREMENTAL_QUERY_H
+#define INCREMENTAL_QUERY_H
+
+#include <stdio.h>
+#include "cnfFormula.h"
+#include "satSolver.h"
+
+/**
+ * @brief Summary of a query script run.
+ */
+typedef struct {
+    int solves;          /**< 's' lines answered */
+    int sat;
+    int unsat;
+    int unknown;
+    int added;           /**< 'a' lines (clauses added) */
+    double seconds;      /**< Wall time spent building solvers and solving */
+    SolverStats stats;   /**< Counters of the shared handle (incremental mode) */
+} QueryReport;
+
+/**
+ * @brief Runs a query script over a base formula.
+ *
+ * Script lines (DIMACS literals, each list terminated by 0):
+ *   - "a l1 l2 ... 0"  add a clause permanently
+ *   - "s l1 l2 ... 0"  solve under the listed assumptions
+ *   - lines starting with 'c' are comments
+ *
+ * Each 's' line prints "SAT" or "UNSAT failed: <assumptions>" to out. In
+ * incremental mode one solver handle answers every query; in cold mode a
+ * fresh solver is built for each query, which is the cost being avoided.
+ *
+ * @param f Base formula.
+ * @param in Query script.
+ * @param out Destination for per-query answers.
+ * @param cold Non-zero to rebuild the solver for every query.
+ * @param report Output summary.
+ * @return 1 on success, 0 on a malformed line or allocation failure.
+ */
+int runIncrementalQueries(const CnfFormula *f, FILE *in, FILE *out, int cold, QueryReport *report);
+
+#endif
@@ -0,0 +1,273 @@
+/**
+ * @file instrument.c
+ * @brief Per-phase wall/CPU timers, allocation counters and memory peaks.
+ *
+ * One clock() pair around the whole pipeline cannot say which task
+ * dominates, and it also counted the time the user spent answering the
+ * truth-table prompts. Each phase here has its own monotonic wall clock
+ * and process CPU clock, stopped while a prompt waits for input.
+ * @section algo Algorithm:
+ *   - Boundaries: CLOCK_MONOTONIC and CLOCK_PROCESS_CPUTIME_ID reads
+ *   - Counters: relaxed atomic adds from newNode/strdup_s, only when on
+ *   - Memory: getrusage peak RSS and (glibc) heap in use at each phase end
+ *   - Cache: perf_event_open hardware counters on Linux, when available
+ * @section time Time Complexity: O(1) per boundary, O(n) tree sizing when on
+ * @section space Space Complexity: O(phases)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "instrument.h"
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2 1
+#endif
+
+/**
+ * @brief Measurements of one phase.
+ */
+typedef struct {
+    const char *name;
+    int ran;
+    double wall, cpu;          /**< Seconds, pauses excluded */
+    long long nodes, bytes;    /**< Allocated during the phase */
+    long peakRssKb;            /**< Process peak RSS at phase end */
+    long heapKb;               /**< Heap in use at phase end (-1 unknown) */
+    long long treeNodes;       /**< Size of the phase's tree (-1 none) */
+    int treeHeight;
+} PhaseRecord;
+
+int phaseCountersOn = 0;
+
+static PhaseRecord phases[PHASE_COUNT] = {
+    { "parse" }, { "prefix" }, { "tree" }, { "traversal" },
+    { "height" }, { "simplify" }, { "evaluation" }, { "cnf" }, { "validity" }
+};
+static atomic_llong nodeCounter, byteCounter;
+static long long nodesAtBegin, bytesAtBegin;
+static double wallAtBegin, cpuAtBegin, wallPaused, cpuPaused;
+static double pauseWall, pauseCpu;
+
+static double readClock(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @copydoc instrumentEnable
+ */
+void instrumentEnable(int on) {
+    phaseCountersOn = on;
+}
+
+/**
+ * @copydoc phaseCountAlloc
+ */
+void phaseCountAlloc(long long nodes, size_t bytes) {
+    atomic_fetch_add_explicit(&nodeCounter, nodes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&byteCounter, (long long)bytes, memory_order_relaxed);
+}
+
+/**
+ * @copydoc phaseBegin
+ */
+void phaseBegin(Phase p) {
+    (void)p;
+    wallPaused = cpuPaused = 0;
+    nodesAtBegin = atomic_load_explicit(&nodeCounter, memory_order_relaxed);
+    bytesAtBegin = atomic_load_explicit(&byteCounter, memory_order_relaxed);
+    cpuAtBegin = readClock(CLOCK_PROCESS_CPUTIME_ID);
+    wallAtBegin = readClock(CLOCK_MONOTONIC);
+}
+
+/**
+ * @copydoc phasePause
+ */
+void phasePause(void) {
+    pauseWall = readClock(CLOCK_MONOTONIC);
+    pauseCpu = readClock(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+/**
+ * @copydoc phaseResume
+ */
+void phaseResume(void) {
+    wallPaused += readClock(CLOCK_MONOTONIC) - pauseWall;
+    cpuPaused += readClock(CLOCK_PROCESS_CPUTIME_ID) - pauseCpu;
+}
+
+static void sizeTree(const Node *n, int depth, long long *count, int *height) {
+    if (!n) return;
+    (*count)++;
+    if (depth > *height) *height = depth;
+    sizeTree(n->left, depth + 1, count, height);
+    sizeTree(n->right, depth + 1, count, height);
+}
+
+/**
+ * @copydoc phaseEnd
+ */
+void phaseEnd(Phase p, const Node *tree) {
+    double wall = readClock(CLOCK_MONOTONIC);
+    double cpu = readClock(CLOCK_PROCESS_CPUTIME_ID);
+    PhaseRecord *r = &phases[p];
+    r->ran = 1;
+    r->wall = wall - wallAtBegin - wallPaused;
+    r->cpu = cpu - cpuAtBegin - cpuPaused;
+    r->nodes = r->bytes = 0;
+    r->peakRssKb = r->heapKb = -1;
+    r->treeNodes = -1;
+    r->treeHeight = 0;
+    if (!phaseCountersOn) return;
+
+    r->nodes = atomic_load_explicit(&nodeCounter, memory_order_relaxed) - nodesAtBegin;
+    r->bytes = atomic_load_explicit(&byteCounter, memory_order_relaxed) - bytesAtBegin;
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) r->peakRssKb = ru.ru_maxrss;
+#ifdef HAVE_MALLINFO2
+    struct mallinfo2 mi = mallinfo2();
+    r->heapKb = (long)((mi.uordblks + mi.hblkhd) / 1024);
+#endif
+    if (tree) {
+        r->treeNodes = 0;
+        sizeTree(tree, 1, &r->treeNodes, &r->treeHeight);
+    }
+}
+
+/**
+ * @copydoc phaseTotalSeconds
+ */
+double phaseTotalSeconds(void) {
+    double total = 0;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        if (phases[i].ran) total += phases[i].wall;
+    }
+    return total;
+}
+
+static void writeLabel(FILE *out, const char *s, int csv) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"') fputs(csv ? "\"\"" : "\\\"", out);
+        else if (*s == '\\' && !csv) fputs("\\\\", out);
+        else if ((unsigned char)*s >= 0x20) fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * @copydoc writePhaseReport
+ */
+void writePhaseReport(FILE *out, int csv, const char *input) {
+    if (csv) {
+        if (ftell(out) <= 0)
+            fprintf(out, "input,phase,wall_s,cpu_s,nodes,bytes,peak_rss_kb,heap_kb,tree_nodes,tree_height\n");
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            const PhaseRecord *r = &phases[i];
+            if (!r->ran) continue;
+            writeLabel(out, input, 1);
+            fprintf(out, ",%s,%.9f,%.9f,%lld,%lld,%ld,%ld,%lld,%d\n", r->name, r->wall, r->cpu,
+                    r->nodes, r->bytes, r->peakRssKb, r->heapKb, r->treeNodes, r->treeHeight);
+        }
+        return;
+    }
+    fprintf(out, "{\"input\":");
+    writeLabel(out, input, 0);
+    fprintf(out, ",\"total_wall_s\":%.9f,\"phases\":[", phaseTotalSeconds());
+    int first = 1;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseRecord *r = &phases[i];
+        if (!r->ran) continue;
+        fprintf(out, "%s{\"phase\":\"%s\",\"wall_s\":%.9f,\"cpu_s\":%.9f,\"nodes\":%lld,\"bytes\":%lld"
+                     ",\"peak_rss_kb\":%ld,\"heap_kb\":%ld",
+                first ? "" : ",", r->name, r->wall, r->cpu, r->nodes, r->bytes, r->peakRssKb, r->heapKb);
+        if (r->treeNodes >= 0) fprintf(out, ",\"tree_nodes\":%lld,\"tree_height\":%d", r->treeNodes, r->treeHeight);
+        fputc('}', out);
+        first = 0;
+    }
+    fprintf(out, "]}\n");
+}
+
+#ifdef __linux__
+static int openHardwareCounter(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/**
+ * @copydoc cacheCountersOpen
+ */
+int cacheCountersOpen(CacheCounters *c) {
+    c->refsFd = c->missesFd = -1;
+#ifdef __linux__
+    c->refsFd = openHardwareCounter(PERF_COUNT_HW_CACHE_REFERENCES);
+    c->missesFd = openHardwareCounter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    return c->missesFd >= 0;
+}
+
+/**
+ * @copydoc cacheCountersStart
+ */
+void cacheCountersStart(CacheCounters *c) {
+#ifdef __linux__
+    int fds[2] = { c->refsFd, c->missesFd };
+    for (int i = 0; i < 2; i++) {
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)c;
+#endif
+}
+
+/**
+ * @copydoc cacheCountersStop
+ */
+void cacheCountersStop(CacheCounters *c, long long *refs, long long *misses) {
+    *refs = *misses = -1;
+#ifdef __linux__
+    int fds[2] = { c->refsFd, c->missesFd };
+    long long *out[2] = { refs, misses };
+    for (int i = 0; i < 2; i++) {
+        long long value;
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fds[i], &value, sizeof(value)) == (ssize_t)sizeof(value)) *out[i] = value;
+    }
+#else
+    (void)c;
+#endif
+}
+
+/**
+ * @copydoc cacheCountersClose
+ */
+void cacheCountersClose(CacheCounters *c) {
+#ifdef __linux__
+    if (c->refsFd >= 0) close(c->refsFd);
+    if (c->missesFd >= 0) close(c->missesFd);
+#endif
+    c->refsFd = c->missesFd = -1;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file instrument.h
+ * @brief Header for per-phase timers, allocation counters and memory peaks.
+ */
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "common.h"
+
+/**
+ * @brief Phases of the interactive pipeline, in execution order.
+ */
+typedef enum {
+    PHASE_PARSE,        /**< Reading the input (.cnf file to infix) */
+    PHASE_PREFIX,       /**< Task 1: infix to prefix */
+    PHASE_TREE,         /**< Task 2: prefix to parse tree */
+    PHASE_TRAVERSAL,    /**< Task 3: in-order printing */
+    PHASE_HEIGHT,       /**< Task 4: tree height */
+    PHASE_SIMPLIFY,     /**< Simplification before Tasks 5 and 6 */
+    PHASE_EVALUATION,   /**< Task 5: truth table */
+    PHASE_CNF,          /**< Task 6: CNF conversion */
+    PHASE_VALIDITY,     /**< Task 7: clause validity */
+    PHASE_COUNT
+} Phase;
+
+/**
+ * @brief Non-zero while allocation counting is on (see instrumentEnable).
+ */
+extern int phaseCountersOn;
+
+/**
+ * @brief Turns the detailed counters on or off.
+ *
+ * Phase timers always run (two clock reads per boundary). The node and
+ * byte counters, heap and RSS samples and the tree size/height taken at
+ * each phase end only run when enabled. Call before starting threads.
+ */
+void instrumentEnable(int on);
+
+/**
+ * @brief Starts timing a phase (one phase runs at a time).
+ */
+void phaseBegin(Phase p);
+
+/**
+ * @brief Stops timing the current phase.
+ * @param p Phase being ended.
+ * @param tree Tree the phase produced or inspected, sized when counters
+ *        are on (may be NULL).
+ */
+void phaseEnd(Phase p, const Node *tree);
+
+/**
+ * @brief Stops the clocks of the current phase while waiting for the user.
+ */
+void phasePause(void);
+
+/**
+ * @brief Restarts the clocks after phasePause.
+ */
+void phaseResume(void);
+
+/**
+ * @brief Returns the wall time of all phases, excluding pauses.
+ */
+double phaseTotalSeconds(void);
+
+/**
+ * @brief Adds to the allocation counters; use phaseNoteAlloc.
+ */
+void phaseCountAlloc(long long nodes, size_t bytes);
+
+/**
+ * @brief Counts an allocation when counters are on; a single predictable
+ *        branch otherwise.
+ */
+static inline void phaseNoteAlloc(long long nodes, size_t bytes) {
+    if (phaseCountersOn) phaseCountAlloc(nodes, bytes);
+}
+
+/**
+ * @brief Hardware cache counters of the calling thread (Linux perf
+ *        events), for comparing memory layouts of the same computation.
+ */
+typedef struct {
+    int refsFd;         /**< Last-level cache references, -1 if unavailable */
+    int missesFd;       /**< Last-level cache misses, -1 if unavailable */
+} CacheCounters;
+
+/**
+ * @brief Opens the counters, stopped and at zero.
+ * @return 1 if the hardware provides them, 0 otherwise (for example in
+ *         virtual machines without a PMU); the other calls are then
+ *         no-ops.
+ */
+int cacheCountersOpen(CacheCounters *c);
+
+/**
+ * @brief Zeroes and starts the counters.
+ */
+void cacheCountersStart(CacheCounters *c);
+
+/**
+ * @brief Stops the counters and reads them.
+ * @param refs Output: cache references, -1 if unavailable.
+ * @param misses Output: cache misses, -1 if unavailable.
+ */
+void cacheCountersStop(CacheCounters *c, long long *refs, long long *misses);
+
+/**
+ * @brief Closes the counters.
+ */
+void cacheCountersClose(CacheCounters *c);
+
+/**
+ * @brief Writes the phase records.
+ *
+ * JSON is one object per run on one line; CSV is one row per phase, with
+ * a header line when the stream is at offset 0 (so runs can be appended
+ * to one file).
+ *
+ * @param out Destination.
+ * @param csv Non-zero for CSV, zero for JSON.
+ * @param input Label of the run (formula or file name).
+ */
+void writePhaseReport(FILE *out, int csv, const char *input);
+
+#endif
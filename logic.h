@@ -0,0 +1,121 @@
+/**
+ * @file logic.h
+ * @brief Public interface of liblogic: reentrant parsing, evaluation,
+ *        CNF conversion and validity checking.
+ *
+ * Every call takes the LogicContext it works in. A context owns its
+ * allocator, its symbol table and its scratch buffers and is used by one
+ * thread at a time; threads with their own contexts share no mutable
+ * state, so they can process formulas concurrently. There are no fixed
+ * size limits: every buffer grows with the input.
+ */
+
+#ifndef LOGIC_H
+#define LOGIC_H
+
+#include <stddef.h>
+#include "common.h"
+
+/**
+ * @brief Memory hooks of a context. All three must be set; user is
+ *        passed back unchanged.
+ */
+typedef struct {
+    void *(*alloc)(void *user, size_t size);
+    void *(*grow)(void *user, void *ptr, size_t size);
+    void (*release)(void *user, void *ptr);
+    void *user;
+} LogicAllocator;
+
+/**
+ * @brief Opaque per-thread working state.
+ */
+typedef struct LogicContext LogicContext;
+
+/**
+ * @brief Creates a context.
+ *
+ * The allocator serves the context and its scratch buffers. Parse trees
+ * and the symbol table use malloc, so trees stay valid after the context
+ * is freed and can be released with freeTree.
+ *
+ * @param allocator Memory hooks, or NULL for malloc/realloc/free.
+ * @return New context, or NULL on allocation failure.
+ */
+LogicContext *logicContextNew(const LogicAllocator *allocator);
+
+/**
+ * @brief Frees a context and everything it owns (not the trees it built).
+ */
+void logicContextFree(LogicContext *ctx);
+
+/**
+ * @brief Forgets the interned variables but keeps the scratch buffers,
+ *        so a long-lived context can serve unrelated formulas.
+ */
+void logicContextReset(LogicContext *ctx);
+
+/**
+ * @brief Parses an infix formula (Tasks 1 and 2) and interns its
+ *        variables in the context's symbol table.
+ * @param ctx Context.
+ * @param infix Formula using ~ * + > and parentheses.
+ * @return Parse tree (free with freeTree), or NULL if malformed.
+ */
+Node *logicParse(LogicContext *ctx, const char *infix);
+
+/**
+ * @brief Height of a parse tree (Task 4).
+ */
+int logicHeight(const Node *root);
+
+/**
+ * @brief Number of variables interned so far.
+ */
+int logicNumVariables(const LogicContext *ctx);
+
+/**
+ * @brief Name of variable index (1-based), or NULL if out of range.
+ */
+const char *logicVariableName(const LogicContext *ctx, int index);
+
+/**
+ * @brief Index (1-based) of a variable name, or 0 if unknown.
+ */
+int logicVariableIndex(const LogicContext *ctx, const char *name);
+
+/**
+ * @brief Evaluates a formula under one assignment.
+ *
+ * Iterative, so deep trees do not consume the thread's stack.
+ *
+ * @param ctx Context whose symbol table numbers the variables.
+ * @param root Formula.
+ * @param values values[i-1] is the value (0/1) of variable index i.
+ * @return 1 true, 0 false, -1 on an unknown variable or malformed tree.
+ */
+int logicEvaluate(LogicContext *ctx, const Node *root, const unsigned char *values);
+
+/**
+ * @brief Converts a formula to CNF (Task 6); the input is not modified.
+ * @return New tree (free with freeTree), or NULL on failure.
+ */
+Node *logicToCNF(LogicContext *ctx, const Node *root);
+
+/**
+ * @brief Checks a CNF tree clause by clause (Task 7).
+ * @param ctx Context.
+ * @param cnf CNF tree.
+ * @param validClauses Output: tautological clauses (may be NULL).
+ * @param invalidClauses Output: other clauses (may be NULL).
+ * @return 1 if every clause is a tautology, else 0.
+ */
+int logicCNFIsValid(LogicContext *ctx, const Node *cnf, int *validClauses, int *invalidClauses);
+
+/**
+ * @brief Decides validity of any formula by refuting its negation.
+ * @return 1 valid, 0 not valid, -1 on malformed input.
+ */
+int logicIsValid(LogicContext *ctx, const Node *root);
+
+#endif
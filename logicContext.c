@@ -0,0 +1,222 @@
+/**
+ * @file logicContext.c
+ * @brief Reentrant front end over the Task 1-7 modules.
+ *
+ * The task modules keep no global state, so the only shared resources a
+ * caller can trip over are buffers. A LogicContext holds the prefix
+ * buffer, the evaluation stacks and the symbol table, and grows them on
+ * demand, so each thread works entirely inside its own context.
+ * @section algo Algorithm: Thin wrappers + iterative postorder evaluation
+ * @section time Time Complexity: as the wrapped tasks; evaluation O(n)
+ * @section space Space Complexity: O(n) scratch per context
+ */
+
+#include "logic.h"
+#include "varMap.h"
+#include "validity.h"
+#include "task1.h"
+#include "task2.h"
+#include "task3.h"
+#include "task5.h"
+#include "task6.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief One pending node of the iterative evaluator.
+ */
+typedef struct {
+    const Node *node;
+    int expanded;            /**< Children already scheduled */
+} EvalFrame;
+
+struct LogicContext {
+    LogicAllocator mem;
+    VarMap symbols;
+    char *prefix;            /**< Task 1 output buffer */
+    size_t prefixCap;
+    EvalFrame *frames;       /**< Evaluation work stack */
+    int frameCap;
+    unsigned char *vals;     /**< Evaluation value stack */
+    int valCap;
+};
+
+static void *stdAlloc(void *user, size_t size) { (void)user; return malloc(size); }
+static void *stdGrow(void *user, void *ptr, size_t size) { (void)user; return realloc(ptr, size); }
+static void stdRelease(void *user, void *ptr) { (void)user; free(ptr); }
+
+/**
+ * @brief Grows a scratch buffer to at least need elements of size elem.
+ * @return 1 on success, 0 on allocation failure.
+ */
+static int reserve(LogicContext *ctx, void **buf, int *cap, int need, size_t elem) {
+    if (need <= *cap) return 1;
+    int ncap = *cap ? *cap : 64;
+    while (ncap < need) ncap *= 2;
+    void *nb = ctx->mem.grow(ctx->mem.user, *buf, (size_t)ncap * elem);
+    if (!nb) { perror("realloc"); return 0; }
+    *buf = nb;
+    *cap = ncap;
+    return 1;
+}
+
+/**
+ * @copydoc logicContextNew
+ */
+LogicContext *logicContextNew(const LogicAllocator *allocator) {
+    LogicAllocator mem = { stdAlloc, stdGrow, stdRelease, NULL };
+    if (allocator) mem = *allocator;
+    LogicContext *ctx = mem.alloc(mem.user, sizeof(LogicContext));
+    if (!ctx) { perror("malloc"); return NULL; }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mem = mem;
+    varMapInit(&ctx->symbols);
+    return ctx;
+}
+
+/**
+ * @copydoc logicContextFree
+ */
+void logicContextFree(LogicContext *ctx) {
+    if (!ctx) return;
+    varMapFree(&ctx->symbols);
+    ctx->mem.release(ctx->mem.user, ctx->prefix);
+    ctx->mem.release(ctx->mem.user, ctx->frames);
+    ctx->mem.release(ctx->mem.user, ctx->vals);
+    ctx->mem.release(ctx->mem.user, ctx);
+}
+
+/**
+ * @copydoc logicContextReset
+ */
+void logicContextReset(LogicContext *ctx) {
+    varMapFree(&ctx->symbols);
+    varMapInit(&ctx->symbols);
+}
+
+/**
+ * @copydoc logicParse
+ */
+Node *logicParse(LogicContext *ctx, const char *infix) {
+    // Prefix tokens plus separators never exceed 2n + 1 characters
+    size_t need = 2 * strlen(infix) + 2;
+    if (need > ctx->prefixCap) {
+        char *np = ctx->mem.grow(ctx->mem.user, ctx->prefix, need);
+        if (!np) { perror("realloc"); return NULL; }
+        ctx->prefix = np;
+        ctx->prefixCap = need;
+    }
+    inFixToPreFix((char*)infix, ctx->prefix);
+
+    Node *root = NULL;
+    convertPreOrderToTree(&root, ctx->prefix);
+    if (root && !varMapCollect(&ctx->symbols, root)) {
+        freeTree(root);
+        return NULL;
+    }
+    return root;
+}
+
+/**
+ * @copydoc logicHeight
+ */
+int logicHeight(const Node *root) {
+    return maxHeightOfParseTree((Node*)root);
+}
+
+/**
+ * @copydoc logicNumVariables
+ */
+int logicNumVariables(const LogicContext *ctx) {
+    return ctx->symbols.count;
+}
+
+/**
+ * @copydoc logicVariableName
+ */
+const char *logicVariableName(const LogicContext *ctx, int index) {
+    if (index < 1 || index > ctx->symbols.count) return NULL;
+    return ctx->symbols.names[index - 1];
+}
+
+/**
+ * @copydoc logicVariableIndex
+ */
+int logicVariableIndex(const LogicContext *ctx, const char *name) {
+    return varMapFind(&ctx->symbols, name);
+}
+
+/**
+ * @copydoc logicEvaluate
+ */
+int logicEvaluate(LogicContext *ctx, const Node *root, const unsigned char *values) {
+    if (!root) return -1;
+    int nf = 0, nv = 0;
+    if (!reserve(ctx, (void**)&ctx->frames, &ctx->frameCap, 1, sizeof(EvalFrame))) return -1;
+    ctx->frames[nf++] = (EvalFrame){ root, 0 };
+
+    while (nf > 0) {
+        EvalFrame *f = &ctx->frames[nf - 1];
+        const Node *n = f->node;
+        if (!n || !n->tok) return -1;
+        if (!reserve(ctx, (void**)&ctx->vals, &ctx->valCap, nv + 1, 1)) return -1;
+
+        if (isVariableLeaf(n)) {
+            int v = varMapFind(&ctx->symbols, n->tok);
+            if (v == 0) return -1;
+            ctx->vals[nv++] = values[v - 1] ? 1 : 0;
+            nf--;
+        } else if (!f->expanded) {
+            // Right child first, so the left value lands below the right one
+            f->expanded = 1;
+            if (!reserve(ctx, (void**)&ctx->frames, &ctx->frameCap, nf + 2, sizeof(EvalFrame))) return -1;
+            ctx->frames[nf++] = (EvalFrame){ n->right, 0 };
+            if (strcmp(n->tok, "~") != 0) ctx->frames[nf++] = (EvalFrame){ n->left, 0 };
+        } else {
+            nf--;
+            if (strcmp(n->tok, "~") == 0) {
+                ctx->vals[nv - 1] = !ctx->vals[nv - 1];
+                continue;
+            }
+            int b = ctx->vals[--nv], a = ctx->vals[nv - 1], r;
+            if (strcmp(n->tok, "*") == 0) r = a && b;
+            else if (strcmp(n->tok, "+") == 0) r = a || b;
+            else if (strcmp(n->tok, ">") == 0) r = !a || b;
+            else return -1;
+            ctx->vals[nv - 1] = (unsigned char)r;
+        }
+    }
+    return nv == 1 ? ctx->vals[0] : -1;
+}
+
+/**
+ * @copydoc logicToCNF
+ */
+Node *logicToCNF(LogicContext *ctx, const Node *root) {
+    (void)ctx;
+    return root ? convertToCNF((Node*)root) : NULL;
+}
+
+/**
+ * @copydoc logicCNFIsValid
+ */
+int logicCNFIsValid(LogicContext *ctx, const Node *cnf, int *validClauses, int *invalidClauses) {
+    (void)ctx;
+    int valid = 0, invalid = 0;
+    checkCNFValidity((Node*)cnf, &valid, &invalid);
+    if (validClauses) *validClauses = valid;
+    if (invalidClauses) *invalidClauses = invalid;
+    return invalid == 0 && valid > 0;
+}
+
+/**
+ * @copydoc logicIsValid
+ */
+int logicIsValid(LogicContext *ctx, const Node *root) {
+    (void)ctx;
+    ValidityResult r;
+    int valid = checkValidityByRefutation((Node*)root, &r);
+    freeValidityResult(&r);
+    return valid;
+}
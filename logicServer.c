@@ -0,0 +1,610 @@
+/**
+ * @file logicServer.c
+ * @brief Long-running analysis daemon on a Unix domain socket.
+ *
+ * Starting the program per formula pays process startup, the driver's
+ * buffers and a cold allocator on every request. The daemon pays them
+ * once: a reader thread per connection frames requests into a FIFO
+ * queue, and a fixed set of workers, each with its own reusable
+ * LogicContext, answers them and writes the replies back.
+ * @section algo Algorithm:
+ *   - Acceptor: poll + accept, one detached reader thread per connection
+ *   - Readers: length-prefixed frames -> job queue (FIFO, so no request
+ *     starves behind newer ones)
+ *   - Workers: pop, analyze, reply under the connection's write lock
+ *   - Latency (enqueue -> reply written) goes into a ring of recent
+ *     samples; percentiles are computed when "stats" is asked for
+ * @section time Time Complexity: O(1) queueing per request + the analyses
+ * @section space Space Complexity: O(W) contexts + queued payloads
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "logicServer.h"
+#include "logic.h"
+#include "cnfFormula.h"
+#include "batchDriver.h"
+#include "workSteal.h"
+#include "resultCache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_FRAME (256u << 20)       /* refuse requests above 256 MB */
+#define LATENCY_SAMPLES 8192         /* recent requests kept for percentiles */
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ----- framing ----- */
+
+/**
+ * @brief Reads exactly n bytes.
+ * @return 1 on success, 0 on EOF or error.
+ */
+static int readFull(int fd, void *buf, size_t n) {
+    char *p = buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return 0;
+        p += r;
+        n -= (size_t)r;
+    }
+    return 1;
+}
+
+/**
+ * @brief Writes exactly n bytes.
+ * @return 1 on success, 0 on error.
+ */
+static int writeFull(int fd, const void *buf, size_t n) {
+    const char *p = buf;
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return 0;
+        p += w;
+        n -= (size_t)w;
+    }
+    return 1;
+}
+
+/**
+ * @brief Reads one frame into a malloc'd, NUL-terminated buffer.
+ * @return Payload, or NULL on EOF, error or an oversized frame.
+ */
+static char *readFrame(int fd, size_t *len) {
+    unsigned char hdr[4];
+    if (!readFull(fd, hdr, 4)) return NULL;
+    uint32_t n = (uint32_t)hdr[0] << 24 | (uint32_t)hdr[1] << 16 | (uint32_t)hdr[2] << 8 | hdr[3];
+    if (n > MAX_FRAME) return NULL;
+    char *buf = malloc((size_t)n + 1);
+    if (!buf) { perror("malloc"); return NULL; }
+    if (!readFull(fd, buf, n)) { free(buf); return NULL; }
+    buf[n] = '\0';
+    *len = n;
+    return buf;
+}
+
+/**
+ * @brief Writes one frame.
+ * @return 1 on success, 0 on error.
+ */
+static int writeFrame(int fd, const char *data, size_t len) {
+    unsigned char hdr[4] = {
+        (unsigned char)(len >> 24), (unsigned char)(len >> 16), (unsigned char)(len >> 8), (unsigned char)len
+    };
+    return writeFull(fd, hdr, 4) && writeFull(fd, data, len);
+}
+
+/* ----- server state ----- */
+
+typedef struct Server Server;
+
+/**
+ * @brief One client connection; freed when the reader and every queued
+ *        job referring to it are done.
+ */
+typedef struct Connection {
+    int fd;
+    Server *server;
+    atomic_int refs;
+    pthread_mutex_t writeLock;
+    struct Connection *next;      /**< Live-connection list (server lock) */
+} Connection;
+
+/**
+ * @brief A framed request waiting for a worker.
+ */
+typedef struct Job {
+    Connection *conn;
+    unsigned id;                  /**< Sequence number on the connection */
+    char *payload;
+    size_t len;
+    double enqueued;
+    struct Job *next;
+} Job;
+
+/**
+ * @brief Per-worker state reused across requests.
+ */
+typedef struct {
+    Server *server;
+    LogicContext *ctx;
+    pthread_t thread;
+} Worker;
+
+struct Server {
+    ServerOptions opts;
+    int listenFd;
+
+    pthread_mutex_t lock;         /* queue, connection list, counters */
+    pthread_cond_t jobReady;
+    pthread_cond_t connsGone;
+    Job *head, *tail;
+    int depth, maxDepth;
+    int stopping;
+    Connection *conns;
+    int numConns;
+
+    long long requests, errors;
+    double latency[LATENCY_SAMPLES];
+    long long latencyCount;
+
+    Worker *workers;
+    int numWorkers;
+    ResultCache *cache;           /**< Shared by all workers, or NULL */
+};
+
+static volatile sig_atomic_t signalStop = 0;
+
+static void onSignal(int sig) {
+    (void)sig;
+    signalStop = 1;
+}
+
+static void connRelease(Connection *c) {
+    if (atomic_fetch_sub(&c->refs, 1) != 1) return;
+    Server *s = c->server;
+    pthread_mutex_lock(&s->lock);
+    for (Connection **pp = &s->conns; *pp; pp = &(*pp)->next) {
+        if (*pp == c) { *pp = c->next; break; }
+    }
+    if (--s->numConns == 0) pthread_cond_broadcast(&s->connsGone);
+    pthread_mutex_unlock(&s->lock);
+    close(c->fd);
+    pthread_mutex_destroy(&c->writeLock);
+    free(c);
+}
+
+/**
+ * @brief Sends a reply frame; concurrent workers never interleave bytes.
+ */
+static void sendReply(Connection *c, const char *data, size_t len) {
+    pthread_mutex_lock(&c->writeLock);
+    writeFrame(c->fd, data, len);
+    pthread_mutex_unlock(&c->writeLock);
+}
+
+static void recordLatency(Server *s, double seconds, int failed) {
+    pthread_mutex_lock(&s->lock);
+    s->requests++;
+    if (failed) s->errors++;
+    s->latency[s->latencyCount++ % LATENCY_SAMPLES] = seconds;
+    pthread_mutex_unlock(&s->lock);
+}
+
+static int cmpDouble(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Writes the counters and latency percentiles as JSON fields.
+ */
+static void printServerStats(Server *s, FILE *out) {
+    static double sorted[LATENCY_SAMPLES];
+    static pthread_mutex_t sortLock = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&sortLock);
+    pthread_mutex_lock(&s->lock);
+    int n = s->latencyCount < LATENCY_SAMPLES ? (int)s->latencyCount : LATENCY_SAMPLES;
+    memcpy(sorted, s->latency, (size_t)n * sizeof(double));
+    long long requests = s->requests, errors = s->errors;
+    int depth = s->depth, maxDepth = s->maxDepth, conns = s->numConns;
+    pthread_mutex_unlock(&s->lock);
+
+    qsort(sorted, (size_t)n, sizeof(double), cmpDouble);
+    double p50 = n ? sorted[(n - 1) / 2] : 0, p99 = n ? sorted[(int)((n - 1) * 0.99)] : 0;
+    pthread_mutex_unlock(&sortLock);
+
+    fprintf(out, ",\"requests\":%lld,\"errors\":%lld,\"queue_depth\":%d,\"max_queue_depth\":%d"
+                 ",\"connections\":%d,\"workers\":%d,\"samples\":%d,\"p50_ms\":%.3f,\"p99_ms\":%.3f",
+            requests, errors, depth, maxDepth, conns, s->numWorkers, n, p50 * 1e3, p99 * 1e3);
+    if (s->cache) {
+        CacheStats st = resultCacheStats(s->cache);
+        fprintf(out, ",\"cache_hits\":%lld,\"cache_misses\":%lld,\"cache_entries\":%d,\"cache_bytes\":%zu",
+                st.memoryHits + st.diskHits, st.misses, st.entries, st.bytes);
+    }
+}
+
+/* ----- request handling ----- */
+
+/**
+ * @brief Answers a formula request with the worker's context.
+ * @return 1 on success, 0 if the request failed (error field written).
+ */
+static int answerFormula(Worker *w, const char *text, int analyses, FILE *out) {
+    if (analyses & BATCH_COUNT) {
+        fprintf(out, ",\"error\":\"count needs a dimacs request\"");
+        return 0;
+    }
+    logicContextReset(w->ctx);
+    Node *root = logicParse(w->ctx, text);
+    if (!root) {
+        fprintf(out, ",\"error\":\"malformed formula\"");
+        return 0;
+    }
+    ResultCache *cache = w->server->cache;
+    CachedResult rec = emptyCachedResult();
+    CacheKey key = hashFormulaTree(root);
+    int hit = cache ? resultCacheLookup(cache, key, &rec) : 0, fromCache = 0, learned = 0;
+
+    if (analyses & BATCH_PARSE) {
+        if (rec.height < 0) {
+            rec.height = logicHeight(root);
+            learned = 1;
+        }
+        fprintf(out, ",\"vars\":%d,\"height\":%d", logicNumVariables(w->ctx), rec.height);
+    }
+    if (analyses & BATCH_TAUTOLOGY) {
+        int valid = rec.valid;
+        if (valid < 0) {
+            valid = logicIsValid(w->ctx, root);
+            if (valid >= 0) { rec.valid = valid; learned = 1; }
+        } else {
+            fromCache = 1;
+        }
+        fprintf(out, ",\"tautology\":%s", valid == 1 ? "true" : "false");
+    }
+    if (analyses & BATCH_SAT) {
+        int refuted = rec.sat < 0 ? -1 : !rec.sat;
+        if (refuted < 0) {
+            // F is satisfiable exactly when ~F is not valid
+            Node negation = { "~", NULL, root };
+            refuted = logicIsValid(w->ctx, &negation);
+            if (refuted >= 0) { rec.sat = !refuted; learned = 1; }
+        } else {
+            fromCache = 1;
+        }
+        fprintf(out, ",\"sat\":\"%s\"", refuted == 1 ? "UNSAT" : "SAT");
+    }
+    if (fromCache) fprintf(out, ",\"cached\":\"%s\"", hit == 2 ? "disk" : "memory");
+    if (cache && learned) {
+        rec.numVars = logicNumVariables(w->ctx);
+        resultCacheStore(cache, key, &rec);
+    }
+    freeCachedResult(&rec);
+    freeTree(root);
+    return 1;
+}
+
+/**
+ * @brief Answers a DIMACS request.
+ * @return 1 on success, 0 if the request failed (error field written).
+ */
+static int answerDimacs(Worker *w, const char *text, size_t len, int analyses, FILE *out) {
+    FILE *in = fmemopen((void*)text, len ? len : 1, "rb");
+    CnfFormula *f = in ? readCnfFormulaStream(in) : NULL;
+    if (in) fclose(in);
+    if (!f) {
+        fprintf(out, ",\"error\":\"malformed dimacs\"");
+        return 0;
+    }
+    BatchOptions o = defaultBatchOptions();
+    o.analyses = analyses;
+    o.conflictBudget = w->server->opts.conflictBudget;
+    o.cache = w->server->cache;
+    printCnfAnalyses(out, f, &o);
+    freeCnfFormula(f);
+    return 1;
+}
+
+/**
+ * @brief Parses the header line, runs the request and sends the reply.
+ */
+static void handleJob(Worker *w, Job *job) {
+    Server *s = w->server;
+    char *reply = NULL;
+    size_t replyLen = 0;
+    FILE *out = open_memstream(&reply, &replyLen);
+    if (!out) { perror("open_memstream"); return; }
+
+    char *body = strchr(job->payload, '\n');
+    if (body) *body++ = '\0';
+    else body = job->payload + job->len;
+    size_t bodyLen = job->len - (size_t)(body - job->payload);
+
+    char kind[16] = "", list[128] = "";
+    sscanf(job->payload, "%15s %127s", kind, list);
+    int analyses = BATCH_PARSE;
+    int ok = 1;
+    fprintf(out, "{\"id\":%u", job->id);
+
+    if (strcmp(kind, "stats") == 0) {
+        printServerStats(s, out);
+    } else if (strcmp(kind, "shutdown") == 0) {
+        pthread_mutex_lock(&s->lock);
+        s->stopping = 1;
+        pthread_mutex_unlock(&s->lock);
+    } else if (strcmp(kind, "formula") != 0 && strcmp(kind, "dimacs") != 0) {
+        fprintf(out, ",\"error\":\"unknown request '%s'\"", kind);
+        ok = 0;
+    } else if (list[0] && !parseBatchAnalyses(list, &analyses)) {
+        fprintf(out, ",\"error\":\"unknown analysis\"");
+        ok = 0;
+    } else {
+        double t0 = nowSeconds();
+        ok = kind[0] == 'f' ? answerFormula(w, body, analyses, out)
+                            : answerDimacs(w, body, bodyLen, analyses, out);
+        fprintf(out, ",\"seconds\":%.6f", nowSeconds() - t0);
+    }
+    fprintf(out, ",\"ok\":%s}", ok ? "true" : "false");
+    fclose(out);
+
+    sendReply(job->conn, reply, replyLen);
+    free(reply);
+    recordLatency(s, nowSeconds() - job->enqueued, !ok);
+}
+
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    Server *s = w->server;
+    for (;;) {
+        pthread_mutex_lock(&s->lock);
+        while (!s->head && !s->stopping) pthread_cond_wait(&s->jobReady, &s->lock);
+        if (!s->head) {
+            pthread_mutex_unlock(&s->lock);
+            break;
+        }
+        Job *job = s->head;
+        s->head = job->next;
+        if (!s->head) s->tail = NULL;
+        s->depth--;
+        pthread_mutex_unlock(&s->lock);
+
+        handleJob(w, job);
+        connRelease(job->conn);
+        free(job->payload);
+        free(job);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Connection reader: frames requests and queues them.
+ */
+static void *readerMain(void *arg) {
+    Connection *c = arg;
+    Server *s = c->server;
+    unsigned nextId = 0;
+    for (;;) {
+        size_t len;
+        char *payload = readFrame(c->fd, &len);
+        if (!payload) break;
+        Job *job = malloc(sizeof(Job));
+        if (!job) { perror("malloc"); free(payload); break; }
+        *job = (Job){ c, nextId++, payload, len, nowSeconds(), NULL };
+
+        pthread_mutex_lock(&s->lock);
+        if (s->stopping) {
+            // Workers may already be gone; nobody would answer this job
+            pthread_mutex_unlock(&s->lock);
+            free(payload);
+            free(job);
+            break;
+        }
+        atomic_fetch_add(&c->refs, 1);
+        if (s->tail) s->tail->next = job;
+        else s->head = job;
+        s->tail = job;
+        if (++s->depth > s->maxDepth) s->maxDepth = s->depth;
+        pthread_cond_signal(&s->jobReady);
+        pthread_mutex_unlock(&s->lock);
+    }
+    connRelease(c);
+    return NULL;
+}
+
+/**
+ * @brief Opens the listening socket, replacing a stale socket file.
+ * @return Descriptor, or -1 on error.
+ */
+static int openListener(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Error: Socket path '%s' is too long.\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { perror("socket"); return -1; }
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @copydoc runServer
+ */
+int runServer(const ServerOptions *opts) {
+    Server *s = calloc(1, sizeof(Server));
+    if (!s) { perror("calloc"); return 1; }
+    s->opts = *opts;
+    s->listenFd = openListener(opts->socketPath);
+    if (s->listenFd < 0) { free(s); return 1; }
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->jobReady, NULL);
+    pthread_cond_init(&s->connsGone, NULL);
+    if (opts->cacheBytes > 0 || opts->cacheDir) {
+        s->cache = resultCacheNew(opts->cacheBytes, opts->cacheDir);
+        if (!s->cache) printf("Warning: Running without a result cache.\n");
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);     /* a vanished client must not kill the daemon */
+
+    s->numWorkers = opts->numWorkers > 0 ? opts->numWorkers : wsNumCores();
+    s->workers = calloc((size_t)s->numWorkers, sizeof(Worker));
+    int started = 0;
+    for (int i = 0; s->workers && i < s->numWorkers; i++) {
+        s->workers[i].server = s;
+        s->workers[i].ctx = logicContextNew(NULL);
+        if (!s->workers[i].ctx || pthread_create(&s->workers[i].thread, NULL, workerMain, &s->workers[i]) != 0) break;
+        started++;
+    }
+    fprintf(stderr, "Listening on %s with %d workers\n", opts->socketPath, started);
+
+    while (started > 0 && !signalStop) {
+        pthread_mutex_lock(&s->lock);
+        int stopping = s->stopping;
+        pthread_mutex_unlock(&s->lock);
+        if (stopping) break;
+
+        struct pollfd pfd = { s->listenFd, POLLIN, 0 };
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        int fd = accept(s->listenFd, NULL, NULL);
+        if (fd < 0) continue;
+
+        Connection *c = calloc(1, sizeof(Connection));
+        pthread_t reader;
+        pthread_attr_t attr;
+        if (!c) { close(fd); continue; }
+        c->fd = fd;
+        c->server = s;
+        atomic_init(&c->refs, 1);
+        pthread_mutex_init(&c->writeLock, NULL);
+        pthread_mutex_lock(&s->lock);
+        c->next = s->conns;
+        s->conns = c;
+        s->numConns++;
+        pthread_mutex_unlock(&s->lock);
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&reader, &attr, readerMain, c) != 0) connRelease(c);
+        pthread_attr_destroy(&attr);
+    }
+
+    // Stop accepting, let workers drain the queue, then wake blocked readers
+    close(s->listenFd);
+    unlink(opts->socketPath);
+    pthread_mutex_lock(&s->lock);
+    s->stopping = 1;
+    pthread_cond_broadcast(&s->jobReady);
+    pthread_mutex_unlock(&s->lock);
+    for (int i = 0; i < started; i++) pthread_join(s->workers[i].thread, NULL);
+
+    pthread_mutex_lock(&s->lock);
+    for (Connection *c = s->conns; c; c = c->next) shutdown(c->fd, SHUT_RDWR);
+    while (s->numConns > 0) pthread_cond_wait(&s->connsGone, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+
+    fprintf(stderr, "Served %lld requests (%lld failed)\n", s->requests, s->errors);
+    if (s->cache) {
+        CacheStats st = resultCacheStats(s->cache);
+        printCacheStats(stderr, &st);
+        resultCacheFree(s->cache);
+    }
+    for (int i = 0; s->workers && i < s->numWorkers; i++) logicContextFree(s->workers[i].ctx);
+    free(s->workers);
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->jobReady);
+    pthread_cond_destroy(&s->connsGone);
+    free(s);
+    return started > 0 ? 0 : 1;
+}
+
+/* ----- client ----- */
+
+/**
+ * @copydoc runClient
+ */
+int runClient(const ClientOptions *opts) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, opts->socketPath, sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        perror(opts->socketPath);
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    int total = opts->repeat > 0 ? opts->repeat : 1;
+    int window = opts->inflight > 0 ? opts->inflight : 1;
+    size_t reqLen = strlen(opts->request);
+    double *sent = malloc((size_t)total * sizeof(double));
+    double *lat = malloc((size_t)total * sizeof(double));
+    if (!sent || !lat) { perror("malloc"); close(fd); free(sent); free(lat); return 1; }
+
+    int status = 0, issued = 0, received = 0;
+    double start = nowSeconds();
+    while (received < total) {
+        while (issued < total && issued - received < window) {
+            sent[issued] = nowSeconds();
+            if (!writeFrame(fd, opts->request, reqLen)) { perror("write"); status = 1; break; }
+            issued++;
+        }
+        if (status) break;
+        size_t len;
+        char *reply = readFrame(fd, &len);
+        if (!reply) {
+            printf("Error: Connection closed after %d replies.\n", received);
+            status = 1;
+            break;
+        }
+        unsigned id = 0;
+        if (sscanf(reply, "{\"id\":%u", &id) != 1 || id >= (unsigned)issued) id = (unsigned)received;
+        lat[received++] = nowSeconds() - sent[id];
+        if (!opts->quiet || received == total) printf("%s\n", reply);
+        free(reply);
+    }
+    double wall = nowSeconds() - start;
+    close(fd);
+
+    if (received > 1) {
+        qsort(lat, (size_t)received, sizeof(double), cmpDouble);
+        fprintf(stderr, "Requests: %d in %f s (%.0f/s), client latency p50 %.3f ms, p99 %.3f ms\n",
+                received, wall, received / wall, lat[(received - 1) / 2] * 1e3,
+                lat[(int)((received - 1) * 0.99)] * 1e3);
+    }
+    free(sent);
+    free(lat);
+    return status;
+}
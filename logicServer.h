@@ -0,0 +1,60 @@
+/**
+ * @file logicServer.h
+ * @brief Header for the Unix-socket analysis daemon and its test client.
+ */
+
+#ifndef LOGIC_SERVER_H
+#define LOGIC_SERVER_H
+
+#include <stddef.h>
+
+/**
+ * @brief Settings of the daemon.
+ */
+typedef struct {
+    const char *socketPath;    /**< Filesystem path of the Unix socket */
+    int numWorkers;            /**< Worker threads (< 1: one per core) */
+    long long conflictBudget;  /**< Per-request SAT conflict limit (<= 0: none) */
+    size_t cacheBytes;         /**< Result cache budget (0 with no cacheDir: no cache) */
+    const char *cacheDir;      /**< On-disk cache tier, or NULL */
+} ServerOptions;
+
+/**
+ * @brief Runs the daemon until a "shutdown" request or SIGINT/SIGTERM.
+ *
+ * Wire format, both directions: a 4-byte big-endian length followed by
+ * that many bytes. A request is a header line and a body:
+ *   - "formula ANALYSES\n" + infix text
+ *   - "dimacs ANALYSES\n"  + DIMACS CNF text
+ *   - "stats\n"            (latency percentiles and queue counters)
+ *   - "shutdown\n"
+ * ANALYSES is a comma list of parse, tautology, sat, count (count is
+ * DIMACS only). Every request gets one JSON object carrying "id", its
+ * sequence number on the connection; replies to pipelined requests may
+ * arrive out of order. With a result cache, answers known for the same
+ * content carry "cached":"memory" or "cached":"disk".
+ *
+ * @param opts Socket path and pool size.
+ * @return 0 on clean shutdown, 1 if the socket could not be set up.
+ */
+int runServer(const ServerOptions *opts);
+
+/**
+ * @brief Settings of the test client.
+ */
+typedef struct {
+    const char *socketPath;
+    const char *request;       /**< Full request text (header line + body) */
+    int repeat;                /**< Times to send the request (>= 1) */
+    int inflight;              /**< Requests kept outstanding (>= 1) */
+    int quiet;                 /**< Print only the last reply */
+} ClientOptions;
+
+/**
+ * @brief Sends a request repeatedly, prints the replies and reports
+ *        client-side latency percentiles and throughput on stderr.
+ * @return 0 on success, 1 on a connection or protocol error.
+ */
+int runClient(const ClientOptions *opts);
+
+#endif
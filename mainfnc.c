@@ -12,13 +12,19 @@
  *   - Task 2: Build a parse tree from the prefix
  *   - Task 3: In-order traversal
  *   - Task 4: Compute parse tree height
+ *   - Simplify the formula (for manual input; see simplify.h)
  *   - Task 5: Generate truth table and evaluate
  *   - Task 6: Convert to CNF (for manual input)
  *   - Task 7: Check CNF validity
  *
  * Large buffers are dynamically allocated to handle large CNF files.
+ *
+ * When started with command-line arguments the program runs one of the
+ * non-interactive modes instead (see printUsage).
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "task3.h"
 #include "task4.h"
 #include "task5.h"
@@ -31,23 +37,1672 @@
 #include <ctype.h>
 #include <time.h>
 #include <math.h>
+#include <sys/stat.h>
 
 #include "common.h"
 #include "cnfReader.h"
 #include "task1.h"
 #include "task2.h"
+#include "cnfFormula.h"
+#include "cubeConquer.h"
+#include "incrementalQuery.h"
+#include "validity.h"
+#include "equivalence.h"
+#include "compiledFormula.h"
+#include "batchEval.h"
+#include "batchDriver.h"
+#include "logicServer.h"
+#include "resultCache.h"
+#include "modelCount.h"
+#include "instrument.h"
+#include "simplify.h"
+#include "parallelTree.h"
+#include "truthBitmap.h"
+#include "allSat.h"
+#include "minimize.h"
+#include "dnnf.h"
+#include "compressedInput.h"
+#include "incrementalAnalysis.h"
+#include "cnfReorder.h"
+#include "unitProp.h"
+#include "formulaGen.h"
+#include "nativeKernel.h"
+#include "cnfStream.h"
 
 #define LARGE_BUFFER_SIZE 2000000
+#define DEFAULT_CACHE_BYTES (64u << 20)   /* memory tier when only --cache-dir is given */
+
+/**
+ * @brief Prints the command-line modes.
+ * @param prog Program name (argv[0]).
+ */
+static void printUsage(const char *prog)
+{
+    printf("Usage: %s                      (interactive menu)\n", prog);
+    printf("       %s --cube FILE.cnf [--threads N] [--depth D] [--count]\n", prog);
+    printf("       %s --query FILE.cnf QUERIES.txt [--cold]\n", prog);
+    printf("       %s --valid FORMULA\n", prog);
+    printf("       %s --simplify FORMULA\n", prog);
+    printf("       %s --equiv FORMULA1 FORMULA2 [--blocks N]\n", prog);
+    printf("       %s --equiv-cnf FORMULA      (FORMULA vs. its Task 6 CNF)\n", prog);
+    printf("       %s --batch-eval FORMULA [--vars A,B,...] [IN|-] [OUT|-]\n", prog);
+    printf("       %s --table FORMULA FILE.ttb   (truth table as a packed bitmap)\n", prog);
+    printf("       %s --table-query FILE.ttb [row K | count [FROM TO] | list [FROM TO] [--limit N]]\n", prog);
+    printf("       %s --export-cnf FORMULA [OUT.cnf|-]   (streamed Task 6 CNF as DIMACS)\n", prog);
+    printf("       %s --models FORMULA|FILE.cnf [--limit N] [--count]   (satisfying cubes, - = don't care)\n", prog);
+    printf("       %s --minimize FORMULA|FILE.ttb [--pos] [--exact|--heuristic]   (two-level SOP/POS form)\n", prog);
+    printf("       %s --dnnf FILE.cnf|FILE.dnnf [QUERIES.txt|-] [--save OUT.dnnf] [--max-nodes N]\n", prog);
+    printf("       %s --incremental [SCRIPT|-]   (load/edit/report script on a memoizing session)\n", prog);
+    printf("       %s --reorder FILE.cnf [--out OUT.cnf] [--map OUT.map] [--probes N] [--rounds N] [--solve]\n", prog);
+    printf("       %s --batch DIR|LIST|FILE.cnf [--analyses parse,tautology,sat,count] [--conflicts N]\n"
+           "              [--cache-dir DIR]\n", prog);
+    printf("       %s --analyze FORMULA|FILE.cnf [--count] [--cache-dir DIR] [--cache-mb N] [--repeat N]\n", prog);
+    printf("       %s --profile [json|csv] [OUT]   (interactive session with per-phase counters)\n", prog);
+    printf("       %s --no-simplify [--profile ...]   (interactive session without simplification)\n", prog);
+    printf("       %s --threads N [MODE ...]   (workers of the parallel CNF and Task 7 passes, 1 = off)\n", prog);
+    printf("       %s --native DIR [MODE ...]   (evaluate with formulas compiled by $CC, cached in DIR)\n", prog);
+    printf("       %s --serve SOCKET [--workers N] [--conflicts N] [--cache-mb N] [--cache-dir DIR]\n", prog);
+    printf("       %s --client SOCKET (--formula F | --dimacs FILE | --stats | --shutdown)\n"
+           "              [--analyses LIST] [--repeat N] [--inflight K]\n", prog);
+    printf("FILE.cnf may be gzip, xz or bzip2 compressed (FILE.cnf.gz, ...); the format is detected from its content.\n");
+}
+
+/**
+ * @brief Parses an infix formula into a parse tree (tasks 1 and 2).
+ * @param infix Infix formula text.
+ * @return Root of the tree, or NULL if the formula could not be parsed.
+ */
+static Node *parseInfixFormula(const char *infix)
+{
+    size_t len = strlen(infix);
+    char *work = malloc(len + 1);
+    char *prefix = malloc(2 * len + 2);
+    Node *root = NULL;
+    if (work && prefix) {
+        memcpy(work, infix, len + 1);
+        inFixToPreFix(work, prefix);
+        convertPreOrderToTree(&root, prefix);
+    }
+    free(work);
+    free(prefix);
+    return root;
+}
+
+/**
+ * @brief Reads the next whitespace-delimited word from a stream, like
+ *        scanf("%s") but with no limit on its length. The whitespace
+ *        after the word is left unread, as scanf leaves it for the
+ *        prompts of the later tasks.
+ * @return The word (free with free), or NULL at the end of input or on
+ *         malloc failure.
+ */
+static char *readFormulaWord(FILE *in)
+{
+    int c;
+    while ((c = getc(in)) != EOF && isspace(c)) {}
+    if (c == EOF) return NULL;
+
+    size_t len = 0, cap = 256;
+    char *word = malloc(cap);
+    while (word != NULL && c != EOF && !isspace(c)) {
+        if (len + 1 == cap) {
+            char *grown = realloc(word, cap *= 2);
+            if (grown == NULL) free(word);
+            word = grown;
+            if (word == NULL) break;
+        }
+        word[len++] = (char)c;
+        c = getc(in);
+    }
+    if (word == NULL) {
+        perror("malloc");
+        return NULL;
+    }
+    if (c != EOF) ungetc(c, in);
+    word[len] = '\0';
+    return word;
+}
+
+/**
+ * @brief Decides validity of one infix formula by refutation and prints
+ *        the verdict (with a falsifying assignment when not valid).
+ * @return 0 if valid, 1 if not valid or on error.
+ */
+static int reportValidity(const char *infix)
+{
+    Node *root = parseInfixFormula(infix);
+    if (root == NULL) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        return 1;
+    }
+    ValidityResult r;
+    checkValidityByRefutation(root, &r);
+    printValidityResult(&r);
+    int status = r.valid == 1 ? 0 : 1;
+    freeValidityResult(&r);
+    freeTree(root);
+    return status;
+}
+
+/**
+ * @brief Prints the node-count change of a simplification.
+ */
+static void printSimplifyStats(const SimplifyStats *s)
+{
+    printf("Nodes: %ld -> %ld (%.1f%% fewer), %ld terms, %d rounds\n", s->nodesBefore, s->nodesAfter,
+           s->nodesBefore ? 100.0 * (s->nodesBefore - s->nodesAfter) / s->nodesBefore : 0.0,
+           s->terms, s->rounds);
+}
+
+/**
+ * @brief Simplify mode: prints the simplified formula and its size change.
+ * @return 0 on success, 1 on error.
+ */
+static int runSimplifyMode(const char *infix)
+{
+    Node *root = parseInfixFormula(infix);
+    if (root == NULL) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        return 1;
+    }
+    SimplifyStats stats;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Node *simplified = simplifyFormula(root, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    freeTree(root);
+    if (simplified == NULL) {
+        printf("Error: Simplification failed.\n");
+        return 1;
+    }
+    printf("Simplified: ");
+    printInOrder(simplified);
+    printf("\n");
+    printSimplifyStats(&stats);
+    printf("Computed in %f seconds\n", seconds);
+    freeTree(simplified);
+    return 0;
+}
+
+/**
+ * @brief Reads the integer value following an option.
+ * @return 1 if argv[*i + 1] exists and is an integer, 0 otherwise.
+ */
+static int optionInt(int argc, char *argv[], int *i, int *out)
+{
+    if (*i + 1 >= argc) {
+        printf("Error: Option '%s' needs a value.\n", argv[*i]);
+        return 0;
+    }
+    char *end;
+    long v = strtol(argv[*i + 1], &end, 10);
+    if (*end != '\0') {
+        printf("Error: Option '%s' expects a number, got '%s'.\n", argv[*i], argv[*i + 1]);
+        return 0;
+    }
+    *out = (int)v;
+    (*i)++;
+    return 1;
+}
+
+/**
+ * @brief Cube-and-conquer mode: split a CNF file into cubes and solve them
+ *        on all cores, optionally counting models.
+ * @return 10 (SAT), 20 (UNSAT) or 0 (unknown) following SAT-solver
+ *         convention, 1 on error.
+ */
+static int runCubeMode(int argc, char *argv[])
+{
+    CubeOptions opt = defaultCubeOptions();
+    const char *path = NULL;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0) {
+            if (!optionInt(argc, argv, &i, &opt.numThreads)) return 1;
+        } else if (strcmp(argv[i], "--depth") == 0) {
+            if (!optionInt(argc, argv, &i, &opt.maxDepth)) return 1;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            opt.countModels = 1;
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!path) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    CnfFormula *f = readCnfFormula(path);
+    if (!f) {
+        printf("Error: Could not read or process file '%s'.\n", path);
+        return 1;
+    }
+    printf("Loaded %s: %d variables, %d clauses\n", path, f->numVars, f->numClauses);
+
+    CubeReport report;
+    if (!cubeAndConquer(f, &opt, &report)) {
+        printf("Fatal Error: Out of memory during cube-and-conquer.\n");
+        freeCnfFormula(f);
+        return 1;
+    }
+    printCubeReport(&report, opt.countModels);
+
+    int status = report.result;
+    freeCubeReport(&report);
+    freeCnfFormula(f);
+    return status;
+}
+
+/**
+ * @brief Query mode: answer a script of add-clause / solve-under-assumptions
+ *        lines against one incremental solver (or cold solvers with --cold).
+ * @return 0 on success, 1 on error.
+ */
+static int runQueryMode(int argc, char *argv[])
+{
+    const char *cnfPath = NULL, *queryPath = NULL;
+    int cold = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--cold") == 0) cold = 1;
+        else if (!cnfPath) cnfPath = argv[i];
+        else if (!queryPath) queryPath = argv[i];
+        else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!cnfPath || !queryPath) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    CnfFormula *f = readCnfFormula(cnfPath);
+    if (!f) {
+        printf("Error: Could not read or process file '%s'.\n", cnfPath);
+        return 1;
+    }
+    FILE *q = strcmp(queryPath, "-") == 0 ? stdin : fopen(queryPath, "r");
+    if (!q) {
+        printf("Error: Cannot open file '%s'\n", queryPath);
+        freeCnfFormula(f);
+        return 1;
+    }
+
+    QueryReport r;
+    int ok = runIncrementalQueries(f, q, stdout, cold, &r);
+    if (q != stdin) fclose(q);
+
+    printf("\n----------------------------------------\n");
+    printf("Mode: %s\n", cold ? "cold start per query" : "incremental");
+    printf("Queries: %d (SAT %d, UNSAT %d, UNKNOWN %d), clauses added: %d\n",
+           r.solves, r.sat, r.unsat, r.unknown, r.added);
+    printf("Conflicts: %lld\n", r.stats.conflicts);
+    printf("Total time: %f seconds (%f ms per query)\n",
+           r.seconds, r.solves ? 1000.0 * r.seconds / r.solves : 0.0);
+    printf("----------------------------------------\n");
+
+    freeCnfFormula(f);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Equivalence mode: compare two formulas, or one formula against
+ *        its Task 6 CNF conversion with --equiv-cnf.
+ * @return 0 if equivalent, 1 if not or on error.
+ */
+static int runEquivMode(int argc, char *argv[])
+{
+    int againstCnf = strcmp(argv[1], "--equiv-cnf") == 0;
+    const char *text[2] = { NULL, NULL };
+    int blocks = 0, n = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--blocks") == 0) {
+            if (!optionInt(argc, argv, &i, &blocks)) return 1;
+        } else if (n < 2) {
+            text[n++] = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (n != (againstCnf ? 1 : 2)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Node *f = parseInfixFormula(text[0]);
+    Node *g = NULL;
+    if (f) g = againstCnf ? convertToCNF(f) : parseInfixFormula(text[1]);
+    if (!f || !g) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        freeTree(f);
+        return 1;
+    }
+    if (againstCnf) {
+        printf("CNF Formula: ");
+        printCNF(g);
+        printf("\n");
+    }
+
+    EquivResult r;
+    checkEquivalence(f, g, blocks, &r);
+    printEquivResult(&r);
+    int status = r.equivalent == 1 ? 0 : 1;
+    freeEquivResult(&r);
+    freeTree(f);
+    freeTree(g);
+    return status;
+}
+
+/**
+ * @brief Batch mode: evaluate one formula on packed assignment rows from
+ *        IN (default stdin) and write the packed result bitmap to OUT
+ *        (default stdout). Columns follow --vars, or first appearance in
+ *        the formula; the mapping and totals go to stderr.
+ * @return 0 on success, 1 on error.
+ */
+static int runBatchEvalMode(int argc, char *argv[])
+{
+    const char *formula = NULL, *varList = NULL, *path[2] = { "-", "-" };
+    int n = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--vars") == 0 && i + 1 < argc) {
+            varList = argv[++i];
+        } else if (!formula) {
+            formula = argv[i];
+        } else if (n < 2) {
+            path[n++] = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!formula) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Node *root = parseInfixFormula(formula);
+    if (!root) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        return 1;
+    }
+    VarMap vm;
+    varMapInit(&vm);
+    int columns = 0;
+    if (varList) {
+        char *names = strdup_s(varList);
+        for (char *tok = strtok(names, ", "); tok; tok = strtok(NULL, ", ")) varMapIntern(&vm, tok);
+        free(names);
+        columns = vm.count;
+    }
+    CompiledFormula *cf = compileFormula(root, &vm);
+    freeTree(root);
+    if (!varList) columns = vm.count;
+    FILE *in = strcmp(path[0], "-") == 0 ? stdin : fopen(path[0], "rb");
+    FILE *out = strcmp(path[1], "-") == 0 ? stdout : fopen(path[1], "wb");
+    int status = 1;
+    if (!cf) {
+        printf("Error: Failed to compile the formula.\n");
+    } else if (vm.count > columns) {
+        printf("Error: Variable '%s' is not listed in --vars.\n", vm.names[columns]);
+    } else if (!in || !out) {
+        perror(!in ? path[0] : path[1]);
+    } else {
+        fprintf(stderr, "Columns:");
+        for (int v = 0; v < columns; v++) fprintf(stderr, " %d=%s", v, vm.names[v]);
+        fprintf(stderr, "\n");
+        // Rows of a regular file are known up front; a pipe may run forever
+        struct stat st;
+        int stride = columns ? (columns + 7) / 8 : 1;
+        double words = fstat(fileno(in), &st) == 0 && S_ISREG(st.st_mode)
+                       ? (double)st.st_size / stride / 64 : HUGE_VAL;
+        nativeKernelAttach(cf, words);
+        BatchEvalReport rep;
+        if (batchEvaluate(cf, columns, in, out, &rep)) {
+            status = 0;
+            fprintf(stderr, "Rows: %lld (%lld true)\n", rep.rows, rep.trueRows);
+            if (rep.trailingBytes)
+                fprintf(stderr, "Warning: Ignored %lld bytes of an incomplete last row.\n", rep.trailingBytes);
+            fprintf(stderr, "Time: %f seconds (%.1f million rows/second)\n",
+                    rep.seconds, rep.seconds > 0 ? rep.rows / rep.seconds / 1e6 : 0.0);
+        }
+    }
+    if (in && in != stdin) fclose(in);
+    if (out && out != stdout) fclose(out);
+    freeCompiledFormula(cf);
+    varMapFree(&vm);
+    return status;
+}
+
+/**
+ * @brief Table mode: write the truth table of a formula as a bitmap file
+ *        (see truthBitmap.h); columns follow first appearance.
+ * @return 0 on success, 1 on error.
+ */
+static int runTableMode(const char *infix, const char *path)
+{
+    Node *root = parseInfixFormula(infix);
+    if (root == NULL) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        return 1;
+    }
+    VarMap vm;
+    varMapInit(&vm);
+    uint64_t ones = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int ok = varMapCollect(&vm, root) && writeTruthBitmap(path, root, vm.names, vm.count, &ones);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    if (ok) {
+        unsigned long long rows = 1ULL << vm.count;
+        printf("Columns:");
+        for (int v = 0; v < vm.count; v++) printf(" %s", vm.names[v]);
+        printf("\nRows: %llu (%llu true)\n", rows, (unsigned long long)ones);
+        printf("Time: %f seconds (%.1f million rows/second)\n", seconds, seconds > 0 ? rows / seconds / 1e6 : 0.0);
+    }
+    varMapFree(&vm);
+    freeTree(root);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief CNF export mode: writes the CNF of a formula as DIMACS, one
+ *        clause at a time, with memory bounded by the formula (see
+ *        cnfStream.h). The totals go to stderr so OUT may be stdout.
+ * @return 0 on success, 1 on error.
+ */
+static int runExportCnfMode(int argc, char *argv[])
+{
+    if (argc < 3 || argc > 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const char *path = argc == 4 ? argv[3] : "-";
+    Node *root = parseInfixFormula(argv[2]);
+    if (root == NULL) {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+        return 1;
+    }
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        perror(path);
+        freeTree(root);
+        return 1;
+    }
+    CnfStreamReport rep;
+    int ok = writeCnfStreamDimacs(root, out, &rep);
+    if (out != stdout && fclose(out) != 0) {
+        perror(path);
+        ok = 0;
+    }
+    if (ok) {
+        fprintf(stderr, "Variables: %d\n", rep.numVars);
+        fprintf(stderr, "Clauses: %lld (%lld valid), %lld literals, widest %d\n",
+                rep.clauses, rep.tautologies, rep.literals, rep.maxWidth);
+        fprintf(stderr, "Generator: %ld nodes, %zu bytes\n", rep.streamNodes, rep.memoryBytes);
+        fprintf(stderr, "Time: %f seconds\n", rep.seconds);
+    }
+    freeTree(root);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Prints one row of a bitmap table in the layout of the text table.
+ */
+static void printBitmapRow(const TruthBitmap *tb, uint64_t k)
+{
+    for (int j = 0; j < tb->numVars; j++) printf("%d\t", truthBitmapValue(tb, k, j));
+    printf(" | %s\n", truthBitmapRow(tb, k) ? "T" : "F");
+}
+
+/**
+ * @brief State of the list query.
+ */
+typedef struct {
+    const TruthBitmap *tb;
+    uint64_t limit;      /**< Rows still to print */
+} ListState;
+
+static int printListedRow(uint64_t row, void *arg)
+{
+    ListState *st = arg;
+    printBitmapRow(st->tb, row);
+    return --st->limit == 0;
+}
+
+/**
+ * @brief Reads a row index argument.
+ * @return 1 if text is a non-negative integer, 0 otherwise.
+ */
+static int parseRowIndex(const char *text, uint64_t *out)
+{
+    char *end;
+    if (text[0] == '-' || text[0] == '\0') return 0;
+    *out = strtoull(text, &end, 10);
+    if (*end != '\0') {
+        printf("Error: Expected a row number, got '%s'.\n", text);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Table query mode: answer row, range-count and satisfying-row
+ *        queries on a bitmap file without evaluating the formula.
+ *        Without a query the columns and totals are printed.
+ * @return 0 on success, 1 on error.
+ */
+static int runTableQueryMode(int argc, char *argv[])
+{
+    int limit = 0;
+    if (argc > 4 && strcmp(argv[argc - 2], "--limit") == 0) {
+        int i = argc - 2;
+        if (!optionInt(argc, argv, &i, &limit) || limit < 1) return 1;
+        argc -= 2;
+    }
+    const char *query = argc > 3 ? argv[3] : NULL;
+    uint64_t from = 0, to = UINT64_MAX;
+    int shapeOk = !query
+        || (strcmp(query, "row") == 0 && argc == 5 && parseRowIndex(argv[4], &from))
+        || ((strcmp(query, "count") == 0 || strcmp(query, "list") == 0)
+            && (argc == 4 || (argc == 6 && parseRowIndex(argv[4], &from) && parseRowIndex(argv[5], &to))));
+    if (argc < 3 || !shapeOk || (limit && (!query || strcmp(query, "list") != 0))) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    TruthBitmap *tb = openTruthBitmap(argv[2]);
+    if (!tb) return 1;
+
+    int status = 0;
+    if (!query) {
+        printf("Columns:");
+        for (int j = 0; j < tb->numVars; j++) printf(" %s", tb->names[j]);
+        printf("\nRows: %llu (%llu true)\n", (unsigned long long)tb->rows, (unsigned long long)tb->ones);
+    } else if (strcmp(query, "count") == 0) {
+        printf("%llu\n", (unsigned long long)truthBitmapCount(tb, from, to));
+    } else {
+        if (strcmp(query, "row") == 0 && from >= tb->rows) {
+            printf("Error: Row %llu is outside the table (%llu rows).\n",
+                   (unsigned long long)from, (unsigned long long)tb->rows);
+            status = 1;
+        } else {
+            for (int j = 0; j < tb->numVars; j++) printf("%s\t", tb->names[j]);
+            printf(" | Result\n");
+            if (strcmp(query, "row") == 0) {
+                printBitmapRow(tb, from);
+            } else {
+                ListState st = { tb, limit ? (uint64_t)limit : UINT64_MAX };
+                truthBitmapForEach(tb, from, to, printListedRow, &st);
+            }
+        }
+    }
+    closeTruthBitmap(tb);
+    return status;
+}
+
+/**
+ * @brief Output state of the models mode.
+ */
+typedef struct {
+    int dimacs;          /**< Cubes as DIMACS literals instead of columns */
+    int quiet;           /**< --count: cubes are not printed */
+    long long limit;     /**< Cubes still to print (< 0: all) */
+} ModelPrinter;
+
+static int printModelCube(const signed char *cube, int numVars, void *arg)
+{
+    ModelPrinter *mp = arg;
+    if (!mp->quiet) {
+        for (int v = 0; v < numVars; v++) {
+            if (!mp->dimacs) printf("%c\t", cube[v] < 0 ? '-' : '0' + cube[v]);
+            else if (cube[v] >= 0) printf("%d ", cube[v] ? v + 1 : -(v + 1));
+        }
+        printf(mp->dimacs ? "0\n" : " | T\n");
+    }
+    return mp->limit > 0 && --mp->limit == 0;
+}
+
+/**
+ * @brief Models mode: stream the satisfying assignments of a formula or
+ *        a .cnf clause set as disjoint cubes, never building the table.
+ *        Formulas print in truth-table columns, clause sets as DIMACS
+ *        literal lines; totals go to stderr.
+ * @return 0 if there are models, 1 if none or on error.
+ */
+static int runModelsMode(int argc, char *argv[])
+{
+    const char *input = NULL;
+    int limit = 0, count = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--limit") == 0) {
+            if (!optionInt(argc, argv, &i, &limit)) return 1;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            count = 1;
+        } else if (!input) {
+            input = argv[i];
+        } else {
+            input = NULL;
+            break;
+        }
+    }
+    if (!input || limit < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int isCnf = isCnfPath(input);
+    CnfFormula *f = NULL;
+    Node *root = NULL;
+    VarMap vm;
+    varMapInit(&vm);
+    AllSat *e = NULL;
+    if (isCnf) {
+        f = readCnfFormula(input);
+        if (f) e = allSatNew(f);
+    } else {
+        root = parseInfixFormula(input);
+        if (root) e = allSatFromFormula(root, &vm);
+    }
+    if (!e) {
+        printf("Error: Cannot enumerate the models of '%s'.\n", input);
+    } else {
+        ModelPrinter mp = { isCnf, count, limit ? limit : -1 };
+        if (!isCnf && !count) {
+            for (int v = 0; v < vm.count; v++) printf("%s\t", vm.names[v]);
+            printf(" | Result\n");
+        }
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        allSatForEach(e, printModelCube, &mp);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        AllSatStats st = allSatGetStats(e);
+        fflush(stdout);
+        fprintf(stderr, "Cubes: %lld covering %.0f of 2^%d assignments%s\n", st.cubes, st.models,
+                allSatNumVars(e), mp.limit == 0 ? " (stopped at --limit)" : "");
+        fprintf(stderr, "Search: %lld decisions, %lld dead ends, %f seconds\n", st.decisions, st.conflicts,
+                (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    }
+    int status = e && allSatGetStats(e).cubes > 0 ? 0 : 1;
+    allSatFree(e);
+    varMapFree(&vm);
+    freeTree(root);
+    freeCnfFormula(f);
+    return status;
+}
+
+/**
+ * @brief Minimize mode: print a minimum (or near-minimum) sum of
+ *        products, or product of sums with --pos, of a formula or of a
+ *        bitmap truth table written by --table.
+ * @return 0 on success, 1 on error.
+ */
+static int runMinimizeMode(int argc, char *argv[])
+{
+    const char *input = NULL;
+    int pos = 0;
+    MinimizeMode mode = MIN_AUTO;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--pos") == 0) pos = 1;
+        else if (strcmp(argv[i], "--exact") == 0) mode = MIN_EXACT;
+        else if (strcmp(argv[i], "--heuristic") == 0) mode = MIN_HEURISTIC;
+        else if (!input) input = argv[i];
+        else {
+            input = NULL;
+            break;
+        }
+    }
+    if (!input) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    size_t len = strlen(input);
+    CubeCover cover = { 0 };
+    MinimizeStats st;
+    VarMap vm;
+    varMapInit(&vm);
+    char **names = NULL;
+    TruthBitmap *tb = NULL;
+    Node *root = NULL;
+    int ok = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (len > 4 && strcmp(input + len - 4, ".ttb") == 0) {
+        // Column j of the file is bit numVars-1-j of the row: variable numVars-1-j here
+        tb = openTruthBitmap(input);
+        names = tb ? malloc((tb->numVars ? tb->numVars : 1) * sizeof(char*)) : NULL;
+        if (names) {
+            for (int j = 0; j < tb->numVars; j++) names[tb->numVars - 1 - j] = (char*)tb->names[j];
+            ok = minimizeTable(tb->bits, tb->numVars, mode, pos, &cover, &st);
+        }
+    } else if ((root = parseInfixFormula(input)) != NULL) {
+        ok = minimizeFormula(root, &vm, mode, pos, &cover, &st);
+        names = vm.names;
+    } else {
+        printf("Error: Failed to build parse tree. Check your input.\n");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (ok) {
+        printf("%s: ", pos ? "POS" : "SOP");
+        printCubeCover(stdout, &cover, names, pos);
+        printf("\nCubes: %ld, literals: %ld (%s)\n", st.cubes, st.literals,
+               st.exact ? "minimum" : "heuristic");
+        printf("Table: %d variables, %lld %s rows; start cover %ld cubes", st.numVars, st.minterms,
+               pos ? "false" : "true", st.initialCubes);
+        if (st.primes >= 0) printf(", %ld prime implicants", st.primes);
+        if (st.passes > 0) printf(", %d passes", st.passes);
+        printf("\nComputed in %f seconds\n", (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    }
+    if (tb) free(names);
+    closeTruthBitmap(tb);
+    freeCubeCover(&cover);
+    varMapFree(&vm);
+    freeTree(root);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Knowledge-compilation mode: compile a CNF file into a
+ *        decision-DNNF circuit (or load one saved earlier), optionally
+ *        save it, and answer a count / SAT / entailment query script.
+ * @return 0 on success, 1 on error.
+ */
+static int runDnnfMode(int argc, char *argv[])
+{
+    const char *input = NULL, *queryPath = NULL, *savePath = NULL;
+    int maxNodes = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--max-nodes") == 0) {
+            if (!optionInt(argc, argv, &i, &maxNodes)) return 1;
+        } else if (!input) {
+            input = argv[i];
+        } else if (!queryPath) {
+            queryPath = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!input) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    size_t len = strlen(input);
+    Dnnf *d = NULL;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (len > 5 && strcmp(input + len - 5, ".dnnf") == 0) {
+        d = loadDnnf(input);
+        if (!d) return 1;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("Loaded %s in %f seconds\n", input,
+               (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    } else {
+        CnfFormula *f = readCnfFormula(input);
+        if (!f) {
+            printf("Error: Could not read or process file '%s'.\n", input);
+            return 1;
+        }
+        printf("Loaded %s: %d variables, %d clauses\n", input, f->numVars, f->numClauses);
+        DnnfCompileStats st;
+        d = compileDnnf(f, maxNodes, &st);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        freeCnfFormula(f);
+        if (!d) return 1;
+        printf("Compiled in %f seconds: %ld decisions, %ld components, %ld cache hits\n",
+               (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9,
+               st.decisions, st.components, st.cacheHits);
+    }
+    printf("Circuit: %d nodes, %ld child entries, %d variables\n", d->numNodes, d->numKids, d->numVars);
+    printf("Models: %.0f\n", dnnfCount(d, NULL, 0));
+
+    int ok = 1;
+    if (savePath) {
+        ok = saveDnnf(d, savePath);
+        if (ok) printf("Saved %s\n", savePath);
+    }
+    if (ok && queryPath) {
+        FILE *q = strcmp(queryPath, "-") == 0 ? stdin : fopen(queryPath, "r");
+        if (!q) {
+            printf("Error: Cannot open file '%s'\n", queryPath);
+            freeDnnf(d);
+            return 1;
+        }
+        DnnfQueryReport r;
+        printf("\n");
+        ok = runDnnfQueries(d, q, stdout, &r);
+        if (q != stdin) fclose(q);
+        printf("\n----------------------------------------\n");
+        printf("Queries: %d\n", r.queries);
+        printf("Total time: %f seconds (%f ms per query)\n",
+               r.seconds, r.queries ? 1000.0 * r.seconds / r.queries : 0.0);
+        printf("----------------------------------------\n");
+    }
+    freeDnnf(d);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Prints the results for the session's current formula.
+ * @return 1 on success, 0 on error.
+ */
+static int printAnalysisReport(AnalysisSession *s)
+{
+    static const char *const how[] = { "signature", "counterexample", "CNF", "refutation" };
+    AnalysisReport r;
+    if (!analysisReport(s, &r)) return 0;
+    printf("Height: %d, variables: %d, signature: %016llx\n",
+           r.height, r.numVars, (unsigned long long)r.signature);
+    if (r.clauses >= 0) {
+        printf("CNF: %lld clauses, %lld valid, %lld invalid\n",
+               r.clauses, r.tautologies, r.clauses - r.tautologies);
+    } else {
+        printf("CNF: over the size limit\n");
+    }
+    printf("Valid: %s (by %s)\n", r.valid ? "yes" : "no", how[r.decidedBy]);
+    return 1;
+}
+
+/**
+ * @brief Incremental mode: runs a script of loads, edits and queries on
+ *        one analysis session, timing each command.
+ *
+ * Script lines:
+ *   - "load FORMULA"       make FORMULA the current formula
+ *   - "edit PATH FORMULA"  replace the subtree at PATH (l/r steps, "." = root)
+ *   - "report"             height, variables, signature, CNF counts, validity
+ *   - "show" / "vars" / "cnf"  the formula, its variables, its CNF
+ *   - lines starting with '#' are comments
+ *
+ * @return 0 if every command succeeded, 1 otherwise.
+ */
+static int runIncrementalMode(int argc, char *argv[])
+{
+    if (argc > 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const char *path = argc == 3 ? argv[2] : "-";
+    FILE *in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!in) {
+        printf("Error: Cannot open file '%s'\n", path);
+        return 1;
+    }
+    AnalysisSession *s = analysisSessionNew();
+    if (!s) {
+        if (in != stdin) fclose(in);
+        return 1;
+    }
+
+    char *line = NULL;
+    size_t cap = 0;
+    int failures = 0;
+    while (getline(&line, &cap, in) != -1) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *cmd = line + strspn(line, " \t");
+        if (*cmd == '\0' || *cmd == '#') continue;
+        char *arg = cmd + strcspn(cmd, " \t");
+        if (*arg) *arg++ = '\0';
+        arg += strspn(arg, " \t");
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        int ok = 1, edited = 0;
+        if (strcmp(cmd, "load") == 0 || strcmp(cmd, "edit") == 0) {
+            char *formula = arg;
+            if (cmd[0] == 'e') {
+                formula = arg + strcspn(arg, " \t");
+                if (*formula) *formula++ = '\0';
+            }
+            Node *tree = *formula ? parseInfixFormula(formula) : NULL;
+            if (!tree) {
+                printf("Error: Failed to build parse tree. Check your input.\n");
+                ok = 0;
+            } else {
+                ok = cmd[0] == 'e' ? analysisEdit(s, arg, tree) : analysisLoad(s, tree);
+                edited = ok;
+            }
+            freeTree(tree);
+        } else if (strcmp(cmd, "report") == 0) {
+            ok = printAnalysisReport(s);
+        } else if (strcmp(cmd, "show") == 0) {
+            Node *tree = analysisTree(s);
+            ok = tree != NULL;
+            if (ok) printInOrder(tree);
+            printf("\n");
+            freeTree(tree);
+        } else if (strcmp(cmd, "vars") == 0) {
+            analysisPrintVars(s, stdout);
+        } else if (strcmp(cmd, "cnf") == 0) {
+            ok = analysisPrintCnf(s, stdout);
+            if (!ok) printf("Error: No CNF (no formula, or over the size limit).\n");
+        } else {
+            printf("Error: Unknown command '%s'.\n", cmd);
+            ok = 0;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        AnalysisStats st = analysisGetStats(s);
+        double ms = 1000.0 * (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-6;
+        if (edited) {
+            printf("%s: %ld new subtrees, %ld reused, %ld in session (%.3f ms)\n",
+                   cmd, st.newNodes, st.reusedNodes, st.totalNodes, ms);
+        } else if (ok && strcmp(cmd, "report") == 0) {
+            printf("report: %ld clause sets built (%.3f ms)\n", st.clauseSets, ms);
+        }
+        failures += !ok;
+    }
+    free(line);
+    if (in != stdin) fclose(in);
+    analysisSessionFree(s);
+    return failures ? 1 : 0;
+}
+
+/**
+ * @brief Propagation workload: assigns the decision literals in order,
+ *        skipping assigned variables and propagating after each, and
+ *        backtracks to the root after a conflict or every depth decisions.
+ * @return Literals assigned at the conflict-free backtracks (the same for
+ *         any numbering), or -1 on malloc failure.
+ */
+static long long propagationWorkload(const CnfFormula *f, const int *decisions, int n, int depth)
+{
+    UnitProp *up = unitPropNew(f);
+    if (!up) return -1;
+    long long assigned = 0;
+    if (!up->rootConflict && unitPropPropagate(up)) {
+        int root = up->trailSize, made = 0;
+        for (int i = 0; i < n; i++) {
+            if (unitPropLitValue(up, decisions[i]) >= 0) continue;
+            int ok = unitPropAssign(up, decisions[i]) && unitPropPropagate(up);
+            if (!ok || ++made == depth) {
+                if (ok) assigned += up->trailSize - root;
+                unitPropBacktrack(up, root);
+                made = 0;
+            }
+        }
+        assigned += up->trailSize - root;
+    }
+    unitPropFree(up);
+    return assigned;
+}
+
+/**
+ * @brief Evaluation workload: counts the clauses satisfied by each of
+ *        rounds assignments; values holds rounds rows of numVars + 1.
+ */
+static long long evaluationWorkload(const CnfFormula *f, const unsigned char *values, int rounds)
+{
+    long long satisfied = 0;
+    for (int r = 0; r < rounds; r++) {
+        const unsigned char *row = values + (size_t)r * (f->numVars + 1);
+        for (int c = 0; c < f->numClauses; c++) {
+            const int *lits = cnfClause(f, c);
+            int size = cnfClauseSize(f, c), sat = 0;
+            for (int k = 0; k < size && !sat; k++) sat = row[abs(lits[k])] == (lits[k] > 0);
+            satisfied += sat;
+        }
+    }
+    return satisfied;
+}
+
+/**
+ * @brief Runs a workload on both numberings, timing it and reading the
+ *        cache counters, and prints the comparison.
+ */
+static void compareLayouts(const char *label, CacheCounters *cc, long long result[2],
+                           long long (*run)(void *arg, int which), void *arg)
+{
+    double seconds[2];
+    long long refs[2], misses[2];
+    for (int which = 0; which < 2; which++) {
+        struct timespec t0, t1;
+        cacheCountersStart(cc);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        result[which] = run(arg, which);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        cacheCountersStop(cc, &refs[which], &misses[which]);
+        seconds[which] = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    }
+    printf("%s: original %f s, reordered %f s (%.2fx)\n", label, seconds[0], seconds[1],
+           seconds[1] > 0 ? seconds[0] / seconds[1] : 0.0);
+    if (misses[0] >= 0 && misses[1] >= 0) {
+        printf("  cache misses: %lld -> %lld (%.1f%% fewer), references: %lld -> %lld\n",
+               misses[0], misses[1], misses[0] ? 100.0 * (misses[0] - misses[1]) / misses[0] : 0.0,
+               refs[0], refs[1]);
+    }
+}
+
+/**
+ * @brief Inputs of the reorder-mode workloads, original [0] and
+ *        reordered [1].
+ */
+typedef struct {
+    const CnfFormula *f[2];
+    int *decisions[2];
+    int numDecisions;
+    int depth;
+    unsigned char *values[2];
+    int rounds;
+} ReorderBench;
+
+static long long runPropagation(void *arg, int which)
+{
+    ReorderBench *b = arg;
+    return propagationWorkload(b->f[which], b->decisions[which], b->numDecisions, b->depth);
+}
+
+static long long runEvaluation(void *arg, int which)
+{
+    ReorderBench *b = arg;
+    return evaluationWorkload(b->f[which], b->values[which], b->rounds);
+}
+
+/**
+ * @brief Solves the reordered formula and checks the translated model
+ *        against the original clauses.
+ * @return 1 if the answer could be checked, 0 otherwise.
+ */
+static int solveReordered(const CnfFormula *f, const CnfFormula *g, const CnfRenumbering *map)
+{
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Solver *s = solverFromFormula(g);
+    int res = s ? solverSolve(s, NULL, 0) : SOLVER_UNKNOWN;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    int ok = res != SOLVER_UNKNOWN;
+    if (res == SOLVER_SAT) {
+        int *values = malloc(((size_t)g->numVars + 1) * sizeof(int));
+        int *model = malloc(((size_t)f->numVars + 1) * sizeof(int));
+        ok = values && model;
+        if (ok) {
+            for (int v = 1; v <= g->numVars; v++) values[v] = solverModelValue(s, v);
+            translateModel(map, values, model);
+            for (int c = 0; c < f->numClauses && ok; c++) {
+                const int *lits = cnfClause(f, c);
+                int sat = 0;
+                for (int k = 0; k < cnfClauseSize(f, c) && !sat; k++) sat = model[abs(lits[k])] == (lits[k] > 0);
+                ok = sat;
+            }
+        }
+        free(values);
+        free(model);
+    }
+    printf("Solved reordered formula in %f seconds: %s%s\n", seconds,
+           res == SOLVER_SAT ? "SAT" : res == SOLVER_UNSAT ? "UNSAT" : "UNKNOWN",
+           res == SOLVER_SAT ? (ok ? ", model verified on the original numbering" : ", MODEL CHECK FAILED") : "");
+    solverFree(s);
+    return ok;
+}
+
+/**
+ * @brief Reorder mode: renumbers a clause set in reverse Cuthill-McKee
+ *        order, reports the locality gain and times propagation and
+ *        evaluation on both numberings.
+ * @return 0 on success, 1 on error.
+ */
+static int runReorderMode(int argc, char *argv[])
+{
+    const char *input = NULL, *outPath = NULL, *mapPath = NULL;
+    int probes = 20000, rounds = 16, depth = 50, solve = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+            mapPath = argv[++i];
+        } else if (strcmp(argv[i], "--probes") == 0) {
+            if (!optionInt(argc, argv, &i, &probes)) return 1;
+        } else if (strcmp(argv[i], "--rounds") == 0) {
+            if (!optionInt(argc, argv, &i, &rounds)) return 1;
+        } else if (strcmp(argv[i], "--solve") == 0) {
+            solve = 1;
+        } else if (!input) {
+            input = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!input || probes < 0 || rounds < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    CnfFormula *f = readCnfFormula(input);
+    if (!f) {
+        printf("Error: Could not read or process file '%s'.\n", input);
+        return 1;
+    }
+    printf("Loaded %s: %d variables, %d clauses\n", input, f->numVars, f->numClauses);
+    CnfRenumbering map;
+    ReorderStats st;
+    CnfFormula *g = reorderCnfFormula(f, &map, &st);
+    if (!g) {
+        freeCnfFormula(f);
+        return 1;
+    }
+    printf("Reordered in %f seconds (%d components)\n", st.seconds, st.components);
+    printf("Clause span: mean %.1f -> %.1f, bandwidth %d -> %d\n",
+           f->numClauses ? (double)st.spanBefore / f->numClauses : 0.0,
+           f->numClauses ? (double)st.spanAfter / f->numClauses : 0.0,
+           st.bandwidthBefore, st.bandwidthAfter);
+
+    int ok = 1;
+    if (outPath) {
+        FILE *out = fopen(outPath, "w");
+        ok = out && writeCnfFormula(g, out);
+        if (out && fclose(out) != 0) ok = 0;
+        if (!ok) printf("Error: Cannot write file '%s'\n", outPath);
+        else printf("Saved %s\n", outPath);
+    }
+    if (ok && mapPath) {
+        FILE *out = fopen(mapPath, "w");
+        if (out) {
+            for (int v = 1; v <= map.numVars; v++) fprintf(out, "%d %d\n", v, map.newOfOld[v]);
+        }
+        ok = out && !ferror(out);
+        if (out && fclose(out) != 0) ok = 0;
+        if (!ok) printf("Error: Cannot write file '%s'\n", mapPath);
+        else printf("Saved %s (original and new number of each variable)\n", mapPath);
+    }
+
+    ReorderBench b = { { f, g }, { NULL, NULL }, probes, depth, { NULL, NULL }, rounds };
+    size_t rowBytes = (size_t)f->numVars + 1;
+    for (int which = 0; which < 2; which++) {
+        b.decisions[which] = malloc(((size_t)probes + 1) * sizeof(int));
+        b.values[which] = malloc((size_t)rounds * rowBytes + 1);
+    }
+    if (ok && f->numVars > 0 && b.decisions[0] && b.decisions[1] && b.values[0] && b.values[1]) {
+        GenRng rng;
+        genSeed(&rng, 1);
+        for (int i = 0; i < probes; i++) {
+            int lit = 1 + genBelow(&rng, f->numVars);
+            if (genNext(&rng) & 1) lit = -lit;
+            b.decisions[0][i] = lit;
+            b.decisions[1][i] = renumberLiteral(&map, lit);
+        }
+        for (int r = 0; r < rounds; r++) {
+            unsigned char *row = b.values[0] + (size_t)r * rowBytes;
+            unsigned char *mapped = b.values[1] + (size_t)r * rowBytes;
+            for (int v = 1; v <= f->numVars; v++) {
+                row[v] = (unsigned char)(genNext(&rng) & 1);
+                mapped[map.newOfOld[v]] = row[v];
+            }
+        }
+
+        CacheCounters cc;
+        if (!cacheCountersOpen(&cc)) printf("Hardware cache counters: unavailable\n");
+        long long result[2];
+        char label[96];
+        snprintf(label, sizeof(label), "Propagation (%d decisions, depth %d)", probes, depth);
+        compareLayouts(label, &cc, result, runPropagation, &b);
+        if (result[0] != result[1]) {
+            printf("Error: Propagation differs: %lld vs %lld literals.\n", result[0], result[1]);
+            ok = 0;
+        }
+        snprintf(label, sizeof(label), "Evaluation (%d assignments)", rounds);
+        compareLayouts(label, &cc, result, runEvaluation, &b);
+        if (result[0] != result[1]) {
+            printf("Error: Evaluation differs: %lld vs %lld satisfied clauses.\n", result[0], result[1]);
+            ok = 0;
+        }
+        cacheCountersClose(&cc);
+    }
+    for (int which = 0; which < 2; which++) {
+        free(b.decisions[which]);
+        free(b.values[which]);
+    }
+
+    if (ok && solve) ok = solveReordered(f, g, &map);
+    freeCnfRenumbering(&map);
+    freeCnfFormula(g);
+    freeCnfFormula(f);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Corpus mode: run the selected analyses on every instance of a
+ *        directory or list file, one JSON line each on stdout; totals
+ *        go to stderr.
+ * @return 0 if every instance was read, 1 otherwise.
+ */
+static int runBatchMode(int argc, char *argv[])
+{
+    BatchOptions opts = defaultBatchOptions();
+    const char *input = NULL, *cacheDir = NULL;
+    for (int i = 2; i < argc; i++) {
+        int budget;
+        if (strcmp(argv[i], "--analyses") == 0 && i + 1 < argc) {
+            if (!parseBatchAnalyses(argv[++i], &opts.analyses)) return 1;
+        } else if (strcmp(argv[i], "--conflicts") == 0) {
+            if (!optionInt(argc, argv, &i, &budget)) return 1;
+            opts.conflictBudget = budget;
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (!input) {
+            input = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!input) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (cacheDir && !(opts.cache = resultCacheNew(DEFAULT_CACHE_BYTES, cacheDir))) return 1;
+
+    char **files;
+    int n = collectBatchInputs(input, &files);
+    if (n < 0) {
+        resultCacheFree(opts.cache);
+        return 1;
+    }
+    BatchSummary sum;
+    int ok = runBatch(files, n, &opts, stdout, &sum);
+    if (ok) {
+        fprintf(stderr, "Instances: %d (%d unreadable)\n", sum.instances, sum.failed);
+        fprintf(stderr, "Wall: %f s, loading: %f s, analysis: %f s, waiting on loader: %f s\n",
+                sum.wallSeconds, sum.loadSeconds, sum.analyzeSeconds, sum.stallSeconds);
+    }
+    if (opts.cache) {
+        CacheStats st = resultCacheStats(opts.cache);
+        printCacheStats(stderr, &st);
+        resultCacheFree(opts.cache);
+    }
+    for (int i = 0; i < n; i++) free(files[i]);
+    free(files);
+    return ok && sum.failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Computes the interactive pipeline's results for a formula:
+ *        height (Task 4), model count (Task 5's truth table), CNF text
+ *        (Task 6) and the Task 7 clause verdict.
+ */
+static void computeFormulaResults(Node *root, CachedResult *r)
+{
+    r->height = maxHeightOfParseTree(root);
+
+    VarMap vm;
+    varMapInit(&vm);
+    CompiledFormula *cf = compileFormula(root, &vm);
+    r->numVars = vm.count;
+    if (cf && cf->numVars <= MAX_COUNT_VARS) nativeKernelAttach(cf, ldexp(1, cf->numVars - 6));
+    r->models = cf ? countCompiledModels(cf) : -1;
+    if (r->models >= 0) r->sat = r->models > 0;
+    freeCompiledFormula(cf);
+    varMapFree(&vm);
+
+    Node *cnf = parConvertToCNF(root);
+    size_t len;
+    FILE *text = open_memstream(&r->cnf, &len);
+    if (text) {
+        fprintCNF(text, cnf);
+        fclose(text);
+    }
+    r->validClauses = r->invalidClauses = 0;
+    parCheckCNFValidity(cnf, &r->validClauses, &r->invalidClauses);
+    r->valid = r->invalidClauses == 0 && r->validClauses > 0;
+    freeTree(cnf);
+}
+
+/**
+ * @brief Computes the results for a clause set: satisfiability, validity
+ *        (every clause tautological, i.e. none kept) and, if asked for,
+ *        the model count.
+ */
+static void computeClauseSetResults(const CnfFormula *f, int count, CachedResult *r)
+{
+    r->numVars = f->numVars;
+    r->valid = f->numClauses == 0;
+    if (count) {
+        r->models = countModels(f);
+        if (r->models >= 0) r->sat = r->models > 0;
+        return;
+    }
+    Solver *s = solverFromFormula(f);
+    int res = s ? solverSolve(s, NULL, 0) : SOLVER_UNKNOWN;
+    if (res != SOLVER_UNKNOWN) r->sat = res == SOLVER_SAT;
+    solverFree(s);
+}
+
+/**
+ * @brief Parses the analyze-mode input and hashes it.
+ * @return 1 on success, 0 if it could not be read or parsed.
+ */
+static int loadAnalyzeInput(const char *input, int isCnf, Node **root, CnfFormula **f, CacheKey *key)
+{
+    if (isCnf) {
+        *f = readCnfFormula(input);
+        if (*f) *key = hashClauseSet(*f);
+        return *f != NULL;
+    }
+    *root = parseInfixFormula(input);
+    if (*root) *key = hashFormulaTree(*root);
+    return *root != NULL;
+}
+
+/**
+ * @brief Prints the known fields of a result record.
+ */
+static void printCachedResult(const CachedResult *r)
+{
+    if (r->height >= 0) printf("The Height of the Parse Tree is: %d\n", r->height);
+    if (r->models >= 0) printf("Models: %.0f of 2^%d assignments\n", r->models, r->numVars);
+    else printf("Models: not counted\n");
+    if (r->sat >= 0) printf("Satisfiable: %s\n", r->sat ? "yes" : "no");
+    if (r->cnf) printf("CNF Formula: %s\n", r->cnf);
+    if (r->validClauses >= 0) {
+        printf("Valid Clauses: %d\n", r->validClauses);
+        printf("Invalid Clauses: %d\n", r->invalidClauses);
+    }
+    printf("Result: The formula is %s.\n", r->valid == 1 ? "VALID (a Tautology)" : "NOT VALID");
+}
+
+/**
+ * @brief Cached pipeline mode: answer height, model count, CNF and
+ *        validity of a formula (or the count and validity of a .cnf
+ *        clause set) from the result cache, computing them on a miss.
+ *        Formulas are counted up to MAX_COUNT_VARS variables, clause
+ *        sets only with --count. --repeat re-submits the same input to
+ *        time cache hits.
+ * @return 0 on success, 1 on error.
+ */
+static int runAnalyzeMode(int argc, char *argv[])
+{
+    const char *input = NULL, *cacheDir = NULL;
+    int megabytes = 64, repeat = 1, count = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (strcmp(argv[i], "--cache-mb") == 0) {
+            if (!optionInt(argc, argv, &i, &megabytes)) return 1;
+        } else if (strcmp(argv[i], "--repeat") == 0) {
+            if (!optionInt(argc, argv, &i, &repeat)) return 1;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            count = 1;
+        } else if (!input) {
+            input = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!input) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int isCnf = isCnfPath(input);
+    ResultCache *cache = resultCacheNew((size_t)(megabytes > 0 ? megabytes : 0) << 20, cacheDir);
+    if (!cache) return 1;
+
+    int status = 0;
+    double hitSeconds = 0;
+    int hits = 0;
+    for (int rep = 0; rep < (repeat > 0 ? repeat : 1); rep++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        Node *root = NULL;
+        CnfFormula *f = NULL;
+        CacheKey key;
+        if (!loadAnalyzeInput(input, isCnf, &root, &f, &key)) {
+            printf("Error: Could not read or parse '%s'.\n", input);
+            status = 1;
+            break;
+        }
+        CachedResult r;
+        int hit = resultCacheLookup(cache, key, &r);
+        if (hit && isCnf && count && r.models < 0) {
+            // Cached without a count; compute it and upgrade the record
+            freeCachedResult(&r);
+            hit = 0;
+        }
+        if (!hit) {
+            r = emptyCachedResult();
+            if (isCnf) computeClauseSetResults(f, count, &r);
+            else computeFormulaResults(root, &r);
+            resultCacheStore(cache, key, &r);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        if (hit) {
+            hits++;
+            hitSeconds += seconds;
+        }
+        if (rep == 0) {
+            printCachedResult(&r);
+            printf("%s in %f seconds (key %016llx%016llx)\n",
+                   hit == 2 ? "Answered from the disk cache" : hit ? "Answered from the memory cache" : "Computed",
+                   seconds, (unsigned long long)key.hi, (unsigned long long)key.lo);
+        }
+        freeCachedResult(&r);
+        freeTree(root);
+        freeCnfFormula(f);
+    }
+    if (hits > 0)
+        fprintf(stderr, "Hits: %d, mean %.2f us each (parse + hash + lookup)\n", hits, hitSeconds / hits * 1e6);
+    CacheStats st = resultCacheStats(cache);
+    printCacheStats(stderr, &st);
+    resultCacheFree(cache);
+    return status;
+}
+
+/**
+ * @brief Daemon mode: serve analysis requests on a Unix socket.
+ * @return 0 on clean shutdown, 1 on error.
+ */
+static int runServeMode(int argc, char *argv[])
+{
+    ServerOptions opts = { NULL, 0, 0, 0, NULL };
+    for (int i = 2; i < argc; i++) {
+        int budget, megabytes;
+        if (strcmp(argv[i], "--workers") == 0) {
+            if (!optionInt(argc, argv, &i, &opts.numWorkers)) return 1;
+        } else if (strcmp(argv[i], "--conflicts") == 0) {
+            if (!optionInt(argc, argv, &i, &budget)) return 1;
+            opts.conflictBudget = budget;
+        } else if (strcmp(argv[i], "--cache-mb") == 0) {
+            if (!optionInt(argc, argv, &i, &megabytes)) return 1;
+            opts.cacheBytes = (size_t)(megabytes > 0 ? megabytes : 0) << 20;
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            opts.cacheDir = argv[++i];
+        } else if (!opts.socketPath) {
+            opts.socketPath = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!opts.socketPath) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (opts.cacheDir && opts.cacheBytes == 0) opts.cacheBytes = DEFAULT_CACHE_BYTES;
+    return runServer(&opts);
+}
+
+/**
+ * @brief Reads a whole file into a malloc'd string.
+ * @return Contents, or NULL on error.
+ */
+static char *readWholeFile(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { perror(path); return NULL; }
+    size_t cap = 65536, len = 0, got;
+    char *buf = malloc(cap);
+    while (buf && (got = fread(buf + len, 1, cap - len - 1, fp)) > 0) {
+        len += got;
+        if (cap - len - 1 == 0) {
+            char *nb = realloc(buf, cap * 2);
+            if (!nb) { free(buf); buf = NULL; break; }
+            buf = nb;
+            cap *= 2;
+        }
+    }
+    fclose(fp);
+    if (buf) buf[len] = '\0';
+    return buf;
+}
+
+/**
+ * @brief Client mode: send one request (optionally many times) to a
+ *        running daemon and print the replies.
+ * @return 0 on success, 1 on error.
+ */
+static int runClientMode(int argc, char *argv[])
+{
+    ClientOptions opts = { NULL, NULL, 1, 1, 0 };
+    const char *formula = NULL, *dimacs = NULL, *analyses = "parse";
+    const char *control = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--formula") == 0 && i + 1 < argc) formula = argv[++i];
+        else if (strcmp(argv[i], "--dimacs") == 0 && i + 1 < argc) dimacs = argv[++i];
+        else if (strcmp(argv[i], "--analyses") == 0 && i + 1 < argc) analyses = argv[++i];
+        else if (strcmp(argv[i], "--stats") == 0) control = "stats\n";
+        else if (strcmp(argv[i], "--shutdown") == 0) control = "shutdown\n";
+        else if (strcmp(argv[i], "--repeat") == 0) {
+            if (!optionInt(argc, argv, &i, &opts.repeat)) return 1;
+        } else if (strcmp(argv[i], "--inflight") == 0) {
+            if (!optionInt(argc, argv, &i, &opts.inflight)) return 1;
+        } else if (!opts.socketPath) {
+            opts.socketPath = argv[i];
+        } else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!opts.socketPath || (!formula && !dimacs && !control)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    char *body = dimacs ? readWholeFile(dimacs) : NULL;
+    if (dimacs && !body) return 1;
+    const char *text = control ? "" : formula ? formula : body;
+    size_t need = strlen(analyses) + strlen(text) + 32;
+    char *request = malloc(need);
+    if (!request) { free(body); return 1; }
+    if (control) snprintf(request, need, "%s", control);
+    else snprintf(request, need, "%s %s\n%s", formula ? "formula" : "dimacs", analyses, text);
+
+    opts.request = request;
+    opts.quiet = opts.repeat > 1;
+    int status = runClient(&opts);
+    free(request);
+    free(body);
+    return status;
+}
+
+/**
+ * @brief Dispatches the non-interactive command-line modes.
+ * @return Process exit status.
+ */
+static int runCommandLine(int argc, char *argv[])
+{
+    if (strcmp(argv[1], "--cube") == 0) return runCubeMode(argc, argv);
+    if (strcmp(argv[1], "--query") == 0) return runQueryMode(argc, argv);
+    if (strcmp(argv[1], "--valid") == 0 && argc == 3) return reportValidity(argv[2]);
+    if (strcmp(argv[1], "--simplify") == 0 && argc == 3) return runSimplifyMode(argv[2]);
+    if (strcmp(argv[1], "--equiv") == 0 || strcmp(argv[1], "--equiv-cnf") == 0)
+        return runEquivMode(argc, argv);
+    if (strcmp(argv[1], "--batch-eval") == 0) return runBatchEvalMode(argc, argv);
+    if (strcmp(argv[1], "--table") == 0 && argc == 4) return runTableMode(argv[2], argv[3]);
+    if (strcmp(argv[1], "--table-query") == 0) return runTableQueryMode(argc, argv);
+    if (strcmp(argv[1], "--export-cnf") == 0) return runExportCnfMode(argc, argv);
+    if (strcmp(argv[1], "--models") == 0) return runModelsMode(argc, argv);
+    if (strcmp(argv[1], "--minimize") == 0) return runMinimizeMode(argc, argv);
+    if (strcmp(argv[1], "--dnnf") == 0) return runDnnfMode(argc, argv);
+    if (strcmp(argv[1], "--incremental") == 0) return runIncrementalMode(argc, argv);
+    if (strcmp(argv[1], "--reorder") == 0) return runReorderMode(argc, argv);
+    if (strcmp(argv[1], "--batch") == 0) return runBatchMode(argc, argv);
+    if (strcmp(argv[1], "--analyze") == 0) return runAnalyzeMode(argc, argv);
+    if (strcmp(argv[1], "--serve") == 0) return runServeMode(argc, argv);
+    if (strcmp(argv[1], "--client") == 0) return runClientMode(argc, argv);
+
+    printUsage(argv[0]);
+    return strcmp(argv[1], "--help") == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Reads "--profile [json|csv] [OUT]", which runs the interactive
+ *        session with instrumentation on.
+ * @return 1 if the arguments are valid, 0 otherwise.
+ */
+static int parseProfileArgs(int argc, char *argv[], int *csv, const char **outPath)
+{
+    *csv = 0;
+    *outPath = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "csv") == 0) *csv = 1;
+        else if (strcmp(argv[i], "json") == 0) *csv = 0;
+        else if (!*outPath) *outPath = argv[i];
+        else {
+            printf("Error: Unexpected argument '%s'.\n", argv[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
 
 /**
  * @brief Entry point for the program.
  *
  * Handles user input, processing tasks 1-7, timing, and cleanup.
+ * Each task is timed as its own phase, excluding time spent at prompts;
+ * with --profile the per-phase record is written at the end. Manual
+ * formulas are simplified before Tasks 5 and 6 unless --no-simplify comes
+ * first; --threads N sets the workers of the parallel Task 6 and 7
+ * passes. Any other command-line arguments select a non-interactive mode
+ * instead.
  *
+ * @param argc Argument count.
+ * @param argv Argument vector.
  * @return int 0 on successful completion, 1 on error.
  */
-int main()
+int main(int argc, char *argv[])
 {
+    int simplifyOn = 1;
+    while (argc > 1) {
+        int used = 0;
+        if (strcmp(argv[1], "--no-simplify") == 0) {
+            simplifyOn = 0;
+            used = 1;
+        } else if (strcmp(argv[1], "--threads") == 0) {
+            int i = 1, threads;
+            if (!optionInt(argc, argv, &i, &threads)) return 1;
+            parTreeConfigure(threads, 0);
+            used = 2;
+        } else if (strcmp(argv[1], "--native") == 0 && argc > 2) {
+            if (!nativeKernelConfigure(argv[2])) return 1;
+            used = 2;
+        } else {
+            break;
+        }
+        argv[used] = argv[0];
+        argv += used;
+        argc -= used;
+    }
+    int profiling = argc > 1 && strcmp(argv[1], "--profile") == 0;
+    int profileCsv = 0;
+    const char *profilePath = NULL;
+    if (profiling) {
+        if (!parseProfileArgs(argc, argv, &profileCsv, &profilePath)) return 1;
+        instrumentEnable(1);
+    } else if (argc > 1) {
+        return runCommandLine(argc, argv);
+    }
+
     // --- Use malloc for large, dynamically allocated buffers ---
     char *inputInfix = malloc(LARGE_BUFFER_SIZE);
     char *inputPrefix = malloc(LARGE_BUFFER_SIZE);
@@ -60,11 +1715,11 @@ int main()
 
     Node *Root = NULL;
     Node *cnRoot = NULL;
+    Node *work = NULL;     // tree seen by Tasks 5-7: Root or its simplification
     
     int choice;
     char filename[256];
 
-    clock_t start, end;
     double total_time_taken;
 
     // --- 1. User Input Menu ---
@@ -73,6 +1728,7 @@ int main()
     printf("========================================\n");
     printf("  1. Enter Infix Formula Manually\n");
     printf("  2. Process a .cnf file\n");
+    printf("  3. Check validity of an Infix Formula (refutation)\n");
     printf("Enter your choice: ");
 
     if (scanf("%d", &choice) != 1) {
@@ -87,14 +1743,22 @@ int main()
     {
         printf("\n(Please use single uppercase letters as atoms: A, B, C...)\n");
         printf("Enter Infix Notation: ");
-        scanf("%s", inputInfix);
+        free(inputInfix);
+        inputInfix = readFormulaWord(stdin);
+        if (inputInfix == NULL) {
+            printf("Invalid input.\n");
+            free(inputPrefix);
+            return 1;
+        }
     }
     else if (choice == 2)
     {
         printf("\nEnter .cnf file path: ");
         scanf("%s", filename);
 
+        phaseBegin(PHASE_PARSE);
         char *formulaFromFile = cnfToInfix(filename);
+        phaseEnd(PHASE_PARSE, NULL);
         if (formulaFromFile == NULL) {
             printf("Error: Could not read or process file '%s'.\n", filename);
             free(inputInfix);
@@ -102,14 +1766,23 @@ int main()
             return 1;
         }
 
-        // Copy the formula, ensuring we don't overflow our large buffer
-        strncpy(inputInfix, formulaFromFile, LARGE_BUFFER_SIZE - 1);
-        inputInfix[LARGE_BUFFER_SIZE - 1] = '\0';
-        
-        free(formulaFromFile); // Free the temporary buffer from cnfReader
+        free(inputInfix);
+        inputInfix = formulaFromFile;
 
         printf("\nSuccessfully loaded formula from %s\n", filename);
     }
+    else if (choice == 3)
+    {
+        printf("\nEnter Infix Notation: ");
+        free(inputInfix);
+        inputInfix = readFormulaWord(stdin);
+        int status = 1;
+        if (inputInfix == NULL) printf("Invalid input.\n");
+        else status = reportValidity(inputInfix);
+        free(inputInfix);
+        free(inputPrefix);
+        return status;
+    }
     else
     {
         printf("Invalid choice. Exiting.\n");
@@ -118,44 +1791,92 @@ int main()
         return 1;
     }
 
+    // The formula can be any size: size the prefix buffer to match
+    // (prefix tokens plus separators never exceed 2n + 1)
+    char *grown = realloc(inputPrefix, 2 * strlen(inputInfix) + 2);
+    if (grown == NULL) {
+        printf("Fatal Error: Failed to allocate memory for buffers.\n");
+        free(inputInfix);
+        free(inputPrefix);
+        return 1;
+    }
+    inputPrefix = grown;
+
     // --- 3. Start Processing ---
     printf("\n--- Starting All Tasks ---\n");
-    start = clock();
 
     // --- Task 1: Infix to Prefix ---
     printf("\n[Task 1] Converting Infix to Prefix...\n");
+    phaseBegin(PHASE_PREFIX);
     inFixToPreFix(inputInfix, inputPrefix);
+    phaseEnd(PHASE_PREFIX, NULL);
 
     // --- Task 2: Prefix to Parse Tree ---
     printf("\n[Task 2] Building Parse Tree from Prefix...\n");
-    convertPreOrderToTree(&Root, inputPrefix);
+    phaseBegin(PHASE_TREE);
+    TreeStats rootStats;   // gathered while building, so Tasks 4 and 5 need no traversal
+    convertPreOrderToTreeWithStats(&Root, inputPrefix, &rootStats);
+    phaseEnd(PHASE_TREE, Root);
     if (Root == NULL) {
         printf("Error: Failed to build parse tree. Check your input.\n");
+        freeTreeStats(&rootStats);
         free(inputInfix);
         free(inputPrefix);
         return 1;
     }
     printf("Parse Tree built successfully.\n");
+    printTreeStats(stdout, &rootStats);
 
     // --- Task 3: In-order Traversal ---
     printf("\n[Task 3] Re-printing expression (In-Order Traversal)...\n");
     printf("Infix Expression: ");
+    phaseBegin(PHASE_TRAVERSAL);
     printPreOrder(Root);
+    phaseEnd(PHASE_TRAVERSAL, NULL);
     printf("\n");
 
     // --- Task 4: Compute Tree Height ---
     printf("\n[Task 4] Calculating Height of Parse Tree...\n");
-    printf("The Height of the Parse Tree is: %d\n", maxHeightOfParseTree(Root));
+    phaseBegin(PHASE_HEIGHT);
+    int height = rootStats.ok ? rootStats.height : maxHeightOfParseTree(Root);
+    phaseEnd(PHASE_HEIGHT, NULL);
+    printf("The Height of the Parse Tree is: %d\n", height);
+
+    // --- Simplification (manual input, before Tasks 5 and 6) ---
+    work = Root;
+    if (choice == 1 && simplifyOn)
+    {
+        printf("\n[Simplify] Removing redundancy before Tasks 5 and 6...\n");
+        SimplifyStats stats;
+        phaseBegin(PHASE_SIMPLIFY);
+        Node *simplified = simplifyFormula(Root, &stats);
+        phaseEnd(PHASE_SIMPLIFY, simplified);
+        if (simplified && stats.nodesAfter < stats.nodesBefore) {
+            work = simplified;
+            printf("Simplified Expression: ");
+            printInOrder(work);
+            printf("\n");
+            printSimplifyStats(&stats);
+        } else {
+            // e.g. implications only: rewriting A > B as ~A + B adds a node
+            printf("No reduction; keeping the original tree.\n");
+            freeTree(simplified);
+        }
+    }
 
     // --- Task 5: Truth Table & Evaluation ---
     printf("\n[Task 5] Generating Truth Table...\n");
-    printTruthTable(Root);
+    phaseBegin(PHASE_EVALUATION);
+    printTruthTable(work, work == Root && rootStats.ok ? &rootStats : NULL);   // pauses its own clocks at the prompts
+    phaseEnd(PHASE_EVALUATION, NULL);
 
     // --- Task 6: Convert to CNF (CONDITIONAL) ---
     if (choice == 1)
     {
         printf("\n[Task 6] Converting to CNF (Manual Input)...\n");
-        cnRoot = convertToCNF(Root);
+        phaseBegin(PHASE_CNF);
+        cnRoot = parConvertToCNF(work);
+        phaseEnd(PHASE_CNF, cnRoot);
         printf("CNF Formula: ");
         printCNF(cnRoot);
         printf("\n");
@@ -169,7 +1890,9 @@ int main()
     // --- Task 7: CNF Validity Check ---
     printf("\n[Task 7] Checking CNF Validity...\n");
     int valid = 0, invalid = 0;
-    checkCNFValidity(cnRoot, &valid, &invalid);
+    phaseBegin(PHASE_VALIDITY);
+    parCheckCNFValidity(cnRoot, &valid, &invalid);
+    phaseEnd(PHASE_VALIDITY, NULL);
     
     printf("Valid Clauses: %d\n", valid);
     printf("Invalid Clauses: %d\n", invalid);
@@ -180,17 +1903,28 @@ int main()
     }
 
     // --- 4. Final Timing ---
-    end = clock();
-    total_time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+    total_time_taken = phaseTotalSeconds();
 
     printf("\n----------------------------------------\n");
     printf("All tasks complete.\n");
     printf("Total execution time: %f seconds\n", total_time_taken);
     printf("----------------------------------------\n");
 
+    if (profiling) {
+        FILE *report = profilePath ? fopen(profilePath, "a") : stderr;
+        if (!report) {
+            perror(profilePath);
+        } else {
+            writePhaseReport(report, profileCsv, choice == 2 ? filename : inputInfix);
+            if (report != stderr) fclose(report);
+        }
+    }
+
     // --- 5. Final Cleanup ---
     printf("Freeing memory...\n");
     freeTree(Root); // This frees the original tree
+    freeTreeStats(&rootStats);
+    if (work != Root) freeTree(work);
     if (choice == 1 && cnRoot != Root) {
          // If choice was 1, cnRoot is a *copy* and must also be freed
          freeTree(cnRoot);
@@ -0,0 +1,362 @@
+/**
+ * @file microBench.c
+ * @brief Microbenchmarks of the task modules on synthetic formulas.
+ *
+ * The corpus benchmark only ever feeds CNF. Here each task function is
+ * timed in isolation on generated shapes (random k-CNF, implication
+ * chains, balanced and skewed trees, parity) over a sweep of sizes, so
+ * its scaling can be plotted.
+ * @section algo Algorithm:
+ *   - Per (shape, size): generate the formula, build the inputs of every
+ *     task once (prefix, tree, variables, CNF tree)
+ *   - Per task: warmup runs, then timed repetitions with fresh copies of
+ *     any input the task consumes; copying and freeing are not timed
+ *   - Summary: min, median, mean, standard deviation, max
+ * @section time Time Complexity: O(sizes × tasks × (warmup + reps) × task)
+ * @section space Space Complexity: O(formula + CNF tree + reps)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "formulaGen.h"
+#include "parallelTree.h"
+#include "task1.h"
+#include "task2.h"
+#include "task3.h"
+#include "task4.h"
+#include "task5.h"
+#include "task6.h"
+#include "common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Task functions that can be timed.
+ */
+typedef enum { MB_PREFIX, MB_TREE, MB_HEIGHT, MB_TABLE, MB_CNF, MB_VALIDITY, MB_NUM_TASKS } MicroTask;
+
+static const char *taskNames[MB_NUM_TASKS] = {
+    "prefix", "tree", "height", "truthtable", "cnf", "validity"
+};
+
+/**
+ * @brief Harness settings.
+ */
+typedef struct {
+    int warmup;            /**< Untimed runs before measuring */
+    int reps;              /**< Timed runs */
+    double budget;         /**< Stop repeating a task after this many seconds */
+    int maxTableVars;      /**< Skip the truth table above this many variables */
+    int maxCnfNodes;       /**< Skip cnf/validity above this input tree size */
+    int tasks;             /**< Mask of (1 << MicroTask) */
+    int parallel;          /**< cnf/validity run the fork-join versions */
+    int csv;
+} MicroOptions;
+
+/**
+ * @brief Inputs of every task for one formula, built once.
+ */
+typedef struct {
+    char *infix;
+    char *prefix;
+    size_t prefixCap;
+    Node *tree;
+    char **vars;
+    int numVars;
+    Node *cnf;
+    long nodes;
+    int height;
+} Fixture;
+
+static long countNodes(const Node *n) {
+    return n ? 1 + countNodes(n->left) + countNodes(n->right) : 0;
+}
+
+/**
+ * @brief Builds the fixture; returns 0 if the formula does not parse.
+ */
+static int buildFixture(Fixture *fx, char *infix, const MicroOptions *o) {
+    memset(fx, 0, sizeof(*fx));
+    fx->infix = infix;
+    size_t len = strlen(infix);
+    fx->prefixCap = 2 * len + 2;
+    fx->prefix = malloc(fx->prefixCap);
+    char *work = malloc(len + 1);
+    if (!fx->prefix || !work) { perror("malloc"); free(work); return 0; }
+    memcpy(work, infix, len + 1);
+    inFixToPreFix(work, fx->prefix);
+    char *copy = strdup_s(fx->prefix);
+    convertPreOrderToTree(&fx->tree, copy);
+    free(copy);
+    free(work);
+    if (!fx->tree) return 0;
+    fx->nodes = countNodes(fx->tree);
+    fx->height = maxHeightOfParseTree(fx->tree);
+    fx->vars = malloc((size_t)fx->nodes * sizeof(char*));
+    if (!fx->vars) { perror("malloc"); return 0; }
+    collectVariables(fx->tree, fx->vars, &fx->numVars);
+    if ((o->tasks & (1 << MB_VALIDITY)) && fx->nodes <= o->maxCnfNodes) fx->cnf = convertToCNF(fx->tree);
+    return 1;
+}
+
+static void freeFixture(Fixture *fx) {
+    free(fx->infix);
+    free(fx->prefix);
+    freeTree(fx->tree);
+    freeTree(fx->cnf);
+    for (int i = 0; i < fx->numVars; i++) free(fx->vars[i]);
+    free(fx->vars);
+}
+
+/**
+ * @brief Runs a task once; returns the seconds spent inside the task call.
+ */
+static double runTask(MicroTask t, Fixture *fx, const MicroOptions *o, char *scratch, FILE *sink) {
+    double t0, t1;
+    switch (t) {
+    case MB_PREFIX: {
+        strcpy(scratch, fx->infix);
+        char *out = malloc(fx->prefixCap);
+        t0 = nowSeconds();
+        inFixToPreFix(scratch, out);
+        t1 = nowSeconds();
+        free(out);
+        break;
+    }
+    case MB_TREE: {
+        strcpy(scratch, fx->prefix);
+        Node *root = NULL;
+        t0 = nowSeconds();
+        convertPreOrderToTree(&root, scratch);
+        t1 = nowSeconds();
+        freeTree(root);
+        break;
+    }
+    case MB_HEIGHT: {
+        t0 = nowSeconds();
+        volatile int h = maxHeightOfParseTree(fx->tree);
+        t1 = nowSeconds();
+        (void)h;
+        break;
+    }
+    case MB_TABLE:
+        t0 = nowSeconds();
+        printAndSaveTable(fx->tree, fx->vars, fx->numVars, sink);
+        fflush(sink);
+        t1 = nowSeconds();
+        break;
+    case MB_CNF: {
+        t0 = nowSeconds();
+        Node *cnf = o->parallel ? parConvertToCNF(fx->tree) : convertToCNF(fx->tree);
+        t1 = nowSeconds();
+        freeTree(cnf);
+        break;
+    }
+    default: {
+        int valid = 0, invalid = 0;
+        t0 = nowSeconds();
+        if (o->parallel) parCheckCNFValidity(fx->cnf, &valid, &invalid);
+        else checkCNFValidity(fx->cnf, &valid, &invalid);
+        t1 = nowSeconds();
+        break;
+    }
+    }
+    return t1 - t0;
+}
+
+static int cmpDouble(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Times one task and prints its summary row.
+ */
+static void benchTask(MicroTask t, Fixture *fx, const GenParams *gp, const MicroOptions *o,
+                      char *scratch, FILE *sink, double *samples) {
+    const char *skip = NULL;
+    if (t == MB_TABLE && fx->numVars > o->maxTableVars) skip = "too many variables";
+    if ((t == MB_CNF || t == MB_VALIDITY) && fx->nodes > o->maxCnfNodes) skip = "tree too large";
+    if (skip) {
+        if (!o->csv) printf("%-9s %7d %-11s skipped (%s)\n", genShapeName(gp->shape), gp->size, taskNames[t], skip);
+        return;
+    }
+
+    double spent = 0;
+    for (int i = 0; i < o->warmup && spent < o->budget; i++) spent += runTask(t, fx, o, scratch, sink);
+    int n = 0;
+    spent = 0;
+    while (n < o->reps && (n == 0 || spent < o->budget)) {
+        samples[n] = runTask(t, fx, o, scratch, sink);
+        spent += samples[n++];
+    }
+
+    double mean = 0, var = 0;
+    for (int i = 0; i < n; i++) mean += samples[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) var += (samples[i] - mean) * (samples[i] - mean);
+    double sd = n > 1 ? sqrt(var / (n - 1)) : 0;
+    qsort(samples, (size_t)n, sizeof(double), cmpDouble);
+    double med = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    if (o->csv) {
+        printf("%s,%d,%zu,%ld,%d,%d,%s,%d,%.9f,%.9f,%.9f,%.9f,%.9f\n", genShapeName(gp->shape), gp->size,
+               strlen(fx->infix), fx->nodes, fx->height, fx->numVars, taskNames[t], n,
+               samples[0], med, mean, sd, samples[n - 1]);
+    } else {
+        printf("%-9s %7d %-11s %5d %12.3f %12.3f %12.3f %10.3f %12.3f\n", genShapeName(gp->shape), gp->size,
+               taskNames[t], n, samples[0] * 1e6, med * 1e6, mean * 1e6, sd * 1e6, samples[n - 1] * 1e6);
+    }
+}
+
+/**
+ * @brief Parses a comma-separated list of positive integers.
+ * @return Number of values, or 0 on a malformed list.
+ */
+static int parseIntList(const char *list, int *out, int max) {
+    int n = 0;
+    const char *p = list;
+    while (*p && n < max) {
+        char *end;
+        long v = strtol(p, &end, 10);
+        if (end == p || v < 1) return 0;
+        out[n++] = (int)v;
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return 0;
+    }
+    return n;
+}
+
+static void printMicroUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --shapes LIST     kcnf,chain,balanced,left,right,parity (default all)\n");
+    printf("  --sizes LIST      sizes to sweep (default 16,64,256,1024)\n");
+    printf("  --tasks LIST      prefix,tree,height,truthtable,cnf,validity (default all)\n");
+    printf("  --vars N          variable pool for kcnf/balanced/left/right (default: size)\n");
+    printf("  --k K             literals per kcnf clause (default 3)\n");
+    printf("  --seed S          generator seed (default 1)\n");
+    printf("  --warmup N        untimed runs per task (default 2)\n");
+    printf("  --reps N          timed runs per task (default 15)\n");
+    printf("  --budget S        stop repeating a task after S seconds (default 2)\n");
+    printf("  --max-table-vars N   skip truth tables above N variables (default 16)\n");
+    printf("  --max-cnf-nodes N    skip cnf/validity above N tree nodes (default 5000)\n");
+    printf("  --threads N       run cnf/validity fork-join on N workers (0: all cores; default 1)\n");
+    printf("  --csv             machine-readable output\n");
+}
+
+#define MAX_SIZES 64
+
+/**
+ * @brief Entry point of the microbenchmark.
+ * @return 0 on success, 1 on invalid arguments.
+ */
+int main(int argc, char *argv[]) {
+    MicroOptions o = { 2, 15, 2.0, 16, 5000, (1 << MB_NUM_TASKS) - 1, 0, 0 };
+    int sizes[MAX_SIZES] = { 16, 64, 256, 1024 }, numSizes = 4;
+    int shapes = (1 << GEN_NUM_SHAPES) - 1, vars = 0, k = 3;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i], *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--csv") == 0) { o.csv = 1; continue; }
+        if (!v || a[0] != '-') {
+            printMicroUsage(argv[0]);
+            return strcmp(a, "--help") == 0 ? 0 : 1;
+        }
+        i++;
+        if (strcmp(a, "--shapes") == 0 || strcmp(a, "--tasks") == 0) {
+            int isShapes = a[2] == 's', mask = 0;
+            char *copy = strdup_s(v), *save = NULL;
+            for (char *tok = copy ? strtok_r(copy, ",", &save) : NULL; tok; tok = strtok_r(NULL, ",", &save)) {
+                GenShape s;
+                int t, found = 0;
+                if (isShapes && genShapeFromName(tok, &s)) { mask |= 1 << s; found = 1; }
+                for (t = 0; !isShapes && t < MB_NUM_TASKS; t++) {
+                    if (strcmp(tok, taskNames[t]) == 0) { mask |= 1 << t; found = 1; }
+                }
+                if (!found) {
+                    printf("Error: Unknown %s '%s'.\n", isShapes ? "shape" : "task", tok);
+                    free(copy);
+                    return 1;
+                }
+            }
+            free(copy);
+            if (isShapes) shapes = mask;
+            else o.tasks = mask;
+        } else if (strcmp(a, "--sizes") == 0) {
+            if (!(numSizes = parseIntList(v, sizes, MAX_SIZES))) {
+                printf("Error: Bad size list '%s'.\n", v);
+                return 1;
+            }
+        } else if (strcmp(a, "--vars") == 0) vars = atoi(v);
+        else if (strcmp(a, "--k") == 0) k = atoi(v);
+        else if (strcmp(a, "--seed") == 0) seed = strtoull(v, NULL, 10);
+        else if (strcmp(a, "--warmup") == 0) o.warmup = atoi(v);
+        else if (strcmp(a, "--reps") == 0) o.reps = atoi(v);
+        else if (strcmp(a, "--budget") == 0) o.budget = atof(v);
+        else if (strcmp(a, "--max-table-vars") == 0) o.maxTableVars = atoi(v);
+        else if (strcmp(a, "--max-cnf-nodes") == 0) o.maxCnfNodes = atoi(v);
+        else if (strcmp(a, "--threads") == 0) {
+            o.parallel = atoi(v) != 1;
+            parTreeConfigure(atoi(v), 0);
+        }
+        else {
+            printMicroUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (o.reps < 1) o.reps = 1;
+
+    double *samples = malloc((size_t)o.reps * sizeof(double));
+    FILE *sink = fopen("/dev/null", "w");
+    if (!samples || !sink) {
+        perror("microbench");
+        free(samples);
+        if (sink) fclose(sink);
+        return 1;
+    }
+
+    if (o.csv) printf("shape,size,chars,nodes,height,vars,task,reps,min_s,median_s,mean_s,stddev_s,max_s\n");
+    else printf("%-9s %7s %-11s %5s %12s %12s %12s %10s %12s\n", "shape", "size", "task", "reps",
+                "min us", "median us", "mean us", "sd us", "max us");
+
+    for (int s = 0; s < GEN_NUM_SHAPES; s++) {
+        if (!(shapes & (1 << s))) continue;
+        for (int z = 0; z < numSizes; z++) {
+            GenParams gp = { (GenShape)s, sizes[z], vars, k, seed };
+            char *infix = generateFormulaString(&gp);
+            if (!infix) {
+                printf("Error: Cannot generate %s of size %d.\n", genShapeName(gp.shape), gp.size);
+                continue;
+            }
+            Fixture fx;
+            if (!buildFixture(&fx, infix, &o)) {
+                printf("Error: Generated %s formula of size %d did not parse.\n", genShapeName(gp.shape), gp.size);
+                freeFixture(&fx);
+                continue;
+            }
+            if (!o.csv) printf("# %s size %d: %zu chars, %ld nodes, height %d, %d variables\n",
+                               genShapeName(gp.shape), gp.size, strlen(infix), fx.nodes, fx.height, fx.numVars);
+            char *scratch = malloc(strlen(infix) + fx.prefixCap + 1);
+            if (!scratch) { perror("malloc"); freeFixture(&fx); break; }
+            for (int t = 0; t < MB_NUM_TASKS; t++) {
+                if (o.tasks & (1 << t)) benchTask((MicroTask)t, &fx, &gp, &o, scratch, sink, samples);
+            }
+            fflush(stdout);
+            free(scratch);
+            freeFixture(&fx);
+        }
+    }
+    fclose(sink);
+    free(samples);
+    return 0;
+}
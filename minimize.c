@@ -0,0 +1,765 @@
+/**
+ * @file minimize.c
+ * @brief Two-level minimization of truth tables into SOP / POS form.
+ *
+ * Cubes are two 64-bit masks (which variables appear, and with which
+ * sign), and the function is held as a truth-table bitmap, so "is this
+ * cube an implicant" is a scan over the bitmap words it touches: the six
+ * low variables select bits inside a word, the others select words.
+ * @section algo Algorithm:
+ *   - Start cover: split the table on one variable after the other;
+ *     cubes that appear in both cofactors are merged through a hash set,
+ *     the others get the split variable as a literal
+ *   - Heuristic (Espresso-style): expand each cube to a prime, dropping
+ *     first the literals whose opposite is most frequent in the cover and
+ *     skipping cubes already inside expanded ones; irredundant drops
+ *     cubes whose minterms are all covered twice; reduce shrinks each
+ *     cube to the supercube of the minterms only it covers; repeat while
+ *     the cost (cubes, then literals) goes down
+ *   - Exact: Quine-McCluskey primes, merging cubes that differ in one
+ *     variable through a hash set per level, then essential primes and a
+ *     branch-and-bound minimum cover
+ * @section time Time Complexity: heuristic O(passes × (cubes × n × probe
+ *   + Σ|cube|)), where a probe is 2^(free variables above 5) words;
+ *   exact worst case exponential (bounded by MAX_IMPLICANTS and
+ *   MAX_COVER_NODES)
+ * @section space Space Complexity: O(2^n) for the table and per-row
+ *   cover counts, plus the cubes
+ */
+
+#include "minimize.h"
+#include "compiledFormula.h"
+#include "simplify.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_IMPLICANTS (1L << 21)   /* exact mode: implicants of all QM levels */
+#define MAX_COVER_NODES 200000      /* exact mode: branch-and-bound nodes */
+#define MAX_PASSES 32
+
+static const uint64_t lowPattern[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+/**
+ * @brief The function being minimized.
+ */
+typedef struct {
+    int n;
+    uint64_t rows;
+    uint64_t words;
+    uint64_t full;         /**< Mask of the n variables */
+    uint64_t rowMask;      /**< Valid bits of a word (all unless rows < 64) */
+    uint64_t *on;          /**< ON-set; bits past the last row are clear */
+    unsigned *counts;      /**< Per row: cubes of the cover containing it */
+} Table;
+
+/* ----- covers ----- */
+
+static int coverAdd(CubeCover *c, BitCube cube) {
+    if (c->count == c->cap) {
+        int ncap = c->cap ? c->cap * 2 : 16;
+        BitCube *nc = realloc(c->cubes, (size_t)ncap * sizeof(BitCube));
+        if (!nc) { perror("realloc"); return 0; }
+        c->cubes = nc;
+        c->cap = ncap;
+    }
+    c->cubes[c->count++] = cube;
+    return 1;
+}
+
+/**
+ * @copydoc freeCubeCover
+ */
+void freeCubeCover(CubeCover *c) {
+    free(c->cubes);
+    c->cubes = NULL;
+    c->count = c->cap = 0;
+}
+
+static long coverLiterals(const CubeCover *c) {
+    long lits = 0;
+    for (int i = 0; i < c->count; i++) lits += __builtin_popcountll(c->cubes[i].mask);
+    return lits;
+}
+
+/**
+ * @brief Orders by cost: fewer cubes first, then fewer literals.
+ */
+static int cheaper(long cubesA, long litsA, long cubesB, long litsB) {
+    return cubesA != cubesB ? cubesA < cubesB : litsA < litsB;
+}
+
+/* ----- hash set of cubes ----- */
+
+typedef struct {
+    BitCube cube;
+    int idx;           /**< -1: empty slot */
+} CubeSlot;
+
+typedef struct {
+    CubeSlot *slots;
+    size_t mask;
+    size_t used;
+} CubeSet;
+
+static size_t cubeHash(BitCube c) {
+    uint64_t x = c.mask * 0x9e3779b97f4a7c15ULL ^ c.bits;
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 29;
+    return (size_t)x;
+}
+
+static int cubeSetInit(CubeSet *s, size_t expected) {
+    size_t cap = 16;
+    while (cap < 2 * expected) cap <<= 1;
+    s->slots = malloc(cap * sizeof(CubeSlot));
+    if (!s->slots) { perror("malloc"); return 0; }
+    for (size_t i = 0; i < cap; i++) s->slots[i].idx = -1;
+    s->mask = cap - 1;
+    s->used = 0;
+    return 1;
+}
+
+/**
+ * @return Index stored for the cube, or -1.
+ */
+static int cubeSetFind(const CubeSet *s, BitCube c) {
+    for (size_t i = cubeHash(c) & s->mask;; i = (i + 1) & s->mask) {
+        const CubeSlot *sl = &s->slots[i];
+        if (sl->idx < 0) return -1;
+        if (sl->cube.mask == c.mask && sl->cube.bits == c.bits) return sl->idx;
+    }
+}
+
+/**
+ * @brief Inserts a cube that is not yet in the set, doubling when half full.
+ */
+static int cubeSetInsert(CubeSet *s, BitCube c, int idx) {
+    if (2 * (s->used + 1) > s->mask + 1) {
+        CubeSet bigger;
+        if (!cubeSetInit(&bigger, s->mask + 1)) return 0;
+        for (size_t i = 0; i <= s->mask; i++)
+            if (s->slots[i].idx >= 0) cubeSetInsert(&bigger, s->slots[i].cube, s->slots[i].idx);
+        free(s->slots);
+        *s = bigger;
+    }
+    size_t i = cubeHash(c) & s->mask;
+    while (s->slots[i].idx >= 0) i = (i + 1) & s->mask;
+    s->slots[i].cube = c;
+    s->slots[i].idx = idx;
+    s->used++;
+    return 1;
+}
+
+/* ----- cubes against the table ----- */
+
+/**
+ * @brief Bits of a word that lie in the cube (from its low variables).
+ */
+static uint64_t cubeLowMask(const Table *t, BitCube c) {
+    uint64_t m = t->rowMask;
+    for (int v = 0; v < 6 && v < t->n; v++)
+        if ((c.mask >> v) & 1) m &= ((c.bits >> v) & 1) ? lowPattern[v] : ~lowPattern[v];
+    return m;
+}
+
+/**
+ * @brief Free variables of the cube above the low six, as word-index bits.
+ */
+static uint64_t cubeHighFree(const Table *t, BitCube c) {
+    return (~c.mask & t->full) >> 6;
+}
+
+/**
+ * @brief Checks that no row of the cube is in the OFF-set.
+ */
+static int isImplicant(const Table *t, BitCube c) {
+    uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+    do {
+        if (~t->on[base | s] & low) return 0;
+        s = (s - span) & span;
+    } while (s);
+    return 1;
+}
+
+/**
+ * @brief Checks that every row of the cube is set in bitmap.
+ */
+static int cubeInside(const Table *t, BitCube c, const uint64_t *bitmap) {
+    uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+    do {
+        if (~bitmap[base | s] & low) return 0;
+        s = (s - span) & span;
+    } while (s);
+    return 1;
+}
+
+static void markCube(const Table *t, BitCube c, uint64_t *bitmap) {
+    uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+    do {
+        bitmap[base | s] |= low;
+        s = (s - span) & span;
+    } while (s);
+}
+
+/**
+ * @brief Adds delta to the cover count of every row of the cube.
+ */
+static void countCube(Table *t, BitCube c, int delta) {
+    uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+    do {
+        unsigned *row = t->counts + ((base | s) << 6);
+        for (uint64_t b = low; b; b &= b - 1) row[__builtin_ctzll(b)] += (unsigned)delta;
+        s = (s - span) & span;
+    } while (s);
+}
+
+/**
+ * @brief Checks whether every row of the cube is covered at least twice.
+ */
+static int coveredElsewhere(const Table *t, BitCube c) {
+    uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+    do {
+        const unsigned *row = t->counts + ((base | s) << 6);
+        for (uint64_t b = low; b; b &= b - 1)
+            if (row[__builtin_ctzll(b)] < 2) return 0;
+        s = (s - span) & span;
+    } while (s);
+    return 1;
+}
+
+static void recount(Table *t, const CubeCover *f) {
+    memset(t->counts, 0, (size_t)t->words * 64 * sizeof(unsigned));
+    for (int i = 0; i < f->count; i++) countCube(t, f->cubes[i], 1);
+}
+
+/* ----- start cover from cofactors ----- */
+
+/**
+ * @brief Value of the rows [base, base + 2^k).
+ * @return 1 all true, 0 all false, -1 mixed.
+ */
+static int regionState(const Table *t, int k, uint64_t base) {
+    if (k < 6) {
+        uint64_t m = ((1ULL << (1 << k)) - 1) << (base & 63);
+        uint64_t x = t->on[base >> 6] & m;
+        return x == m ? 1 : x == 0 ? 0 : -1;
+    }
+    int any1 = 0, any0 = 0;
+    for (uint64_t w = base >> 6, end = w + (1ULL << (k - 6)); w < end; w++) {
+        any1 |= t->on[w] != 0;
+        any0 |= t->on[w] != ~0ULL;
+        if (any0 && any1) return -1;
+    }
+    return any1;
+}
+
+/**
+ * @brief Cover of the rows [base, base + 2^k) over variables 0..k-1.
+ */
+static int cofactorCover(const Table *t, int k, uint64_t base, CubeCover *out) {
+    int state = regionState(t, k, base);
+    if (state >= 0) return state == 0 || coverAdd(out, (BitCube){ 0, 0 });
+
+    uint64_t bit = 1ULL << (k - 1);
+    CubeCover c0 = { 0 }, c1 = { 0 };
+    CubeSet set = { 0 };
+    int ok = cofactorCover(t, k - 1, base, &c0) && cofactorCover(t, k - 1, base + bit, &c1)
+             && cubeSetInit(&set, (size_t)c0.count);
+    char *merged = ok ? calloc((size_t)c0.count + 1, 1) : NULL;
+    ok = ok && merged;
+    for (int i = 0; ok && i < c0.count; i++) ok = cubeSetInsert(&set, c0.cubes[i], i);
+    for (int i = 0; ok && i < c1.count; i++) {
+        BitCube c = c1.cubes[i];
+        int j = cubeSetFind(&set, c);
+        if (j >= 0 && !merged[j]) {
+            merged[j] = 1;
+            ok = coverAdd(out, c);
+        } else {
+            ok = coverAdd(out, (BitCube){ c.mask | bit, c.bits | bit });
+        }
+    }
+    for (int i = 0; ok && i < c0.count; i++)
+        if (!merged[i]) ok = coverAdd(out, (BitCube){ c0.cubes[i].mask | bit, c0.cubes[i].bits });
+    free(merged);
+    free(set.slots);
+    freeCubeCover(&c0);
+    freeCubeCover(&c1);
+    return ok;
+}
+
+/* ----- heuristic ----- */
+
+static int bySizeDesc(const void *a, const void *b) {
+    int pa = __builtin_popcountll(((const BitCube*)a)->mask), pb = __builtin_popcountll(((const BitCube*)b)->mask);
+    return pa - pb;
+}
+
+static int bySizeAsc(const void *a, const void *b) {
+    return bySizeDesc(b, a);
+}
+
+/**
+ * @brief Replaces every cube by a prime containing it; cubes inside an
+ *        already expanded cube are dropped.
+ */
+static int expandCover(const Table *t, CubeCover *f) {
+    long freq[2][64] = { { 0 } };
+    for (int i = 0; i < f->count; i++)
+        for (uint64_t m = f->cubes[i].mask; m; m &= m - 1) {
+            int v = __builtin_ctzll(m);
+            freq[(f->cubes[i].bits >> v) & 1][v]++;
+        }
+    qsort(f->cubes, (size_t)f->count, sizeof(BitCube), bySizeDesc);
+    uint64_t *done = calloc((size_t)t->words, sizeof(uint64_t));
+    if (!done) { perror("calloc"); return 0; }
+
+    int kept = 0;
+    for (int i = 0; i < f->count; i++) {
+        BitCube c = f->cubes[i];
+        if (cubeInside(t, c, done)) continue;
+        // Raise first the literals whose opposite is common: the expanded
+        // cube then swallows more of the others
+        int order[64], n = 0;
+        for (uint64_t m = c.mask; m; m &= m - 1) {
+            int v = __builtin_ctzll(m), k = n++;
+            long w = freq[!((c.bits >> v) & 1)][v];
+            while (k > 0 && freq[!((c.bits >> order[k - 1]) & 1)][order[k - 1]] < w) {
+                order[k] = order[k - 1];
+                k--;
+            }
+            order[k] = v;
+        }
+        for (int k = 0; k < n; k++) {
+            uint64_t bit = 1ULL << order[k];
+            BitCube raised = { c.mask & ~bit, c.bits & ~bit };
+            if (isImplicant(t, raised)) c = raised;
+        }
+        markCube(t, c, done);
+        f->cubes[kept++] = c;
+    }
+    f->count = kept;
+    free(done);
+    return 1;
+}
+
+/**
+ * @brief Drops cubes whose rows are all covered by others, smallest
+ *        first. Leaves t->counts matching the cover.
+ */
+static void irredundantCover(Table *t, CubeCover *f) {
+    qsort(f->cubes, (size_t)f->count, sizeof(BitCube), bySizeAsc);
+    recount(t, f);
+    int kept = 0;
+    for (int i = 0; i < f->count; i++) {
+        if (coveredElsewhere(t, f->cubes[i])) countCube(t, f->cubes[i], -1);
+        else f->cubes[kept++] = f->cubes[i];
+    }
+    f->count = kept;
+}
+
+/**
+ * @brief Shrinks each cube, largest first, to the smallest cube holding
+ *        the rows no other cube covers (t->counts must match the cover).
+ */
+static void reduceCover(Table *t, CubeCover *f) {
+    qsort(f->cubes, (size_t)f->count, sizeof(BitCube), bySizeDesc);
+    int kept = 0;
+    for (int i = 0; i < f->count; i++) {
+        BitCube c = f->cubes[i];
+        uint64_t low = cubeLowMask(t, c), span = cubeHighFree(t, c), base = c.bits >> 6, s = 0;
+        uint64_t all1 = ~0ULL, all0 = ~0ULL;
+        int any = 0;
+        do {
+            const unsigned *row = t->counts + ((base | s) << 6);
+            for (uint64_t b = low; b; b &= b - 1) {
+                int bit = __builtin_ctzll(b);
+                if (row[bit] != 1) continue;
+                uint64_t r = ((base | s) << 6) | (uint64_t)bit;
+                all1 &= r;
+                all0 &= ~r;
+                any = 1;
+            }
+            s = (s - span) & span;
+        } while (s);
+        countCube(t, c, -1);
+        if (!any) continue;
+        uint64_t mask = (all1 | all0) & t->full;
+        c.mask = mask;
+        c.bits = all1 & mask;
+        countCube(t, c, 1);
+        f->cubes[kept++] = c;
+    }
+    f->count = kept;
+}
+
+static int copyCover(CubeCover *dst, const CubeCover *src) {
+    dst->count = 0;
+    for (int i = 0; i < src->count; i++)
+        if (!coverAdd(dst, src->cubes[i])) return 0;
+    return 1;
+}
+
+/**
+ * @brief Espresso-style loop from a start cover, keeping the cheapest
+ *        irredundant prime cover seen.
+ */
+static int heuristicCover(Table *t, CubeCover *f, CubeCover *best, int *passes) {
+    if (!expandCover(t, f)) return 0;
+    irredundantCover(t, f);
+    if (!copyCover(best, f)) return 0;
+    for (*passes = 1; *passes < MAX_PASSES; (*passes)++) {
+        reduceCover(t, f);
+        if (!expandCover(t, f)) return 0;
+        irredundantCover(t, f);
+        if (!cheaper(f->count, coverLiterals(f), best->count, coverLiterals(best))) break;
+        if (!copyCover(best, f)) return 0;
+    }
+    return 1;
+}
+
+/* ----- exact ----- */
+
+/**
+ * @brief Quine-McCluskey: merges the cubes of each level that differ in
+ *        one variable (the partner is found by hashing) until nothing
+ *        merges; unmerged cubes are the primes.
+ * @return 1 on success, 0 past MAX_IMPLICANTS or on malloc failure.
+ */
+static int generatePrimes(const Table *t, CubeCover *primes) {
+    CubeCover cur = { 0 }, next = { 0 };
+    CubeSet set = { 0 }, nextSet = { 0 };
+    int ok = cubeSetInit(&set, (size_t)t->rows / 2);
+    for (uint64_t r = 0; ok && r < t->rows; r++)
+        if ((t->on[r >> 6] >> (r & 63)) & 1) {
+            BitCube m = { t->full, r };
+            ok = cubeSetInsert(&set, m, cur.count) && coverAdd(&cur, m);
+        }
+    long total = cur.count;
+    if (total > MAX_IMPLICANTS) ok = 0;
+    while (ok && cur.count > 0) {
+        char *merged = calloc((size_t)cur.count, 1);
+        ok = merged && cubeSetInit(&nextSet, (size_t)cur.count);
+        for (int i = 0; ok && i < cur.count; i++) {
+            BitCube c = cur.cubes[i];
+            for (uint64_t m = c.mask & ~c.bits; ok && m; m &= m - 1) {
+                uint64_t bit = m & -m;
+                int j = cubeSetFind(&set, (BitCube){ c.mask, c.bits | bit });
+                if (j < 0) continue;
+                merged[i] = merged[j] = 1;
+                BitCube u = { c.mask & ~bit, c.bits };
+                if (cubeSetFind(&nextSet, u) >= 0) continue;
+                ok = ++total <= MAX_IMPLICANTS && cubeSetInsert(&nextSet, u, next.count) && coverAdd(&next, u);
+            }
+        }
+        for (int i = 0; ok && i < cur.count; i++)
+            if (!merged[i]) ok = coverAdd(primes, cur.cubes[i]);
+        free(merged);
+        free(set.slots);
+        set = nextSet;
+        nextSet.slots = NULL;
+        CubeCover swap = cur;
+        cur = next;
+        next = swap;
+        next.count = 0;
+    }
+    free(set.slots);
+    free(nextSet.slots);
+    freeCubeCover(&cur);
+    freeCubeCover(&next);
+    return ok;
+}
+
+/**
+ * @brief Minimum-cover search state: rows are the ON minterms, columns
+ *        the primes, in compressed lists both ways.
+ */
+typedef struct {
+    int numRows, numPrimes;
+    const BitCube *primes;
+    int *rowStart, *rowPrimes;     /**< Primes covering each row */
+    int *primeStart, *primeRows;   /**< Rows covered by each prime */
+    int *covered;                  /**< Per row: chosen primes covering it */
+    int *chosen, numChosen;
+    long chosenLits;
+    int *best, bestCount;
+    long bestLits;
+    long nodes;
+} CoverSearch;
+
+static void choosePrime(CoverSearch *cs, int p, int delta) {
+    for (int k = cs->primeStart[p]; k < cs->primeStart[p + 1]; k++) cs->covered[cs->primeRows[k]] += delta;
+    if (delta > 0) cs->chosen[cs->numChosen++] = p;
+    else cs->numChosen--;
+    cs->chosenLits += delta * __builtin_popcountll(cs->primes[p].mask);
+}
+
+/**
+ * @brief Branches on the uncovered row with the fewest primes.
+ */
+static void searchCover(CoverSearch *cs) {
+    if (++cs->nodes > MAX_COVER_NODES) return;
+    int row = -1, fewest = 0x7fffffff;
+    for (int r = 0; r < cs->numRows; r++) {
+        int options = cs->rowStart[r + 1] - cs->rowStart[r];
+        if (!cs->covered[r] && options < fewest) {
+            row = r;
+            fewest = options;
+        }
+    }
+    if (row < 0) {
+        if (cheaper(cs->numChosen, cs->chosenLits, cs->bestCount, cs->bestLits)) {
+            memcpy(cs->best, cs->chosen, (size_t)cs->numChosen * sizeof(int));
+            cs->bestCount = cs->numChosen;
+            cs->bestLits = cs->chosenLits;
+        }
+        return;
+    }
+    // Any completion adds at least one cube
+    if (cs->numChosen + 1 > cs->bestCount) return;
+    for (int k = cs->rowStart[row]; k < cs->rowStart[row + 1]; k++) {
+        int p = cs->rowPrimes[k];
+        if (cs->numChosen + 1 == cs->bestCount
+            && cs->chosenLits + __builtin_popcountll(cs->primes[p].mask) >= cs->bestLits) continue;
+        choosePrime(cs, p, 1);
+        searchCover(cs);
+        choosePrime(cs, p, -1);
+    }
+}
+
+/**
+ * @brief Picks a minimum subset of the primes covering every ON row.
+ * @return 1 if proven minimum, 0 if the node budget ran out (the cover
+ *         is then the best found) or the problem is too large to set up
+ *         (no cover), -1 on malloc failure.
+ */
+static int exactCover(const Table *t, const CubeCover *primes, CubeCover *out) {
+    CoverSearch cs;
+    memset(&cs, 0, sizeof cs);
+    cs.primes = primes->cubes;
+    cs.numPrimes = primes->count;
+    int *rowOf = malloc((size_t)t->rows * sizeof(int));
+    if (!rowOf) { perror("malloc"); return -1; }
+    for (uint64_t r = 0; r < t->rows; r++)
+        rowOf[r] = (t->on[r >> 6] >> (r & 63)) & 1 ? cs.numRows++ : -1;
+
+    // Rows of each prime by subset enumeration of its free variables
+    long entries = 0;
+    for (int p = 0; p < cs.numPrimes; p++) entries += 1L << (t->n - __builtin_popcountll(cs.primes[p].mask));
+    if (entries > 8 * MAX_IMPLICANTS) {
+        free(rowOf);
+        return 0;
+    }
+    cs.primeStart = malloc(((size_t)cs.numPrimes + 1) * sizeof(int));
+    cs.primeRows = malloc((size_t)entries * sizeof(int));
+    cs.rowStart = calloc((size_t)cs.numRows + 2, sizeof(int));
+    cs.rowPrimes = malloc((size_t)entries * sizeof(int));
+    cs.covered = calloc((size_t)cs.numRows + 1, sizeof(int));
+    cs.chosen = malloc(((size_t)cs.numPrimes + 1) * sizeof(int));
+    cs.best = malloc(((size_t)cs.numPrimes + 1) * sizeof(int));
+    int status = -1;
+    if (!cs.primeStart || !cs.primeRows || !cs.rowStart || !cs.rowPrimes || !cs.covered || !cs.chosen || !cs.best) {
+        perror("malloc");
+        goto done;
+    }
+    long k = 0;
+    for (int p = 0; p < cs.numPrimes; p++) {
+        cs.primeStart[p] = (int)k;
+        uint64_t span = ~cs.primes[p].mask & t->full, s = 0;
+        do {
+            int r = rowOf[cs.primes[p].bits | s];
+            cs.primeRows[k++] = r;
+            cs.rowStart[r + 2]++;
+            s = (s - span) & span;
+        } while (s);
+    }
+    cs.primeStart[cs.numPrimes] = (int)k;
+    for (int r = 0; r < cs.numRows; r++) cs.rowStart[r + 2] += cs.rowStart[r + 1];
+    for (int p = 0; p < cs.numPrimes; p++)
+        for (int j = cs.primeStart[p]; j < cs.primeStart[p + 1]; j++)
+            cs.rowPrimes[cs.rowStart[cs.primeRows[j] + 1]++] = p;
+
+    // Essential primes, then a greedy cover as the first bound
+    for (int r = 0; r < cs.numRows; r++)
+        if (cs.rowStart[r + 1] - cs.rowStart[r] == 1 && !cs.covered[r]) choosePrime(&cs, cs.rowPrimes[cs.rowStart[r]], 1);
+    int essentials = cs.numChosen;
+    for (;;) {
+        int bestP = -1;
+        long gain = 0;
+        for (int p = 0; p < cs.numPrimes; p++) {
+            long g = 0;
+            for (int j = cs.primeStart[p]; j < cs.primeStart[p + 1]; j++) g += !cs.covered[cs.primeRows[j]];
+            if (g > gain) {
+                gain = g;
+                bestP = p;
+            }
+        }
+        if (bestP < 0) break;
+        choosePrime(&cs, bestP, 1);
+    }
+    memcpy(cs.best, cs.chosen, (size_t)cs.numChosen * sizeof(int));
+    cs.bestCount = cs.numChosen;
+    cs.bestLits = cs.chosenLits;
+    while (cs.numChosen > essentials) choosePrime(&cs, cs.chosen[cs.numChosen - 1], -1);
+
+    searchCover(&cs);
+    status = cs.nodes <= MAX_COVER_NODES;
+    out->count = 0;
+    for (int i = 0; i < cs.bestCount; i++)
+        if (!coverAdd(out, cs.primes[cs.best[i]])) status = -1;
+done:
+    free(rowOf);
+    free(cs.primeStart);
+    free(cs.primeRows);
+    free(cs.rowStart);
+    free(cs.rowPrimes);
+    free(cs.covered);
+    free(cs.chosen);
+    free(cs.best);
+    return status;
+}
+
+/* ----- entry points ----- */
+
+/**
+ * @copydoc minimizeTable
+ */
+int minimizeTable(const uint64_t *table, int numVars, MinimizeMode mode, int pos, CubeCover *out,
+                  MinimizeStats *st) {
+    if (numVars < 0 || numVars > MINIMIZE_MAX_VARS) {
+        printf("Error: Minimization is limited to %d variables (got %d).\n", MINIMIZE_MAX_VARS, numVars);
+        return 0;
+    }
+    Table t;
+    t.n = numVars;
+    t.rows = 1ULL << numVars;
+    t.words = (t.rows + 63) / 64;
+    t.full = (1ULL << numVars) - 1;
+    t.rowMask = t.rows >= 64 ? ~0ULL : (1ULL << t.rows) - 1;
+    t.on = malloc((size_t)t.words * sizeof(uint64_t));
+    t.counts = malloc((size_t)t.words * 64 * sizeof(unsigned));
+    if (!t.on || !t.counts) {
+        perror("malloc");
+        free(t.on);
+        free(t.counts);
+        return 0;
+    }
+    long long minterms = 0;
+    for (uint64_t w = 0; w < t.words; w++) {
+        t.on[w] = (pos ? ~table[w] : table[w]) & t.rowMask;
+        minterms += __builtin_popcountll(t.on[w]);
+    }
+
+    MinimizeStats s;
+    memset(&s, 0, sizeof s);
+    s.numVars = numVars;
+    s.minterms = minterms;
+    s.primes = -1;
+    CubeCover f = { 0 };
+    out->count = 0;
+    int ok = cofactorCover(&t, numVars, 0, &f);
+    s.initialCubes = f.count;
+
+    int exact = mode == MIN_EXACT || (mode == MIN_AUTO && numVars <= MINIMIZE_AUTO_EXACT_VARS);
+    if (ok && exact && minterms > 0) {
+        CubeCover primes = { 0 };
+        if (generatePrimes(&t, &primes)) {
+            s.primes = primes.count;
+            int r = exactCover(&t, &primes, out);
+            ok = r >= 0;
+            s.exact = r == 1;
+        }
+        freeCubeCover(&primes);
+    }
+    if (ok && !s.exact && minterms > 0) {
+        // The heuristic result replaces an exact search that gave up, if cheaper
+        CubeCover h = { 0 };
+        ok = heuristicCover(&t, &f, &h, &s.passes);
+        if (ok && (out->count == 0 || cheaper(h.count, coverLiterals(&h), out->count, coverLiterals(out)))) {
+            freeCubeCover(out);
+            *out = h;
+        } else {
+            freeCubeCover(&h);
+        }
+    }
+    if (minterms == 0) s.exact = 1;
+    s.cubes = out->count;
+    s.literals = coverLiterals(out);
+    freeCubeCover(&f);
+    free(t.on);
+    free(t.counts);
+    if (!ok) freeCubeCover(out);
+    if (st) *st = s;
+    return ok;
+}
+
+/**
+ * @copydoc minimizeFormula
+ */
+int minimizeFormula(const Node *root, VarMap *vm, MinimizeMode mode, int pos, CubeCover *out,
+                    MinimizeStats *st) {
+    if (!root || !root->tok) return 0;
+    int constant = constantValue(root->tok);
+    if (constant < 0 && !varMapCollect(vm, root)) return 0;
+    int n = vm->count;
+    if (n > MINIMIZE_MAX_VARS) {
+        printf("Error: Minimization is limited to %d variables (got %d).\n", MINIMIZE_MAX_VARS, n);
+        return 0;
+    }
+    uint64_t rows = 1ULL << n, words = (rows + 63) / 64;
+    int width = words >= 64 ? 64 : 1;
+    CompiledFormula *cf = constant < 0 ? compileFormula(root, vm) : NULL;
+    uint64_t *table = malloc((size_t)words * sizeof(uint64_t));
+    uint64_t *in = malloc((size_t)(n ? n : 1) * width * sizeof(uint64_t));
+    uint64_t *slots = cf ? malloc((size_t)cf->numInstrs * width * sizeof(uint64_t)) : NULL;
+    int ok = 0;
+    if ((constant < 0 && !cf) || !table || !in || (cf && !slots)) {
+        if (constant >= 0 || cf) perror("malloc");
+    } else {
+        for (uint64_t w0 = 0; w0 < words; w0 += width) {
+            if (!cf) {
+                for (int w = 0; w < width; w++) table[w0 + w] = constant ? ~0ULL : 0;
+                continue;
+            }
+            setTableRowInputs(in, n, width, w0 * 64);
+            memcpy(table + w0, evalCompiledBlock(cf, in, width, slots), (size_t)width * sizeof(uint64_t));
+        }
+        ok = minimizeTable(table, n, mode, pos, out, st);
+    }
+    free(table);
+    free(in);
+    free(slots);
+    freeCompiledFormula(cf);
+    return ok;
+}
+
+/**
+ * @copydoc printCubeCover
+ */
+void printCubeCover(FILE *out, const CubeCover *c, char *const names[], int pos) {
+    const char *inner = pos ? " + " : " * ", *outer = pos ? " * " : " + ";
+    if (c->count == 0) {
+        fputs(pos ? "1" : "0", out);
+        return;
+    }
+    for (int i = 0; i < c->count; i++) {
+        BitCube q = c->cubes[i];
+        int lits = __builtin_popcountll(q.mask);
+        if (i > 0) fputs(outer, out);
+        if (lits == 0) {
+            fputs(pos ? "0" : "1", out);
+            continue;
+        }
+        if (lits > 1 && c->count > 1) fputc('(', out);
+        for (uint64_t m = q.mask, k = 0; m; m &= m - 1, k++) {
+            int v = __builtin_ctzll(m);
+            // A POS clause is the cube negated
+            int positive = (int)((q.bits >> v) & 1) != pos;
+            fprintf(out, "%s%s%s", k ? inner : "", positive ? "" : "~", names[v]);
+        }
+        if (lits > 1 && c->count > 1) fputc(')', out);
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file minimize.h
+ * @brief Header for two-level (SOP / POS) minimization.
+ */
+
+#ifndef MINIMIZE_H
+#define MINIMIZE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "common.h"
+#include "varMap.h"
+
+/** Largest number of variables minimized (the truth table is built). */
+#define MINIMIZE_MAX_VARS 24
+
+/** MIN_AUTO picks the exact cover up to this many variables. */
+#define MINIMIZE_AUTO_EXACT_VARS 10
+
+/**
+ * @brief A product term: variable v appears iff bit v of mask is set,
+ *        positively iff bit v of bits is also set (bits ⊆ mask).
+ */
+typedef struct {
+    uint64_t mask;
+    uint64_t bits;
+} BitCube;
+
+/**
+ * @brief A growable list of cubes (a sum of products).
+ */
+typedef struct {
+    BitCube *cubes;
+    int count;
+    int cap;
+} CubeCover;
+
+/**
+ * @brief How the cover is chosen.
+ */
+typedef enum {
+    MIN_AUTO,        /**< Exact for small tables, heuristic otherwise */
+    MIN_HEURISTIC,   /**< Expand / irredundant / reduce until no gain */
+    MIN_EXACT        /**< All primes, then a minimum cover by branch and
+                          bound (falls back to the heuristic when the
+                          primes or the search get too large) */
+} MinimizeMode;
+
+/**
+ * @brief Sizes of one minimization.
+ */
+typedef struct {
+    int numVars;
+    long long minterms;    /**< Rows of the function minimized (the OFF-set for POS) */
+    long initialCubes;     /**< Cubes of the cofactor cover the search starts from */
+    long primes;           /**< Prime implicants generated, -1 if not generated */
+    long cubes;            /**< Cubes of the result */
+    long literals;         /**< Literals of the result */
+    int passes;            /**< Reduce / expand / irredundant rounds */
+    int exact;             /**< The result is a proven minimum (cubes, then literals) */
+} MinimizeStats;
+
+/**
+ * @brief Minimizes a function given as a truth table.
+ * @param table Bit r of word r/64 is the value of row r; bit v of r is
+ *        the value of variable v (the layout of setTableRowInputs).
+ * @param numVars Variables (at most MINIMIZE_MAX_VARS).
+ * @param mode Cover selection.
+ * @param pos Nonzero: minimize the complement, so that the result, read
+ *        as clauses (printCubeCover with pos set), is a product of sums.
+ * @param out Output: the cover (release with freeCubeCover).
+ * @param st Sizes (may be NULL).
+ * @return 1 on success, 0 on error (reported on stdout).
+ */
+int minimizeTable(const uint64_t *table, int numVars, MinimizeMode mode, int pos, CubeCover *out,
+                  MinimizeStats *st);
+
+/**
+ * @brief Minimizes a formula; its leaves are interned into vm, whose
+ *        indices number the variables of the cubes (name of variable v
+ *        is vm->names[v]).
+ * @return 1 on success, 0 on error.
+ */
+int minimizeFormula(const Node *root, VarMap *vm, MinimizeMode mode, int pos, CubeCover *out,
+                    MinimizeStats *st);
+
+/**
+ * @brief Frees the cubes of a cover.
+ */
+void freeCubeCover(CubeCover *c);
+
+/**
+ * @brief Writes a cover as an infix formula the parser accepts: a sum
+ *        of products, or with pos a product of sums whose clauses are
+ *        the negated cubes. Constant results are written as "1" / "0".
+ */
+void printCubeCover(FILE *out, const CubeCover *c, char *const names[], int pos);
+
+#endif
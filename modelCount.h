@@ -0,0 +1,32 @@
+/**
+ * @file modelCount.h
+ * @brief Header for exact model counting of CNF formulas.
+ */
+
+#ifndef MODEL_COUNT_H
+#define MODEL_COUNT_H
+
+#include "unitProp.h"
+
+/**
+ * @brief Counts the models of the engine's formula under assumptions.
+ *
+ * The count is over all f->numVars variables. Counts are held in a
+ * double: exact up to 2^53, relative error below 1e-15 beyond that.
+ * The engine is restored to its state on entry before returning.
+ *
+ * @param up Propagation engine (already propagated at the root).
+ * @param assumptions DIMACS literals fixed for this count (may be NULL).
+ * @param n Number of assumptions.
+ * @return Number of satisfying assignments.
+ */
+double countModelsUnder(UnitProp *up, const int *assumptions, int n);
+
+/**
+ * @brief Counts the models of a formula.
+ * @param f Parsed CNF formula.
+ * @return Number of satisfying assignments, or -1 on malloc failure.
+ */
+double countModels(const CnfFormula *f);
+
+#endif
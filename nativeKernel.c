@@ -0,0 +1,295 @@
+/**
+ * @file nativeKernel.c
+ * @brief Compiles formulas to shared objects and loads them as
+ *        evaluation kernels.
+ *
+ * evalCompiledBlock interprets the instruction array: every instruction
+ * reads its operands from and writes its result to a slot in memory, so a
+ * block of width words moves numInstrs × width words through the cache
+ * twice. Emitting the same code as straight-line C with one local per
+ * slot lets the C compiler keep intermediate words in registers, fold
+ * negations into and-not/or-not and vectorize across words. The result
+ * is built once with the system compiler, cached on disk under a hash of
+ * the code, and loaded with dlopen.
+ * @section algo Algorithm:
+ *   - Key: FNV-1a hash of the instructions, variable count, kernel ABI
+ *     and compiler command
+ *   - Kernel: one loop over words whose body is the formula, t_i = op of
+ *     earlier t_j, out[w] = last t
+ *   - Cache: <dir>/k<key>.so, written under a per-process name and
+ *     renamed into place; the embedded key is checked after dlopen
+ * @section time Time Complexity: O(n) hashing and code generation, plus
+ *   one compiler run per new formula
+ * @section space Space Complexity: O(n) source text on disk
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "nativeKernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+/* Bump when the generated code or the kernel signature changes */
+#define NATIVE_ABI 1
+#define NATIVE_FLAGS "-O2 -march=native -fPIC -shared -w"
+#define MAX_COMMAND_ARGS 32
+
+static char *cacheDir = NULL;
+static NativeKernelStats stats;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t fnvMix(uint64_t h, const void *data, size_t n) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Cache key of a formula under a compiler command.
+ */
+static uint64_t kernelHash(const CompiledFormula *cf, const char *command) {
+    int header[3] = {NATIVE_ABI, cf->numVars, cf->numInstrs};
+    uint64_t h = fnvMix(14695981039346656037ULL, header, sizeof(header));
+    for (int i = 0; i < cf->numInstrs; i++) {
+        int in[3] = {cf->code[i].op, cf->code[i].a, cf->code[i].b};
+        h = fnvMix(h, in, sizeof(in));
+    }
+    return fnvMix(h, command, strlen(command));
+}
+
+/**
+ * @brief Writes the kernel source: the key the loader checks, then the
+ *        formula as one loop body over words.
+ */
+static int writeKernelSource(const char *path, const CompiledFormula *cf, const char *key) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) { perror(path); return 0; }
+    fprintf(fp, "/* Formula kernel generated by logic; do not edit */\n"
+                "#include <stdint.h>\n"
+                "const char logicKernelKey[] = \"%s\";\n"
+                "void logicKernel(const uint64_t *restrict x, long width, uint64_t *restrict out)\n"
+                "{\n"
+                "    for (long w = 0; w < width; w++) {\n"
+                "        const uint64_t *v = x + w;\n", key);
+    for (int i = 0; i < cf->numInstrs; i++) {
+        const FormulaInstr *in = &cf->code[i];
+        fprintf(fp, "        const uint64_t t%d = ", i);
+        switch (in->op) {
+        case FOP_VAR:     fprintf(fp, "v[%d * width];\n", in->a); break;
+        case FOP_NOT:     fprintf(fp, "~t%d;\n", in->a); break;
+        case FOP_AND:     fprintf(fp, "t%d & t%d;\n", in->a, in->b); break;
+        case FOP_OR:      fprintf(fp, "t%d | t%d;\n", in->a, in->b); break;
+        case FOP_IMPLIES: fprintf(fp, "~t%d | t%d;\n", in->a, in->b); break;
+        }
+    }
+    fprintf(fp, "        out[w] = t%d;\n    }\n}\n", cf->numInstrs - 1);
+    int ok = !ferror(fp);
+    ok = fclose(fp) == 0 && ok;
+    if (!ok) perror(path);
+    return ok;
+}
+
+/**
+ * @brief Runs the compiler command on src, output to so, messages to log.
+ * @return 1 if the compiler exited with status 0, 0 if it failed (log
+ *         kept), -1 if it could not be started (including a command of
+ *         more than MAX_COMMAND_ARGS words, which is never truncated).
+ */
+static int runCompiler(const char *command, const char *src, const char *so, const char *log) {
+    char *words = strdup_s(command);
+    if (!words) return 0;
+    char *argv[MAX_COMMAND_ARGS + 4];
+    char *save = NULL;
+    int argc = 0;
+    for (char *tok = strtok_r(words, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (argc == MAX_COMMAND_ARGS) {
+            fprintf(stderr, "Native kernel: compiler command '%s' has more than %d words\n",
+                    command, MAX_COMMAND_ARGS);
+            free(words);
+            return -1;
+        }
+        argv[argc++] = tok;
+    }
+    if (argc == 0) {
+        fprintf(stderr, "Native kernel: empty compiler command\n");
+        free(words);
+        return -1;
+    }
+    argv[argc++] = "-o";
+    argv[argc++] = (char*)so;
+    argv[argc++] = (char*)src;
+    argv[argc] = NULL;
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, 1, log, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&fa, 1, 2);
+    pid_t pid;
+    int err = posix_spawnp(&pid, argv[0], &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    int ok = 0;
+    if (err != 0) {
+        fprintf(stderr, "Native kernel: cannot run '%s': %s\n", argv[0], strerror(err));
+        unlink(log);
+        ok = -1;
+    } else {
+        int status;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!ok) fprintf(stderr, "Native kernel: '%s' failed, see %s\n", argv[0], log);
+    }
+    free(words);
+    return ok;
+}
+
+/**
+ * @brief Loads a kernel and attaches it if its embedded key matches.
+ * @param report Whether to explain a failure on stderr (a stale cache
+ *        entry is rebuilt silently).
+ */
+static int loadKernel(CompiledFormula *cf, const char *path, const char *key, int report) {
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        if (report) fprintf(stderr, "Native kernel: %s\n", dlerror());
+        return 0;
+    }
+    const char *embedded = dlsym(handle, "logicKernelKey");
+    void *fn = dlsym(handle, "logicKernel");
+    if (!embedded || !fn || strcmp(embedded, key) != 0) {
+        if (report) fprintf(stderr, "Native kernel: %s does not match the formula\n", path);
+        dlclose(handle);
+        return 0;
+    }
+    cf->native = (NativeKernelFn)fn;
+    cf->nativeHandle = handle;
+    return 1;
+}
+
+/**
+ * @brief Builds the kernel under per-process names and renames the shared
+ *        object into the cache, so concurrent builds never see a partial
+ *        file.
+ */
+static int buildKernel(const CompiledFormula *cf, const char *command, const char *stem,
+                       const char *key, const char *path) {
+    size_t len = strlen(stem) + 32;
+    char *src = malloc(len), *so = malloc(len), *log = malloc(len);
+    int ok = 0;
+    if (!src || !so || !log) {
+        perror("malloc");
+    } else {
+        snprintf(src, len, "%s.%ld.c", stem, (long)getpid());
+        snprintf(so, len, "%s.%ld.so", stem, (long)getpid());
+        snprintf(log, len, "%s.%ld.log", stem, (long)getpid());
+        int ran = writeKernelSource(src, cf, key) ? runCompiler(command, src, so, log) : -1;
+        ok = ran == 1;
+        if (ok && rename(so, path) != 0) { perror(path); ok = 0; }
+        if (ok || ran < 0) unlink(src);   /* kept with the log when the compiler failed */
+        if (ok) unlink(log);
+        else unlink(so);
+    }
+    free(src);
+    free(so);
+    free(log);
+    return ok;
+}
+
+/**
+ * @copydoc nativeKernelConfigure
+ */
+int nativeKernelConfigure(const char *dir) {
+    struct stat st;
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) { perror(dir); return 0; }
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        printf("Error: '%s' is not a directory.\n", dir);
+        return 0;
+    }
+    char *copy = strdup_s(dir);
+    if (!copy) return 0;
+    free(cacheDir);
+    cacheDir = copy;
+    return 1;
+}
+
+/**
+ * @copydoc nativeKernelAttach
+ */
+int nativeKernelAttach(CompiledFormula *cf, double words) {
+    if (!cacheDir || !cf || cf->numInstrs == 0) return 0;
+    if (cf->native) return 1;
+    if (cf->numInstrs > NATIVE_MAX_INSTRS) {
+        fprintf(stderr, "Native kernel: %d instructions is over the limit of %d; using the interpreter.\n",
+                cf->numInstrs, NATIVE_MAX_INSTRS);
+        stats.fallbacks++;
+        return 0;
+    }
+
+    const char *cc = getenv("CC");
+    char command[512];
+    if (snprintf(command, sizeof(command), "%s %s", cc && *cc ? cc : "cc", NATIVE_FLAGS) >= (int)sizeof(command)) {
+        fprintf(stderr, "Native kernel: $CC is too long; using the interpreter.\n");
+        stats.fallbacks++;
+        return 0;
+    }
+    uint64_t h = kernelHash(cf, command);
+    char key[64];
+    snprintf(key, sizeof(key), "%016llx %d %d", (unsigned long long)h, cf->numVars, cf->numInstrs);
+    size_t len = strlen(cacheDir) + 32;
+    char *stem = malloc(len), *path = malloc(len);
+    if (!stem || !path) {
+        perror("malloc");
+        free(stem);
+        free(path);
+        return 0;
+    }
+    snprintf(stem, len, "%s/k%016llx", cacheDir, (unsigned long long)h);
+    snprintf(path, len, "%s.so", stem);
+
+    int ok = 0;
+    if (access(path, F_OK) == 0 && loadKernel(cf, path, key, 0)) {
+        stats.cacheHits++;
+        fprintf(stderr, "Native kernel: %s (cached)\n", path);
+        ok = 1;
+    } else if ((double)cf->numInstrs * words >= NATIVE_MIN_WORK) {
+        double t0 = nowSeconds();
+        ok = buildKernel(cf, command, stem, key, path) && loadKernel(cf, path, key, 1);
+        double secs = nowSeconds() - t0;
+        stats.compileSeconds += secs;
+        if (ok) {
+            stats.compiled++;
+            fprintf(stderr, "Native kernel: %s (built in %.2f s)\n", path, secs);
+        } else {
+            stats.fallbacks++;
+            fprintf(stderr, "Native kernel: unavailable; using the interpreter.\n");
+        }
+    }
+    free(stem);
+    free(path);
+    return ok;
+}
+
+/**
+ * @copydoc nativeKernelGetStats
+ */
+NativeKernelStats nativeKernelGetStats(void) {
+    return stats;
+}
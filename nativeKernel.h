@@ -0,0 +1,64 @@
+/**
+ * @file nativeKernel.h
+ * @brief Header for compiling formulas to machine code with the system C
+ *        compiler.
+ */
+
+#ifndef NATIVE_KERNEL_H
+#define NATIVE_KERNEL_H
+
+#include "compiledFormula.h"
+
+/**
+ * @brief Largest formula (instructions) turned into native code; compile
+ *        time grows faster than linearly, about 15 s at this size.
+ */
+#define NATIVE_MAX_INSTRS 50000
+
+/**
+ * @brief Smallest expected work (instructions × words) worth a compiler
+ *        run, about 50 ms of interpretation; kernels already in the cache
+ *        are used regardless.
+ */
+#define NATIVE_MIN_WORK 1e8
+
+/**
+ * @brief Outcome counters of nativeKernelAttach.
+ */
+typedef struct {
+    int compiled;            /**< Kernels built by the compiler */
+    int cacheHits;           /**< Kernels loaded from the cache directory */
+    int fallbacks;           /**< Formulas left to the interpreter */
+    double compileSeconds;   /**< Time spent in the compiler */
+} NativeKernelStats;
+
+/**
+ * @brief Enables native kernels, kept in a cache directory (created if
+ *        missing). The compiler is $CC, or cc if unset.
+ * @param dir Cache directory.
+ * @return 1 on success, 0 if the directory cannot be created.
+ */
+int nativeKernelConfigure(const char *dir);
+
+/**
+ * @brief Gives a compiled formula a native kernel, which evalCompiledBlock
+ *        then runs instead of interpreting the code. The kernel is looked
+ *        up in the cache by a hash of the code and the compiler command,
+ *        and built when missing and the expected work pays for it.
+ *
+ * Does nothing unless nativeKernelConfigure was called. Any failure (no
+ * compiler, compile error, dlopen error) is reported on stderr and leaves
+ * the interpreter in place.
+ *
+ * @param cf Compiled formula (updated).
+ * @param words Expected number of 64-row words to evaluate.
+ * @return 1 if a native kernel is attached, 0 otherwise.
+ */
+int nativeKernelAttach(CompiledFormula *cf, double words);
+
+/**
+ * @brief Counters since the program started.
+ */
+NativeKernelStats nativeKernelGetStats(void);
+
+#endif
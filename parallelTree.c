@@ -0,0 +1,400 @@
+/**
+ * @file parallelTree.c
+ * @brief Fork-join copying, CNF conversion, evaluation and clause counting.
+ *
+ * Every pass here recurses into two independent subtrees, so when both
+ * are large the right one is spawned on the work-stealing pool while the
+ * current worker continues with the left one, and joins (running other
+ * tasks meanwhile) before the node-local step that needs both results.
+ * The steps themselves are the ones of task6.c, so the output is the same
+ * tree the sequential passes build.
+ * @section algo Algorithm: Fork-join over subtrees
+ *   - Fork test, only in the top log2(P) + 5 levels: both children are
+ *     counted in lockstep until either ends or both reach the cutoff,
+ *     costing O(min(|left|, |right|, cutoff)); deeper levels run the
+ *     sequential passes, so the tests cost O(2^depth × cutoff) in all
+ *   - Clause counting gathers the clauses under the root's run of '*'
+ *     (parser chains are one-sided) and splits them by count instead
+ *   - One shared pool, created on first use with one worker per core
+ * @section time Time Complexity: O(W/P + D) expected for work W, span D
+ * @section space Space Complexity: O(P × depth) task frames, O(cutoff) per test
+ */
+
+#include "parallelTree.h"
+#include "workSteal.h"
+#include "task5.h"
+#include "task6.h"
+#include "simplify.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Fork levels beyond log2(workers): up to 2^this tasks per worker. */
+#define PAR_EXTRA_DEPTH 5
+
+static int configuredWorkers = 0;
+static int maxForkDepth = 0;
+static long forkCutoff = PAR_TREE_CUTOFF;
+static WsPool *treePool = NULL;
+static pthread_once_t poolOnce = PTHREAD_ONCE_INIT;
+
+static void createTreePool(void) {
+    int workers = configuredWorkers > 0 ? configuredWorkers : wsNumCores();
+    if (workers > 1) treePool = wsPoolCreate(workers);
+    maxForkDepth = PAR_EXTRA_DEPTH;
+    while (workers > 1) {
+        maxForkDepth++;
+        workers = (workers + 1) / 2;
+    }
+}
+
+/**
+ * @brief The shared pool, or NULL when everything runs sequentially.
+ */
+static WsPool *sharedPool(void) {
+    pthread_once(&poolOnce, createTreePool);
+    return treePool;
+}
+
+/**
+ * @copydoc parTreeConfigure
+ */
+void parTreeConfigure(int workers, long cutoff) {
+    configuredWorkers = workers;
+    forkCutoff = cutoff > 0 ? cutoff : PAR_TREE_CUTOFF;
+}
+
+/** Stack entries kept inline by a SizeProbe before it needs the heap. */
+#define PROBE_INLINE 64
+
+/**
+ * @brief Incremental preorder count of one subtree.
+ */
+typedef struct {
+    const Node **stack;
+    int top, cap;
+    long seen;
+    const Node *inlineStack[PROBE_INLINE];
+} SizeProbe;
+
+static void probeInit(SizeProbe *p, const Node *root) {
+    p->stack = p->inlineStack;
+    p->cap = PROBE_INLINE;
+    p->top = 0;
+    p->seen = 0;
+    if (root) p->stack[p->top++] = root;
+}
+
+/**
+ * @brief Visits one node. @return 0 once the subtree is exhausted.
+ */
+static int probeStep(SizeProbe *p) {
+    if (p->top == 0) return 0;
+    const Node *n = p->stack[--p->top];
+    p->seen++;
+    if (p->top + 2 > p->cap) {
+        int ncap = p->cap * 2;
+        const Node **ns = malloc((size_t)ncap * sizeof(Node *));
+        if (!ns) { perror("malloc"); p->top = 0; return 0; }
+        memcpy(ns, p->stack, (size_t)p->top * sizeof(Node *));
+        if (p->stack != p->inlineStack) free(p->stack);
+        p->stack = ns;
+        p->cap = ncap;
+    }
+    if (n->right) p->stack[p->top++] = n->right;
+    if (n->left) p->stack[p->top++] = n->left;
+    return 1;
+}
+
+static void probeFree(SizeProbe *p) {
+    if (p->stack != p->inlineStack) free(p->stack);
+}
+
+/**
+ * @brief Decides whether to fork on the two subtrees of a node at the
+ *        given fork depth.
+ * @return 1 if the depth allows it and both subtrees reach the cutoff.
+ */
+static int worthForking(const Node *l, const Node *r, int depth) {
+    if (depth >= maxForkDepth || !l || !r) return 0;
+    SizeProbe pl, pr;
+    probeInit(&pl, l);
+    probeInit(&pr, r);
+    int small = 0;
+    while (!small && (pl.seen < forkCutoff || pr.seen < forkCutoff)) {
+        if (pl.seen < forkCutoff && !probeStep(&pl)) small = 1;
+        else if (pr.seen < forkCutoff && !probeStep(&pr)) small = 1;
+    }
+    probeFree(&pl);
+    probeFree(&pr);
+    return !small;
+}
+
+typedef Node *(*SeqPass)(Node *root);
+typedef Node *(*ParPass)(Node *root, int worker, int depth);
+
+/**
+ * @brief A subtree handed to another worker.
+ */
+typedef struct {
+    ParPass par;
+    Node *in;
+    int depth;
+    Node *out;
+} PassJob;
+
+static void passTask(void *arg, int worker) {
+    PassJob *job = arg;
+    job->out = job->par(job->in, worker, job->depth);
+}
+
+/**
+ * @brief Runs a pass over two subtrees, in parallel when both are large.
+ *        Below the fork depth everything is sequential.
+ */
+static void forkPair(Node *l, Node *r, SeqPass seq, ParPass par, int worker, int depth,
+                     Node **outL, Node **outR) {
+    if (depth >= maxForkDepth) {
+        *outL = seq(l);
+        *outR = seq(r);
+    } else if (worthForking(l, r, depth)) {
+        PassJob job = { par, r, depth + 1, NULL };
+        WsGroup g;
+        wsGroupInit(&g);
+        wsSpawn(treePool, worker, &g, passTask, &job);
+        *outL = par(l, worker, depth + 1);
+        wsJoin(treePool, worker, &g);
+        *outR = job.out;
+    } else {
+        *outL = par(l, worker, depth + 1);
+        *outR = par(r, worker, depth + 1);
+    }
+}
+
+/**
+ * @brief Runs a parallel pass from a thread outside the pool.
+ */
+static Node *runPass(Node *root, ParPass par) {
+    PassJob job = { par, root, 0, NULL };
+    WsGroup g;
+    wsGroupInit(&g);
+    wsSpawn(treePool, 0, &g, passTask, &job);
+    wsJoin(treePool, -1, &g);
+    return job.out;
+}
+
+static Node *copyPar(Node *root, int worker, int depth) {
+    if (!root) return NULL;
+    Node *c = newNode(root->tok);
+    if (!c) return NULL;
+    forkPair(root->left, root->right, copyTree, copyPar, worker, depth, &c->left, &c->right);
+    return c;
+}
+
+static Node *eliminatePar(Node *root, int worker, int depth) {
+    if (!root) return NULL;
+    forkPair(root->left, root->right, eliminateImplications, eliminatePar, worker, depth,
+             &root->left, &root->right);
+    eliminateImplicationStep(root);
+    return root;
+}
+
+static Node *moveNotPar(Node *root, int worker, int depth) {
+    if (!root) return NULL;
+    root = moveNotStep(root);
+    forkPair(root->left, root->right, moveNotInwards, moveNotPar, worker, depth, &root->left, &root->right);
+    return root;
+}
+
+static Node *distributePar(Node *root, int worker, int depth) {
+    if (!root) return NULL;
+    forkPair(root->left, root->right, distributeOr, distributePar, worker, depth, &root->left, &root->right);
+    if (distributeOrStep(root))
+        forkPair(root->left, root->right, distributeOr, distributePar, worker, depth, &root->left, &root->right);
+    return root;
+}
+
+/**
+ * @copydoc parCopyTree
+ */
+Node *parCopyTree(Node *root) {
+    if (!sharedPool()) return copyTree(root);
+    return runPass(root, copyPar);
+}
+
+/**
+ * @copydoc parConvertToCNF
+ */
+Node *parConvertToCNF(Node *root) {
+    if (!sharedPool()) return convertToCNF(root);
+    Node *t = runPass(root, copyPar);
+    t = runPass(t, eliminatePar);
+    t = runPass(t, moveNotPar);
+    return runPass(t, distributePar);
+}
+
+/**
+ * @brief Clause counting over clauses[lo .. hi).
+ */
+typedef struct {
+    Node **clauses;
+    int lo, hi, grain;
+    int valid, invalid;
+} CountJob;
+
+static void countTask(void *arg, int worker) {
+    CountJob *job = arg;
+    if (job->hi - job->lo <= job->grain) {
+        for (int i = job->lo; i < job->hi; i++) checkCNFValidity(job->clauses[i], &job->valid, &job->invalid);
+        return;
+    }
+    int mid = job->lo + (job->hi - job->lo) / 2;
+    CountJob right = { job->clauses, mid, job->hi, job->grain, 0, 0 };
+    WsGroup g;
+    wsGroupInit(&g);
+    wsSpawn(treePool, worker, &g, countTask, &right);
+    job->hi = mid;
+    countTask(job, worker);
+    wsJoin(treePool, worker, &g);
+    job->valid += right.valid;
+    job->invalid += right.invalid;
+}
+
+/**
+ * @copydoc parCheckCNFValidity
+ */
+void parCheckCNFValidity(Node *root, int *valid, int *invalid) {
+    if (!sharedPool() || !root) {
+        checkCNFValidity(root, valid, invalid);
+        return;
+    }
+    // The clauses are the maximal subtrees below the run of '*' at the
+    // root, whatever its shape (chains from the parser are one-sided),
+    // so they are gathered first and split by count
+    int cap = 1024, count = 0, top = 0;
+    Node **clauses = malloc((size_t)cap * sizeof(Node *));
+    Node **stack = malloc((size_t)cap * sizeof(Node *));
+    if (!clauses || !stack) {
+        perror("malloc");
+        free(clauses);
+        free(stack);
+        checkCNFValidity(root, valid, invalid);
+        return;
+    }
+    stack[top++] = root;
+    while (top > 0) {
+        Node *n = stack[--top];
+        if (!n) continue;
+        if (count + 1 >= cap || top + 2 >= cap) {
+            cap *= 2;
+            Node **nc = realloc(clauses, (size_t)cap * sizeof(Node *));
+            if (nc) clauses = nc;
+            Node **ns = nc ? realloc(stack, (size_t)cap * sizeof(Node *)) : NULL;
+            if (ns) stack = ns;
+            if (!nc || !ns) {
+                perror("realloc");
+                free(clauses);
+                free(stack);
+                checkCNFValidity(root, valid, invalid);
+                return;
+            }
+        }
+        if (strcmp(n->tok, "*") == 0) {
+            stack[top++] = n->right;
+            stack[top++] = n->left;
+        } else {
+            clauses[count++] = n;
+        }
+    }
+    free(stack);
+
+    int workers = wsPoolNumWorkers(treePool);
+    int grain = count / (workers << PAR_EXTRA_DEPTH);
+    CountJob job = { clauses, 0, count, grain > 0 ? grain : 1, 0, 0 };
+    WsGroup g;
+    wsGroupInit(&g);
+    wsSpawn(treePool, 0, &g, countTask, &job);
+    wsJoin(treePool, -1, &g);
+    free(clauses);
+    *valid += job.valid;
+    *invalid += job.invalid;
+}
+
+/**
+ * @brief Evaluation of one subtree.
+ */
+typedef struct {
+    const Node *root;
+    const VarMap *vm;
+    const unsigned char *values;
+    int depth;
+    int result;
+} EvalJob;
+
+static int evalSeq(const Node *n, const VarMap *vm, const unsigned char *values) {
+    if (!n || !n->tok) return -1;
+    if (isVariableLeaf(n)) {
+        int c = constantValue(n->tok);
+        if (c >= 0) return c;
+        int v = varMapFind(vm, n->tok);
+        return v ? values[v - 1] != 0 : -1;
+    }
+    if (strcmp(n->tok, "~") == 0) {
+        int x = evalSeq(n->right, vm, values);
+        return x < 0 ? -1 : !x;
+    }
+    int l = evalSeq(n->left, vm, values);
+    int r = l < 0 ? -1 : evalSeq(n->right, vm, values);
+    if (r < 0) return -1;
+    if (strcmp(n->tok, "+") == 0) return l || r;
+    if (strcmp(n->tok, "*") == 0) return l && r;
+    if (strcmp(n->tok, ">") == 0) return !l || r;
+    return -1;
+}
+
+static int evalPar(const Node *n, const VarMap *vm, const unsigned char *values, int worker, int depth);
+
+static void evalTask(void *arg, int worker) {
+    EvalJob *job = arg;
+    job->result = evalPar(job->root, job->vm, job->values, worker, job->depth);
+}
+
+static int evalPar(const Node *n, const VarMap *vm, const unsigned char *values, int worker, int depth) {
+    if (!n || !n->tok || isVariableLeaf(n) || depth >= maxForkDepth) return evalSeq(n, vm, values);
+    if (strcmp(n->tok, "~") == 0) {
+        int x = evalPar(n->right, vm, values, worker, depth + 1);
+        return x < 0 ? -1 : !x;
+    }
+    int l, r;
+    if (worthForking(n->left, n->right, depth)) {
+        EvalJob job = { n->right, vm, values, depth + 1, -1 };
+        WsGroup g;
+        wsGroupInit(&g);
+        wsSpawn(treePool, worker, &g, evalTask, &job);
+        l = evalPar(n->left, vm, values, worker, depth + 1);
+        wsJoin(treePool, worker, &g);
+        r = job.result;
+    } else {
+        l = evalPar(n->left, vm, values, worker, depth + 1);
+        r = evalPar(n->right, vm, values, worker, depth + 1);
+    }
+    if (l < 0 || r < 0) return -1;
+    if (strcmp(n->tok, "+") == 0) return l || r;
+    if (strcmp(n->tok, "*") == 0) return l && r;
+    if (strcmp(n->tok, ">") == 0) return !l || r;
+    return -1;
+}
+
+/**
+ * @copydoc parEvaluateFormula
+ */
+int parEvaluateFormula(const Node *root, const VarMap *vm, const unsigned char *values) {
+    if (!sharedPool()) return evalSeq(root, vm, values);
+    EvalJob job = { root, vm, values, 0, -1 };
+    WsGroup g;
+    wsGroupInit(&g);
+    wsSpawn(treePool, 0, &g, evalTask, &job);
+    wsJoin(treePool, -1, &g);
+    return job.result;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file parallelTree.h
+ * @brief Header for the fork-join versions of the tree passes.
+ */
+
+#ifndef PARALLEL_TREE_H
+#define PARALLEL_TREE_H
+
+#include "common.h"
+#include "varMap.h"
+
+/** Subtrees smaller than this many nodes are never split. */
+#define PAR_TREE_CUTOFF 2048
+
+/**
+ * @brief Sets the worker count and cutoff of the shared pool. Only takes
+ *        effect before the first parallel call.
+ * @param workers Threads (< 1: one per core; 1: everything sequential).
+ * @param cutoff Minimum size of both subtrees for a fork (< 1: default).
+ */
+void parTreeConfigure(int workers, long cutoff);
+
+/**
+ * @brief Deep copy, forking on large subtrees (same result as copyTree).
+ */
+Node *parCopyTree(Node *root);
+
+/**
+ * @brief CNF conversion with every step parallel (same result as
+ *        convertToCNF).
+ */
+Node *parConvertToCNF(Node *root);
+
+/**
+ * @brief Task 7 clause count over the conjunctions, forking on large
+ *        subtrees (same result as checkCNFValidity).
+ */
+void parCheckCNFValidity(Node *root, int *valid, int *invalid);
+
+/**
+ * @brief Evaluates a formula under one assignment.
+ * @param root Formula.
+ * @param vm Variable names; leaf names are looked up here.
+ * @param values values[i] is the value (0/1) of variable i+1 of vm.
+ * @return 1 or 0, or -1 if a leaf is not in vm or the tree is malformed.
+ */
+int parEvaluateFormula(const Node *root, const VarMap *vm, const unsigned char *values);
+
+#endif
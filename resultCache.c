@@ -0,0 +1,415 @@
+/**
+ * @file resultCache.c
+ * @brief Content-addressed cache of analysis results.
+ *
+ * The same formulas and instances arrive again and again, and each time
+ * the height, truth table, CNF conversion and validity were recomputed.
+ * Results are stored under a hash of the formula's content instead of its
+ * file name or spelling, so re-submissions are answered by a table lookup.
+ * @section algo Algorithm:
+ *   - Keys: bottom-up 128-bit hash (two independent 64-bit lanes) of the
+ *     tree with operands in order; clause hashes are summed
+ *   - Memory tier: chained hash table threaded on an LRU list, evicted
+ *     from the cold end once the byte budget is exceeded
+ *   - Disk tier: one small text file per key, written via rename so
+ *     readers never see a partial file; disk hits are promoted to memory
+ * @section time Time Complexity: O(n) hashing, O(1) expected per lookup
+ * @section space Space Complexity: O(maxBytes) in memory
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "resultCache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define PATH_LEN 4096
+
+/* ----- hashing ----- */
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/**
+ * @brief Order-sensitive combination of a tag and two child keys.
+ */
+static CacheKey combineKeys(uint64_t tag, CacheKey a, CacheKey b) {
+    CacheKey k;
+    k.hi = mix64(mix64(tag ^ a.hi) + rotl64(b.hi, 23));
+    k.lo = mix64(mix64(tag ^ 0x9e3779b97f4a7c15ULL ^ a.lo) ^ rotl64(b.lo, 41));
+    return k;
+}
+
+static int keyEqual(CacheKey a, CacheKey b) {
+    return a.hi == b.hi && a.lo == b.lo;
+}
+
+/**
+ * @brief FNV-1a over a name, one lane per offset basis.
+ */
+static CacheKey hashName(const char *s) {
+    uint64_t h1 = 0xcbf29ce484222325ULL, h2 = 0x84222325cbf29ce4ULL;
+    for (; *s; s++) {
+        h1 = (h1 ^ (unsigned char)*s) * 0x100000001b3ULL;
+        h2 = (h2 ^ (unsigned char)*s) * 0x100000001b3ULL;
+    }
+    CacheKey k = { mix64(h1), mix64(h2 + 1) };
+    return k;
+}
+
+/**
+ * @copydoc hashFormulaTree
+ */
+CacheKey hashFormulaTree(const Node *root) {
+    static const CacheKey none = { 0, 0 };
+    if (!root || !root->tok) return none;
+    if (!root->left && !root->right) return combineKeys('v', hashName(root->tok), none);
+
+    // Operands stay in order: the stored CNF text and clause counts
+    // depend on it even where the height and models do not
+    CacheKey l = hashFormulaTree(root->left);
+    CacheKey r = hashFormulaTree(root->right);
+    return combineKeys(hashName(root->tok).hi, l, r);
+}
+
+/**
+ * @copydoc hashClauseSet
+ */
+CacheKey hashClauseSet(const CnfFormula *f) {
+    uint64_t sumHi = 0, sumLo = 0;
+    for (int i = 0; i < f->numClauses; i++) {
+        const int *c = cnfClause(f, i);
+        uint64_t h1 = 0x243f6a8885a308d3ULL, h2 = 0x13198a2e03707344ULL;
+        for (int j = 0; j < cnfClauseSize(f, i); j++) {
+            uint64_t lit = (uint32_t)c[j];
+            h1 = mix64(h1 ^ lit);
+            h2 = mix64(h2 + lit * 0x9e3779b97f4a7c15ULL);
+        }
+        // Summing makes the set hash independent of clause order
+        sumHi += h1;
+        sumLo += mix64(h2);
+    }
+    CacheKey k = { sumHi, sumLo };
+    CacheKey shape = { (uint64_t)f->numVars, (uint64_t)f->numClauses };
+    return combineKeys('c', k, shape);
+}
+
+/* ----- records ----- */
+
+/**
+ * @copydoc emptyCachedResult
+ */
+CachedResult emptyCachedResult(void) {
+    CachedResult r = { -1, -1, -1, -1, -1, -1, -1, NULL };
+    return r;
+}
+
+/**
+ * @copydoc freeCachedResult
+ */
+void freeCachedResult(CachedResult *r) {
+    free(r->cnf);
+    r->cnf = NULL;
+}
+
+/**
+ * @brief Deep-copies a record.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int copyRecord(CachedResult *dst, const CachedResult *src) {
+    *dst = *src;
+    dst->cnf = NULL;
+    if (src->cnf && !(dst->cnf = strdup_s(src->cnf))) return 0;
+    return 1;
+}
+
+/* ----- memory tier ----- */
+
+typedef struct Entry {
+    CacheKey key;
+    CachedResult rec;
+    size_t bytes;                 /**< Accounted size of this entry */
+    struct Entry *prev, *next;    /**< LRU list, most recent first */
+    struct Entry *chain;          /**< Next entry in the same bucket */
+} Entry;
+
+struct ResultCache {
+    pthread_mutex_t lock;
+    Entry **buckets;
+    size_t numBuckets;            /**< Power of two */
+    Entry *head, *tail;
+    CacheStats st;
+    char *dir;                    /**< Disk tier, or NULL */
+    unsigned long tmpCounter;     /**< Unique suffix of temporary files */
+};
+
+static size_t entryBytes(const CachedResult *r) {
+    return sizeof(Entry) + (r->cnf ? strlen(r->cnf) + 1 : 0);
+}
+
+static Entry **findSlot(ResultCache *c, CacheKey key) {
+    Entry **p = &c->buckets[key.lo & (c->numBuckets - 1)];
+    while (*p && !keyEqual((*p)->key, key)) p = &(*p)->chain;
+    return p;
+}
+
+static void unlinkLru(ResultCache *c, Entry *e) {
+    if (e->prev) e->prev->next = e->next;
+    else c->head = e->next;
+    if (e->next) e->next->prev = e->prev;
+    else c->tail = e->prev;
+}
+
+static void pushFront(ResultCache *c, Entry *e) {
+    e->prev = NULL;
+    e->next = c->head;
+    if (c->head) c->head->prev = e;
+    c->head = e;
+    if (!c->tail) c->tail = e;
+}
+
+/**
+ * @brief Doubles the bucket array once it is as full as it is long.
+ */
+static void maybeGrow(ResultCache *c) {
+    if ((size_t)c->st.entries < c->numBuckets) return;
+    size_t n = c->numBuckets * 2;
+    Entry **nb = calloc(n, sizeof(Entry*));
+    if (!nb) return;              /* keep the longer chains */
+    for (size_t i = 0; i < c->numBuckets; i++) {
+        for (Entry *e = c->buckets[i], *next; e; e = next) {
+            next = e->chain;
+            Entry **head = &nb[e->key.lo & (n - 1)];
+            e->chain = *head;
+            *head = e;
+        }
+    }
+    free(c->buckets);
+    c->buckets = nb;
+    c->numBuckets = n;
+}
+
+static void evictOverBudget(ResultCache *c) {
+    while (c->tail && c->st.bytes > c->st.maxBytes) {
+        Entry *e = c->tail;
+        *findSlot(c, e->key) = e->chain;
+        unlinkLru(c, e);
+        c->st.bytes -= e->bytes;
+        c->st.entries--;
+        c->st.evictions++;
+        freeCachedResult(&e->rec);
+        free(e);
+    }
+}
+
+/**
+ * @brief Inserts or replaces a record in memory (lock held).
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int memoryInsert(ResultCache *c, CacheKey key, const CachedResult *r) {
+    CachedResult copy;
+    if (!copyRecord(&copy, r)) { perror("malloc"); return 0; }
+    Entry **slot = findSlot(c, key);
+    Entry *e = *slot;
+    if (e) {
+        unlinkLru(c, e);
+        c->st.bytes -= e->bytes;
+        freeCachedResult(&e->rec);
+    } else {
+        e = malloc(sizeof(Entry));
+        if (!e) { perror("malloc"); freeCachedResult(&copy); return 0; }
+        e->key = key;
+        e->chain = NULL;
+        *slot = e;
+        c->st.entries++;
+    }
+    e->rec = copy;
+    e->bytes = entryBytes(&copy);
+    c->st.bytes += e->bytes;
+    pushFront(c, e);
+    evictOverBudget(c);
+    maybeGrow(c);
+    return 1;
+}
+
+/* ----- disk tier ----- */
+
+static void diskPath(const ResultCache *c, CacheKey key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016llx%016llx", c->dir,
+             (unsigned long long)key.hi, (unsigned long long)key.lo);
+}
+
+/**
+ * @brief Reads a record file.
+ * @return 1 if the file exists and is well formed, 0 otherwise.
+ */
+static int diskRead(const ResultCache *c, CacheKey key, CachedResult *r) {
+    char path[PATH_LEN];
+    diskPath(c, key, path, sizeof(path));
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    *r = emptyCachedResult();
+    long cnfLen = -1;
+    int ok = fscanf(fp, "logic-cache 1\nvars %d\nheight %d\nmodels %lf\nsat %d\nvalid %d\nclauses %d %d\ncnf %ld",
+                    &r->numVars, &r->height, &r->models, &r->sat, &r->valid,
+                    &r->validClauses, &r->invalidClauses, &cnfLen) == 8
+             && fgetc(fp) == '\n';
+    if (ok && cnfLen >= 0) {
+        r->cnf = malloc((size_t)cnfLen + 1);
+        ok = r->cnf && fread(r->cnf, 1, (size_t)cnfLen, fp) == (size_t)cnfLen;
+        if (ok) r->cnf[cnfLen] = '\0';
+    }
+    fclose(fp);
+    if (!ok) freeCachedResult(r);
+    return ok;
+}
+
+/**
+ * @brief Writes a record file through a temporary name.
+ * @return 1 on success, 0 on an I/O error.
+ */
+static int diskWrite(const ResultCache *c, CacheKey key, const CachedResult *r, unsigned long serial) {
+    char path[PATH_LEN], tmp[PATH_LEN + 64];
+    diskPath(c, key, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%ld.%lu", path, (long)getpid(), serial);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) { perror(tmp); return 0; }
+    fprintf(fp, "logic-cache 1\nvars %d\nheight %d\nmodels %.17g\nsat %d\nvalid %d\nclauses %d %d\ncnf %ld\n",
+            r->numVars, r->height, r->models, r->sat, r->valid,
+            r->validClauses, r->invalidClauses, r->cnf ? (long)strlen(r->cnf) : -1L);
+    if (r->cnf) fputs(r->cnf, fp);
+    int ok = !ferror(fp);
+    ok = fclose(fp) == 0 && ok;
+    if (ok && rename(tmp, path) != 0) { perror(path); ok = 0; }
+    if (!ok) unlink(tmp);
+    return ok;
+}
+
+/* ----- public interface ----- */
+
+/**
+ * @copydoc resultCacheNew
+ */
+ResultCache *resultCacheNew(size_t maxBytes, const char *diskDir) {
+    ResultCache *c = calloc(1, sizeof(ResultCache));
+    if (!c) { perror("calloc"); return NULL; }
+    c->numBuckets = 64;
+    c->buckets = calloc(c->numBuckets, sizeof(Entry*));
+    if (!c->buckets) { perror("calloc"); free(c); return NULL; }
+    c->st.maxBytes = maxBytes;
+    if (diskDir) {
+        if (mkdir(diskDir, 0777) != 0 && errno != EEXIST) {
+            perror(diskDir);
+            free(c->buckets);
+            free(c);
+            return NULL;
+        }
+        if (!(c->dir = strdup_s(diskDir))) {
+            free(c->buckets);
+            free(c);
+            return NULL;
+        }
+    }
+    pthread_mutex_init(&c->lock, NULL);
+    return c;
+}
+
+/**
+ * @copydoc resultCacheFree
+ */
+void resultCacheFree(ResultCache *c) {
+    if (!c) return;
+    for (Entry *e = c->head, *next; e; e = next) {
+        next = e->next;
+        freeCachedResult(&e->rec);
+        free(e);
+    }
+    pthread_mutex_destroy(&c->lock);
+    free(c->buckets);
+    free(c->dir);
+    free(c);
+}
+
+/**
+ * @copydoc resultCacheLookup
+ */
+int resultCacheLookup(ResultCache *c, CacheKey key, CachedResult *out) {
+    pthread_mutex_lock(&c->lock);
+    c->st.lookups++;
+    Entry *e = *findSlot(c, key);
+    if (e && copyRecord(out, &e->rec)) {
+        unlinkLru(c, e);
+        pushFront(c, e);
+        c->st.memoryHits++;
+        pthread_mutex_unlock(&c->lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    // The disk tier is read without the lock; files only ever appear whole
+    int hit = c->dir && diskRead(c, key, out);
+    pthread_mutex_lock(&c->lock);
+    if (hit) {
+        c->st.diskHits++;
+        memoryInsert(c, key, out);
+    } else {
+        c->st.misses++;
+    }
+    pthread_mutex_unlock(&c->lock);
+    return hit ? 2 : 0;
+}
+
+/**
+ * @copydoc resultCacheStore
+ */
+int resultCacheStore(ResultCache *c, CacheKey key, const CachedResult *r) {
+    pthread_mutex_lock(&c->lock);
+    int ok = memoryInsert(c, key, r);
+    c->st.stores++;
+    unsigned long serial = c->tmpCounter++;
+    pthread_mutex_unlock(&c->lock);
+
+    if (c->dir && diskWrite(c, key, r, serial)) {
+        pthread_mutex_lock(&c->lock);
+        c->st.diskWrites++;
+        pthread_mutex_unlock(&c->lock);
+    }
+    return ok;
+}
+
+/**
+ * @copydoc resultCacheStats
+ */
+CacheStats resultCacheStats(ResultCache *c) {
+    pthread_mutex_lock(&c->lock);
+    CacheStats st = c->st;
+    pthread_mutex_unlock(&c->lock);
+    return st;
+}
+
+/**
+ * @copydoc printCacheStats
+ */
+void printCacheStats(FILE *out, const CacheStats *st) {
+    long long hits = st->memoryHits + st->diskHits;
+    fprintf(out, "Cache: %lld lookups, %lld hits (%lld memory, %lld disk), %lld misses, "
+                 "hit rate %.1f%%, %d entries, %zu of %zu bytes, %lld evictions\n",
+            st->lookups, hits, st->memoryHits, st->diskHits, st->misses,
+            st->lookups ? 100.0 * hits / st->lookups : 0.0,
+            st->entries, st->bytes, st->maxBytes, st->evictions);
+}
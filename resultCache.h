@@ -0,0 +1,133 @@
+/**
+ * @file resultCache.h
+ * @brief Header for the content-addressed cache of analysis results.
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "cnfFormula.h"
+
+/**
+ * @brief 128-bit content hash identifying a formula or clause set.
+ */
+typedef struct {
+    uint64_t hi, lo;
+} CacheKey;
+
+/**
+ * @brief Hashes a parse tree, operands in order.
+ *
+ * Trees with the same structure and tokens share a key whatever their
+ * spacing or parenthesization in the input. Swapping the operands of + or
+ * * gives a different key: the height and model count would not change,
+ * but the cached Task 6 CNF text and Task 7 clause counts do.
+ *
+ * @param root Root of the parse tree.
+ * @return Key of the tree.
+ */
+CacheKey hashFormulaTree(const Node *root);
+
+/**
+ * @brief Hashes a clause set independently of clause order.
+ *
+ * Clauses from readCnfFormula are already sorted and de-duplicated, so
+ * files differing only in comments, whitespace, clause order or literal
+ * order within a clause share a key. numVars is part of the key, since
+ * free variables change the model count.
+ *
+ * @param f Parsed formula.
+ * @return Key of the clause set.
+ */
+CacheKey hashClauseSet(const CnfFormula *f);
+
+/**
+ * @brief Results stored for one key; unknown fields are -1 (NULL for cnf).
+ */
+typedef struct {
+    int numVars;          /**< Variables of the formula */
+    int height;           /**< Parse-tree height (Task 4) */
+    double models;        /**< Number of satisfying assignments */
+    int sat;              /**< 1 satisfiable, 0 unsatisfiable */
+    int valid;            /**< 1 tautology, 0 not */
+    int validClauses;     /**< Task 7 clause counts */
+    int invalidClauses;
+    char *cnf;            /**< Task 6 CNF text */
+} CachedResult;
+
+/**
+ * @brief Returns a record with every field unknown.
+ */
+CachedResult emptyCachedResult(void);
+
+/**
+ * @brief Frees the text held by a record (not the record itself).
+ */
+void freeCachedResult(CachedResult *r);
+
+/**
+ * @brief Counters of a cache.
+ */
+typedef struct {
+    long long lookups;
+    long long memoryHits;   /**< Answered by the in-memory tier */
+    long long diskHits;     /**< Answered by the disk tier (then promoted) */
+    long long misses;
+    long long stores;
+    long long evictions;    /**< Entries dropped from memory by the LRU */
+    long long diskWrites;
+    int entries;            /**< Entries in memory */
+    size_t bytes;           /**< Bytes held by the in-memory tier */
+    size_t maxBytes;
+} CacheStats;
+
+typedef struct ResultCache ResultCache;
+
+/**
+ * @brief Creates a cache.
+ * @param maxBytes Budget of the in-memory tier; the least recently used
+ *        entries are evicted beyond it.
+ * @param diskDir Directory of the on-disk tier (created if missing), or
+ *        NULL for memory only.
+ * @return New cache, or NULL on error. Safe to share between threads.
+ */
+ResultCache *resultCacheNew(size_t maxBytes, const char *diskDir);
+
+/**
+ * @brief Frees a cache (the disk tier stays on disk).
+ */
+void resultCacheFree(ResultCache *c);
+
+/**
+ * @brief Looks up a key in memory, then on disk.
+ * @param c Cache.
+ * @param key Key to find.
+ * @param out Filled with a copy of the record on a hit; release with
+ *        freeCachedResult.
+ * @return 1 on a memory hit, 2 on a disk hit, 0 on a miss.
+ */
+int resultCacheLookup(ResultCache *c, CacheKey key, CachedResult *out);
+
+/**
+ * @brief Stores (or replaces) the record of a key in both tiers.
+ * @param c Cache.
+ * @param key Key of the record.
+ * @param r Record to copy.
+ * @return 1 on success, 0 on malloc failure.
+ */
+int resultCacheStore(ResultCache *c, CacheKey key, const CachedResult *r);
+
+/**
+ * @brief Returns a snapshot of the counters.
+ */
+CacheStats resultCacheStats(ResultCache *c);
+
+/**
+ * @brief Prints the counters on one line.
+ */
+void printCacheStats(FILE *out, const CacheStats *st);
+
+#endif
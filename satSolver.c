@@ -0,0 +1,866 @@
+/**
+ * @file satSolver.c
+ * @brief Conflict-driven clause-learning (CDCL) SAT solver.
+ *
+ * Decides satisfiability of clause sets with two-watched-literal unit
+ * propagation, first-UIP conflict analysis, VSIDS branching with phase
+ * saving, Luby restarts and activity-based learned clause deletion.
+ * Assumption literals are decided first, one per decision level, so the
+ * same handle can be queried repeatedly without rebuilding any state;
+ * when assumptions make the clause set unsatisfiable the responsible
+ * subset is extracted from the final conflict.
+ * @section algo Algorithm: CDCL (MiniSat-style)
+ * @section time Time Complexity: O(2^n) worst case
+ *   - Each propagation is linear in the visited watch lists
+ * @section space Space Complexity: O(L + n)
+ *   - L = literals in original and learned clauses, n = variables
+ */
+
+#include "satSolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VAR_DECAY 0.95
+#define CLAUSE_DECAY 0.999
+#define RESTART_BASE 100
+#define LEARNT_GROWTH 1.05
+
+#define LIT_UNDEF -1
+
+/**
+ * @brief A stored clause. lits[0] is the implied literal when the
+ *        clause is the reason for an assignment.
+ */
+typedef struct {
+    int size;
+    int learnt;
+    int deleted;
+    float activity;
+    int lits[];
+} Clause;
+
+/**
+ * @brief Watch list entry; the blocker short-cuts satisfied clauses.
+ */
+typedef struct {
+    Clause *c;
+    int blocker;
+} Watcher;
+
+typedef struct {
+    Watcher *w;
+    int size;
+    int cap;
+} WatchList;
+
+typedef struct {
+    Clause **data;
+    int size;
+    int cap;
+} ClauseVec;
+
+struct Solver {
+    int numVars;
+    int varCap;
+    int ok;                   /* 0 once the clause set is unsatisfiable */
+
+    ClauseVec clauses;
+    ClauseVec learnts;
+    WatchList *watches;       /* indexed by internal literal */
+
+    signed char *assigns;     /* per variable: 1, 0 or -1 (unassigned) */
+    signed char *polarity;    /* saved phase */
+    signed char *model;
+    int *level;
+    Clause **reason;
+    char *seen;
+
+    int *trail;
+    int trailSize;
+    int qhead;
+    int *trailLim;
+    int trailLimSize;
+    int trailLimCap;
+
+    double *activity;
+    double varInc;
+    double claInc;
+    int *heap;                /* binary max-heap of variables */
+    int heapSize;
+    int *heapIdx;             /* position in heap, -1 if absent */
+
+    int *assumps;             /* internal literals of the current call */
+    int numAssumps;
+    int assumpCap;
+
+    int *scratch;             /* learnt clause under construction */
+    int *toClear;
+    double maxLearnts;
+
+    int *failed;              /* failed assumptions of the last call (DIMACS) */
+    int numFailed;
+
+    long long solves;
+    long long decisions;
+    long long propagations;
+    long long conflicts;
+    long long conflictBudget;
+    long long budgetEnd;
+    volatile int *interrupt;
+};
+
+// --- Literal helpers ---
+
+static inline int toLit(int dimacs) {
+    return dimacs > 0 ? 2 * (dimacs - 1) : 2 * (-dimacs - 1) + 1;
+}
+
+static inline int toDimacs(int lit) {
+    return (lit & 1) ? -((lit >> 1) + 1) : (lit >> 1) + 1;
+}
+
+static inline int litVar(int lit) { return lit >> 1; }
+
+static inline int litValue(const Solver *s, int lit) {
+    signed char a = s->assigns[lit >> 1];
+    return a < 0 ? -1 : (a ^ (lit & 1));
+}
+
+static inline int decisionLevel(const Solver *s) { return s->trailLimSize; }
+
+// --- Growable arrays ---
+
+/**
+ * @brief Appends a clause pointer.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int clauseVecPush(ClauseVec *v, Clause *c) {
+    if (v->size == v->cap) {
+        int ncap = v->cap ? v->cap * 2 : 256;
+        Clause **nd = realloc(v->data, (size_t)ncap * sizeof(Clause*));
+        if (!nd) { perror("realloc"); return 0; }
+        v->data = nd;
+        v->cap = ncap;
+    }
+    v->data[v->size++] = c;
+    return 1;
+}
+
+/**
+ * @brief Appends a watcher to a literal's watch list.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int watchPush(WatchList *l, Clause *c, int blocker) {
+    if (l->size == l->cap) {
+        int ncap = l->cap ? l->cap * 2 : 4;
+        Watcher *nd = realloc(l->w, (size_t)ncap * sizeof(Watcher));
+        if (!nd) { perror("realloc"); return 0; }
+        l->w = nd;
+        l->cap = ncap;
+    }
+    l->w[l->size].c = c;
+    l->w[l->size].blocker = blocker;
+    l->size++;
+    return 1;
+}
+
+// --- VSIDS heap ---
+
+static void heapUp(Solver *s, int i) {
+    int v = s->heap[i];
+    double a = s->activity[v];
+    while (i > 0) {
+        int p = (i - 1) >> 1;
+        if (s->activity[s->heap[p]] >= a) break;
+        s->heap[i] = s->heap[p];
+        s->heapIdx[s->heap[i]] = i;
+        i = p;
+    }
+    s->heap[i] = v;
+    s->heapIdx[v] = i;
+}
+
+static void heapDown(Solver *s, int i) {
+    int v = s->heap[i];
+    double a = s->activity[v];
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= s->heapSize) break;
+        if (c + 1 < s->heapSize && s->activity[s->heap[c + 1]] > s->activity[s->heap[c]]) c++;
+        if (s->activity[s->heap[c]] <= a) break;
+        s->heap[i] = s->heap[c];
+        s->heapIdx[s->heap[i]] = i;
+        i = c;
+    }
+    s->heap[i] = v;
+    s->heapIdx[v] = i;
+}
+
+static void heapInsert(Solver *s, int v) {
+    if (s->heapIdx[v] >= 0) return;
+    s->heap[s->heapSize] = v;
+    s->heapIdx[v] = s->heapSize;
+    s->heapSize++;
+    heapUp(s, s->heapSize - 1);
+}
+
+static int heapRemoveMax(Solver *s) {
+    int v = s->heap[0];
+    s->heapIdx[v] = -1;
+    s->heapSize--;
+    if (s->heapSize > 0) {
+        s->heap[0] = s->heap[s->heapSize];
+        s->heapIdx[s->heap[0]] = 0;
+        heapDown(s, 0);
+    }
+    return v;
+}
+
+/**
+ * @brief Increases a variable's activity, rescaling all when too large.
+ */
+static void bumpVar(Solver *s, int v) {
+    if ((s->activity[v] += s->varInc) > 1e100) {
+        for (int i = 0; i < s->numVars; i++) s->activity[i] *= 1e-100;
+        s->varInc *= 1e-100;
+    }
+    if (s->heapIdx[v] >= 0) heapUp(s, s->heapIdx[v]);
+}
+
+/**
+ * @brief Increases a learned clause's activity, rescaling when too large.
+ */
+static void bumpClause(Solver *s, Clause *c) {
+    if ((c->activity += (float)s->claInc) > 1e20f) {
+        for (int i = 0; i < s->learnts.size; i++) s->learnts.data[i]->activity *= 1e-20f;
+        s->claInc *= 1e-20;
+    }
+}
+
+// --- Variables ---
+
+/**
+ * @brief Grows every per-variable array to hold at least n variables.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int ensureVars(Solver *s, int n) {
+    if (n <= s->numVars) return 1;
+    if (n > s->varCap) {
+        int cap = s->varCap ? s->varCap : 16;
+        while (cap < n) cap *= 2;
+
+#define GROW(ptr, count) do { \
+            void *np_ = realloc((ptr), (size_t)(count) * sizeof(*(ptr))); \
+            if (!np_) { perror("realloc"); return 0; } \
+            (ptr) = np_; \
+        } while (0)
+
+        GROW(s->assigns, cap);
+        GROW(s->polarity, cap);
+        GROW(s->model, cap);
+        GROW(s->level, cap);
+        GROW(s->reason, cap);
+        GROW(s->seen, cap);
+        GROW(s->trail, cap);
+        GROW(s->activity, cap);
+        GROW(s->heap, cap);
+        GROW(s->heapIdx, cap);
+        GROW(s->scratch, cap + 1);
+        GROW(s->toClear, cap + 1);
+        GROW(s->failed, cap + 1);
+        GROW(s->watches, 2 * cap);
+#undef GROW
+        memset(s->watches + 2 * s->varCap, 0, (size_t)(2 * (cap - s->varCap)) * sizeof(WatchList));
+        s->varCap = cap;
+    }
+    for (int v = s->numVars; v < n; v++) {
+        s->assigns[v] = -1;
+        s->polarity[v] = 0;
+        s->model[v] = 0;
+        s->level[v] = 0;
+        s->reason[v] = NULL;
+        s->seen[v] = 0;
+        s->activity[v] = 0.0;
+        s->heapIdx[v] = -1;
+    }
+    int old = s->numVars;
+    s->numVars = n;
+    for (int v = old; v < n; v++) heapInsert(s, v);
+    return 1;
+}
+
+// --- Trail ---
+
+/**
+ * @brief Assigns a literal true with the given reason clause.
+ */
+static void enqueue(Solver *s, int lit, Clause *from) {
+    int v = litVar(lit);
+    s->assigns[v] = !(lit & 1);
+    s->level[v] = decisionLevel(s);
+    s->reason[v] = from;
+    s->trail[s->trailSize++] = lit;
+}
+
+/**
+ * @brief Opens a new decision level.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int newDecisionLevel(Solver *s) {
+    if (s->trailLimSize == s->trailLimCap) {
+        int ncap = s->trailLimCap ? s->trailLimCap * 2 : 64;
+        int *nd = realloc(s->trailLim, (size_t)ncap * sizeof(int));
+        if (!nd) { perror("realloc"); return 0; }
+        s->trailLim = nd;
+        s->trailLimCap = ncap;
+    }
+    s->trailLim[s->trailLimSize++] = s->trailSize;
+    return 1;
+}
+
+/**
+ * @brief Undoes all assignments above the given decision level.
+ */
+static void cancelUntil(Solver *s, int lvl) {
+    if (decisionLevel(s) <= lvl) return;
+    for (int i = s->trailSize - 1; i >= s->trailLim[lvl]; i--) {
+        int v = litVar(s->trail[i]);
+        s->polarity[v] = s->assigns[v];
+        s->assigns[v] = -1;
+        s->reason[v] = NULL;
+        heapInsert(s, v);
+    }
+    s->trailSize = s->trailLim[lvl];
+    s->qhead = s->trailSize;
+    s->trailLimSize = lvl;
+}
+
+// --- Clauses ---
+
+/**
+ * @brief Allocates a clause and watches its first two literals.
+ * @return The clause, or NULL on malloc failure.
+ */
+static Clause *attachNewClause(Solver *s, const int *lits, int n, int learnt) {
+    Clause *c = malloc(sizeof(Clause) + (size_t)n * sizeof(int));
+    if (!c) { perror("malloc"); return NULL; }
+    c->size = n;
+    c->learnt = learnt;
+    c->deleted = 0;
+    c->activity = 0.0f;
+    memcpy(c->lits, lits, (size_t)n * sizeof(int));
+    if (!watchPush(&s->watches[c->lits[0] ^ 1], c, c->lits[1]) ||
+        !watchPush(&s->watches[c->lits[1] ^ 1], c, c->lits[0]) ||
+        !clauseVecPush(learnt ? &s->learnts : &s->clauses, c)) {
+        return NULL;
+    }
+    return c;
+}
+
+/**
+ * @brief Checks whether a clause is the reason for a current assignment.
+ */
+static int isLocked(const Solver *s, const Clause *c) {
+    int v = litVar(c->lits[0]);
+    return s->reason[v] == c && litValue(s, c->lits[0]) == 1;
+}
+
+static int cmpActivity(const void *a, const void *b) {
+    const Clause *x = *(Clause* const*)a, *y = *(Clause* const*)b;
+    if (x->size == 2 && y->size != 2) return 1;
+    if (y->size == 2 && x->size != 2) return -1;
+    return (x->activity > y->activity) - (x->activity < y->activity);
+}
+
+/**
+ * @brief Deletes the less active half of the learned clauses.
+ *
+ * Binary clauses and clauses that are currently reasons are kept.
+ */
+static void reduceLearnts(Solver *s) {
+    qsort(s->learnts.data, (size_t)s->learnts.size, sizeof(Clause*), cmpActivity);
+    double extraLim = s->claInc / (s->learnts.size ? s->learnts.size : 1);
+    int half = s->learnts.size / 2, removed = 0;
+    for (int i = 0; i < s->learnts.size; i++) {
+        Clause *c = s->learnts.data[i];
+        if (c->size > 2 && !isLocked(s, c) && (i < half || c->activity < extraLim)) {
+            c->deleted = 1;
+            removed++;
+        }
+    }
+    if (removed == 0) return;
+
+    // Unhook deleted clauses from every watch list before freeing them
+    for (int l = 0; l < 2 * s->numVars; l++) {
+        WatchList *wl = &s->watches[l];
+        int k = 0;
+        for (int i = 0; i < wl->size; i++)
+            if (!wl->w[i].c->deleted) wl->w[k++] = wl->w[i];
+        wl->size = k;
+    }
+    int j = 0;
+    for (int i = 0; i < s->learnts.size; i++) {
+        Clause *c = s->learnts.data[i];
+        if (c->deleted) free(c);
+        else s->learnts.data[j++] = c;
+    }
+    s->learnts.size = j;
+}
+
+// --- Propagation ---
+
+/**
+ * @brief Propagates all enqueued assignments.
+ * @return A conflicting clause, or NULL if no conflict arose.
+ */
+static Clause *propagate(Solver *s) {
+    Clause *confl = NULL;
+    while (s->qhead < s->trailSize) {
+        int p = s->trail[s->qhead++];
+        s->propagations++;
+        int falseLit = p ^ 1;
+        WatchList *wl = &s->watches[p];
+        Watcher *ws = wl->w;
+        int i = 0, j = 0, n = wl->size;
+
+        while (i < n) {
+            int blocker = ws[i].blocker;
+            if (litValue(s, blocker) == 1) { ws[j++] = ws[i++]; continue; }
+
+            Clause *c = ws[i].c;
+            i++;
+            if (c->lits[0] == falseLit) {
+                c->lits[0] = c->lits[1];
+                c->lits[1] = falseLit;
+            }
+            int first = c->lits[0];
+            if (first != blocker && litValue(s, first) == 1) {
+                ws[j].c = c; ws[j].blocker = first; j++;
+                continue;
+            }
+
+            int found = 0;
+            for (int k = 2; k < c->size; k++) {
+                if (litValue(s, c->lits[k]) != 0) {
+                    c->lits[1] = c->lits[k];
+                    c->lits[k] = falseLit;
+                    watchPush(&s->watches[c->lits[1] ^ 1], c, first);
+                    found = 1;
+                    break;
+                }
+            }
+            if (found) continue;
+
+            ws[j].c = c; ws[j].blocker = first; j++;
+            if (litValue(s, first) == 0) {
+                confl = c;
+                s->qhead = s->trailSize;
+                while (i < n) ws[j++] = ws[i++];
+            } else {
+                enqueue(s, first, c);
+            }
+        }
+        wl->size = j;
+        if (confl) break;
+    }
+    return confl;
+}
+
+// --- Conflict analysis ---
+
+/**
+ * @brief Checks whether a literal of the learnt clause is implied by others.
+ */
+static int isRedundant(const Solver *s, int lit) {
+    Clause *r = s->reason[litVar(lit)];
+    if (!r) return 0;
+    for (int k = 1; k < r->size; k++) {
+        int v = litVar(r->lits[k]);
+        if (!s->seen[v] && s->level[v] > 0) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Derives a first-UIP learned clause from a conflict.
+ *
+ * @param s Solver.
+ * @param confl Conflicting clause.
+ * @param outSize Receives the learned clause length (clause is in s->scratch).
+ * @return Decision level to backjump to.
+ */
+static int analyze(Solver *s, Clause *confl, int *outSize) {
+    int *learnt = s->scratch;
+    int n = 1, pathC = 0, p = LIT_UNDEF;
+    int idx = s->trailSize - 1;
+    int nClear = 0;
+
+    do {
+        if (confl->learnt) bumpClause(s, confl);
+        for (int j = (p == LIT_UNDEF) ? 0 : 1; j < confl->size; j++) {
+            int q = confl->lits[j];
+            int v = litVar(q);
+            if (!s->seen[v] && s->level[v] > 0) {
+                bumpVar(s, v);
+                s->seen[v] = 1;
+                s->toClear[nClear++] = v;
+                if (s->level[v] >= decisionLevel(s)) pathC++;
+                else learnt[n++] = q;
+            }
+        }
+        while (!s->seen[litVar(s->trail[idx])]) idx--;
+        p = s->trail[idx--];
+        confl = s->reason[litVar(p)];
+        s->seen[litVar(p)] = 0;
+        pathC--;
+    } while (pathC > 0);
+    learnt[0] = p ^ 1;
+
+    // Local minimization: drop literals implied by the rest of the clause
+    int w = 1;
+    for (int i = 1; i < n; i++)
+        if (!isRedundant(s, learnt[i])) learnt[w++] = learnt[i];
+    n = w;
+
+    int btLevel = 0;
+    if (n > 1) {
+        int maxI = 1;
+        for (int i = 2; i < n; i++)
+            if (s->level[litVar(learnt[i])] > s->level[litVar(learnt[maxI])]) maxI = i;
+        int tmp = learnt[1]; learnt[1] = learnt[maxI]; learnt[maxI] = tmp;
+        btLevel = s->level[litVar(learnt[1])];
+    }
+
+    for (int i = 0; i < nClear; i++) s->seen[s->toClear[i]] = 0;
+    *outSize = n;
+    return btLevel;
+}
+
+/**
+ * @brief Collects the assumptions that imply ~p, where p is a falsified
+ *        assumption, by walking the trail backwards through reasons.
+ *
+ * Every decision on the trail at this point is an assumption, so the
+ * decisions reached from ~p form the failed set (together with p). ~p
+ * itself may be one of them, when the assumptions contain both p and ~p.
+ */
+static void analyzeFinal(Solver *s, int p) {
+    s->numFailed = 0;
+    s->failed[s->numFailed++] = toDimacs(p);
+    if (decisionLevel(s) == 0) return;
+
+    s->seen[litVar(p)] = 1;
+    for (int i = s->trailSize - 1; i >= s->trailLim[0]; i--) {
+        int v = litVar(s->trail[i]);
+        if (!s->seen[v]) continue;
+        Clause *r = s->reason[v];
+        if (r == NULL) {
+            s->failed[s->numFailed++] = toDimacs(s->trail[i]);
+        } else {
+            for (int j = 1; j < r->size; j++)
+                if (s->level[litVar(r->lits[j])] > 0) s->seen[litVar(r->lits[j])] = 1;
+        }
+        s->seen[v] = 0;
+    }
+    s->seen[litVar(p)] = 0;
+}
+
+// --- Search ---
+
+/**
+ * @brief Picks the most active unassigned variable with its saved phase.
+ * @return Literal to decide, or LIT_UNDEF if all variables are assigned.
+ */
+static int pickBranchLit(Solver *s) {
+    while (s->heapSize > 0) {
+        int v = heapRemoveMax(s);
+        if (s->assigns[v] < 0) return 2 * v + (s->polarity[v] ? 0 : 1);
+    }
+    return LIT_UNDEF;
+}
+
+static int budgetExhausted(const Solver *s) {
+    if (s->interrupt && *s->interrupt) return 1;
+    return s->conflictBudget >= 0 && s->conflicts >= s->budgetEnd;
+}
+
+/**
+ * @brief Runs CDCL until a result or until nofConflicts conflicts occur.
+ * @return SOLVER_SAT, SOLVER_UNSAT or SOLVER_UNKNOWN (restart or budget).
+ */
+static int search(Solver *s, int nofConflicts) {
+    int conflictC = 0;
+    for (;;) {
+        Clause *confl = propagate(s);
+        if (confl) {
+            s->conflicts++;
+            conflictC++;
+            if (decisionLevel(s) == 0) { s->ok = 0; return SOLVER_UNSAT; }
+
+            int n;
+            int btLevel = analyze(s, confl, &n);
+            cancelUntil(s, btLevel);
+            if (n == 1) {
+                enqueue(s, s->scratch[0], NULL);
+            } else {
+                Clause *c = attachNewClause(s, s->scratch, n, 1);
+                if (!c) return SOLVER_UNKNOWN;
+                bumpClause(s, c);
+                enqueue(s, s->scratch[0], c);
+            }
+            s->varInc /= VAR_DECAY;
+            s->claInc /= CLAUSE_DECAY;
+        } else {
+            if (conflictC >= nofConflicts || budgetExhausted(s)) {
+                cancelUntil(s, 0);
+                return SOLVER_UNKNOWN;
+            }
+            if (s->learnts.size - s->trailSize >= s->maxLearnts) reduceLearnts(s);
+
+            int next = LIT_UNDEF;
+            while (decisionLevel(s) < s->numAssumps) {
+                int a = s->assumps[decisionLevel(s)];
+                int val = litValue(s, a);
+                if (val == 1) {
+                    if (!newDecisionLevel(s)) return SOLVER_UNKNOWN;
+                } else if (val == 0) {
+                    analyzeFinal(s, a);
+                    return SOLVER_UNSAT;
+                } else {
+                    next = a;
+                    break;
+                }
+            }
+            if (next == LIT_UNDEF) {
+                next = pickBranchLit(s);
+                if (next == LIT_UNDEF) {
+                    for (int v = 0; v < s->numVars; v++) s->model[v] = s->assigns[v];
+                    return SOLVER_SAT;
+                }
+            }
+            if (!newDecisionLevel(s)) return SOLVER_UNKNOWN;
+            s->decisions++;
+            enqueue(s, next, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Finite Luby sequence value y^x scaled restart interval.
+ */
+static double luby(double y, int x) {
+    int size, seq;
+    for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1);
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    double r = 1.0;
+    while (seq-- > 0) r *= y;
+    return r;
+}
+
+// --- Public API ---
+
+/**
+ * @copydoc solverNew
+ */
+Solver *solverNew(int numVars) {
+    Solver *s = calloc(1, sizeof(Solver));
+    if (!s) { perror("calloc"); return NULL; }
+    s->ok = 1;
+    s->varInc = 1.0;
+    s->claInc = 1.0;
+    s->conflictBudget = -1;
+    s->maxLearnts = 5000;
+    if (!ensureVars(s, numVars > 0 ? numVars : 1)) {
+        solverFree(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * @copydoc solverFromFormula
+ */
+Solver *solverFromFormula(const CnfFormula *f) {
+    Solver *s = solverNew(f->numVars);
+    if (!s) return NULL;
+    for (int i = 0; i < f->numClauses; i++)
+        if (!solverAddClause(s, cnfClause(f, i), cnfClauseSize(f, i))) break;
+    if (s->maxLearnts < f->numClauses / 3.0) s->maxLearnts = f->numClauses / 3.0;
+    return s;
+}
+
+/**
+ * @copydoc solverFree
+ */
+void solverFree(Solver *s) {
+    if (!s) return;
+    for (int i = 0; i < s->clauses.size; i++) free(s->clauses.data[i]);
+    for (int i = 0; i < s->learnts.size; i++) free(s->learnts.data[i]);
+    free(s->clauses.data);
+    free(s->learnts.data);
+    for (int l = 0; l < 2 * s->varCap; l++) free(s->watches[l].w);
+    free(s->watches);
+    free(s->assigns);
+    free(s->polarity);
+    free(s->model);
+    free(s->level);
+    free(s->reason);
+    free(s->seen);
+    free(s->trail);
+    free(s->trailLim);
+    free(s->activity);
+    free(s->heap);
+    free(s->heapIdx);
+    free(s->assumps);
+    free(s->scratch);
+    free(s->toClear);
+    free(s->failed);
+    free(s);
+}
+
+/**
+ * @copydoc solverAddClause
+ */
+int solverAddClause(Solver *s, const int *lits, int n) {
+    if (!s->ok) return 0;
+    cancelUntil(s, 0);
+
+    int maxVar = 0;
+    for (int i = 0; i < n; i++) {
+        int v = lits[i] > 0 ? lits[i] : -lits[i];
+        if (v > maxVar) maxVar = v;
+    }
+    if (!ensureVars(s, maxVar)) return 0;
+
+    // Translate, drop false/duplicate literals, detect satisfied clauses
+    int *c = s->scratch;
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        int l = toLit(lits[i]);
+        int val = litValue(s, l);
+        if (val == 1) return 1;
+        if (val == 0) continue;
+        int dup = 0;
+        for (int k = 0; k < m; k++) {
+            if (c[k] == l) { dup = 1; break; }
+            if (c[k] == (l ^ 1)) return 1;
+        }
+        if (!dup) c[m++] = l;
+    }
+
+    if (m == 0) { s->ok = 0; return 0; }
+    if (m == 1) {
+        enqueue(s, c[0], NULL);
+        if (propagate(s)) { s->ok = 0; return 0; }
+        return 1;
+    }
+    if (!attachNewClause(s, c, m, 0)) { s->ok = 0; return 0; }
+    return 1;
+}
+
+/**
+ * @copydoc solverSolve
+ */
+int solverSolve(Solver *s, const int *assumptions, int n) {
+    s->solves++;
+    s->numFailed = 0;
+    if (!s->ok) return SOLVER_UNSAT;
+    cancelUntil(s, 0);
+
+    if (n > s->assumpCap) {
+        int *na = realloc(s->assumps, (size_t)n * sizeof(int));
+        if (!na) { perror("realloc"); return SOLVER_UNKNOWN; }
+        s->assumps = na;
+        s->assumpCap = n;
+    }
+    for (int i = 0; i < n; i++) {
+        int v = assumptions[i] > 0 ? assumptions[i] : -assumptions[i];
+        if (!ensureVars(s, v)) return SOLVER_UNKNOWN;
+        s->assumps[i] = toLit(assumptions[i]);
+    }
+    s->numAssumps = n;
+    s->budgetEnd = s->conflicts + s->conflictBudget;
+
+    int status = SOLVER_UNKNOWN;
+    for (int restarts = 0; status == SOLVER_UNKNOWN; restarts++) {
+        status = search(s, (int)(luby(2.0, restarts) * RESTART_BASE));
+        if (status == SOLVER_UNKNOWN && budgetExhausted(s)) break;
+        s->maxLearnts *= LEARNT_GROWTH;
+    }
+
+    cancelUntil(s, 0);
+    s->numAssumps = 0;
+    return status;
+}
+
+/**
+ * @copydoc solverModelValue
+ */
+int solverModelValue(const Solver *s, int var) {
+    if (var < 1 || var > s->numVars) return 0;
+    return s->model[var - 1] == 1;
+}
+
+/**
+ * @copydoc solverFailedAssumptions
+ */
+int solverFailedAssumptions(const Solver *s, const int **out) {
+    *out = s->failed;
+    return s->numFailed;
+}
+
+/**
+ * @copydoc solverIsFailed
+ */
+int solverIsFailed(const Solver *s, int lit) {
+    for (int i = 0; i < s->numFailed; i++)
+        if (s->failed[i] == lit) return 1;
+    return 0;
+}
+
+/**
+ * @copydoc solverNewVar
+ */
+int solverNewVar(Solver *s) {
+    return ensureVars(s, s->numVars + 1) ? s->numVars : 0;
+}
+
+/**
+ * @copydoc solverGetStats
+ */
+SolverStats solverGetStats(const Solver *s) {
+    SolverStats st;
+    st.solves = s->solves;
+    st.conflicts = s->conflicts;
+    st.decisions = s->decisions;
+    st.propagations = s->propagations;
+    st.learnts = s->learnts.size;
+    st.clauses = s->clauses.size;
+    return st;
+}
+
+/**
+ * @copydoc solverNumVars
+ */
+int solverNumVars(const Solver *s) {
+    return s->numVars;
+}
+
+/**
+ * @copydoc solverSetConflictBudget
+ */
+void solverSetConflictBudget(Solver *s, long long conflicts) {
+    s->conflictBudget = conflicts;
+}
+
+/**
+ * @copydoc solverSetInterrupt
+ */
+void solverSetInterrupt(Solver *s, volatile int *flag) {
+    s->interrupt = flag;
+}
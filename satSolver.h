@@ -0,0 +1,132 @@
+/**
+ * @file satSolver.h
+ * @brief Header for the CDCL SAT solver.
+ */
+
+#ifndef SAT_SOLVER_H
+#define SAT_SOLVER_H
+
+#include "cnfFormula.h"
+
+#define SOLVER_UNKNOWN 0   /**< Budget exhausted or interrupted */
+#define SOLVER_SAT 10      /**< Satisfiable (DIMACS exit code convention) */
+#define SOLVER_UNSAT 20    /**< Unsatisfiable */
+
+/**
+ * @brief Cumulative search counters of a solver handle.
+ */
+typedef struct {
+    long long solves;        /**< solverSolve calls */
+    long long conflicts;     /**< Conflicts analyzed */
+    long long decisions;     /**< Branching decisions (including assumptions) */
+    long long propagations;  /**< Literals propagated */
+    int learnts;             /**< Learned clauses currently kept */
+    int clauses;             /**< Original clauses currently kept */
+} SolverStats;
+
+/**
+ * @brief Opaque solver handle.
+ *
+ * Clauses, learned clauses, variable activities and watch lists live in
+ * the handle and survive between solverSolve calls, so one handle can
+ * answer many queries under different assumptions.
+ */
+typedef struct Solver Solver;
+
+/**
+ * @brief Creates an empty solver.
+ * @param numVars Initial number of variables (more are added on demand).
+ * @return New solver, or NULL on malloc failure.
+ */
+Solver *solverNew(int numVars);
+
+/**
+ * @brief Creates a solver loaded with every clause of a formula.
+ * @param f Parsed CNF formula.
+ * @return New solver, or NULL on malloc failure.
+ */
+Solver *solverFromFormula(const CnfFormula *f);
+
+/**
+ * @brief Frees a solver and all its clauses.
+ */
+void solverFree(Solver *s);
+
+/**
+ * @brief Adds a clause of DIMACS literals.
+ *
+ * Variables beyond the current count are created automatically.
+ *
+ * @param s Solver.
+ * @param lits Literals (non-zero ints).
+ * @param n Number of literals.
+ * @return 0 if the clause set is now trivially unsatisfiable, 1 otherwise.
+ */
+int solverAddClause(Solver *s, const int *lits, int n);
+
+/**
+ * @brief Decides satisfiability under a set of assumption literals.
+ *
+ * Assumptions hold only for this call. The search stops early with
+ * SOLVER_UNKNOWN when the conflict budget runs out or the interrupt
+ * flag is raised.
+ *
+ * @param s Solver.
+ * @param assumptions DIMACS literals assumed true (may be NULL).
+ * @param n Number of assumptions.
+ * @return SOLVER_SAT, SOLVER_UNSAT or SOLVER_UNKNOWN.
+ */
+int solverSolve(Solver *s, const int *assumptions, int n);
+
+/**
+ * @brief Value of a variable in the last satisfying assignment.
+ * @return 1 for true, 0 for false.
+ */
+int solverModelValue(const Solver *s, int var);
+
+/**
+ * @brief Assumptions responsible for the last SOLVER_UNSAT answer.
+ *
+ * The returned literals are a subset of the last call's assumptions whose
+ * conjunction is already inconsistent with the clause set. The set is
+ * empty when the clauses are unsatisfiable without any assumptions.
+ *
+ * @param s Solver.
+ * @param out Receives a pointer to the literals (valid until the next call).
+ * @return Number of failed assumptions.
+ */
+int solverFailedAssumptions(const Solver *s, const int **out);
+
+/**
+ * @brief Checks whether an assumption is in the last failed set.
+ * @return 1 if lit is a failed assumption, 0 otherwise.
+ */
+int solverIsFailed(const Solver *s, int lit);
+
+/**
+ * @brief Creates a fresh variable.
+ * @return Its DIMACS index, or 0 on malloc failure.
+ */
+int solverNewVar(Solver *s);
+
+/**
+ * @brief Current search counters.
+ */
+SolverStats solverGetStats(const Solver *s);
+
+/**
+ * @brief Number of variables currently known to the solver.
+ */
+int solverNumVars(const Solver *s);
+
+/**
+ * @brief Limits the conflicts spent by each solverSolve call (<0: no limit).
+ */
+void solverSetConflictBudget(Solver *s, long long conflicts);
+
+/**
+ * @brief Points the solver at a shared flag; a non-zero value stops search.
+ */
+void solverSetInterrupt(Solver *s, volatile int *flag);
+
+#endif
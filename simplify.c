@@ -0,0 +1,379 @@
+/**
+ * @file simplify.c
+ * @brief Boolean simplification of parse trees before Tasks 5 and 6.
+ *
+ * Redundancy such as A * A, A + ~A or A * (A + B) costs the truth table a
+ * factor of two per spurious variable and costs distributeOr far more.
+ * The tree is rebuilt bottom-up through smart constructors that apply the
+ * local rules as each subterm is made, then rebuilt again until a round
+ * changes nothing.
+ * @section algo Algorithm: Hash-consed normalization
+ *   - Terms (constants, variables, ~, n-ary * and +) are interned in an
+ *     open-addressing table, so equal subterms share one id and equality
+ *     is an integer comparison
+ *   - * and + absorb nested operators of the same kind, drop their unit,
+ *     collapse on their zero, sort and deduplicate operand ids, and use
+ *     binary search for complements (A, ~A) and absorption (A, A + B)
+ *   - The result is written back as a balanced binary tree
+ * @section time Time Complexity: O(n log n) per round, usually two rounds
+ * @section space Space Complexity: O(n) terms, O(h) recursion
+ */
+
+#include "simplify.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+typedef enum { TERM_CONST, TERM_VAR, TERM_NOT, TERM_AND, TERM_OR } TermKind;
+
+/** Ids of the two constants, interned first. */
+#define TERM_FALSE 0
+#define TERM_TRUE 1
+
+/**
+ * @brief One interned subterm; its operand ids live in the bank's pool.
+ */
+typedef struct {
+    TermKind kind;
+    int numKids;
+    size_t first;          /**< Index of the first operand in pool */
+    const char *name;      /**< Variable or constant token, else NULL */
+    uint64_t hash;
+} Term;
+
+/**
+ * @brief Every term of one simplification, with its hash-consing table.
+ */
+typedef struct {
+    Term *terms;
+    int count, cap;
+    int *pool;
+    size_t poolLen, poolCap;
+    int *slots;            /**< Term id + 1, 0 for an empty slot */
+    size_t numSlots;
+    int *scratch;
+    size_t scratchCap;
+    int failed;
+} TermBank;
+
+/**
+ * @copydoc constantValue
+ */
+int constantValue(const char *tok) {
+    if (tok && tok[0] == '1' && tok[1] == '\0') return 1;
+    if (tok && tok[0] == '0' && tok[1] == '\0') return 0;
+    return -1;
+}
+
+static const int *termKids(const TermBank *b, int id) {
+    return b->pool + b->terms[id].first;
+}
+
+static uint64_t hashTerm(TermKind kind, const int *kids, int n, const char *name) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ (uint64_t)kind;
+    for (int i = 0; i < n; i++) h = (h ^ (uint32_t)kids[i]) * 0x100000001b3ULL;
+    for (const char *p = name; p && *p; p++) h = (h ^ (unsigned char)*p) * 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+static int sameTerm(const TermBank *b, int id, TermKind kind, const int *kids, int n, const char *name) {
+    const Term *t = &b->terms[id];
+    if (t->kind != kind || t->numKids != n) return 0;
+    if (n && memcmp(termKids(b, id), kids, (size_t)n * sizeof(int)) != 0) return 0;
+    return name ? strcmp(t->name, name) == 0 : 1;
+}
+
+static int growSlots(TermBank *b) {
+    size_t n = b->numSlots ? b->numSlots * 2 : 1024;
+    int *slots = calloc(n, sizeof(int));
+    if (!slots) { perror("calloc"); return 0; }
+    for (int id = 0; id < b->count; id++) {
+        size_t i = b->terms[id].hash & (n - 1);
+        while (slots[i]) i = (i + 1) & (n - 1);
+        slots[i] = id + 1;
+    }
+    free(b->slots);
+    b->slots = slots;
+    b->numSlots = n;
+    return 1;
+}
+
+/**
+ * @brief Returns the id of a term, creating it if it is new. kids must
+ *        not point into the pool, which may move.
+ */
+static int intern(TermBank *b, TermKind kind, const int *kids, int n, const char *name) {
+    if (b->failed) return TERM_FALSE;
+    uint64_t h = hashTerm(kind, kids, n, name);
+    size_t mask = b->numSlots - 1, i = h & mask;
+    for (; b->slots[i]; i = (i + 1) & mask) {
+        int id = b->slots[i] - 1;
+        if (b->terms[id].hash == h && sameTerm(b, id, kind, kids, n, name)) return id;
+    }
+
+    if (b->count == b->cap) {
+        int ncap = b->cap ? b->cap * 2 : 256;
+        Term *nt = realloc(b->terms, (size_t)ncap * sizeof(Term));
+        if (!nt) { perror("realloc"); b->failed = 1; return TERM_FALSE; }
+        b->terms = nt;
+        b->cap = ncap;
+    }
+    if (b->poolLen + (size_t)n > b->poolCap) {
+        size_t ncap = b->poolCap ? b->poolCap * 2 : 1024;
+        while (ncap < b->poolLen + (size_t)n) ncap *= 2;
+        int *np = realloc(b->pool, ncap * sizeof(int));
+        if (!np) { perror("realloc"); b->failed = 1; return TERM_FALSE; }
+        b->pool = np;
+        b->poolCap = ncap;
+    }
+    int id = b->count++;
+    Term *t = &b->terms[id];
+    t->kind = kind;
+    t->numKids = n;
+    t->first = b->poolLen;
+    t->name = name;
+    t->hash = h;
+    if (n) memcpy(b->pool + b->poolLen, kids, (size_t)n * sizeof(int));
+    b->poolLen += (size_t)n;
+    b->slots[i] = id + 1;
+    if ((size_t)b->count * 2 > b->numSlots && !growSlots(b)) b->failed = 1;
+    return id;
+}
+
+static int makeNot(TermBank *b, int a) {
+    if (a == TERM_TRUE) return TERM_FALSE;
+    if (a == TERM_FALSE) return TERM_TRUE;
+    if (b->terms[a].kind == TERM_NOT) return termKids(b, a)[0];
+    return intern(b, TERM_NOT, &a, 1, NULL);
+}
+
+static int compareIds(const void *x, const void *y) {
+    int a = *(const int *)x, c = *(const int *)y;
+    return (a > c) - (a < c);
+}
+
+static int containsId(const int *sorted, int n, int id) {
+    return bsearch(&id, sorted, (size_t)n, sizeof(int), compareIds) != NULL;
+}
+
+/**
+ * @brief Builds the normalized conjunction (TERM_AND) or disjunction
+ *        (TERM_OR) of already normalized operands.
+ */
+static int makeNary(TermBank *b, TermKind kind, const int *kids, int n) {
+    int unit = kind == TERM_AND ? TERM_TRUE : TERM_FALSE;
+    int zero = kind == TERM_AND ? TERM_FALSE : TERM_TRUE;
+    TermKind dual = kind == TERM_AND ? TERM_OR : TERM_AND;
+
+    size_t need = 0;
+    for (int i = 0; i < n; i++) {
+        if (kids[i] == zero) return zero;
+        need += b->terms[kids[i]].kind == kind ? (size_t)b->terms[kids[i]].numKids : 1;
+    }
+    if (2 * need > b->scratchCap) {
+        int *ns = realloc(b->scratch, 2 * need * sizeof(int));
+        if (!ns) { perror("realloc"); b->failed = 1; return TERM_FALSE; }
+        b->scratch = ns;
+        b->scratchCap = 2 * need;
+    }
+
+    // flatten, then sort and deduplicate (idempotence)
+    int *ops = b->scratch, len = 0;
+    for (int i = 0; i < n; i++) {
+        if (kids[i] == unit) continue;
+        if (b->terms[kids[i]].kind == kind) {
+            const int *sub = termKids(b, kids[i]);
+            for (int j = 0; j < b->terms[kids[i]].numKids; j++) ops[len++] = sub[j];
+        } else {
+            ops[len++] = kids[i];
+        }
+    }
+    qsort(ops, (size_t)len, sizeof(int), compareIds);
+    int unique = 0;
+    for (int i = 0; i < len; i++) {
+        if (unique == 0 || ops[unique - 1] != ops[i]) ops[unique++] = ops[i];
+    }
+    len = unique;
+
+    // complement: A and ~A together
+    for (int i = 0; i < len; i++) {
+        if (b->terms[ops[i]].kind == TERM_NOT && containsId(ops, len, termKids(b, ops[i])[0])) return zero;
+    }
+
+    // absorption: A * (A + B) drops the disjunction (dually for +); the
+    // operands of a dual term are never dual themselves, so none of the
+    // terms that absorb can be dropped
+    int *kept = ops + len, numKept = 0;
+    for (int i = 0; i < len; i++) {
+        int absorbed = 0;
+        if (b->terms[ops[i]].kind == dual) {
+            const int *sub = termKids(b, ops[i]);
+            for (int j = 0; j < b->terms[ops[i]].numKids && !absorbed; j++)
+                absorbed = containsId(ops, len, sub[j]);
+        }
+        if (!absorbed) kept[numKept++] = ops[i];
+    }
+
+    if (numKept == 0) return unit;
+    if (numKept == 1) return kept[0];
+    return intern(b, kind, kept, numKept, NULL);
+}
+
+/**
+ * @brief Interns a parse tree; returns -1 if it is malformed.
+ */
+static int termFromTree(TermBank *b, const Node *n) {
+    if (!n || !n->tok) return -1;
+    if (!n->left && !n->right) {
+        int c = constantValue(n->tok);
+        if (c >= 0) return c ? TERM_TRUE : TERM_FALSE;
+        return intern(b, TERM_VAR, NULL, 0, n->tok);
+    }
+    if (strcmp(n->tok, "~") == 0) {
+        int x = termFromTree(b, n->right);
+        return x < 0 ? -1 : makeNot(b, x);
+    }
+    if (strcmp(n->tok, ">") == 0) {
+        int l = termFromTree(b, n->left);
+        int r = l < 0 ? -1 : termFromTree(b, n->right);
+        if (r < 0) return -1;
+        int kids[2] = { makeNot(b, l), r };
+        return makeNary(b, TERM_OR, kids, 2);
+    }
+    if (strcmp(n->tok, "*") != 0 && strcmp(n->tok, "+") != 0) return -1;
+
+    // Gather the whole run of the same operator first: folding it two
+    // operands at a time would re-flatten the growing term at every step
+    int cap = 16, numOps = 0, depth = 0;
+    const Node **stack = malloc((size_t)cap * sizeof(Node *));
+    int *kids = malloc((size_t)cap * sizeof(int));
+    if (!stack || !kids) { perror("malloc"); free(stack); free(kids); b->failed = 1; return -1; }
+    stack[depth++] = n;
+    int ok = 1;
+    while (ok && depth > 0) {
+        const Node *m = stack[--depth];
+        if (m->tok && strcmp(m->tok, n->tok) == 0 && m->left && m->right) {
+            if (depth + 2 > cap || numOps + 2 > cap) {
+                cap *= 2;
+                const Node **ns = realloc(stack, (size_t)cap * sizeof(Node *));
+                if (ns) stack = ns;
+                int *nk = ns ? realloc(kids, (size_t)cap * sizeof(int)) : NULL;
+                if (nk) kids = nk;
+                if (!ns || !nk) { perror("realloc"); b->failed = 1; ok = 0; break; }
+            }
+            stack[depth++] = m->right;
+            stack[depth++] = m->left;
+        } else {
+            int t = termFromTree(b, m);
+            if (t < 0) ok = 0;
+            else kids[numOps++] = t;
+        }
+    }
+    int result = ok ? makeNary(b, n->tok[0] == '*' ? TERM_AND : TERM_OR, kids, numOps) : -1;
+    free(stack);
+    free(kids);
+    return result;
+}
+
+/**
+ * @brief One rewriting round: rebuilds a term from its rebuilt operands.
+ *        memo covers the ids that existed when the round started.
+ */
+static int rebuildTerm(TermBank *b, int id, int *memo) {
+    if (memo[id] >= 0) return memo[id];
+    const Term *t = &b->terms[id];
+    int result = id;
+    if (t->kind == TERM_NOT) {
+        result = makeNot(b, rebuildTerm(b, termKids(b, id)[0], memo));
+    } else if (t->kind == TERM_AND || t->kind == TERM_OR) {
+        TermKind kind = t->kind;
+        int n = t->numKids;
+        int *kids = malloc((size_t)n * sizeof(int));
+        if (!kids) { perror("malloc"); b->failed = 1; return id; }
+        memcpy(kids, termKids(b, id), (size_t)n * sizeof(int));
+        for (int i = 0; i < n; i++) kids[i] = rebuildTerm(b, kids[i], memo);
+        result = makeNary(b, kind, kids, n);
+        free(kids);
+    }
+    memo[id] = result;
+    return result;
+}
+
+static Node *treeFromTerm(const TermBank *b, int id);
+
+/**
+ * @brief Balanced binary tree over operands kids[lo .. hi).
+ */
+static Node *treeFromRange(const TermBank *b, const char *op, const int *kids, int lo, int hi) {
+    if (hi - lo == 1) return treeFromTerm(b, kids[lo]);
+    int mid = lo + (hi - lo) / 2;
+    Node *n = newNode(op);
+    if (!n) return NULL;
+    n->left = treeFromRange(b, op, kids, lo, mid);
+    n->right = n->left ? treeFromRange(b, op, kids, mid, hi) : NULL;
+    if (!n->right) {
+        freeTree(n);
+        return NULL;
+    }
+    return n;
+}
+
+static Node *treeFromTerm(const TermBank *b, int id) {
+    const Term *t = &b->terms[id];
+    if (t->kind == TERM_CONST || t->kind == TERM_VAR) return newNode(t->name);
+    if (t->kind == TERM_NOT) {
+        Node *n = newNode("~");
+        if (!n) return NULL;
+        n->right = treeFromTerm(b, termKids(b, id)[0]);
+        if (!n->right) {
+            freeTree(n);
+            return NULL;
+        }
+        return n;
+    }
+    return treeFromRange(b, t->kind == TERM_AND ? "*" : "+", termKids(b, id), 0, t->numKids);
+}
+
+static long countTreeNodes(const Node *n) {
+    return n ? 1 + countTreeNodes(n->left) + countTreeNodes(n->right) : 0;
+}
+
+/** Rounds after the first before giving up on reaching the fixpoint. */
+#define MAX_ROUNDS 16
+
+/**
+ * @copydoc simplifyFormula
+ */
+Node *simplifyFormula(const Node *root, SimplifyStats *stats) {
+    TermBank b;
+    memset(&b, 0, sizeof b);
+    if (!growSlots(&b)) return NULL;
+    intern(&b, TERM_CONST, NULL, 0, "0");
+    intern(&b, TERM_CONST, NULL, 0, "1");
+
+    int top = termFromTree(&b, root), rounds = 1;
+    while (top >= 0 && !b.failed && rounds < MAX_ROUNDS) {
+        int *memo = malloc((size_t)b.count * sizeof(int));
+        if (!memo) { perror("malloc"); b.failed = 1; break; }
+        for (int i = 0; i < b.count; i++) memo[i] = -1;
+        int next = rebuildTerm(&b, top, memo);
+        free(memo);
+        rounds++;
+        if (next == top) break;
+        top = next;
+    }
+
+    Node *result = top >= 0 && !b.failed ? treeFromTerm(&b, top) : NULL;
+    if (stats) {
+        stats->nodesBefore = countTreeNodes(root);
+        stats->nodesAfter = countTreeNodes(result);
+        stats->terms = b.count;
+        stats->rounds = rounds;
+    }
+    free(b.terms);
+    free(b.pool);
+    free(b.slots);
+    free(b.scratch);
+    return result;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file simplify.h
+ * @brief Header for the Boolean simplification pass over parse trees.
+ */
+
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include "common.h"
+
+/**
+ * @brief Sizes before and after one simplification.
+ */
+typedef struct {
+    long nodesBefore;     /**< Nodes of the input tree */
+    long nodesAfter;      /**< Nodes of the simplified tree */
+    long terms;           /**< Distinct hash-consed subterms created */
+    int rounds;           /**< Rewriting rounds until the fixpoint */
+} SimplifyStats;
+
+/**
+ * @brief Returns the value of a constant leaf ("1" or "0"), or -1 for any
+ *        other token. Constants never come from the tokenizer, which only
+ *        accepts names starting with a letter; only simplifyFormula makes
+ *        them, and only as the whole formula.
+ */
+int constantValue(const char *tok);
+
+/**
+ * @brief Rewrites a formula into a smaller equivalent one.
+ *
+ * Implications become disjunctions, nested * and + are flattened with
+ * their operands sorted, and the rules below are applied until nothing
+ * changes:
+ *   - idempotence:  A * A = A,  A + A = A
+ *   - complement:   A * ~A = 0, A + ~A = 1
+ *   - absorption:   A * (A + B) = A,  A + (A * B) = A
+ *   - constants:    A * 1 = A, A * 0 = 0, A + 0 = A, A + 1 = 1, ~0 = 1
+ *   - double negation: ~~A = A
+ * The result is either free of constants or a single "1" / "0" leaf.
+ *
+ * @param root Formula to simplify (not modified).
+ * @param stats Sizes and rounds (may be NULL).
+ * @return New tree (free with freeTree), or NULL if the tree is malformed
+ *         or memory runs out.
+ */
+Node *simplifyFormula(const Node *root, SimplifyStats *stats);
+
+#endif
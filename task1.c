@@ -18,38 +18,41 @@
 #include <ctype.h>
 #include "common.h"
 
-#define MAX_TOKENS 8192
-#define MAX_TOKEN_LEN 64
-
-// --- Stack for string tokens ---
-static char* stack[MAX_TOKENS];
-static int top = -1;
+/**
+ * @brief Token stack of the shunting-yard pass; one per call, so
+ *        concurrent conversions share nothing.
+ */
+typedef struct {
+    char** items;
+    int top;
+} TokenStack;
 
 /**
- * @brief Pushes a token onto the stack.
+ * @brief Pushes a token onto the stack (sized for every token up front).
+ * @param st The stack.
  * @param s The string token to push.
  */
-static void stackPush(char* s) {
-    if (top < MAX_TOKENS - 1) {
-        stack[++top] = s;
-    }
+static void stackPush(TokenStack* st, char* s) {
+    st->items[++st->top] = s;
 }
 
 /**
  * @brief Pops a token from the stack.
+ * @param st The stack.
  * @return Pointer to the popped string token, or NULL if empty.
  */
-static char* stackPop() {
-    if (top == -1) return NULL;
-    return stack[top--];
+static char* stackPop(TokenStack* st) {
+    if (st->top == -1) return NULL;
+    return st->items[st->top--];
 }
 
 /**
  * @brief Checks if the stack is empty.
+ * @param st The stack.
  * @return 1 if empty, 0 otherwise.
  */
-static int stackIsEmpty() {
-    return top == -1;
+static int stackIsEmpty(const TokenStack* st) {
+    return st->top == -1;
 }
 
 /**
@@ -79,28 +82,31 @@ static int isAtom(const char* tok) {
  * @brief Tokenizes the infix string into an array of tokens.
  * @param input Input infix expression string.
  * @param tokens Output array of string pointers.
+ * @param maxTokens Capacity of tokens.
  * @return Number of tokens parsed.
  */
-static int tokenize(const char* input, char* tokens[]) {
+static int tokenize(const char* input, char* tokens[], int maxTokens) {
     int count = 0;
     const char* p = input;
-    char buffer[MAX_TOKEN_LEN];
 
-    while (*p != '\0' && count < MAX_TOKENS) {
+    while (*p != '\0' && count < maxTokens) {
         while (isspace((unsigned char)*p)) p++;
         if (*p == '\0') break;
 
         if (strchr("()~*+>", *p)) {
-            buffer[0] = *p;
-            buffer[1] = '\0';
-            tokens[count++] = strdup_s(buffer);
+            char op[2] = { *p, '\0' };
+            tokens[count++] = strdup_s(op);
             p++;
         } else if (isalpha((unsigned char)*p)) {
-            int i = 0;
-            while (isalnum((unsigned char)*p) && i < MAX_TOKEN_LEN - 1)
-                buffer[i++] = *p++;
-            buffer[i] = '\0';
-            tokens[count++] = strdup_s(buffer);
+            size_t len = 0;
+            while (isalnum((unsigned char)p[len])) len++;
+            char* name = malloc(len + 1);
+            if (name) {
+                memcpy(name, p, len);
+                name[len] = '\0';
+            }
+            tokens[count++] = name;
+            p += len;
         } else {
             p++;
         }
@@ -114,12 +120,21 @@ static int tokenize(const char* input, char* tokens[]) {
  * @param outputToChar Output buffer for prefix expression.
  */
 void inFixToPreFix(char *input, char *outputToChar) {
-    char* tokens[MAX_TOKENS];
-    char* output[MAX_TOKENS];
+    // Every token consumes at least one input character
+    size_t maxTokens = strlen(input) + 1;
+    char** tokens = malloc(maxTokens * sizeof(char*));
+    char** output = malloc(maxTokens * sizeof(char*));
+    TokenStack st = { malloc(maxTokens * sizeof(char*)), -1 };
     int outputCounter = 0;
-    top = -1;
+    outputToChar[0] = '\0';
+    if (!tokens || !output || !st.items) {
+        free(tokens);
+        free(output);
+        free(st.items);
+        return;
+    }
 
-    int n = tokenize(input, tokens);
+    int n = tokenize(input, tokens, (int)maxTokens);
 
     // Reverse tokens
     for (int i = 0; i < n / 2; i++) {
@@ -146,30 +161,36 @@ void inFixToPreFix(char *input, char *outputToChar) {
         if (isAtom(tok)) {
             output[outputCounter++] = tok;
         } else if (strcmp(tok, "(") == 0) {
-            stackPush(tok);
+            stackPush(&st, tok);
         } else if (strcmp(tok, ")") == 0) {
-            while (!stackIsEmpty() && strcmp(stack[top], "(") != 0)
-                output[outputCounter++] = stackPop();
-            if (!stackIsEmpty()) stackPop();
+            while (!stackIsEmpty(&st) && strcmp(st.items[st.top], "(") != 0)
+                output[outputCounter++] = stackPop(&st);
+            if (!stackIsEmpty(&st)) stackPop(&st);
         } else {
-            while (!stackIsEmpty() && strcmp(stack[top], "(") != 0 &&
-                   priority(stack[top]) >= priority(tok))
-                output[outputCounter++] = stackPop();
-            stackPush(tok);
+            while (!stackIsEmpty(&st) && strcmp(st.items[st.top], "(") != 0 &&
+                   priority(st.items[st.top]) >= priority(tok))
+                output[outputCounter++] = stackPop(&st);
+            stackPush(&st, tok);
         }
     }
 
-    while (!stackIsEmpty()) {
-        output[outputCounter++] = stackPop();
+    while (!stackIsEmpty(&st)) {
+        output[outputCounter++] = stackPop(&st);
     }
 
-    // Build prefix string
-    outputToChar[0] = '\0';
+    // Build prefix string (appending at the end, not via strcat, keeps this linear)
+    char* end = outputToChar;
     for (int i = outputCounter - 1; i >= 0; i--) {
-        strcat(outputToChar, output[i]);
-        strcat(outputToChar, " ");
+        size_t len = strlen(output[i]);
+        memcpy(end, output[i], len);
+        end[len] = ' ';
+        end += len + 1;
     }
+    *end = '\0';
 
     // Cleanup
     for (int i = 0; i < n; i++) free(tokens[i]);
+    free(tokens);
+    free(output);
+    free(st.items);
 }
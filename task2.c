@@ -12,15 +12,15 @@
  *   - Worst case: O(n) for skewed trees
  */
 
-#include "common.h"
+#define _POSIX_C_SOURCE 200809L
+
+#include "task2.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-#define MAX_TOKENS 8192
-
-static Node* buildTreeRecursive(char* tokens[], int* index);
+static Node* buildTreeRecursive(char* tokens[], int* index, TreeStats* st, SubtreeStats* sum);
 
 /**
  * @brief Checks whether a token is a binary operator.
@@ -37,30 +37,52 @@ static int isBinaryOperator(const char* tok) {
  * @param prefixString Input prefix string.
  */
 void convertPreOrderToTree(Node **root, char *prefixString) {
-    char* tokens[MAX_TOKENS];
+    convertPreOrderToTreeWithStats(root, prefixString, NULL);
+}
+
+/**
+ * @copydoc convertPreOrderToTreeWithStats
+ */
+void convertPreOrderToTreeWithStats(Node **root, char *prefixString, TreeStats *st) {
+    if (st) treeStatsInit(st);
+    // Tokens are separated by whitespace, so there are at most len/2 + 1
+    size_t maxTokens = strlen(prefixString) / 2 + 2;
+    char** tokens = malloc(maxTokens * sizeof(char*));
     int tokenCount = 0;
 
     char* buffer = strdup_s(prefixString);
-    char* tok = strtok(buffer, " \t\n");
-    while (tok != NULL && tokenCount < MAX_TOKENS) {
+    if (!tokens || !buffer) {
+        free(tokens);
+        free(buffer);
+        *root = NULL;
+        return;
+    }
+    char* save = NULL;
+    char* tok = strtok_r(buffer, " \t\n", &save);
+    while (tok != NULL && tokenCount < (int)maxTokens - 1) {
         tokens[tokenCount++] = tok;
-        tok = strtok(NULL, " \t\n");
+        tok = strtok_r(NULL, " \t\n", &save);
     }
     tokens[tokenCount] = NULL;
 
     int index = 0;
-    *root = buildTreeRecursive(tokens, &index);
+    SubtreeStats sum;
+    *root = buildTreeRecursive(tokens, &index, st, &sum);
+    if (st) treeStatsFinish(st, *root ? &sum : NULL);
 
     free(buffer);
+    free(tokens);
 }
 
 /**
  * @brief Recursively builds parse tree from prefix tokens.
  * @param tokens Array of tokens.
  * @param index Pointer to current token index.
+ * @param st Statistics to account the new nodes in (may be NULL).
+ * @param sum Output: summary of the new subtree (used only with st).
  * @return Pointer to the newly constructed node.
  */
-static Node* buildTreeRecursive(char* tokens[], int* index) {
+static Node* buildTreeRecursive(char* tokens[], int* index, TreeStats* st, SubtreeStats* sum) {
     char* currentToken = tokens[*index];
     (*index)++;
 
@@ -68,12 +90,17 @@ static Node* buildTreeRecursive(char* tokens[], int* index) {
 
     Node* node = newNode(currentToken);
 
+    SubtreeStats l, r;
     if (strcmp(currentToken, "~") == 0) {
         node->left = NULL;
-        node->right = buildTreeRecursive(tokens, index);
+        node->right = buildTreeRecursive(tokens, index, st, &r);
+        if (st) treeStatsNode(st, currentToken, NULL, node->right ? &r : NULL, sum);
     } else if (isBinaryOperator(currentToken)) {
-        node->left = buildTreeRecursive(tokens, index);
-        node->right = buildTreeRecursive(tokens, index);
+        node->left = buildTreeRecursive(tokens, index, st, &l);
+        node->right = buildTreeRecursive(tokens, index, st, &r);
+        if (st) treeStatsNode(st, currentToken, node->left ? &l : NULL, node->right ? &r : NULL, sum);
+    } else if (st) {
+        treeStatsLeaf(st, currentToken, sum);
     }
     return node;
 }
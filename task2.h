@@ -7,6 +7,7 @@
 #define TASK2_H
 
 #include "common.h"
+#include "treeStats.h"
 
 /**
  * @brief Converts prefix expression string into a parse tree.
@@ -15,6 +16,15 @@
  */
 void convertPreOrderToTree(Node **root, char *start);
 
+/**
+ * @brief Converts a prefix expression into a parse tree and gathers its
+ *        statistics (height, sizes, variables, clauses) in the same pass.
+ * @param root Pointer to root node pointer.
+ * @param start Input prefix string.
+ * @param st Output: statistics (free with freeTreeStats), or NULL.
+ */
+void convertPreOrderToTreeWithStats(Node **root, char *start, TreeStats *st);
+
 /**
  * @brief Prints preorder traversal of parse tree.
  * @param root Root node.
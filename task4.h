@@ -1,8 +1,12 @@
 #ifndef TASK4_H
 #define TASK4_H
 
+#include <stdio.h>
 #include "common.h"
+#include "treeStats.h"
 
-void printTruthTable(Node *root);
+void printTruthTable(Node *root, const TreeStats *stats);
+void collectVariables(Node *root, char *vars[], int *varCount);
+void printAndSaveTable(Node *root, char *vars[], int varCount, FILE *file);
 
 #endif
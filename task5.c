@@ -21,6 +21,10 @@
  */
 #include "task2.h"  // for printInOrder
 #include "common.h"
+#include "instrument.h"
+#include "simplify.h"
+#include "truthBitmap.h"
+#include "treeStats.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,26 +48,36 @@ void printAndSaveTable(Node* root, char* vars[], int varCount, FILE* file);
 /**
  * @brief Main entry point for truth table generation.
  *
- * Collects all unique variables, computes truth values for all possible
- * combinations, and prints or saves the table.
+ * Takes the variables from the tree's statistics, computes truth values
+ * for all possible combinations, and prints or saves the table.
  *
  * @param root Root node of the parse tree.
+ * @param stats Statistics of root (e.g. from convertPreOrderToTreeWithStats),
+ *        or NULL to gather them here in one traversal.
  */
-void printTruthTable(Node *root) {
+void printTruthTable(Node *root, const TreeStats *stats) {
     if (!root) {
         printf("Error: Cannot generate truth table for an empty formula.\n");
         return;
     }
 
-    char* variables[2048];
-    int varCount = 0;
-    collectVariables(root, variables, &varCount);
+    TreeStats own;
+    if (!stats) {
+        if (!computeTreeStats(root, &own)) {
+            freeTreeStats(&own);
+            return;
+        }
+        stats = &own;
+    }
+    char** variables = stats->vars.names;
+    int varCount = stats->vars.count;
 
     if (varCount == 0) {
         printf("No variables found in formula.\n");
         TruthAssignment assignments[1];
         int result = evaluateFormula(root, assignments, 0);
         printf("\nResult of constant formula: %s\n", result ? "T" : "F");
+        if (stats == &own) freeTreeStats(&own);
         return;
     }
 
@@ -73,10 +87,12 @@ void printTruthTable(Node *root) {
         printf("Warning: %d variables will generate %lld rows.\n", varCount, numRows);
         printf("Proceed? (y/n): ");
         char choice = 'n';
+        phasePause();
         while (getchar() != '\n');
         scanf(" %c", &choice);
+        phaseResume();
         if (choice != 'y' && choice != 'Y') {
-            for (int i = 0; i < varCount; i++) free(variables[i]);
+            if (stats == &own) freeTreeStats(&own);
             return;
         }
     }
@@ -85,15 +101,23 @@ void printTruthTable(Node *root) {
 
     printf("\nDo you want to save the truth table to a file? (y/n): ");
     char saveChoice = 'n';
+    phasePause();
     while (getchar() != '\n');
     scanf(" %c", &saveChoice);
+    phaseResume();
 
     if (saveChoice == 'y' || saveChoice == 'Y') {
         char filename[256];
-        printf("Enter filename: ");
+        printf("Enter filename (*.ttb for a packed bitmap): ");
+        phasePause();
         scanf("%255s", filename);
-        FILE *file = fopen(filename, "w");
-        if (file == NULL) {
+        phaseResume();
+        size_t len = strlen(filename);
+        FILE *file = NULL;
+        if (len > 4 && strcmp(filename + len - 4, ".ttb") == 0) {
+            if (writeTruthBitmap(filename, root, variables, varCount, NULL))
+                printf("Truth table saved to '%s'\n", filename);
+        } else if ((file = fopen(filename, "w")) == NULL) {
             printf("Error: Cannot open file '%s'\n", filename);
         } else {
             printAndSaveTable(root, variables, varCount, file);
@@ -102,7 +126,7 @@ void printTruthTable(Node *root) {
         }
     }
 
-    for (int i = 0; i < varCount; i++) free(variables[i]);
+    if (stats == &own) freeTreeStats(&own);
 }
 
 /**
@@ -116,6 +140,7 @@ void collectVariables(Node* root, char* vars[], int* varCount) {
     if (!root) return;
 
     if (root->left == NULL && root->right == NULL) {
+        if (constantValue(root->tok) >= 0) return;
         for (int i = 0; i < *varCount; i++)
             if (strcmp(vars[i], root->tok) == 0) return;
 
@@ -143,6 +168,8 @@ void collectVariables(Node* root, char* vars[], int* varCount) {
  */
 int evaluateFormula(Node* root, TruthAssignment assignments[], int assignmentCount) {
     if (root->left == NULL && root->right == NULL) {
+        int constant = constantValue(root->tok);
+        if (constant >= 0) return constant;
         for (int i = 0; i < assignmentCount; i++)
             if (strcmp(root->tok, assignments[i].variable) == 0)
                 return assignments[i].value;
@@ -1,9 +1,22 @@
 #ifndef TASK5_H
 #define TASK5_H
 
+#include <stdio.h>
 #include "common.h"
 
 Node* convertToCNF(Node *root);
 void printCNF(Node *root);
+void fprintCNF(FILE *out, Node *root);
+
+/* The steps of convertToCNF, also run by the parallel versions in
+   parallelTree.c: each recursive pass is a node-local step applied
+   bottom-up (implications, distribution) or top-down (negations). */
+Node* copyTree(Node *root);
+Node* eliminateImplications(Node *root);
+void eliminateImplicationStep(Node *root);
+Node* moveNotInwards(Node *root);
+Node* moveNotStep(Node *root);
+Node* distributeOr(Node *root);
+int distributeOrStep(Node *root);
 
 #endif
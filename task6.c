@@ -20,6 +20,8 @@
  *   - Original tree copy: O(n)
  *   - Expanded tree: O(2^n) in worst case
  *   - Multiple intermediate trees during transformation
+ * @note To write the clauses rather than keep them, cnfStream.c generates
+ *   them one at a time from the NNF in O(n) memory.
  */
 
 #include "common.h"
@@ -27,11 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Forward declarations
-Node* eliminateImplications(Node* root);
-Node* moveNotInwards(Node* root);
-Node* distributeOr(Node* root);
-Node* copyTree(Node* root);
+#include "task5.h"
 
 /**
  * @brief Creates a deep copy of a parse tree.
@@ -60,7 +58,16 @@ Node* eliminateImplications(Node* root) {
     if (!root) return NULL;
     root->left = eliminateImplications(root->left);
     root->right = eliminateImplications(root->right);
+    eliminateImplicationStep(root);
+    return root;
+}
 
+/**
+ * @brief Rewrites one node A > B into ~A + B (children already done).
+ *
+ * @param root Node to rewrite in place.
+ */
+void eliminateImplicationStep(Node* root) {
     if (strcmp(root->tok, ">") == 0) {
         free(root->tok);
         root->tok = strdup_s("+");
@@ -68,7 +75,6 @@ Node* eliminateImplications(Node* root) {
         notLeft->right = root->left;
         root->left = notLeft;
     }
-    return root;
 }
 
 /**
@@ -81,30 +87,42 @@ Node* eliminateImplications(Node* root) {
  */
 Node* moveNotInwards(Node* root) {
     if (!root) return NULL;
+    root = moveNotStep(root);
+    root->left = moveNotInwards(root->left);
+    root->right = moveNotInwards(root->right);
+    return root;
+}
 
-    if (strcmp(root->tok, "~") == 0) {
+/**
+ * @brief Applies De Morgan's laws and double-negation removal at the top
+ *        of a subtree; its children still need moveNotInwards.
+ *
+ * The ~ nodes and operators that are rewritten away are freed.
+ *
+ * @param root Root of the subtree.
+ * @return New root of the subtree.
+ */
+Node* moveNotStep(Node* root) {
+    while (strcmp(root->tok, "~") == 0 && root->right) {
         Node* child = root->right;
-        if (strcmp(child->tok, "~") == 0)
-            return moveNotInwards(child->right);
-        if (strcmp(child->tok, "*") == 0) {
-            root->tok = strdup_s("+");
-            Node* a = newNode("~"); a->right = child->left;
-            Node* b = newNode("~"); b->right = child->right;
-            root->left = moveNotInwards(a);
-            root->right = moveNotInwards(b);
-            return root;
+        if (strcmp(child->tok, "~") == 0) {
+            Node* inner = child->right;
+            free(root->tok); free(root);
+            free(child->tok); free(child);
+            root = inner;
+            continue;
         }
-        if (strcmp(child->tok, "+") == 0) {
-            root->tok = strdup_s("*");
+        if (strcmp(child->tok, "*") == 0 || strcmp(child->tok, "+") == 0) {
+            free(root->tok);
+            root->tok = strdup_s(strcmp(child->tok, "*") == 0 ? "+" : "*");
             Node* a = newNode("~"); a->right = child->left;
             Node* b = newNode("~"); b->right = child->right;
-            root->left = moveNotInwards(a);
-            root->right = moveNotInwards(b);
-            return root;
+            root->left = a;
+            root->right = b;
+            free(child->tok); free(child);
         }
+        break;
     }
-    root->left = moveNotInwards(root->left);
-    root->right = moveNotInwards(root->right);
     return root;
 }
 
@@ -119,19 +137,32 @@ Node* distributeOr(Node* root) {
     root->left = distributeOr(root->left);
     root->right = distributeOr(root->right);
 
-    if (strcmp(root->tok, "+") == 0) {
-        if (root->right && strcmp(root->right->tok, "*") == 0) {
-            Node* a = root->left, *b = root->right->left, *c = root->right->right;
-            Node* left = newNode("+"); left->left = copyTree(a); left->right = b;
-            Node* right = newNode("+"); right->left = a; right->right = c;
-            root->tok = strdup_s("*");
-            root->left = distributeOr(left);
-            root->right = distributeOr(right);
-        }
+    if (distributeOrStep(root)) {
+        root->left = distributeOr(root->left);
+        root->right = distributeOr(root->right);
     }
     return root;
 }
 
+/**
+ * @brief Rewrites one node A + (B * C) into (A + B) * (A + C).
+ *
+ * @param root Node to rewrite in place (children already distributed).
+ * @return 1 if it was rewritten, so both new children need distributeOr.
+ */
+int distributeOrStep(Node* root) {
+    if (strcmp(root->tok, "+") != 0 || !root->right || strcmp(root->right->tok, "*") != 0) return 0;
+    Node* a = root->left, *and = root->right, *b = and->left, *c = and->right;
+    Node* left = newNode("+"); left->left = copyTree(a); left->right = b;
+    Node* right = newNode("+"); right->left = a; right->right = c;
+    free(root->tok);
+    root->tok = strdup_s("*");
+    root->left = left;
+    root->right = right;
+    free(and->tok); free(and);
+    return 1;
+}
+
 /**
  * @brief Converts a formula tree to Conjunctive Normal Form.
  *
@@ -152,10 +183,20 @@ Node* convertToCNF(Node* root) {
  * @param root Root node of the CNF tree.
  */
 void printCNF(Node* root) {
+    fprintCNF(stdout, root);
+}
+
+/**
+ * @brief Writes the CNF formula in infix form to a stream.
+ *
+ * @param out Destination stream.
+ * @param root Root node of the CNF tree.
+ */
+void fprintCNF(FILE* out, Node* root) {
     if (!root) return;
-    if (strcmp(root->tok, "*") == 0 || strcmp(root->tok, "+") == 0) printf("(");
-    printCNF(root->left);
-    printf(" %s ", root->tok);
-    printCNF(root->right);
-    if (strcmp(root->tok, "*") == 0 || strcmp(root->tok, "+") == 0) printf(")");
+    if (strcmp(root->tok, "*") == 0 || strcmp(root->tok, "+") == 0) fprintf(out, "(");
+    fprintCNF(out, root->left);
+    fprintf(out, " %s ", root->tok);
+    fprintCNF(out, root->right);
+    if (strcmp(root->tok, "*") == 0 || strcmp(root->tok, "+") == 0) fprintf(out, ")");
 }
@@ -22,11 +22,35 @@
  */
 
 #include "common.h"
+#include "simplify.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_CLAUSE_ATOMS 1024
+/**
+ * @brief Growable array of pointers used for the clause scan.
+ */
+typedef struct {
+    void** items;
+    int count;
+    int cap;
+} PtrList;
+
+/**
+ * @brief Appends an item, doubling the capacity when full.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int ptrListPush(PtrList* l, void* item) {
+    if (l->count == l->cap) {
+        int ncap = l->cap ? l->cap * 2 : 16;
+        void** ni = realloc(l->items, (size_t)ncap * sizeof(void*));
+        if (!ni) { perror("realloc"); return 0; }
+        l->items = ni;
+        l->cap = ncap;
+    }
+    l->items[l->count++] = item;
+    return 1;
+}
 
 /**
  * @brief Checks whether a single CNF clause is valid.
@@ -39,35 +63,36 @@
  */
 int isClauseValid(Node* clause) {
     if (!clause) return 0;
+    // the constant "1" left by simplifyFormula is a valid clause
+    if (!clause->left && !clause->right && constantValue(clause->tok) >= 0)
+        return constantValue(clause->tok);
 
-    char* pos[MAX_CLAUSE_ATOMS];
-    char* neg[MAX_CLAUSE_ATOMS];
-    int posCount = 0, negCount = 0;
-
-    Node* stack[MAX_CLAUSE_ATOMS];
-    int top = -1;
-    stack[++top] = clause;
+    PtrList pos = { NULL, 0, 0 }, neg = { NULL, 0, 0 }, stack = { NULL, 0, 0 };
+    int ok = ptrListPush(&stack, clause);
 
-    while (top >= 0) {
-        Node* node = stack[top--];
+    while (ok && stack.count > 0) {
+        Node* node = stack.items[--stack.count];
         if (!node) continue;
 
         if (node->left == NULL && node->right == NULL)
-            pos[posCount++] = node->tok;
+            ok = ptrListPush(&pos, node->tok);
         else if (strcmp(node->tok, "~") == 0 && node->right)
-            neg[negCount++] = node->right->tok;
+            ok = ptrListPush(&neg, node->right->tok);
         else if (strcmp(node->tok, "+") == 0) {
-            if (node->left) stack[++top] = node->left;
-            if (node->right) stack[++top] = node->right;
+            if (node->left) ok = ptrListPush(&stack, node->left);
+            if (ok && node->right) ok = ptrListPush(&stack, node->right);
         }
     }
 
-    for (int i = 0; i < posCount; i++)
-        for (int j = 0; j < negCount; j++)
-            if (strcmp(pos[i], neg[j]) == 0)
-                return 1;
+    int valid = 0;
+    for (int i = 0; ok && i < pos.count && !valid; i++)
+        for (int j = 0; j < neg.count; j++)
+            if (strcmp(pos.items[i], neg.items[j]) == 0) { valid = 1; break; }
 
-    return 0;
+    free(pos.items);
+    free(neg.items);
+    free(stack.items);
+    return valid;
 }
 
 /**
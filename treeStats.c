@@ -0,0 +1,170 @@
+/**
+ * @file treeStats.c
+ * @brief Height, size, operator, variable and clause statistics of a
+ *        parse tree in a single pass.
+ *
+ * Task 4's height, Task 5's variable list and Task 7's clause walk each
+ * traverse the whole tree, and node and operator counts were not kept at
+ * all. Each node here gets a small summary computed from its children's
+ * summaries, so the builder in task2.c fills in every statistic as it
+ * creates the nodes and no later traversal is needed.
+ * @section algo Algorithm: Bottom-up summaries
+ *   - Height: 1 + the larger child height
+ *   - Shape: atom, ~atom (literal), + of literals (clause), * of clauses
+ *     (CNF) or anything else; clause widths are recorded when a clause
+ *     becomes an operand of '*', and kept only if the root is CNF
+ *   - Clauses: operands below the root's run of '*', summed up that run
+ *   - Variables: interned in a VarMap as the leaves are met in preorder
+ * @section time Time Complexity: O(n) expected
+ * @section space Space Complexity: O(v + w) for v variables and clauses
+ *   of up to w literals, plus the caller's recursion
+ */
+
+#include "treeStats.h"
+#include <stdlib.h>
+#include <string.h>
+#include "simplify.h"
+
+enum { SHAPE_ATOM, SHAPE_LITERAL, SHAPE_CLAUSE, SHAPE_CNF, SHAPE_OTHER };
+
+/**
+ * @brief Adds one clause of the given width to the histogram.
+ */
+static void recordWidth(TreeStats *st, long width) {
+    if (width >= st->widthCap) {
+        int ncap = st->widthCap ? st->widthCap : 16;
+        while (ncap <= width) ncap *= 2;
+        long *nc = realloc(st->widthCounts, (size_t)ncap * sizeof(long));
+        if (!nc) { perror("realloc"); st->ok = 0; return; }
+        memset(nc + st->widthCap, 0, (size_t)(ncap - st->widthCap) * sizeof(long));
+        st->widthCounts = nc;
+        st->widthCap = ncap;
+    }
+    st->widthCounts[width]++;
+    if (width > st->maxWidth) st->maxWidth = (int)width;
+}
+
+/**
+ * @copydoc treeStatsInit
+ */
+void treeStatsInit(TreeStats *st) {
+    memset(st, 0, sizeof(*st));
+    varMapInit(&st->vars);
+    st->ok = 1;
+}
+
+/**
+ * @copydoc freeTreeStats
+ */
+void freeTreeStats(TreeStats *st) {
+    varMapFree(&st->vars);
+    free(st->widthCounts);
+    st->widthCounts = NULL;
+    st->widthCap = 0;
+}
+
+/**
+ * @copydoc treeStatsLeaf
+ */
+void treeStatsLeaf(TreeStats *st, const char *tok, SubtreeStats *out) {
+    st->nodes++;
+    st->leaves++;
+    if (constantValue(tok) >= 0) st->constants++;
+    else if (!varMapIntern(&st->vars, tok)) st->ok = 0;
+    out->height = 1;
+    out->shape = SHAPE_ATOM;
+    out->width = 1;
+    out->conjuncts = 1;
+}
+
+/**
+ * @copydoc treeStatsNode
+ */
+void treeStatsNode(TreeStats *st, const char *tok, const SubtreeStats *l, const SubtreeStats *r,
+                   SubtreeStats *out) {
+    st->nodes++;
+    int lh = l ? l->height : 0, rh = r ? r->height : 0;
+    out->height = (lh > rh ? lh : rh) + 1;
+    out->shape = SHAPE_OTHER;
+    out->width = 0;
+    out->conjuncts = 1;
+
+    if (strcmp(tok, "~") == 0) {
+        st->nots++;
+        if (!l && r && r->shape == SHAPE_ATOM) {
+            out->shape = SHAPE_LITERAL;
+            out->width = 1;
+        }
+    } else if (strcmp(tok, "+") == 0) {
+        st->ors++;
+        if (l && r && l->shape <= SHAPE_CLAUSE && r->shape <= SHAPE_CLAUSE) {
+            out->shape = SHAPE_CLAUSE;
+            out->width = l->width + r->width;
+        }
+    } else if (strcmp(tok, "*") == 0) {
+        st->ands++;
+        out->conjuncts = (l ? l->conjuncts : 0) + (r ? r->conjuncts : 0);
+        if (l && r && l->shape <= SHAPE_CNF && r->shape <= SHAPE_CNF) {
+            out->shape = SHAPE_CNF;
+            if (l->shape != SHAPE_CNF) recordWidth(st, l->width);
+            if (r->shape != SHAPE_CNF) recordWidth(st, r->width);
+        }
+    } else if (strcmp(tok, ">") == 0) {
+        st->implies++;
+    }
+}
+
+/**
+ * @copydoc treeStatsFinish
+ */
+void treeStatsFinish(TreeStats *st, const SubtreeStats *root) {
+    st->height = root ? root->height : 0;
+    st->clauses = root ? root->conjuncts : 0;
+    st->isCnf = root && root->shape <= SHAPE_CNF;
+    if (st->isCnf && root->shape != SHAPE_CNF) recordWidth(st, root->width);
+    if (!st->isCnf) {
+        // Widths recorded below a '*' that turned out not to be on the top run
+        if (st->widthCounts) memset(st->widthCounts, 0, (size_t)st->widthCap * sizeof(long));
+        st->maxWidth = 0;
+    }
+}
+
+static void statsRec(TreeStats *st, const Node *n, SubtreeStats *out) {
+    if (!n->left && !n->right) {
+        treeStatsLeaf(st, n->tok, out);
+        return;
+    }
+    SubtreeStats l, r;
+    if (n->left) statsRec(st, n->left, &l);
+    if (n->right) statsRec(st, n->right, &r);
+    treeStatsNode(st, n->tok, n->left ? &l : NULL, n->right ? &r : NULL, out);
+}
+
+/**
+ * @copydoc computeTreeStats
+ */
+int computeTreeStats(const Node *root, TreeStats *st) {
+    treeStatsInit(st);
+    SubtreeStats s;
+    if (root) statsRec(st, root, &s);
+    treeStatsFinish(st, root ? &s : NULL);
+    return st->ok;
+}
+
+/**
+ * @copydoc printTreeStats
+ */
+void printTreeStats(FILE *out, const TreeStats *st) {
+    fprintf(out, "Nodes: %ld (%ld leaves, %ld ~, %ld *, %ld +, %ld >), %d variables\n",
+            st->nodes, st->leaves, st->nots, st->ands, st->ors, st->implies, st->vars.count);
+    fprintf(out, "Clauses: %ld", st->clauses);
+    if (st->isCnf) {
+        fprintf(out, " (CNF; widths");
+        for (int k = 1; k <= st->maxWidth; k++)
+            if (st->widthCounts[k]) fprintf(out, " %d:%ld", k, st->widthCounts[k]);
+        fprintf(out, ")");
+    } else {
+        fprintf(out, " (not CNF)");
+    }
+    fprintf(out, "\n");
+}
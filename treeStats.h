@@ -0,0 +1,90 @@
+/**
+ * @file treeStats.h
+ * @brief Header for size and shape statistics of a parse tree, gathered
+ *        in the pass that builds it.
+ */
+
+#ifndef TREE_STATS_H
+#define TREE_STATS_H
+
+#include <stdio.h>
+#include "common.h"
+#include "varMap.h"
+
+/**
+ * @brief Statistics of one tree.
+ */
+typedef struct {
+    int height;           /**< As maxHeightOfParseTree */
+    long nodes;
+    long leaves;
+    long constants;       /**< Leaves "0" and "1" */
+    long nots;            /**< Operator counts */
+    long ands;
+    long ors;
+    long implies;
+    VarMap vars;          /**< Distinct variables in preorder of first appearance,
+                               the order of collectVariables */
+    long clauses;         /**< Subtrees below the root's run of '*', as Task 7 counts them */
+    int isCnf;            /**< Every clause is a disjunction of literals */
+    int maxWidth;         /**< Literals of the widest clause (isCnf only) */
+    long *widthCounts;    /**< widthCounts[k]: clauses of k literals, k <= maxWidth (isCnf only) */
+    int widthCap;
+    int ok;               /**< 0 if an allocation failed; the statistics are then incomplete */
+} TreeStats;
+
+/**
+ * @brief Summary of one subtree passed up while a tree is built.
+ */
+typedef struct {
+    int height;
+    int shape;            /**< Internal classification (atom, literal, clause, CNF, other) */
+    long width;           /**< Literals of an atom, literal or clause */
+    long conjuncts;       /**< Subtrees below this node's run of '*' */
+} SubtreeStats;
+
+/**
+ * @brief Starts an empty set of statistics.
+ */
+void treeStatsInit(TreeStats *st);
+
+/**
+ * @brief Frees the variable names and the width histogram.
+ */
+void freeTreeStats(TreeStats *st);
+
+/**
+ * @brief Accounts for a leaf.
+ * @param out Output: the leaf's summary.
+ */
+void treeStatsLeaf(TreeStats *st, const char *tok, SubtreeStats *out);
+
+/**
+ * @brief Accounts for an operator node once its children are summarized.
+ * @param l Summary of the left child (NULL for ~ or a missing child).
+ * @param r Summary of the right child (NULL if missing).
+ * @param out Output: the node's summary.
+ */
+void treeStatsNode(TreeStats *st, const char *tok, const SubtreeStats *l, const SubtreeStats *r,
+                   SubtreeStats *out);
+
+/**
+ * @brief Completes the statistics from the root's summary (NULL for an
+ *        empty tree).
+ */
+void treeStatsFinish(TreeStats *st, const SubtreeStats *root);
+
+/**
+ * @brief Gathers the statistics of an existing tree in one traversal,
+ *        for trees not built by convertPreOrderToTreeWithStats.
+ * @param st Output (free with freeTreeStats).
+ * @return st->ok.
+ */
+int computeTreeStats(const Node *root, TreeStats *st);
+
+/**
+ * @brief Writes the node, operator, variable and clause counts.
+ */
+void printTreeStats(FILE *out, const TreeStats *st);
+
+#endif
@@ -0,0 +1,335 @@
+/**
+ * @file truthBitmap.c
+ * @brief Truth tables stored as one result bit per row.
+ *
+ * printAndSaveTable spends about 2n+6 bytes of text per row on what is
+ * one bit of information, and every reader has to parse it again. Here
+ * the result column alone is stored as a packed bitmap behind a small
+ * header with the column names; the row index itself encodes the
+ * assignment, so any row, range count or satisfying row is found with
+ * word operations on the mapped file.
+ *
+ * File layout (native byte order, checked on open):
+ *   - header: magic "LOGICTT1", byte-order mark, numVars, rows, ones,
+ *     size of the names, offset of the bitmap
+ *   - names: numVars NUL-terminated column names
+ *   - bitmap: ceil(rows / 64) words at a 64-byte aligned offset; bits
+ *     past the last row are zero
+ * @section algo Algorithm:
+ *   - Write: compile the formula with the columns numbered from the
+ *     right, so bit v of a row index is compiled variable v; evaluate
+ *     4096 rows per block straight into the mapped file
+ *   - Queries: popcount over whole words, count-trailing-zeros to step
+ *     from one satisfying row to the next
+ * @section time Time Complexity: O(n × 2^n / 64) write, O(1) row,
+ *   O(range / 64) count, O(range / 64 + ones) iteration
+ * @section space Space Complexity: 2^n / 8 bytes on disk, O(n) in memory
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "truthBitmap.h"
+#include "compiledFormula.h"
+#include "nativeKernel.h"
+#include "simplify.h"
+#include "varMap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TT_MAGIC "LOGICTT1"
+#define TT_BYTE_ORDER 0x01020304u
+#define TT_ALIGN 64
+#define TT_BLOCK_WORDS 64
+
+/**
+ * @brief Fixed part of the file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t numVars;
+    uint64_t rows;
+    uint64_t ones;
+    uint64_t namesBytes;
+    uint64_t dataOffset;
+} TruthBitmapHeader;
+
+static uint64_t wordCount(uint64_t rows) {
+    return (rows + 63) / 64;
+}
+
+/**
+ * @brief Mask of the bits of the last word that are rows.
+ */
+static uint64_t lastWordMask(uint64_t rows) {
+    return rows % 64 ? (1ULL << (rows % 64)) - 1 : ~0ULL;
+}
+
+/**
+ * @brief Evaluates every row into bits.
+ * @return Satisfying rows, or -1 on error.
+ */
+static long long fillBitmap(uint64_t *bits, const Node *root, char *vars[], int varCount) {
+    uint64_t rows = 1ULL << varCount, words = wordCount(rows);
+    int constant = constantValue(root->tok);
+    if (constant >= 0) {
+        memset(bits, constant ? 0xFF : 0, words * sizeof(uint64_t));
+        bits[words - 1] &= lastWordMask(rows);
+        return constant ? (long long)rows : 0;
+    }
+
+    // Row k gives column j bit varCount-1-j of k; interning the columns
+    // right to left makes that compiled variable varCount-1-j
+    VarMap vm;
+    varMapInit(&vm);
+    int ok = 1;
+    for (int j = varCount - 1; j >= 0 && ok; j--) ok = varMapIntern(&vm, vars[j]) != 0;
+    CompiledFormula *cf = ok ? compileFormula(root, &vm) : NULL;
+    if (cf && vm.count > varCount) {
+        printf("Error: Variable '%s' is not a column of the table.\n", vm.names[varCount]);
+        freeCompiledFormula(cf);
+        cf = NULL;
+    }
+    varMapFree(&vm);
+    if (!cf) return -1;
+    nativeKernelAttach(cf, (double)words);
+
+    int width = words >= TT_BLOCK_WORDS ? TT_BLOCK_WORDS : 1;
+    uint64_t *in = malloc((size_t)(varCount ? varCount : 1) * width * sizeof(uint64_t));
+    uint64_t *slots = malloc((size_t)cf->numInstrs * width * sizeof(uint64_t));
+    long long ones = -1;
+    if (!in || !slots) {
+        perror("malloc");
+    } else {
+        ones = 0;
+        for (uint64_t w0 = 0; w0 < words; w0 += width) {
+            setTableRowInputs(in, varCount, width, w0 * 64);
+            const uint64_t *res = evalCompiledBlock(cf, in, width, slots);
+            memcpy(bits + w0, res, (size_t)width * sizeof(uint64_t));
+        }
+        bits[words - 1] &= lastWordMask(rows);
+        for (uint64_t w = 0; w < words; w++) ones += __builtin_popcountll(bits[w]);
+    }
+    free(in);
+    free(slots);
+    freeCompiledFormula(cf);
+    return ones;
+}
+
+/**
+ * @copydoc writeTruthBitmap
+ */
+int writeTruthBitmap(const char *path, const Node *root, char *vars[], int varCount, uint64_t *ones) {
+    if (!root || !root->tok) {
+        printf("Error: Cannot generate truth table for an empty formula.\n");
+        return 0;
+    }
+    if (varCount < 0 || varCount > TRUTH_BITMAP_MAX_VARS) {
+        printf("Error: A bitmap table holds at most %d variables (got %d).\n", TRUTH_BITMAP_MAX_VARS, varCount);
+        return 0;
+    }
+    uint64_t namesBytes = 0;
+    for (int j = 0; j < varCount; j++) namesBytes += strlen(vars[j]) + 1;
+    uint64_t rows = 1ULL << varCount;
+    uint64_t dataOffset = (sizeof(TruthBitmapHeader) + namesBytes + TT_ALIGN - 1) / TT_ALIGN * TT_ALIGN;
+    size_t size = dataOffset + wordCount(rows) * sizeof(uint64_t);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror(path);
+        return 0;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        perror(path);
+        close(fd);
+        return 0;
+    }
+    char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 0;
+    }
+
+    char *name = map + sizeof(TruthBitmapHeader);
+    for (int j = 0; j < varCount; j++) {
+        size_t len = strlen(vars[j]) + 1;
+        memcpy(name, vars[j], len);
+        name += len;
+    }
+    long long found = fillBitmap((uint64_t*)(map + dataOffset), root, vars, varCount);
+
+    // The header goes in last, so an interrupted write is never a valid table
+    TruthBitmapHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, TT_MAGIC, sizeof h.magic);
+    h.byteOrder = TT_BYTE_ORDER;
+    h.numVars = (uint32_t)varCount;
+    h.rows = rows;
+    h.ones = found < 0 ? 0 : (uint64_t)found;
+    h.namesBytes = namesBytes;
+    h.dataOffset = dataOffset;
+    if (found >= 0) memcpy(map, &h, sizeof h);
+    int ok = munmap(map, size) == 0 && found >= 0;
+    if (!ok) {
+        if (found >= 0) perror("munmap");
+        unlink(path);
+        return 0;
+    }
+    if (ones) *ones = (uint64_t)found;
+    return 1;
+}
+
+/**
+ * @copydoc openTruthBitmap
+ */
+TruthBitmap *openTruthBitmap(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)sb.st_size;
+    if (size < sizeof(TruthBitmapHeader)) {
+        printf("Error: '%s' is not a bitmap truth table.\n", path);
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+
+    TruthBitmapHeader h;
+    memcpy(&h, map, sizeof h);
+    const char *err = NULL;
+    if (memcmp(h.magic, TT_MAGIC, sizeof h.magic) != 0) err = "is not a bitmap truth table";
+    else if (h.byteOrder != TT_BYTE_ORDER) err = "was written with another byte order";
+    else if (h.numVars > TRUTH_BITMAP_MAX_VARS || h.rows != 1ULL << h.numVars
+             || h.dataOffset % sizeof(uint64_t) != 0
+             || h.dataOffset < sizeof h + h.namesBytes
+             || h.dataOffset > size
+             || (size - h.dataOffset) / sizeof(uint64_t) < wordCount(h.rows)) err = "is truncated or corrupt";
+
+    TruthBitmap *tb = err ? NULL : calloc(1, sizeof(TruthBitmap));
+    const char **names = err ? NULL : malloc((h.numVars ? h.numVars : 1) * sizeof(char*));
+    if (!err && (!tb || !names)) {
+        perror("malloc");
+        err = "";
+    }
+    // Names must be exactly numVars strings filling namesBytes
+    const char *p = (const char*)map + sizeof h, *end = p + (err ? 0 : h.namesBytes);
+    for (uint32_t j = 0; !err && j < h.numVars; j++) {
+        const char *nul = memchr(p, '\0', (size_t)(end - p));
+        if (!nul) err = "has corrupt column names";
+        else {
+            names[j] = p;
+            p = nul + 1;
+        }
+    }
+    if (!err && p != end) err = "has corrupt column names";
+
+    if (err) {
+        if (*err) printf("Error: '%s' %s.\n", path, err);
+        free(names);
+        free(tb);
+        munmap(map, size);
+        return NULL;
+    }
+    tb->numVars = (int)h.numVars;
+    tb->names = names;
+    tb->rows = h.rows;
+    tb->ones = h.ones;
+    tb->bits = (const uint64_t*)((const char*)map + h.dataOffset);
+    tb->map = map;
+    tb->mapSize = size;
+    return tb;
+}
+
+/**
+ * @copydoc closeTruthBitmap
+ */
+void closeTruthBitmap(TruthBitmap *tb) {
+    if (!tb) return;
+    munmap(tb->map, tb->mapSize);
+    free(tb->names);
+    free(tb);
+}
+
+/**
+ * @copydoc truthBitmapRow
+ */
+int truthBitmapRow(const TruthBitmap *tb, uint64_t k) {
+    if (k >= tb->rows) return -1;
+    return (int)((tb->bits[k / 64] >> (k % 64)) & 1);
+}
+
+/**
+ * @brief Word w of the bitmap with the rows outside [from, to) cleared.
+ */
+static uint64_t rangeWord(const TruthBitmap *tb, uint64_t w, uint64_t from, uint64_t to) {
+    uint64_t bits = tb->bits[w];
+    if (w == from / 64) bits &= ~0ULL << (from % 64);
+    if (w == (to - 1) / 64 && to % 64) bits &= (1ULL << (to % 64)) - 1;
+    return bits;
+}
+
+/**
+ * @copydoc truthBitmapCount
+ */
+uint64_t truthBitmapCount(const TruthBitmap *tb, uint64_t from, uint64_t to) {
+    if (to > tb->rows) to = tb->rows;
+    if (from >= to) return 0;
+    if (from == 0 && to == tb->rows) return tb->ones;
+    uint64_t first = from / 64, last = (to - 1) / 64, count = 0;
+    for (uint64_t w = first; w <= last; w++) {
+        uint64_t bits = w == first || w == last ? rangeWord(tb, w, from, to) : tb->bits[w];
+        count += (uint64_t)__builtin_popcountll(bits);
+    }
+    return count;
+}
+
+/**
+ * @copydoc truthBitmapNext
+ */
+uint64_t truthBitmapNext(const TruthBitmap *tb, uint64_t from) {
+    if (from >= tb->rows) return tb->rows;
+    uint64_t words = wordCount(tb->rows);
+    uint64_t bits = tb->bits[from / 64] & (~0ULL << (from % 64));
+    for (uint64_t w = from / 64;;) {
+        if (bits) return w * 64 + (uint64_t)__builtin_ctzll(bits);
+        if (++w == words) return tb->rows;
+        bits = tb->bits[w];
+    }
+}
+
+/**
+ * @copydoc truthBitmapForEach
+ */
+uint64_t truthBitmapForEach(const TruthBitmap *tb, uint64_t from, uint64_t to, TruthRowFn fn, void *arg) {
+    if (to > tb->rows) to = tb->rows;
+    if (from >= to) return 0;
+    uint64_t first = from / 64, last = (to - 1) / 64, visited = 0;
+    for (uint64_t w = first; w <= last; w++) {
+        uint64_t bits = w == first || w == last ? rangeWord(tb, w, from, to) : tb->bits[w];
+        while (bits) {
+            visited++;
+            if (fn(w * 64 + (uint64_t)__builtin_ctzll(bits), arg)) return visited;
+            bits &= bits - 1;
+        }
+    }
+    return visited;
+}
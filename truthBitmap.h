@@ -0,0 +1,97 @@
+/**
+ * @file truthBitmap.h
+ * @brief Header for the packed binary truth-table format.
+ */
+
+#ifndef TRUTH_BITMAP_H
+#define TRUTH_BITMAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "common.h"
+
+/** Largest number of variables a bitmap table may have (8 GiB of bits). */
+#define TRUTH_BITMAP_MAX_VARS 36
+
+/**
+ * @brief An open bitmap table, mapped read-only.
+ *
+ * Row k is the row k of the text table of printAndSaveTable: column j
+ * (variable names[j]) has the value of bit numVars-1-j of k, and bit k of
+ * the bitmap is the result of that row.
+ */
+typedef struct {
+    int numVars;
+    const char **names;     /**< Column names, pointing into the mapping */
+    uint64_t rows;          /**< 2^numVars */
+    uint64_t ones;          /**< Satisfying rows */
+    const uint64_t *bits;   /**< ceil(rows / 64) words; bit k%64 of word k/64 is row k */
+    void *map;
+    size_t mapSize;
+} TruthBitmap;
+
+/**
+ * @brief Called for each satisfying row by truthBitmapForEach.
+ * @return Nonzero to stop the iteration.
+ */
+typedef int (*TruthRowFn)(uint64_t row, void *arg);
+
+/**
+ * @brief Writes the truth table of a formula as a bitmap file.
+ *
+ * The file is sized up front and filled through a shared mapping, 4096
+ * rows per compiled evaluation; no row is formatted as text.
+ *
+ * @param path Output file (replaced).
+ * @param root Formula.
+ * @param vars Column names, as returned by collectVariables; every
+ *        variable of root must be among them.
+ * @param varCount Number of columns (at most TRUTH_BITMAP_MAX_VARS).
+ * @param ones Output: satisfying rows (may be NULL).
+ * @return 1 on success, 0 on error (reported on stdout).
+ */
+int writeTruthBitmap(const char *path, const Node *root, char *vars[], int varCount, uint64_t *ones);
+
+/**
+ * @brief Maps a bitmap file and checks its header.
+ * @return Table (close with closeTruthBitmap), or NULL on error.
+ */
+TruthBitmap *openTruthBitmap(const char *path);
+
+/**
+ * @brief Unmaps and frees a table.
+ */
+void closeTruthBitmap(TruthBitmap *tb);
+
+/**
+ * @brief Result of row k.
+ * @return 1 or 0, or -1 if k is not a row.
+ */
+int truthBitmapRow(const TruthBitmap *tb, uint64_t k);
+
+/**
+ * @brief Counts the satisfying rows in [from, to) (clamped to the table).
+ */
+uint64_t truthBitmapCount(const TruthBitmap *tb, uint64_t from, uint64_t to);
+
+/**
+ * @brief First satisfying row at or after from.
+ * @return Its index, or tb->rows if there is none.
+ */
+uint64_t truthBitmapNext(const TruthBitmap *tb, uint64_t from);
+
+/**
+ * @brief Calls fn for each satisfying row in [from, to) in increasing
+ *        order, a word at a time.
+ * @return Number of rows passed to fn.
+ */
+uint64_t truthBitmapForEach(const TruthBitmap *tb, uint64_t from, uint64_t to, TruthRowFn fn, void *arg);
+
+/**
+ * @brief Value of column j in row k.
+ */
+static inline int truthBitmapValue(const TruthBitmap *tb, uint64_t k, int j) {
+    return (int)((k >> (tb->numVars - 1 - j)) & 1);
+}
+
+#endif
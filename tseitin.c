@@ -0,0 +1,157 @@
+/**
+ * @file tseitin.c
+ * @brief Encodes parse trees into equisatisfiable CNF in linear time.
+ *
+ * Unlike convertToCNF, whose distribution step can grow the formula
+ * exponentially, the Tseitin encoding introduces an auxiliary variable
+ * per operator and at most three clauses defining it. The clauses go
+ * either into a solver or into a CnfFormula of their own.
+ * @section algo Algorithm: Tseitin transformation
+ *   a <-> (l * r):  (~a + l), (~a + r), (a + ~l + ~r)
+ *   a <-> (l + r):  (a + ~l), (a + ~r), (~a + l + r)
+ *   a <-> (l > r):  (a + l), (a + ~r), (~a + ~l + r)
+ *   ~x reuses the literal of x, negated.
+ * @section time Time Complexity: O(n)
+ * @section space Space Complexity: O(n) clauses, O(h) recursion
+ */
+
+#include "tseitin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Destination of the clauses: a solver, or growing clause arrays.
+ */
+typedef struct {
+    Solver *solver;       /**< Clauses go here when set */
+    CnfFormula *f;        /**< Otherwise they are appended here */
+    int litCap;
+    int clauseCap;
+    int failed;           /**< An append ran out of memory */
+} ClauseSink;
+
+/**
+ * @brief Appends one clause (at most three literals) to the sink's
+ *        formula. Repeated literals are merged and tautologies dropped,
+ *        as readCnfFormula does, e.g. for the clauses of A * A or A + ~A.
+ */
+static void appendClause(ClauseSink *k, const int *in, int count) {
+    int lits[3], n = 0;
+    for (int i = 0; i < count; i++) {
+        int dup = 0;
+        for (int j = 0; j < n; j++) {
+            if (lits[j] == -in[i]) return;
+            if (lits[j] == in[i]) dup = 1;
+        }
+        if (!dup) lits[n++] = in[i];
+    }
+    CnfFormula *f = k->f;
+    int used = f->clauseStart[f->numClauses];
+    if (used + n > k->litCap) {
+        int ncap = k->litCap * 2 + n;
+        int *nl = realloc(f->lits, (size_t)ncap * sizeof(int));
+        if (!nl) { k->failed = 1; return; }
+        f->lits = nl;
+        k->litCap = ncap;
+    }
+    if (f->numClauses + 2 > k->clauseCap) {
+        int ncap = k->clauseCap * 2;
+        int *ns = realloc(f->clauseStart, (size_t)ncap * sizeof(int));
+        if (!ns) { k->failed = 1; return; }
+        f->clauseStart = ns;
+        k->clauseCap = ncap;
+    }
+    memcpy(f->lits + used, lits, (size_t)n * sizeof(int));
+    f->clauseStart[++f->numClauses] = used + n;
+}
+
+/**
+ * @brief Adds a clause of up to three literals.
+ */
+static void addClause3(ClauseSink *k, int a, int b, int c) {
+    int lits[3] = { a, b, c };
+    if (k->solver) solverAddClause(k->solver, lits, c ? 3 : 2);
+    else appendClause(k, lits, c ? 3 : 2);
+}
+
+/**
+ * @brief Creates an auxiliary variable.
+ * @return Its DIMACS index, or 0 on failure.
+ */
+static int newAuxVar(ClauseSink *k) {
+    if (k->solver) return solverNewVar(k->solver);
+    return k->failed ? 0 : ++k->f->numVars;
+}
+
+/**
+ * @brief Encodes a subtree.
+ * @return Literal equivalent to it, or 0 on error.
+ */
+static int encodeRec(ClauseSink *k, const VarMap *vm, const Node *root) {
+    if (!root || !root->tok) return 0;
+    if (isVariableLeaf(root)) return varMapFind(vm, root->tok);
+
+    if (strcmp(root->tok, "~") == 0) {
+        int x = encodeRec(k, vm, root->right);
+        return x ? -x : 0;
+    }
+
+    int l = encodeRec(k, vm, root->left);
+    int r = l ? encodeRec(k, vm, root->right) : 0;
+    if (!l || !r) return 0;
+
+    int a = newAuxVar(k);
+    if (!a) return 0;
+
+    if (strcmp(root->tok, "*") == 0) {
+        addClause3(k, -a, l, 0);
+        addClause3(k, -a, r, 0);
+        addClause3(k, a, -l, -r);
+    } else if (strcmp(root->tok, "+") == 0) {
+        addClause3(k, a, -l, 0);
+        addClause3(k, a, -r, 0);
+        addClause3(k, -a, l, r);
+    } else if (strcmp(root->tok, ">") == 0) {
+        addClause3(k, a, l, 0);
+        addClause3(k, a, -r, 0);
+        addClause3(k, -a, -l, r);
+    } else {
+        return 0;
+    }
+    return a;
+}
+
+/**
+ * @copydoc tseitinEncode
+ */
+int tseitinEncode(Solver *s, const VarMap *vm, const Node *root) {
+    ClauseSink k = { s, NULL, 0, 0, 0 };
+    return encodeRec(&k, vm, root);
+}
+
+/**
+ * @copydoc tseitinToCnf
+ */
+CnfFormula *tseitinToCnf(const VarMap *vm, const Node *root) {
+    CnfFormula *f = calloc(1, sizeof(CnfFormula));
+    ClauseSink k = { NULL, f, 64, 16, 0 };
+    if (f) {
+        f->numVars = vm->count;
+        f->lits = malloc((size_t)k.litCap * sizeof(int));
+        f->clauseStart = calloc((size_t)k.clauseCap, sizeof(int));
+    }
+    if (!f || !f->lits || !f->clauseStart) {
+        perror("malloc");
+        freeCnfFormula(f);
+        return NULL;
+    }
+    int root0 = encodeRec(&k, vm, root);
+    if (root0) appendClause(&k, &root0, 1);
+    if (k.failed) perror("realloc");
+    if (!root0 || k.failed) {
+        freeCnfFormula(f);
+        return NULL;
+    }
+    return f;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file tseitin.h
+ * @brief Header for the linear-size Tseitin encoding of parse trees.
+ */
+
+#ifndef TSEITIN_H
+#define TSEITIN_H
+
+#include "common.h"
+#include "varMap.h"
+#include "satSolver.h"
+#include "cnfFormula.h"
+
+/**
+ * @brief Adds clauses defining one fresh variable per operator node.
+ *
+ * Leaves map to the DIMACS variable of their name in vm (which must be
+ * fully populated, with the solver already holding vm->count variables),
+ * negations map to the negated child literal, and every binary operator
+ * gets an auxiliary variable constrained to equal it. The clause set is
+ * satisfiable together with any value of the returned literal.
+ *
+ * @param s Solver receiving the definitions.
+ * @param vm Names of the original variables.
+ * @param root Root of the formula.
+ * @return DIMACS literal equivalent to the formula, or 0 if the tree is
+ *         malformed (missing operand, unknown name or operator).
+ */
+int tseitinEncode(Solver *s, const VarMap *vm, const Node *root);
+
+/**
+ * @brief Encodes a formula into a clause set of its own.
+ *
+ * Variables 1..vm->count are the formula's (vm must hold every leaf);
+ * the auxiliary variables follow them, and a unit clause asserts the
+ * root. The models of the result, restricted to the first vm->count
+ * variables, are exactly the models of the formula.
+ *
+ * @param vm Names of the original variables.
+ * @param root Root of the formula.
+ * @return New formula (free with freeCnfFormula), or NULL if the tree is
+ *         malformed or memory runs out.
+ */
+CnfFormula *tseitinToCnf(const VarMap *vm, const Node *root);
+
+#endif
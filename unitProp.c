@@ -0,0 +1,154 @@
+/**
+ * @file unitProp.c
+ * @brief Counter-based unit propagation with cheap backtracking.
+ *
+ * Used where the search needs to measure formula reduction rather than
+ * just detect conflicts: lookahead cube splitting and exact model
+ * counting. The CDCL solver keeps its own watched-literal propagation.
+ * @section algo Algorithm: Occurrence lists with per-clause counters
+ *   Assigning l increments satCount of clauses with l and decrements
+ *   freeCount of clauses with ~l; freeCount == 1 with satCount == 0 is a
+ *   unit, freeCount == 0 with satCount == 0 a conflict.
+ * @section time Time Complexity: O(occ(l)) per propagated literal
+ * @section space Space Complexity: O(L + n + m)
+ */
+
+#include "unitProp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @copydoc unitPropNew
+ */
+UnitProp *unitPropNew(const CnfFormula *f) {
+    UnitProp *up = calloc(1, sizeof(UnitProp));
+    if (!up) { perror("calloc"); return NULL; }
+    int n = f->numVars, m = f->numClauses;
+    int totalLits = f->clauseStart[m];
+
+    up->f = f;
+    up->occStart = calloc((size_t)(2 * n + 3), sizeof(int));
+    up->occ = malloc((size_t)(totalLits + 1) * sizeof(int));
+    up->value = malloc((size_t)(n + 1));
+    up->trail = malloc((size_t)(n + 1) * sizeof(int));
+    up->satCount = calloc((size_t)(m + 1), sizeof(int));
+    up->freeCount = malloc((size_t)(m + 1) * sizeof(int));
+    if (!up->occStart || !up->occ || !up->value || !up->trail || !up->satCount || !up->freeCount) {
+        perror("malloc");
+        unitPropFree(up);
+        return NULL;
+    }
+    memset(up->value, -1, (size_t)(n + 1));
+
+    // Counting sort of literal occurrences into CSR lists
+    for (int i = 0; i < totalLits; i++) up->occStart[unitPropLitIndex(f->lits[i]) + 1]++;
+    for (int l = 0; l < 2 * n + 2; l++) up->occStart[l + 1] += up->occStart[l];
+    int *fill = malloc((size_t)(2 * n + 2) * sizeof(int));
+    if (!fill) { perror("malloc"); unitPropFree(up); return NULL; }
+    memcpy(fill, up->occStart, (size_t)(2 * n + 2) * sizeof(int));
+    for (int c = 0; c < m; c++) {
+        const int *lits = cnfClause(f, c);
+        int sz = cnfClauseSize(f, c);
+        up->freeCount[c] = sz;
+        for (int k = 0; k < sz; k++) up->occ[fill[unitPropLitIndex(lits[k])]++] = c;
+    }
+    free(fill);
+
+    for (int c = 0; c < m; c++) {
+        int sz = cnfClauseSize(f, c);
+        if (sz == 0) up->rootConflict = 1;
+        else if (sz == 1 && !unitPropAssign(up, cnfClause(f, c)[0])) up->rootConflict = 1;
+    }
+    up->conflict = up->rootConflict;
+    return up;
+}
+
+/**
+ * @copydoc unitPropFree
+ */
+void unitPropFree(UnitProp *up) {
+    if (!up) return;
+    free(up->occStart);
+    free(up->occ);
+    free(up->value);
+    free(up->trail);
+    free(up->satCount);
+    free(up->freeCount);
+    free(up);
+}
+
+/**
+ * @copydoc unitPropAssign
+ */
+int unitPropAssign(UnitProp *up, int lit) {
+    int val = unitPropLitValue(up, lit);
+    if (val == 1) return 1;
+    if (val == 0) { up->conflict = 1; return 0; }
+    up->value[lit > 0 ? lit : -lit] = lit > 0;
+    up->trail[up->trailSize++] = lit;
+    return 1;
+}
+
+/**
+ * @brief Finds the unit literal of a clause with satCount 0 and freeCount 1.
+ * @return The literal, or 0 if a pending assignment already decides it.
+ */
+static int findUnit(const UnitProp *up, int c) {
+    const int *lits = cnfClause(up->f, c);
+    int sz = cnfClauseSize(up->f, c);
+    for (int k = 0; k < sz; k++)
+        if (unitPropLitValue(up, lits[k]) != 0) return unitPropLitValue(up, lits[k]) < 0 ? lits[k] : 0;
+    return 0;
+}
+
+/**
+ * @copydoc unitPropPropagate
+ */
+int unitPropPropagate(UnitProp *up) {
+    if (up->rootConflict) { up->conflict = 1; return 0; }
+    while (up->qhead < up->trailSize && !up->conflict) {
+        int lit = up->trail[up->qhead++];
+
+        int li = unitPropLitIndex(lit);
+        for (int k = up->occStart[li]; k < up->occStart[li + 1]; k++)
+            if (up->satCount[up->occ[k]]++ == 0) up->numSatisfied++;
+
+        // The whole list is always processed so that backtracking can
+        // undo this literal's counter updates symmetrically.
+        int ni = unitPropLitIndex(-lit);
+        for (int k = up->occStart[ni]; k < up->occStart[ni + 1]; k++) {
+            int c = up->occ[k];
+            int left = --up->freeCount[c];
+            if (up->satCount[c] > 0 || up->conflict) continue;
+            if (left == 0) {
+                up->conflict = 1;
+            } else if (left == 1) {
+                int u = findUnit(up, c);
+                if (u) unitPropAssign(up, u);
+            }
+        }
+    }
+    return !up->conflict;
+}
+
+/**
+ * @copydoc unitPropBacktrack
+ */
+void unitPropBacktrack(UnitProp *up, int mark) {
+    for (int i = up->trailSize - 1; i >= mark; i--) {
+        int lit = up->trail[i];
+        if (i < up->qhead) {
+            int li = unitPropLitIndex(lit);
+            for (int k = up->occStart[li]; k < up->occStart[li + 1]; k++)
+                if (--up->satCount[up->occ[k]] == 0) up->numSatisfied--;
+            int ni = unitPropLitIndex(-lit);
+            for (int k = up->occStart[ni]; k < up->occStart[ni + 1]; k++)
+                up->freeCount[up->occ[k]]++;
+        }
+        up->value[lit > 0 ? lit : -lit] = -1;
+    }
+    up->trailSize = mark;
+    if (up->qhead > mark) up->qhead = mark;
+    up->conflict = up->rootConflict;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file unitProp.h
+ * @brief Header for the counter-based unit propagation engine.
+ */
+
+#ifndef UNIT_PROP_H
+#define UNIT_PROP_H
+
+#include "cnfFormula.h"
+
+/**
+ * @brief Assignment state over a fixed formula with undoable propagation.
+ *
+ * Every clause keeps a count of satisfied and unassigned literals so that
+ * "all clauses satisfied" and "how much did this literal simplify" are
+ * O(1) questions, which is what lookahead and model counting need.
+ */
+typedef struct {
+    const CnfFormula *f;
+    int *occStart;        /**< CSR offsets of occurrence lists, by literal index */
+    int *occ;             /**< Clause ids containing each literal */
+    signed char *value;   /**< Per variable (1-based): 1, 0 or -1 */
+    int *trail;           /**< Assigned DIMACS literals in order */
+    int trailSize;
+    int qhead;            /**< Trail entries below qhead have been propagated */
+    int *satCount;        /**< Per clause: number of true literals */
+    int *freeCount;       /**< Per clause: number of unassigned literals */
+    int numSatisfied;     /**< Clauses with satCount > 0 */
+    int conflict;         /**< Non-zero once a clause became false */
+    int rootConflict;     /**< Formula contains an empty clause */
+} UnitProp;
+
+/**
+ * @brief Builds occurrence lists and enqueues the formula's unit clauses.
+ * @return New engine, or NULL on malloc failure.
+ */
+UnitProp *unitPropNew(const CnfFormula *f);
+
+/**
+ * @brief Frees an engine.
+ */
+void unitPropFree(UnitProp *up);
+
+/**
+ * @brief Enqueues a literal (no propagation yet).
+ * @return 0 if the literal is already false (conflict), 1 otherwise.
+ */
+int unitPropAssign(UnitProp *up, int lit);
+
+/**
+ * @brief Propagates all enqueued literals.
+ * @return 0 on conflict, 1 otherwise.
+ */
+int unitPropPropagate(UnitProp *up);
+
+/**
+ * @brief Undoes every assignment made after the trail had size mark.
+ */
+void unitPropBacktrack(UnitProp *up, int mark);
+
+/**
+ * @brief Value of a literal: 1 true, 0 false, -1 unassigned.
+ */
+static inline int unitPropLitValue(const UnitProp *up, int lit) {
+    int v = up->value[lit > 0 ? lit : -lit];
+    return v < 0 ? -1 : (lit > 0 ? v : !v);
+}
+
+/**
+ * @brief Index of a literal in the occurrence arrays.
+ */
+static inline int unitPropLitIndex(int lit) {
+    return lit > 0 ? 2 * lit : 2 * (-lit) + 1;
+}
+
+#endif
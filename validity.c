@@ -0,0 +1,95 @@
+/**
+ * @file validity.c
+ * @brief Checks validity of non-CNF formulas by refuting their negation.
+ *
+ * Task 6 + Task 7 decide validity by converting to CNF with
+ * distributeOr and looking for tautological clauses, which blows up
+ * exponentially. Here the negated tree is encoded in linear size and
+ * refuted with a complete CDCL search instead.
+ * @section algo Algorithm:
+ *   Step 1: Wrap the root in a '~' node
+ *   Step 2: Tseitin-encode it and assert the resulting literal
+ *   Step 3: UNSAT => valid; SAT => model gives a falsifying assignment
+ * @section time Time Complexity: O(n) encoding, exponential worst-case search
+ * @section space Space Complexity: O(n)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "validity.h"
+#include "tseitin.h"
+#include "satSolver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @copydoc checkValidityByRefutation
+ */
+int checkValidityByRefutation(Node *root, ValidityResult *r) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    memset(r, 0, sizeof(*r));
+    r->valid = -1;
+    varMapInit(&r->vars);
+    if (!root || !varMapCollect(&r->vars, root)) return r->valid;
+
+    Node negation = { "~", NULL, root };
+    Solver *s = solverNew(r->vars.count);
+    if (!s) return r->valid;
+
+    int lit = tseitinEncode(s, &r->vars, &negation);
+    if (lit) {
+        solverAddClause(s, &lit, 1);
+        r->auxVars = solverNumVars(s) - r->vars.count;
+
+        int res = solverSolve(s, NULL, 0);
+        if (res == SOLVER_UNSAT) {
+            r->valid = 1;
+        } else if (res == SOLVER_SAT) {
+            r->falsifying = malloc((size_t)(r->vars.count + 1) * sizeof(int));
+            if (r->falsifying) {
+                for (int v = 1; v <= r->vars.count; v++) r->falsifying[v] = solverModelValue(s, v);
+                r->valid = 0;
+            }
+        }
+        r->conflicts = solverGetStats(s).conflicts;
+    }
+    solverFree(s);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    r->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    return r->valid;
+}
+
+/**
+ * @copydoc printValidityResult
+ */
+void printValidityResult(const ValidityResult *r) {
+    if (r->valid < 0) {
+        printf("Error: Could not encode the formula. Check your input.\n");
+        return;
+    }
+    printf("Variables: %d, auxiliary variables: %d, conflicts: %lld\n",
+           r->vars.count, r->auxVars, r->conflicts);
+    if (r->valid) {
+        printf("Result: The formula is VALID (a Tautology).\n");
+    } else {
+        printf("Result: The formula is NOT VALID.\n");
+        printf("Falsifying assignment:");
+        for (int v = 1; v <= r->vars.count; v++)
+            printf(" %s=%d", r->vars.names[v - 1], r->falsifying[v]);
+        printf("\n");
+    }
+    printf("Refutation time: %f seconds\n", r->seconds);
+}
+
+/**
+ * @copydoc freeValidityResult
+ */
+void freeValidityResult(ValidityResult *r) {
+    varMapFree(&r->vars);
+    free(r->falsifying);
+    r->falsifying = NULL;
+}
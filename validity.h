@@ -0,0 +1,47 @@
+/**
+ * @file validity.h
+ * @brief Header for validity checking of arbitrary formulas by refutation.
+ */
+
+#ifndef VALIDITY_H
+#define VALIDITY_H
+
+#include "common.h"
+#include "varMap.h"
+
+/**
+ * @brief Outcome of a refutation-based validity check.
+ */
+typedef struct {
+    int valid;          /**< 1 valid, 0 not valid, -1 malformed formula or error */
+    VarMap vars;        /**< Variables of the formula, in preorder */
+    int *falsifying;    /**< When not valid: falsifying[i] is the value of vars index i (1-based) */
+    int auxVars;        /**< Auxiliary variables introduced by the encoding */
+    long long conflicts;/**< Conflicts needed to decide */
+    double seconds;     /**< Encoding plus solving time */
+} ValidityResult;
+
+/**
+ * @brief Decides whether a formula is a tautology.
+ *
+ * The negation ~F is Tseitin-encoded and handed to the CDCL solver:
+ * F is valid exactly when ~F is unsatisfiable. Otherwise the solver's
+ * model restricted to F's variables is a falsifying assignment.
+ *
+ * @param root Root of the parse tree (not modified).
+ * @param r Output; release with freeValidityResult.
+ * @return r->valid.
+ */
+int checkValidityByRefutation(Node *root, ValidityResult *r);
+
+/**
+ * @brief Prints the verdict and, if any, the falsifying assignment.
+ */
+void printValidityResult(const ValidityResult *r);
+
+/**
+ * @brief Frees memory held by a result.
+ */
+void freeValidityResult(ValidityResult *r);
+
+#endif
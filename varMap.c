@@ -0,0 +1,109 @@
+/**
+ * @file varMap.c
+ * @brief Open-addressing hash map from variable names to indices.
+ *
+ * Replaces the linear strcmp scans used by collectVariables and
+ * evaluateFormula when formulas have thousands of distinct variables.
+ * @section algo Algorithm: FNV-1a hashing with linear probing
+ * @section time Time Complexity: O(len) expected per lookup
+ * @section space Space Complexity: O(n)
+ */
+
+#include "varMap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int hashName(const char *s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @copydoc varMapInit
+ */
+void varMapInit(VarMap *m) {
+    memset(m, 0, sizeof(*m));
+}
+
+/**
+ * @copydoc varMapFree
+ */
+void varMapFree(VarMap *m) {
+    for (int i = 0; i < m->count; i++) free(m->names[i]);
+    free(m->names);
+    free(m->slots);
+    memset(m, 0, sizeof(*m));
+}
+
+/**
+ * @copydoc varMapFind
+ */
+int varMapFind(const VarMap *m, const char *name) {
+    if (m->numSlots == 0) return 0;
+    unsigned int mask = (unsigned int)m->numSlots - 1;
+    for (unsigned int i = hashName(name) & mask;; i = (i + 1) & mask) {
+        int idx = m->slots[i];
+        if (idx == 0) return 0;
+        if (strcmp(m->names[idx - 1], name) == 0) return idx;
+    }
+}
+
+/**
+ * @brief Doubles the probe table and reinserts every index.
+ * @return 1 on success, 0 on malloc failure.
+ */
+static int rehash(VarMap *m) {
+    int ns = m->numSlots ? m->numSlots * 2 : 64;
+    int *slots = calloc((size_t)ns, sizeof(int));
+    if (!slots) { perror("calloc"); return 0; }
+    unsigned int mask = (unsigned int)ns - 1;
+    for (int idx = 1; idx <= m->count; idx++) {
+        unsigned int i = hashName(m->names[idx - 1]) & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = idx;
+    }
+    free(m->slots);
+    m->slots = slots;
+    m->numSlots = ns;
+    return 1;
+}
+
+/**
+ * @copydoc varMapIntern
+ */
+int varMapIntern(VarMap *m, const char *name) {
+    int idx = varMapFind(m, name);
+    if (idx) return idx;
+
+    if (2 * (m->count + 1) > m->numSlots && !rehash(m)) return 0;
+    if (m->count == m->cap) {
+        int ncap = m->cap ? m->cap * 2 : 16;
+        char **nn = realloc(m->names, (size_t)ncap * sizeof(char*));
+        if (!nn) { perror("realloc"); return 0; }
+        m->names = nn;
+        m->cap = ncap;
+    }
+    char *copy = strdup_s(name);
+    if (!copy) return 0;
+    m->names[m->count++] = copy;
+
+    unsigned int mask = (unsigned int)m->numSlots - 1;
+    unsigned int i = hashName(name) & mask;
+    while (m->slots[i]) i = (i + 1) & mask;
+    m->slots[i] = m->count;
+    return m->count;
+}
+
+/**
+ * @copydoc varMapCollect
+ */
+int varMapCollect(VarMap *m, const Node *root) {
+    if (!root) return 1;
+    if (isVariableLeaf(root)) return varMapIntern(m, root->tok) != 0;
+    return varMapCollect(m, root->left) && varMapCollect(m, root->right);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file varMap.h
+ * @brief Header for the variable-name to index map.
+ */
+
+#ifndef VAR_MAP_H
+#define VAR_MAP_H
+
+#include <stddef.h>
+#include "common.h"
+
+/**
+ * @brief Hash map from variable names to dense indices 1..count.
+ *
+ * Names are numbered in first-insertion order, so collecting the leaves
+ * of a tree in preorder reproduces the column order of the truth table.
+ */
+typedef struct {
+    char **names;     /**< names[i] is the name of index i+1 */
+    int count;        /**< Number of distinct names */
+    int cap;          /**< Capacity of names */
+    int *slots;       /**< Open-addressing table of indices (0 = empty) */
+    int numSlots;     /**< Power of two */
+} VarMap;
+
+/**
+ * @brief Initializes an empty map.
+ */
+void varMapInit(VarMap *m);
+
+/**
+ * @brief Frees the names and table held by a map.
+ */
+void varMapFree(VarMap *m);
+
+/**
+ * @brief Looks up a name.
+ * @return Its index (1-based), or 0 if absent.
+ */
+int varMapFind(const VarMap *m, const char *name);
+
+/**
+ * @brief Looks up a name, inserting it if absent.
+ * @return Its index (1-based), or 0 on malloc failure.
+ */
+int varMapIntern(VarMap *m, const char *name);
+
+/**
+ * @brief Interns every leaf of a tree in preorder.
+ * @return 1 on success, 0 on malloc failure.
+ */
+int varMapCollect(VarMap *m, const Node *root);
+
+/**
+ * @brief Checks whether a parse-tree node is a variable leaf.
+ */
+static inline int isVariableLeaf(const Node *n) {
+    return n->left == NULL && n->right == NULL;
+}
+
+#endif
@@ -0,0 +1,351 @@
+/**
+ * @file workSteal.c
+ * @brief Thread pool with per-worker deques and randomized stealing.
+ *
+ * @section algo Algorithm: Work stealing
+ *   Each worker pops from the bottom of its own deque (LIFO, cache warm)
+ *   and, when empty, steals from the top of a random victim (FIFO, the
+ *   oldest and usually largest piece of work). Idle workers sleep on a
+ *   condition variable until new tasks are queued.
+ *   Fork-join: spawned tasks count down their group; a worker that joins
+ *   runs other tasks (its own children first) until the group is empty.
+ * @section time Time Complexity: O(1) per push/pop/steal
+ * @section space Space Complexity: O(T) for T queued tasks
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "workSteal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    WsTaskFn fn;
+    void *arg;
+    WsGroup *group;    /* NULL for wsPoolSubmit */
+} WsTask;
+
+/**
+ * @brief Mutex-protected circular deque of tasks.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    WsTask *buf;
+    int cap;
+    int head;    /* index of the oldest task (steal end) */
+    int count;
+} WsDeque;
+
+typedef struct {
+    WsPool *pool;
+    int id;
+    pthread_t thread;
+    WsWorkerStats stats;
+    unsigned int rng;
+} WsWorker;
+
+struct WsPool {
+    int numWorkers;
+    WsDeque *deques;
+    WsWorker *workers;
+    atomic_int queued;      /* tasks sitting in deques */
+    atomic_int pending;     /* tasks submitted but not finished */
+    int shutdown;
+    pthread_mutex_t lock;   /* guards sleeping and shutdown */
+    pthread_cond_t workReady;
+    pthread_cond_t allDone;
+};
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Pushes at the bottom (owner end), growing the buffer if full.
+ * @return 1 if queued, 0 if the buffer could not grow.
+ */
+static int dequePush(WsDeque *d, WsTask t) {
+    pthread_mutex_lock(&d->lock);
+    if (d->count == d->cap) {
+        int ncap = d->cap ? d->cap * 2 : 64;
+        WsTask *nb = malloc((size_t)ncap * sizeof(WsTask));
+        if (!nb) {
+            perror("malloc");
+            pthread_mutex_unlock(&d->lock);
+            return 0;
+        }
+        for (int i = 0; i < d->count; i++) nb[i] = d->buf[(d->head + i) % d->cap];
+        free(d->buf);
+        d->buf = nb;
+        d->cap = ncap;
+        d->head = 0;
+    }
+    d->buf[(d->head + d->count) % d->cap] = t;
+    d->count++;
+    pthread_mutex_unlock(&d->lock);
+    return 1;
+}
+
+/**
+ * @brief Takes a task from the bottom (owner) or top (thief) end.
+ * @return 1 if a task was taken, 0 if the deque was empty.
+ */
+static int dequeTake(WsDeque *d, int fromTop, WsTask *out) {
+    pthread_mutex_lock(&d->lock);
+    if (d->count == 0) {
+        pthread_mutex_unlock(&d->lock);
+        return 0;
+    }
+    if (fromTop) {
+        *out = d->buf[d->head];
+        d->head = (d->head + 1) % d->cap;
+    } else {
+        *out = d->buf[(d->head + d->count - 1) % d->cap];
+    }
+    d->count--;
+    pthread_mutex_unlock(&d->lock);
+    return 1;
+}
+
+/**
+ * @brief Finds work for a worker: own deque first, then random victims.
+ */
+static int findTask(WsWorker *w, WsTask *out) {
+    WsPool *p = w->pool;
+    if (dequeTake(&p->deques[w->id], 0, out)) return 1;
+    int start = (int)(rand_r(&w->rng) % (unsigned)p->numWorkers);
+    for (int k = 0; k < p->numWorkers; k++) {
+        int victim = (start + k) % p->numWorkers;
+        if (victim == w->id) continue;
+        if (dequeTake(&p->deques[victim], 1, out)) {
+            w->stats.steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Counts a finished task out of its group and the pool, waking
+ *        the waiters when either drains.
+ */
+static void finishTask(WsPool *p, WsTask t) {
+    int groupDone = t.group && atomic_fetch_sub(&t.group->pending, 1) == 1;
+    if (atomic_fetch_sub(&p->pending, 1) == 1 || groupDone) {
+        pthread_mutex_lock(&p->lock);
+        pthread_cond_broadcast(&p->allDone);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+/**
+ * @brief Runs a task taken by findTask and settles the counters.
+ */
+static void runTask(WsWorker *w, WsTask t) {
+    WsPool *p = w->pool;
+    atomic_fetch_sub(&p->queued, 1);
+    double t0 = nowSeconds();
+    t.fn(t.arg, w->id);
+    w->stats.busySeconds += nowSeconds() - t0;
+    w->stats.tasksRun++;
+    finishTask(p, t);
+}
+
+static void *workerLoop(void *arg) {
+    WsWorker *w = arg;
+    WsPool *p = w->pool;
+    for (;;) {
+        WsTask t;
+        if (findTask(w, &t)) {
+            runTask(w, t);
+            continue;
+        }
+        pthread_mutex_lock(&p->lock);
+        while (atomic_load(&p->queued) == 0 && !p->shutdown)
+            pthread_cond_wait(&p->workReady, &p->lock);
+        int stop = p->shutdown && atomic_load(&p->queued) == 0;
+        pthread_mutex_unlock(&p->lock);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+/**
+ * @copydoc wsNumCores
+ */
+int wsNumCores(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+/**
+ * @copydoc wsPoolCreate
+ */
+WsPool *wsPoolCreate(int numWorkers) {
+    if (numWorkers < 1) numWorkers = wsNumCores();
+    WsPool *p = calloc(1, sizeof(WsPool));
+    if (!p) { perror("calloc"); return NULL; }
+    p->numWorkers = numWorkers;
+    p->deques = calloc((size_t)numWorkers, sizeof(WsDeque));
+    p->workers = calloc((size_t)numWorkers, sizeof(WsWorker));
+    if (!p->deques || !p->workers) {
+        perror("calloc");
+        free(p->deques);
+        free(p->workers);
+        free(p);
+        return NULL;
+    }
+    atomic_init(&p->queued, 0);
+    atomic_init(&p->pending, 0);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->workReady, NULL);
+    pthread_cond_init(&p->allDone, NULL);
+
+    for (int i = 0; i < numWorkers; i++) pthread_mutex_init(&p->deques[i].lock, NULL);
+    for (int i = 0; i < numWorkers; i++) {
+        WsWorker *w = &p->workers[i];
+        w->pool = p;
+        w->id = i;
+        w->rng = 0x9e3779b9u * (unsigned)(i + 1);
+        if (pthread_create(&w->thread, NULL, workerLoop, w) != 0) {
+            perror("pthread_create");
+            p->numWorkers = i;
+            wsPoolDestroy(p);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+/**
+ * @copydoc wsPoolSubmit
+ */
+void wsPoolSubmit(WsPool *p, int worker, WsTaskFn fn, void *arg) {
+    wsSpawn(p, worker, NULL, fn, arg);
+}
+
+/**
+ * @copydoc wsGroupInit
+ */
+void wsGroupInit(WsGroup *g) {
+    atomic_init(&g->pending, 0);
+}
+
+/**
+ * @copydoc wsSpawn
+ */
+void wsSpawn(WsPool *p, int worker, WsGroup *g, WsTaskFn fn, void *arg) {
+    WsTask t = { fn, arg, g };
+    if (g) atomic_fetch_add(&g->pending, 1);
+    atomic_fetch_add(&p->pending, 1);
+    atomic_fetch_add(&p->queued, 1);
+    int owner = (worker % p->numWorkers + p->numWorkers) % p->numWorkers;
+    if (!dequePush(&p->deques[owner], t)) {
+        // Cannot queue: run inline rather than drop, and settle the
+        // counters as a worker would
+        atomic_fetch_sub(&p->queued, 1);
+        t.fn(t.arg, owner);
+        finishTask(p, t);
+        return;
+    }
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_signal(&p->workReady);
+    pthread_mutex_unlock(&p->lock);
+}
+
+/** Failed steal attempts a joining worker yields through before dozing. */
+#define JOIN_SPINS 32
+#define JOIN_DOZE_NS 200000L
+
+/**
+ * @copydoc wsJoin
+ */
+void wsJoin(WsPool *p, int worker, WsGroup *g) {
+    if (worker < 0 || worker >= p->numWorkers) {
+        pthread_mutex_lock(&p->lock);
+        while (atomic_load(&g->pending) > 0)
+            pthread_cond_wait(&p->allDone, &p->lock);
+        pthread_mutex_unlock(&p->lock);
+        return;
+    }
+    WsWorker *w = &p->workers[worker];
+    int idle = 0;
+    while (atomic_load(&g->pending) > 0) {
+        WsTask t;
+        if (findTask(w, &t)) {
+            runTask(w, t);
+            idle = 0;
+        } else if (++idle < JOIN_SPINS) {
+            sched_yield();   // the rest of the group runs on other workers
+        } else {
+            // Nothing to steal for a while: doze so an oversubscribed core
+            // goes to the worker being waited for, waking early if the
+            // group completes
+            struct timespec until;
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += JOIN_DOZE_NS;
+            if (until.tv_nsec >= 1000000000L) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+            pthread_mutex_lock(&p->lock);
+            if (atomic_load(&g->pending) > 0) pthread_cond_timedwait(&p->allDone, &p->lock, &until);
+            pthread_mutex_unlock(&p->lock);
+        }
+    }
+}
+
+/**
+ * @copydoc wsPoolWait
+ */
+void wsPoolWait(WsPool *p) {
+    pthread_mutex_lock(&p->lock);
+    while (atomic_load(&p->pending) > 0)
+        pthread_cond_wait(&p->allDone, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * @copydoc wsPoolNumWorkers
+ */
+int wsPoolNumWorkers(const WsPool *p) {
+    return p->numWorkers;
+}
+
+/**
+ * @copydoc wsPoolWorkerStats
+ */
+WsWorkerStats wsPoolWorkerStats(const WsPool *p, int worker) {
+    return p->workers[worker].stats;
+}
+
+/**
+ * @copydoc wsPoolDestroy
+ */
+void wsPoolDestroy(WsPool *p) {
+    if (!p) return;
+    wsPoolWait(p);
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = 1;
+    pthread_cond_broadcast(&p->workReady);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 0; i < p->numWorkers; i++) pthread_join(p->workers[i].thread, NULL);
+
+    for (int i = 0; i < p->numWorkers; i++) {
+        pthread_mutex_destroy(&p->deques[i].lock);
+        free(p->deques[i].buf);
+    }
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->workReady);
+    pthread_cond_destroy(&p->allDone);
+    free(p->deques);
+    free(p->workers);
+    free(p);
+}
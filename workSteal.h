@@ -0,0 +1,111 @@
+/**
+ * @file workSteal.h
+ * @brief Header for the work-stealing thread pool.
+ */
+
+#ifndef WORK_STEAL_H
+#define WORK_STEAL_H
+
+#include <stdatomic.h>
+
+/**
+ * @brief Task body. workerId identifies the thread running the task
+ *        (0 .. numWorkers-1), so tasks can use per-worker state.
+ */
+typedef void (*WsTaskFn)(void *arg, int workerId);
+
+/**
+ * @brief Per-worker counters collected while the pool runs.
+ */
+typedef struct {
+    double busySeconds;   /**< Wall time spent inside tasks */
+    long long tasksRun;   /**< Tasks executed by this worker */
+    long long steals;     /**< Tasks taken from another worker's deque */
+} WsWorkerStats;
+
+/**
+ * @brief Opaque pool handle.
+ */
+typedef struct WsPool WsPool;
+
+/**
+ * @brief Completion counter of the tasks spawned into it (fork-join).
+ */
+typedef struct {
+    atomic_int pending;
+} WsGroup;
+
+/**
+ * @brief Starts a pool of worker threads, each owning a task deque.
+ * @param numWorkers Number of threads (values < 1 mean one per core).
+ * @return New pool, or NULL on failure.
+ */
+WsPool *wsPoolCreate(int numWorkers);
+
+/**
+ * @brief Queues a task on a worker's deque.
+ *
+ * The owner runs its newest task first; idle workers steal the oldest
+ * task from a random victim.
+ *
+ * @param p Pool.
+ * @param worker Deque to push to (taken modulo the worker count).
+ * @param fn Task body.
+ * @param arg Argument passed to fn.
+ */
+void wsPoolSubmit(WsPool *p, int worker, WsTaskFn fn, void *arg);
+
+/**
+ * @brief Prepares an empty group.
+ */
+void wsGroupInit(WsGroup *g);
+
+/**
+ * @brief Queues a task that counts towards a group (the fork of fork-join).
+ *
+ * Called from inside a task, worker should be the caller's own workerId
+ * so that the task lands on its own deque and is run next unless stolen.
+ *
+ * @param p Pool.
+ * @param worker Deque to push to (taken modulo the worker count).
+ * @param g Group to count the task in.
+ * @param fn Task body.
+ * @param arg Argument passed to fn.
+ */
+void wsSpawn(WsPool *p, int worker, WsGroup *g, WsTaskFn fn, void *arg);
+
+/**
+ * @brief Waits until every task spawned into a group has finished (the join).
+ *
+ * A worker (worker >= 0, its own workerId) keeps running queued tasks
+ * while it waits, so a task that joins never blocks a thread. Any other
+ * thread passes worker < 0 and sleeps.
+ */
+void wsJoin(WsPool *p, int worker, WsGroup *g);
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ */
+void wsPoolWait(WsPool *p);
+
+/**
+ * @brief Number of worker threads in the pool.
+ */
+int wsPoolNumWorkers(const WsPool *p);
+
+/**
+ * @brief Snapshot of a worker's counters.
+ */
+WsWorkerStats wsPoolWorkerStats(const WsPool *p, int worker);
+
+/**
+ * @brief Stops the workers and frees the pool. Pending tasks are drained first.
+ */
+void wsPoolDestroy(WsPool *p);
+
+/**
+ * @brief Number of online processors (at least 1).
+ */
+int wsNumCores(void);
+
+#endif